@@ -1,6 +1,7 @@
 #include "ActManager.h"
 #include "ActTransitionRule.h"
 #include "DebugLog.h"
+#include "TerritorySystem.h"
 
 #include "CStats.h"
 
@@ -10,6 +11,7 @@ void ActManager::Init()
 {
     s_currentAct = 0;
     std::memset(s_lastMissionSeen, 0, sizeof(s_lastMissionSeen));
+    TerritorySystem::OnActChanged(s_currentAct);
 }
 
 void ActManager::SetAct(int act)
@@ -17,6 +19,7 @@ void ActManager::SetAct(int act)
     if (act == s_currentAct) return;
     DebugLog::Write("ActManager: act %d -> %d", s_currentAct, act);
     s_currentAct = act;
+    TerritorySystem::OnActChanged(act);
 }
 
 // Called every game loop tick. Detects when CStats::LastMissionPassedName changes
@@ -0,0 +1,132 @@
+#include "Crc32c.h"
+
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define CRC32C_X86 1
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CRC32C_TARGET_SSE42
+#else
+#include <cpuid.h>
+#define CRC32C_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#endif
+
+namespace Crc32c {
+
+// ------------------------------------------------------------
+// Slice-by-8 tables, built at compile time
+// ------------------------------------------------------------
+// t[0] is the classic byte table; t[k][b] is the CRC of byte b followed by
+// k zero bytes, so eight table lookups advance the CRC by eight bytes.
+struct Tables {
+    unsigned int t[8][256];
+};
+
+static constexpr Tables MakeTables() {
+    Tables tab{};
+    for (unsigned int i = 0; i < 256; ++i) {
+        unsigned int c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : (c >> 1);
+        tab.t[0][i] = c;
+    }
+    for (int k = 1; k < 8; ++k) {
+        for (unsigned int i = 0; i < 256; ++i) {
+            const unsigned int prev = tab.t[k - 1][i];
+            tab.t[k][i] = (prev >> 8) ^ tab.t[0][prev & 0xFF];
+        }
+    }
+    return tab;
+}
+
+static constexpr Tables kTables = MakeTables();
+
+static inline unsigned int LoadU32(const unsigned char* p) {
+    return (unsigned int)p[0]
+         | ((unsigned int)p[1] <<  8)
+         | ((unsigned int)p[2] << 16)
+         | ((unsigned int)p[3] << 24);
+}
+
+unsigned int ComputeSoftware(const void* data, size_t size, unsigned int crc) {
+    const unsigned int (*t)[256] = kTables.t;
+    const unsigned char* p = (const unsigned char*)data;
+    crc = ~crc;
+
+    while (size >= 8) {
+        const unsigned int lo = crc ^ LoadU32(p);
+        const unsigned int hi = LoadU32(p + 4);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+            ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size--) crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+// ------------------------------------------------------------
+// SSE4.2
+// ------------------------------------------------------------
+#ifdef CRC32C_X86
+static bool DetectSse42() {
+#ifdef _MSC_VER
+    int r[4] = {};
+    __cpuid(r, 1);
+    return ((unsigned int)r[2] >> 20) & 1u;
+#else
+    unsigned int a = 0, b = 0, c = 0, d = 0;
+    if (!__get_cpuid(1, &a, &b, &c, &d)) return false;
+    return (c >> 20) & 1u;
+#endif
+}
+
+CRC32C_TARGET_SSE42 static unsigned int ComputeSse42(const unsigned char* p, size_t size, unsigned int crc) {
+    crc = ~crc;
+#if defined(_M_X64) || defined(__x86_64__)
+    unsigned long long c = crc;
+    while (size >= 8) {
+        unsigned long long v;
+        std::memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        size -= 8;
+    }
+    crc = (unsigned int)c;
+#endif
+    while (size >= 4) {
+        unsigned int v;
+        std::memcpy(&v, p, 4);
+        crc = _mm_crc32_u32(crc, v);
+        p += 4;
+        size -= 4;
+    }
+    while (size--) crc = _mm_crc32_u8(crc, *p++);
+    return ~crc;
+}
+#endif
+
+bool HasHardware() {
+#ifdef CRC32C_X86
+    static const bool has = DetectSse42();
+    return has;
+#else
+    return false;
+#endif
+}
+
+unsigned int ComputeHardware(const void* data, size_t size, unsigned int crc) {
+#ifdef CRC32C_X86
+    if (HasHardware()) return ComputeSse42((const unsigned char*)data, size, crc);
+#endif
+    return ComputeSoftware(data, size, crc);
+}
+
+unsigned int Compute(const void* data, size_t size, unsigned int crc) {
+    return ComputeHardware(data, size, crc);
+}
+
+} // namespace Crc32c
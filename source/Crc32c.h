@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+
+// CRC-32C (Castagnoli polynomial, reflected 0x82F63B78) for sidecar
+// integrity checks.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Compute() uses the SSE4.2 crc32 instruction when the CPU has it and a
+// table-driven slice-by-8 loop otherwise; both give the same value.
+// Calls chain: Compute(b, n, Compute(a, m)) equals the CRC of a followed
+// by b. Check value: Compute("123456789", 9) == 0xE3069283.
+
+namespace Crc32c {
+
+unsigned int Compute(const void* data, size_t size, unsigned int crc = 0);
+
+// The two paths, for tests and benchmarks. ComputeHardware falls back to
+// software when HasHardware() is false.
+unsigned int ComputeSoftware(const void* data, size_t size, unsigned int crc = 0);
+unsigned int ComputeHardware(const void* data, size_t size, unsigned int crc = 0);
+bool HasHardware();
+
+} // namespace Crc32c
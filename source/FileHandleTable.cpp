@@ -0,0 +1,72 @@
+#include "FileHandleTable.h"
+
+static constexpr unsigned int kLive = 1u << 31;
+static constexpr unsigned int kSave = 1u << 8;
+static constexpr unsigned int kLoad = 1u << 9;
+static constexpr unsigned int kMask = (unsigned int)FileHandleTable::kCapacity - 1;
+static_assert(FileHandleTable::kCapacity == 256, "Home() takes the top 8 bits of the hash");
+
+unsigned int FileHandleTable::Home(std::intptr_t handle) {
+    // Fibonacci hashing: handles are pointers or small ints with the low
+    // bits mostly fixed, so mix before taking the top bits.
+    const unsigned long long h = (unsigned long long)handle * 0x9E3779B97F4A7C15ull;
+    return (unsigned int)(h >> 56) & kMask;
+}
+
+unsigned int FileHandleTable::Encode(const Op& op) {
+    return kLive | ((unsigned int)op.slot & 0xFFu) | (op.isSave ? kSave : 0u) | (op.isLoad ? kLoad : 0u);
+}
+
+FileHandleTable::Op FileHandleTable::Decode(unsigned int v) {
+    return Op{ (int)(v & 0xFFu), (v & kSave) != 0, (v & kLoad) != 0 };
+}
+
+bool FileHandleTable::Insert(std::intptr_t handle, const Op& op) {
+    if (handle == 0) return false;
+
+    unsigned int i = Home(handle);
+    for (int probes = 0; probes < kCapacity; ++probes, i = (i + 1) & kMask) {
+        std::intptr_t key = m_keys[i].load(std::memory_order_acquire);
+        if (key == 0) {
+            // Claim the empty slot; someone else may beat us to it.
+            if (m_keys[i].compare_exchange_strong(key, handle, std::memory_order_acq_rel)) key = handle;
+        }
+        if (key != handle) continue;
+
+        m_values[i].store(Encode(op), std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+bool FileHandleTable::Take(std::intptr_t handle, Op& out) {
+    if (handle == 0) return false;
+
+    unsigned int i = Home(handle);
+    for (int probes = 0; probes < kCapacity; ++probes, i = (i + 1) & kMask) {
+        const std::intptr_t key = m_keys[i].load(std::memory_order_acquire);
+        if (key == 0) return false; // keys are never removed, so the probe ends here
+        if (key != handle) continue;
+
+        const unsigned int v = m_values[i].exchange(0u, std::memory_order_acq_rel);
+        if (!(v & kLive)) return false;
+        out = Decode(v);
+        return true;
+    }
+    return false;
+}
+
+void FileHandleTable::Clear() {
+    for (int i = 0; i < kCapacity; ++i) {
+        m_values[i].store(0u, std::memory_order_relaxed);
+        m_keys[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+int FileHandleTable::Count() const {
+    int n = 0;
+    for (int i = 0; i < kCapacity; ++i) {
+        if (m_values[i].load(std::memory_order_acquire) & kLive) ++n;
+    }
+    return n;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Lock-free map from an open file handle to the save/load it belongs to.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// TerritoryPersistence's OpenFile/CloseFile hooks run for every file the
+// game opens, possibly on its streaming thread, so Insert/Take take no
+// lock. Open addressing with linear probing over a fixed power-of-two
+// array: a key slot, once claimed by a handle, keeps that handle for good
+// and only its value comes and goes. The CRT hands the same few handles
+// back for save files, so the table never fills in practice; if it does,
+// Insert fails and that one save/load goes untracked.
+//
+// Take() empties the value with one exchange, so a handle closed on two
+// threads at once completes its operation exactly once.
+
+class FileHandleTable {
+public:
+    struct Op {
+        int slot;     // save slot 1..8
+        bool isSave;
+        bool isLoad;
+    };
+
+    static constexpr int kCapacity = 256; // power of two
+
+    // handle 0 is never tracked (a failed open). Replaces an existing op.
+    bool Insert(std::intptr_t handle, const Op& op);
+
+    // Removes and returns the handle's op. False if it has none.
+    bool Take(std::intptr_t handle, Op& out);
+
+    // Drops every entry and key. Not safe against concurrent Insert/Take.
+    void Clear();
+
+    int Count() const; // live ops; a snapshot under concurrency
+
+private:
+    std::atomic<std::intptr_t> m_keys[kCapacity]{};
+    std::atomic<unsigned int> m_values[kCapacity]{}; // 0 = empty, else Encode(op)
+
+    static unsigned int Home(std::intptr_t handle);
+    static unsigned int Encode(const Op& op);
+    static Op Decode(unsigned int v);
+};
@@ -0,0 +1,250 @@
+#include "FileWatch.h"
+#include "Fnv1a.h"
+
+#include <cstdio>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+// ------------------------------------------------------------
+// Polling backend
+// ------------------------------------------------------------
+static bool PollingStat(const char* path, FileWatch::Stamp& out, void*) {
+    struct stat s {};
+    if (stat(path, &s) != 0) return false;
+    out.size = (long long)s.st_size;
+    out.mtime = (long long)s.st_mtime;
+    return true;
+}
+
+static bool PollingRead(const char* path, std::vector<char>& out, void*) {
+    out.clear();
+    FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    char buf[4096];
+    size_t rd;
+    while ((rd = std::fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + rd);
+    const bool ok = !std::ferror(f);
+    std::fclose(f);
+    return ok;
+}
+
+FileWatch::Backend FileWatch::Polling() {
+    Backend b;
+    b.stat = PollingStat;
+    b.read = PollingRead;
+    return b;
+}
+
+// ------------------------------------------------------------
+// Native backend
+// ------------------------------------------------------------
+#ifdef _WIN32
+static void* NativeOpenDir(const char* dir, void*) {
+    const HANDLE h = FindFirstChangeNotificationA(dir, FALSE,
+        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_FILE_NAME);
+    return h == INVALID_HANDLE_VALUE ? nullptr : (void*)h;
+}
+
+static bool NativePollDir(void* handle, void*) {
+    if (WaitForSingleObject((HANDLE)handle, 0) != WAIT_OBJECT_0) return false;
+    FindNextChangeNotification((HANDLE)handle); // re-arm
+    return true;
+}
+
+static void NativeCloseDir(void* handle, void*) {
+    FindCloseChangeNotification((HANDLE)handle);
+}
+#endif
+
+FileWatch::Backend FileWatch::Native() {
+    Backend b = Polling();
+#ifdef _WIN32
+    b.openDir = NativeOpenDir;
+    b.pollDir = NativePollDir;
+    b.closeDir = NativeCloseDir;
+#endif
+    return b;
+}
+
+// ------------------------------------------------------------
+// FileWatch
+// ------------------------------------------------------------
+FileWatch& FileWatch::Instance() {
+    static FileWatch instance(Native());
+    return instance;
+}
+
+static std::string DirOf(const std::string& path) {
+    const size_t slash = path.find_last_of("\\/");
+    if (slash == std::string::npos) return ".";
+    if (slash == 0) return path.substr(0, 1);
+    return path.substr(0, slash);
+}
+
+int FileWatch::FindFile(const std::string& path) const {
+    for (int i = 0; i < (int)m_files.size(); ++i) {
+        if (m_files[i].path == path) return i;
+    }
+    return -1;
+}
+
+int FileWatch::Watch(const std::string& path, Callback cb, void* user) {
+    if (!cb) return 0;
+    const int id = m_nextId++;
+
+    int at = FindFile(path);
+    if (at < 0) {
+        const std::string dirPath = DirOf(path);
+        int dir = -1;
+        for (int i = 0; i < (int)m_dirs.size(); ++i) {
+            if (m_dirs[i].path == dirPath) { dir = i; break; }
+        }
+        if (dir < 0) {
+            // Armed before the first stat below, so no change slips between them.
+            Dir d;
+            d.path = dirPath;
+            d.handle = m_backend.openDir ? m_backend.openDir(dirPath.c_str(), m_backend.user) : nullptr;
+            d.files = 0;
+            d.changed = false;
+            d.recheck = false;
+            m_dirs.push_back(d);
+            dir = (int)m_dirs.size() - 1;
+        }
+        ++m_dirs[dir].files;
+
+        File f;
+        f.path = path;
+        f.dir = dir;
+        // The file as it is now is the baseline; only later changes notify.
+        if (!m_backend.stat(path.c_str(), f.stamp, m_backend.user)) f.stamp = Stamp();
+        m_files.push_back(std::move(f));
+        at = (int)m_files.size() - 1;
+    }
+
+    m_files[at].subs.push_back({ id, cb, user });
+    return id;
+}
+
+void FileWatch::Unwatch(int id) {
+    for (File& f : m_files) {
+        for (Subscriber& s : f.subs) {
+            if (s.id == id) s.cb = nullptr;
+        }
+    }
+    if (!m_ticking) Sweep();
+}
+
+void FileWatch::Acknowledge(const std::string& path) {
+    const int at = FindFile(path);
+    if (at < 0) return;
+    File& f = m_files[at];
+    if (!m_backend.stat(path.c_str(), f.stamp, m_backend.user)) f.stamp = Stamp();
+    // Content we did not read ourselves: the next change always notifies.
+    f.hasHash = false;
+}
+
+int FileWatch::SubscriberCount() const {
+    int n = 0;
+    for (const File& f : m_files) {
+        for (const Subscriber& s : f.subs) {
+            if (s.cb) ++n;
+        }
+    }
+    return n;
+}
+
+void FileWatch::Tick(unsigned int nowMs) {
+    if (m_ticking || m_files.empty()) return;
+    if (m_checked && nowMs >= m_lastCheckMs && nowMs - m_lastCheckMs < m_intervalMs) return;
+    m_checked = true;
+    m_lastCheckMs = nowMs;
+
+    // One poll per directory, not per file.
+    for (Dir& d : m_dirs) {
+        d.changed = !d.handle || d.recheck || m_backend.pollDir(d.handle, m_backend.user);
+        d.recheck = false;
+    }
+
+    m_ticking = true;
+    const int count = (int)m_files.size(); // files watched from a callback wait for the next tick
+    for (int i = 0; i < count; ++i) {
+        if (!m_dirs[m_files[i].dir].changed) continue;
+
+        Stamp now;
+        if (!m_backend.stat(m_files[i].path.c_str(), now, m_backend.user)) now = Stamp();
+        if (now.size == m_files[i].stamp.size && now.mtime == m_files[i].stamp.mtime) continue;
+        m_files[i].stamp = now;
+        if (now.size < 0) continue; // gone; report it when it is back
+
+        if (!m_backend.read(m_files[i].path.c_str(), m_content, m_backend.user)) {
+            // Likely still being written: try again next tick.
+            m_files[i].stamp = Stamp();
+            m_dirs[m_files[i].dir].recheck = true;
+            continue;
+        }
+        const unsigned long long hash = Fnv1a::Hash(m_content.data(), m_content.size());
+        if (m_files[i].hasHash && hash == m_files[i].hash) continue;
+        m_files[i].hash = hash;
+        m_files[i].hasHash = true;
+
+        // m_files may grow under a callback; index it afresh each time.
+        const size_t subs = m_files[i].subs.size();
+        for (size_t k = 0; k < subs; ++k) {
+            const Subscriber s = m_files[i].subs[k];
+            if (s.cb) s.cb(m_content, hash, s.user);
+        }
+    }
+    m_ticking = false;
+    Sweep();
+}
+
+void FileWatch::Clear() {
+    if (m_ticking) {
+        for (File& f : m_files) {
+            for (Subscriber& s : f.subs) s.cb = nullptr;
+        }
+        return;
+    }
+    for (const Dir& d : m_dirs) {
+        if (d.handle && m_backend.closeDir) m_backend.closeDir(d.handle, m_backend.user);
+    }
+    m_files.clear();
+    m_dirs.clear();
+    m_content.clear();
+    m_checked = false;
+}
+
+void FileWatch::Sweep() {
+    for (size_t i = 0; i < m_files.size();) {
+        std::vector<Subscriber>& subs = m_files[i].subs;
+        size_t keep = 0;
+        for (size_t k = 0; k < subs.size(); ++k) {
+            if (subs[k].cb) subs[keep++] = subs[k];
+        }
+        subs.resize(keep);
+
+        if (subs.empty()) {
+            --m_dirs[m_files[i].dir].files;
+            m_files.erase(m_files.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+
+    std::vector<int> remap(m_dirs.size(), -1);
+    size_t keep = 0;
+    for (size_t i = 0; i < m_dirs.size(); ++i) {
+        if (m_dirs[i].files > 0) {
+            remap[i] = (int)keep;
+            m_dirs[keep++] = m_dirs[i];
+        } else if (m_dirs[i].handle && m_backend.closeDir) {
+            m_backend.closeDir(m_dirs[i].handle, m_backend.user);
+        }
+    }
+    if (keep == m_dirs.size()) return;
+    m_dirs.resize(keep);
+    for (File& f : m_files) f.dir = remap[f.dir];
+}
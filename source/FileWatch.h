@@ -0,0 +1,118 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// One watcher for every live-tunable file (territories.txt, the INI).
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Tick() runs once per frame from the main loop and does real work once
+// per interval. Each watched path is checked once however many
+// subscribers it has, and a changed file is read once and handed to all
+// of them along with its content hash. So the I/O per second depends on
+// the number of files, not on how many systems want to hear about them.
+//
+// Backends:
+//   Native()  - Windows: one directory change notification per watched
+//               directory, polled without blocking. A quiet directory costs
+//               no stat() at all; a signalled one stats only its own files.
+//               Elsewhere, the same as Polling().
+//   Polling() - stat() every watched file each interval.
+// Tests plug in their own.
+//
+// A changed stamp (size or mtime) triggers the read. A file whose bytes
+// hash the same as last time (saved without edits, touched) notifies no
+// one. Subscribers may Watch/Unwatch from inside their callback.
+
+class FileWatch {
+public:
+    struct Stamp {
+        long long size = -1; // -1: missing
+        long long mtime = -1;
+    };
+
+    // Each returns false on failure.
+    struct Backend {
+        void* user = nullptr;
+        bool (*stat)(const char* path, Stamp& out, void* user) = nullptr;
+        bool (*read)(const char* path, std::vector<char>& out, void* user) = nullptr;
+        // Optional. openDir returns nullptr when the directory cannot be
+        // watched (its files are then stat'ed every interval). pollDir must
+        // not block; true when anything in the directory may have changed
+        // since the last call.
+        void* (*openDir)(const char* dir, void* user) = nullptr;
+        bool (*pollDir)(void* handle, void* user) = nullptr;
+        void (*closeDir)(void* handle, void* user) = nullptr;
+    };
+    static Backend Native();
+    static Backend Polling();
+
+    typedef void (*Callback)(const std::vector<char>& content, unsigned long long hash, void* user);
+
+    // The game's watcher, on Native(). Ticked from gameProcessEvent.
+    static FileWatch& Instance();
+
+    explicit FileWatch(const Backend& backend = Native()) : m_backend(backend) {}
+    ~FileWatch() { Clear(); }
+
+    FileWatch(const FileWatch&) = delete;
+    FileWatch& operator=(const FileWatch&) = delete;
+
+    // Calls cb after the file at path changes. Paths are compared as given.
+    // Returns an id > 0.
+    int Watch(const std::string& path, Callback cb, void* user = nullptr);
+    void Unwatch(int id);
+
+    // The caller wrote or read the file itself: take its current stamp as
+    // seen, so that change is not reported back.
+    void Acknowledge(const std::string& path);
+
+    void SetIntervalMs(unsigned int ms) { m_intervalMs = ms; }
+    unsigned int IntervalMs() const { return m_intervalMs; }
+
+    // Checks at most once per interval. Game time going backwards (a save
+    // was loaded) checks right away.
+    void Tick(unsigned int nowMs);
+
+    // Drops every watch and closes the directory handles.
+    void Clear();
+
+    int FileCount() const { return (int)m_files.size(); }
+    int SubscriberCount() const;
+
+private:
+    struct Subscriber {
+        int id;
+        Callback cb; // nullptr once unwatched during a Tick
+        void* user;
+    };
+
+    struct File {
+        std::string path;
+        int dir; // index into m_dirs
+        Stamp stamp;
+        unsigned long long hash = 0;
+        bool hasHash = false;
+        std::vector<Subscriber> subs;
+    };
+
+    struct Dir {
+        std::string path;
+        void* handle; // nullptr: no native notification
+        int files;    // watched files in it
+        bool changed; // stat its files this tick
+        bool recheck; // a read failed: stat again next tick whatever the handle says
+    };
+
+    Backend m_backend;
+    std::vector<File> m_files;
+    std::vector<Dir> m_dirs;
+    std::vector<char> m_content; // scratch for reads
+    unsigned int m_intervalMs = 500;
+    unsigned int m_lastCheckMs = 0;
+    bool m_checked = false;
+    bool m_ticking = false;
+    int m_nextId = 1;
+
+    int FindFile(const std::string& path) const;
+    void Sweep(); // drops unwatched subscribers, then files and dirs nobody watches
+};
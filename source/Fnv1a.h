@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+
+// 64-bit FNV-1a, the one content hash for territories.txt and the INI.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// TerritoryCache::HashText, FileWatch's change check and IniConfig all go
+// through here, so a hash FileWatch reports compares equal to the one the
+// territory cache was keyed with. Add() chains: Add(Add(kOffset, a, m), b, n)
+// equals Hash() of a followed by b.
+
+namespace Fnv1a {
+
+constexpr unsigned long long kOffset = 0xCBF29CE484222325ull;
+constexpr unsigned long long kPrime = 0x100000001B3ull;
+
+inline unsigned long long Add(unsigned long long h, const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        h ^= (unsigned char)data[i];
+        h *= kPrime;
+    }
+    return h;
+}
+
+inline unsigned long long Hash(const char* data, size_t size) {
+    return Add(kOffset, data, size);
+}
+
+} // namespace Fnv1a
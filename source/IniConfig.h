@@ -1,11 +1,31 @@
 #pragma once
+#include "Fnv1a.h"
 
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
-#include <fstream>
-#include <sstream>
-#include <map>
+#include <string_view>
+#include <vector>
+#include <sys/stat.h>
+#ifdef _WIN32
 #include <Windows.h>
+#endif
 
+// III.GangTerritoryWars.ini, parsed once into a snapshot.
+//
+// Values live in a flat open-addressed table keyed by "section.key";
+// lookups take string_views and allocate nothing, and int/float values are
+// converted when the file is parsed. A value that is not a number reads as
+// the caller's default.
+//
+// Load() of the file that is already loaded only stats it: the same size
+// and mtime means no read at all. Otherwise it is read and hashed, and the
+// snapshot is rebuilt only if the content really changed. Generation()
+// moves on every rebuild, so a module keeps its settings in a plain struct
+// and re-reads them only when the generation it stored is stale.
 class IniConfig {
 public:
     static IniConfig& Instance() {
@@ -14,14 +34,13 @@ public:
     }
 
     // Get the directory where the calling module (ASI) is located
-    static std::string GetModuleDirectory(HMODULE hModule = nullptr) {
+    static std::string GetModuleDirectory() {
+#ifdef _WIN32
         char path[MAX_PATH];
-        if (hModule == nullptr) {
-            // Get handle to this DLL
-            MEMORY_BASIC_INFORMATION mbi;
-            VirtualQuery(&GetModuleDirectory, &mbi, sizeof(mbi));
-            hModule = (HMODULE)mbi.AllocationBase;
-        }
+        // Get handle to this DLL
+        MEMORY_BASIC_INFORMATION mbi;
+        VirtualQuery(&GetModuleDirectory, &mbi, sizeof(mbi));
+        HMODULE hModule = (HMODULE)mbi.AllocationBase;
 
         GetModuleFileNameA(hModule, path, MAX_PATH);
 
@@ -31,78 +50,211 @@ public:
         if (lastSlash != std::string::npos) {
             return fullPath.substr(0, lastSlash + 1);
         }
+#endif
         return "";
     }
 
     // Parse INI content from a string — used by unit tests and live-reload paths.
-    void LoadFromString(const std::string& content) {
-        std::istringstream stream(content);
-        ParseStream(stream);
+    // Replaces the snapshot. True if the content differs from the current one.
+    bool LoadFromString(std::string_view content) {
+        return Apply(content.data(), content.size());
+    }
+
+    // Loads from the module directory, falling back to the working
+    // directory. True if the snapshot changed.
+    bool Load(const std::string& filename) {
+        static const std::string moduleDir = GetModuleDirectory();
+        m_name = filename;
+
+        std::string path = moduleDir + filename;
+        Stamp stamp;
+        if (!StatFile(path, stamp)) {
+            path = filename;
+            if (!StatFile(path, stamp)) return false;
+        }
+        if (path == m_path && stamp.size == m_stamp.size && stamp.mtime == m_stamp.mtime) return false;
+
+        std::vector<char> text;
+        if (!ReadFile(path, text)) return false;
+        m_path = path;
+        m_stamp = stamp;
+        return Apply(text.data(), text.size());
     }
 
-    std::string GetString(const std::string& section, const std::string& key, const std::string& defaultValue) {
-        auto it = data_.find(section + "." + key);
-        return (it != data_.end()) ? it->second : defaultValue;
+    // Load() again with the last file name. Cheap when nothing changed.
+    bool Refresh() {
+        return m_name.empty() ? false : Load(m_name);
     }
 
-    void Load(const std::string& filename) {
-        // Try to load from module directory first
-        std::string modulePath = GetModuleDirectory() + filename;
+    unsigned int Generation() const { return m_generation; }
 
-        std::ifstream file(modulePath);
-        if (!file.is_open()) {
-            // Fallback to working directory
-            file.open(filename);
-            if (!file.is_open()) return;
-        }
+    // Where Load() found the file; empty if it never did.
+    const std::string& Path() const { return m_path; }
 
-        ParseStream(file);
+    std::string GetString(std::string_view section, std::string_view key, const std::string& defaultValue) const {
+        const Entry* e = Find(section, key);
+        return e ? e->text : defaultValue;
     }
 
-    int GetInt(const std::string& section, const std::string& key, int defaultValue) {
-        auto it = data_.find(section + "." + key);
-        if (it != data_.end()) {
-            return std::stoi(it->second);
-        }
-        return defaultValue;
+    int GetInt(std::string_view section, std::string_view key, int defaultValue) const {
+        const Entry* e = Find(section, key);
+        return (e && e->hasInt) ? e->intValue : defaultValue;
     }
 
-    float GetFloat(const std::string& section, const std::string& key, float defaultValue) {
-        auto it = data_.find(section + "." + key);
-        if (it != data_.end()) {
-            return std::stof(it->second);
-        }
-        return defaultValue;
+    float GetFloat(std::string_view section, std::string_view key, float defaultValue) const {
+        const Entry* e = Find(section, key);
+        return (e && e->hasFloat) ? e->floatValue : defaultValue;
     }
 
 private:
-    std::map<std::string, std::string> data_;
+    struct Entry {
+        std::string key; // "section.key"
+        unsigned long long hash;
+        std::string text;
+        int intValue;
+        float floatValue;
+        bool hasInt;
+        bool hasFloat;
+    };
+
+    struct Stamp {
+        long long size = -1;
+        long long mtime = -1;
+    };
 
-    void ParseStream(std::istream& stream) {
-        std::string line, section;
-        while (std::getline(stream, line)) {
-            line.erase(0, line.find_first_not_of(" \t\r\n"));
-            line.erase(line.find_last_not_of(" \t\r\n") + 1);
+    std::vector<Entry> m_entries;
+    std::vector<int> m_slots; // power of two; index into m_entries, -1 = empty
+    unsigned long long m_contentHash = 0;
+    bool m_hasContent = false;
+    unsigned int m_generation = 0;
+
+    std::string m_name; // as passed to Load()
+    std::string m_path; // where it was found
+    Stamp m_stamp;
+
+    static unsigned long long KeyHash(std::string_view section, std::string_view key) {
+        unsigned long long h = Fnv1a::Hash(section.data(), section.size());
+        h = Fnv1a::Add(h, ".", 1);
+        return Fnv1a::Add(h, key.data(), key.size());
+    }
+
+    const Entry* Find(std::string_view section, std::string_view key) const {
+        if (m_slots.empty()) return nullptr;
+        const unsigned long long h = KeyHash(section, key);
+        const size_t mask = m_slots.size() - 1;
+        const size_t keyLen = section.size() + 1 + key.size();
+        for (size_t i = (size_t)h & mask;; i = (i + 1) & mask) {
+            const int at = m_slots[i];
+            if (at < 0) return nullptr;
+            const Entry& e = m_entries[at];
+            if (e.hash == h && e.key.size() == keyLen
+                && std::memcmp(e.key.data(), section.data(), section.size()) == 0
+                && e.key[section.size()] == '.'
+                && std::memcmp(e.key.data() + section.size() + 1, key.data(), key.size()) == 0)
+            {
+                return &e;
+            }
+        }
+    }
+
+    static bool StatFile(const std::string& path, Stamp& out) {
+        struct stat s {};
+        if (stat(path.c_str(), &s) != 0) return false;
+        out.size = (long long)s.st_size;
+        out.mtime = (long long)s.st_mtime;
+        return true;
+    }
+
+    static bool ReadFile(const std::string& path, std::vector<char>& out) {
+        out.clear();
+        FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        char buf[4096];
+        size_t rd;
+        while ((rd = std::fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + rd);
+        std::fclose(f);
+        return true;
+    }
+
+    static std::string_view Trim(std::string_view s, const char* chars) {
+        const size_t b = s.find_first_not_of(chars);
+        if (b == std::string_view::npos) return std::string_view();
+        return s.substr(b, s.find_last_not_of(chars) - b + 1);
+    }
+
+    bool Apply(const char* data, size_t size) {
+        const unsigned long long contentHash = Fnv1a::Hash(data, size);
+        if (m_hasContent && contentHash == m_contentHash) return false;
+
+        Parse(std::string_view(data, size));
+        m_contentHash = contentHash;
+        m_hasContent = true;
+        ++m_generation;
+        return true;
+    }
+
+    void Parse(std::string_view text) {
+        m_entries.clear();
+
+        std::string_view section;
+        while (!text.empty()) {
+            const size_t nl = text.find('\n');
+            std::string_view line = Trim(text.substr(0, nl), " \t\r\n");
+            text = (nl == std::string_view::npos) ? std::string_view() : text.substr(nl + 1);
 
             if (line.empty() || line[0] == ';' || line[0] == '#') continue;
 
             if (line[0] == '[') {
-                section = line.substr(1, line.find(']') - 1);
-            } else {
-                size_t pos = line.find('=');
-                if (pos != std::string::npos) {
-                    std::string key   = line.substr(0, pos);
-                    std::string value = line.substr(pos + 1);
-                    key.erase(key.find_last_not_of(" \t") + 1);
-                    value.erase(0, value.find_first_not_of(" \t"));
-                    // Strip inline comments
-                    size_t cmtPos = value.find_first_of(";#");
-                    if (cmtPos != std::string::npos)
-                        value = value.substr(0, cmtPos);
-                    value.erase(value.find_last_not_of(" \t") + 1);
-                    data_[section + "." + key] = value;
+                const size_t close = line.find(']');
+                section = line.substr(1, close == std::string_view::npos ? close : close - 1);
+                continue;
+            }
+
+            const size_t pos = line.find('=');
+            if (pos == std::string_view::npos) continue;
+            const std::string_view key = Trim(line.substr(0, pos), " \t");
+            std::string_view value = line.substr(pos + 1);
+            // Strip inline comments
+            value = Trim(value.substr(0, value.find_first_of(";#")), " \t");
+
+            Entry e;
+            e.key.reserve(section.size() + 1 + key.size());
+            e.key.append(section).append(1, '.').append(key);
+            e.hash = KeyHash(section, key);
+            e.text.assign(value);
+            Convert(e);
+            m_entries.push_back(std::move(e));
+        }
+
+        // Later duplicates win, as they always did.
+        size_t cap = 16;
+        while (cap < m_entries.size() * 2) cap <<= 1;
+        m_slots.assign(cap, -1);
+        for (int n = 0; n < (int)m_entries.size(); ++n) {
+            const Entry& e = m_entries[n];
+            for (size_t i = (size_t)e.hash & (cap - 1);; i = (i + 1) & (cap - 1)) {
+                const int at = m_slots[i];
+                if (at < 0 || (m_entries[at].hash == e.hash && m_entries[at].key == e.key)) {
+                    m_slots[i] = n;
+                    break;
                 }
             }
         }
     }
-};
\ No newline at end of file
+
+    // Same prefixes stoi/stof accept ("1.5" is int 1), without the throw.
+    static void Convert(Entry& e) {
+        const char* s = e.text.c_str();
+        char* end = nullptr;
+
+        errno = 0;
+        const long l = std::strtol(s, &end, 10);
+        e.hasInt = end != s && errno != ERANGE && l >= INT_MIN && l <= INT_MAX;
+        e.intValue = e.hasInt ? (int)l : 0;
+
+        errno = 0;
+        const float f = std::strtof(s, &end);
+        e.hasFloat = end != s && errno != ERANGE;
+        e.floatValue = e.hasFloat ? f : 0.0f;
+    }
+};
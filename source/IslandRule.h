@@ -23,3 +23,12 @@ inline bool IsIslandUnlocked(Island island, int currentAct) {
     default:                return false;
     }
 }
+
+// Whether an island's territories take part in point queries and the radar
+// loop (TerritoryPartitions). Portland is where every game starts, so it is
+// active from act 0 — gang turf there still drives ambient spawns before JM2
+// even though the radar keeps it hidden; the other islands join as they
+// unlock.
+inline bool IsIslandActive(Island island, int currentAct) {
+    return island == Island::PORTLAND || IsIslandUnlocked(island, currentAct);
+}
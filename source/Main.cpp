@@ -18,6 +18,8 @@
 #include "TerritoryAmbientSpawner.h"
 #include "ActManager.h"
 #include "CStreaming.h"
+#include "CTimer.h"
+#include "FileWatch.h"
 
 #include <windows.h>
 #include <cstdio>
@@ -96,6 +98,7 @@ public:
             TerritoryAmbientSpawner::Shutdown();
             TerritoryPersistence::Shutdown();
             TerritorySystem::Shutdown();
+            FileWatch::Instance().Clear();
             PedDeathTracker::Shutdown();
             DirectDamageTracker::Shutdown();
             WaveManager::Shutdown();
@@ -105,6 +108,13 @@ public:
         Events::gameProcessEvent += [] {
             if (g_isTearingDown) return;
 
+            // Live-tuned files (territories.txt, the INI): one check for all
+            // of them, subscribers called with the new content.
+            FileWatch::Instance().Tick(CTimer::m_snTimeInMilliseconds);
+
+            // Player position/territory for this tick; everything below reads it.
+            TerritorySystem::UpdatePlayerContext();
+
             // One-time model preloading on first game tick
             static bool s_modelsPreloaded = false;
             if (!s_modelsPreloaded) {
@@ -179,6 +189,8 @@ public:
             if (JustPressed(VK_NUMPAD9)) TerritorySystem::EditorSetCornerBAtPlayer();
             if (JustPressed(VK_NUMPAD5)) TerritorySystem::EditorCommitTerritory();
             if (JustPressed(VK_NUMPAD8)) TerritorySystem::EditorDeleteClosestToPlayer();
+            if (JustPressed(VK_NUMPAD4)) TerritorySystem::EditorUndo();
+            if (JustPressed(VK_NUMPAD6)) TerritorySystem::EditorRedo();
             if (JustPressed(VK_NUMPAD1)) TerritorySystem::ForceReloadNow();
             if (JustPressed(VK_NUMPAD2)) TerritorySystem::ToggleOverlay();
             };
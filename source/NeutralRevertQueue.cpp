@@ -0,0 +1,33 @@
+#include "NeutralRevertQueue.h"
+
+#include <algorithm>
+
+namespace {
+
+// std heap helpers build a max-heap; invert for oldest-first.
+struct LaterFirst {
+    bool operator()(const NeutralRevertQueue::Entry& a, const NeutralRevertQueue::Entry& b) const {
+        return a.sinceMs > b.sinceMs;
+    }
+};
+
+} // namespace
+
+void NeutralRevertQueue::Push(TerritoryHandle h, unsigned int sinceMs) {
+    if (sinceMs == 0) return; // 0 = not stamped; NeutralRevertDue never fires
+    m_heap.push_back(Entry{ sinceMs, h });
+    std::push_heap(m_heap.begin(), m_heap.end(), LaterFirst());
+}
+
+void NeutralRevertQueue::Clear() {
+    m_heap.clear();
+}
+
+bool NeutralRevertQueue::PopDue(unsigned int nowMs, unsigned int revertMs, Entry& out) {
+    if (m_heap.empty() || !NeutralRevertDue(m_heap.front().sinceMs, nowMs, revertMs)) return false;
+
+    std::pop_heap(m_heap.begin(), m_heap.end(), LaterFirst());
+    out = m_heap.back();
+    m_heap.pop_back();
+    return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "NeutralRevertRule.h"
+#include "TerritoryHandleTable.h"
+
+#include <vector>
+
+// Pending neutral auto-reverts, ordered by the time each territory went neutral.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Replaces the per-frame scan over every territory: SetTerritoryOwner pushes
+// an entry when a territory goes neutral, and ProcessDue only looks at the
+// entries whose NeutralRevertDue window has passed. Recaptures are cancelled
+// lazily — an entry whose territory is no longer neutral, or has been
+// re-stamped since, is dropped when it reaches the top.
+//
+// Stamps are ordered by game time, so the heap is only valid while time runs
+// forward. When it jumps backwards (loading a save) or ownership is rewritten
+// in bulk, callers run one full pass with TryRevert() and then Clear() and
+// re-Push() whatever is still neutral.
+
+class NeutralRevertQueue {
+public:
+    struct Entry {
+        unsigned int sinceMs; // Territory::neutralSinceMs at push time
+        TerritoryHandle handle;
+    };
+
+    void Push(TerritoryHandle h, unsigned int sinceMs);
+    void Clear();
+
+    // Removes and returns the oldest entry if NeutralRevertDue says it is due.
+    bool PopDue(unsigned int nowMs, unsigned int revertMs, Entry& out);
+
+    int Size() const { return (int)m_heap.size(); }
+
+    // Applies every due revert with exactly the per-territory rule the old
+    // scan used. resolve(handle) returns a mutable Territory* (or nullptr);
+    // onRevert(territory, newOwner) runs after the owner is written. Due
+    // entries that are blocked (under attack, no revert target) stay queued
+    // and are retried on the next call. Returns the number of reverts.
+    template <typename ResolveFn, typename OnRevertFn>
+    int ProcessDue(unsigned int nowMs, unsigned int revertMs, ResolveFn resolve, OnRevertFn onRevert);
+
+    // The per-territory half of the rule, for a territory already known to be
+    // neutral and due: reverts it unless it is under attack or has no target.
+    template <typename TerritoryT, typename OnRevertFn>
+    static bool TryRevert(TerritoryT& t, OnRevertFn onRevert);
+
+private:
+    std::vector<Entry> m_heap;    // min-heap on sinceMs
+    std::vector<Entry> m_blocked; // scratch for ProcessDue
+};
+
+template <typename ResolveFn, typename OnRevertFn>
+int NeutralRevertQueue::ProcessDue(unsigned int nowMs, unsigned int revertMs, ResolveFn resolve, OnRevertFn onRevert) {
+    int reverted = 0;
+    m_blocked.clear();
+
+    Entry e;
+    while (PopDue(nowMs, revertMs, e)) {
+        auto* t = resolve(e.handle);
+        if (!t || t->ownerGang != -1 || t->neutralSinceMs != e.sinceMs) continue; // recaptured or re-stamped
+
+        if (TryRevert(*t, onRevert)) ++reverted;
+        else m_blocked.push_back(e);
+    }
+
+    for (const Entry& b : m_blocked) Push(b.handle, b.sinceMs);
+    return reverted;
+}
+
+template <typename TerritoryT, typename OnRevertFn>
+bool NeutralRevertQueue::TryRevert(TerritoryT& t, OnRevertFn onRevert) {
+    if (t.underAttack) return false;
+
+    const int revertTo = NeutralRevertTarget(t.lastOwnerGang, t.defaultOwnerGang);
+    if (revertTo == -1) return false;
+
+    t.ownerGang = revertTo;
+    t.neutralSinceMs = 0;
+    onRevert(t, revertTo);
+    return true;
+}
@@ -0,0 +1,139 @@
+#include "OwnershipJournal.h"
+#include "Crc32c.h"
+
+#include <cstdio>
+
+// ------------------------------------------------------------
+// Binary helpers
+// ------------------------------------------------------------
+static void StoreU32(unsigned char* p, unsigned int v) {
+    p[0] = (unsigned char)(v & 0xFF);
+    p[1] = (unsigned char)((v >>  8) & 0xFF);
+    p[2] = (unsigned char)((v >> 16) & 0xFF);
+    p[3] = (unsigned char)((v >> 24) & 0xFF);
+}
+
+static unsigned int LoadU32(const unsigned char* p) {
+    return (unsigned int)p[0]
+         | ((unsigned int)p[1] <<  8)
+         | ((unsigned int)p[2] << 16)
+         | ((unsigned int)p[3] << 24);
+}
+
+// Owners are ped types or the negative OWNER_ constants; 16 bits is plenty.
+static void StoreOwner(unsigned char* p, int owner) {
+    const unsigned short v = (unsigned short)(short)owner;
+    p[0] = (unsigned char)(v & 0xFF);
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static int LoadOwner(const unsigned char* p) {
+    return (int)(short)(unsigned short)(p[0] | (p[1] << 8));
+}
+
+// ------------------------------------------------------------
+// File format
+// ------------------------------------------------------------
+void OwnershipJournal::AppendHeader(std::vector<unsigned char>& out, unsigned int checkpointCrc) {
+    unsigned char h[kHeaderSize];
+    StoreU32(h, kMagic);
+    StoreU32(h + 4, kVersion);
+    StoreU32(h + 8, checkpointCrc);
+    out.insert(out.end(), h, h + kHeaderSize);
+}
+
+void OwnershipJournal::AppendRecord(std::vector<unsigned char>& out, const Record& r) {
+    unsigned char b[kRecordSize];
+    StoreU32(b, r.id);
+    StoreOwner(b + 4, r.oldOwner);
+    StoreOwner(b + 6, r.newOwner);
+    StoreU32(b + 8, r.timeMs);
+    StoreU32(b + 12, Crc32c::Compute(b, 12));
+    out.insert(out.end(), b, b + kRecordSize);
+}
+
+bool OwnershipJournal::Parse(const unsigned char* data, size_t size, unsigned int& outCheckpointCrc,
+    std::vector<Record>& outRecords, std::string& outErr)
+{
+    outCheckpointCrc = 0;
+    outRecords.clear();
+
+    if (size < kHeaderSize || LoadU32(data) != kMagic) {
+        outErr = "Not a GTWJ journal";
+        return false;
+    }
+    if (LoadU32(data + 4) != kVersion) {
+        outErr = "Unsupported journal version";
+        return false;
+    }
+    outCheckpointCrc = LoadU32(data + 8);
+
+    const size_t count = (size - kHeaderSize) / kRecordSize;
+    outRecords.reserve(count);
+    const unsigned char* p = data + kHeaderSize;
+    for (size_t i = 0; i < count; ++i, p += kRecordSize) {
+        if (Crc32c::Compute(p, 12) != LoadU32(p + 12)) {
+            char msg[64];
+            std::snprintf(msg, sizeof(msg), "Journal record %u: bad checksum", (unsigned int)i);
+            outErr = msg;
+            return false;
+        }
+        outRecords.push_back(Record{ LoadU32(p), LoadOwner(p + 4), LoadOwner(p + 6), LoadU32(p + 8) });
+    }
+    if ((size - kHeaderSize) % kRecordSize != 0) {
+        outErr = "Journal ends in a torn record";
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Session lineage
+// ------------------------------------------------------------
+void OwnershipJournal::Note(unsigned int id, int oldOwner, int newOwner, unsigned int timeMs) {
+    if (oldOwner == newOwner || m_overflowed) return;
+    if ((int)m_pending.size() >= kMaxPending) {
+        m_pending.clear();
+        m_overflowed = true;
+        return;
+    }
+    m_pending.push_back(Record{ id, oldOwner, newOwner, timeMs });
+}
+
+void OwnershipJournal::Reset() {
+    m_slot = -1;
+    m_act = 0;
+    m_defaultsHash = 0;
+    m_journaled = 0;
+    m_overflowed = false;
+    m_pending.clear();
+}
+
+void OwnershipJournal::Adopt(int slot, unsigned int act, unsigned long long defaultsHash, int journaled) {
+    Reset();
+    m_slot = slot;
+    m_act = act;
+    m_defaultsHash = defaultsHash;
+    m_journaled = journaled;
+}
+
+bool OwnershipJournal::BeginSave(int slot, unsigned int act, unsigned long long defaultsHash,
+    std::vector<Record>& outRecords)
+{
+    const bool checkpoint = m_slot < 0 || slot != m_slot || act != m_act || defaultsHash != m_defaultsHash
+        || m_overflowed || m_journaled + (int)m_pending.size() > kCompactAfter;
+
+    outRecords.swap(m_pending);
+    m_pending.clear();
+    m_overflowed = false;
+
+    m_slot = slot;
+    m_act = act;
+    m_defaultsHash = defaultsHash;
+    m_journaled = checkpoint ? 0 : m_journaled + (int)outRecords.size();
+    return checkpoint;
+}
+
+void OwnershipJournal::SaveFailed(int slot) {
+    if (slot == m_slot) m_slot = -1;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Per-slot write-ahead journal of ownership transitions.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// A save slot is its checkpoint (slot_N.dat, a full SidecarFormat
+// snapshot) plus slot_N.jnl, the transitions made after that checkpoint:
+//   [u32 magic 'GTWJ'][u32 version=1][u32 crc32c of the checkpoint file]
+//   then repeated, 16 bytes each:
+//   [u32 territory id][i16 old owner][i16 new owner][u32 game time ms]
+//   [u32 crc32c of the 12 bytes before it]
+// A journal whose checkpoint CRC does not match slot_N.dat belongs to an
+// older checkpoint and is ignored, so replacing the checkpoint first and
+// the journal second never mixes the two. A torn or corrupt record ends
+// the replay; everything before it still applies.
+//
+// The session side tracks which slot the in-memory ownership last matched
+// on disk (its lineage). TerritorySystem notes every gameplay transition;
+// a save to that same slot appends just those, anything else writes a new
+// checkpoint: another slot, a changed act or territories.txt defaults, a
+// failed write, or more than kCompactAfter records since the checkpoint.
+
+class OwnershipJournal {
+public:
+    struct Record {
+        unsigned int id;      // numeric territory id
+        int oldOwner;
+        int newOwner;
+        unsigned int timeMs;  // CTimer game time
+    };
+
+    static constexpr unsigned int kMagic   = 0x4A575447; // 'GTWJ' little-endian
+    static constexpr unsigned int kVersion = 1;
+    static constexpr size_t kHeaderSize = 12;
+    static constexpr size_t kRecordSize = 16;
+
+    // Replay cost on load grows with the journal; past this many records
+    // the next save compacts it into a checkpoint.
+    static constexpr int kCompactAfter = 512;
+    // Transitions kept between saves. Beyond this they are dropped and the
+    // next save checkpoints instead.
+    static constexpr int kMaxPending = 4096;
+
+    static void AppendHeader(std::vector<unsigned char>& out, unsigned int checkpointCrc);
+    static void AppendRecord(std::vector<unsigned char>& out, const Record& r);
+
+    // False (with outErr) on a bad header, a corrupt record or a torn last
+    // record. Records before the damage are kept in outRecords.
+    static bool Parse(const unsigned char* data, size_t size, unsigned int& outCheckpointCrc,
+        std::vector<Record>& outRecords, std::string& outErr);
+
+    // A gameplay ownership change.
+    void Note(unsigned int id, int oldOwner, int newOwner, unsigned int timeMs);
+
+    // Forgets the lineage and pending transitions; the next save checkpoints.
+    void Reset();
+    // Ownership now matches slot's checkpoint plus its `journaled` records.
+    void Adopt(int slot, unsigned int act, unsigned long long defaultsHash, int journaled);
+
+    // Moves the pending transitions into outRecords and takes slot as the
+    // lineage. True when this save must be a checkpoint (outRecords then
+    // only matter for the log: the snapshot already holds them).
+    bool BeginSave(int slot, unsigned int act, unsigned long long defaultsHash, std::vector<Record>& outRecords);
+    // A write for slot failed; its next save checkpoints.
+    void SaveFailed(int slot);
+
+    int Slot() const { return m_slot; } // -1 = no lineage
+    int Journaled() const { return m_journaled; }
+    const std::vector<Record>& Pending() const { return m_pending; }
+
+private:
+    int m_slot = -1;
+    unsigned int m_act = 0;
+    unsigned long long m_defaultsHash = 0;
+    int m_journaled = 0;
+    bool m_overflowed = false;
+    std::vector<Record> m_pending;
+};
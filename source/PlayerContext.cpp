@@ -0,0 +1,101 @@
+#include "PlayerContext.h"
+#include "TerritorySystem.h"
+
+#include <algorithm>
+
+void PlayerContextTracker::Update(bool valid, const CVector& pos, bool inVehicle, int act,
+    unsigned int geometryEpoch, const Source& src)
+{
+    const TerritoryHandle prev = m_ctx.territory;
+    const int prevOwner = m_ctx.ownerGang;
+
+    // Same geometry and act: last frame's territory still stands while the
+    // player is inside it and nothing else can claim the point.
+    const bool coherent = act == m_act && geometryEpoch == m_geometryEpoch;
+    m_act = act;
+    m_geometryEpoch = geometryEpoch;
+
+    TerritoryHandle h;
+    const Territory* t = nullptr;
+    if (valid) {
+        if (coherent && prev.IsValid()) {
+            t = src.resolve(prev, src.user);
+            if (t && t->ContainsPoint(pos) && !(src.contested && src.contested(prev, src.user))) {
+                h = prev;
+                ++m_reuses;
+            } else {
+                t = nullptr;
+            }
+        }
+        if (!h.IsValid()) {
+            h = src.query(pos, src.user);
+            t = h.IsValid() ? src.resolve(h, src.user) : nullptr;
+            if (!t) h = TerritoryHandle();
+            ++m_lookups;
+        }
+    }
+
+    m_ctx.valid = valid;
+    m_ctx.pos = pos;
+    m_ctx.inVehicle = valid && inVehicle;
+    m_ctx.island = valid ? GetIslandForPosition(pos.x, pos.y) : Island::UNKNOWN;
+    m_ctx.territory = h;
+    if (t) {
+        const Island home = GetIslandForPosition((t->minX + t->maxX) * 0.5f, (t->minY + t->maxY) * 0.5f);
+        m_ctx.ownerGang = t->ownerGang;
+        m_ctx.state = ComputeTerritoryState(t->ownerGang, act, !IsIslandUnlocked(home, act));
+    } else {
+        m_ctx.ownerGang = -1;
+        m_ctx.state = TerritoryState::NEUTRAL;
+    }
+
+    if (h != prev) {
+        if (prev.IsValid()) Fire(kExit, prev, prevOwner, prevOwner);
+        if (h.IsValid()) Fire(kEnter, h, m_ctx.ownerGang, m_ctx.ownerGang);
+    } else if (h.IsValid() && m_ctx.ownerGang != prevOwner) {
+        Fire(kOwnerChanged, h, prevOwner, m_ctx.ownerGang);
+    }
+}
+
+void PlayerContextTracker::Reset() {
+    const TerritoryHandle prev = m_ctx.territory;
+    const int prevOwner = m_ctx.ownerGang;
+    m_ctx = PlayerContext();
+    m_act = -1;
+    m_geometryEpoch = 0;
+    if (prev.IsValid()) Fire(kExit, prev, prevOwner, prevOwner);
+}
+
+int PlayerContextTracker::Subscribe(unsigned int kinds, Callback cb, void* user) {
+    if (!cb) return 0;
+    const int id = m_nextSubId++;
+    m_subs.push_back(Subscriber{ id, kinds & kAll, cb, user });
+    return id;
+}
+
+void PlayerContextTracker::Unsubscribe(int id) {
+    for (size_t i = 0; i < m_subs.size(); ++i) {
+        if (m_subs[i].id != id) continue;
+        if (m_dispatching) m_subs[i].cb = nullptr; // compacted when Fire finishes
+        else m_subs.erase(m_subs.begin() + i);
+        return;
+    }
+}
+
+void PlayerContextTracker::Fire(EventKind kind, TerritoryHandle h, int oldOwner, int newOwner) {
+    if (m_subs.empty()) return;
+    const Event e{ kind, h, oldOwner, newOwner };
+
+    // An exit and an enter fire back to back; only the outermost call compacts.
+    const bool outer = !m_dispatching;
+    m_dispatching = true;
+    for (size_t i = 0; i < m_subs.size(); ++i) {
+        const Subscriber s = m_subs[i];
+        if (s.cb && (s.kinds & kind)) s.cb(e, s.user);
+    }
+    if (!outer) return;
+    m_dispatching = false;
+
+    m_subs.erase(std::remove_if(m_subs.begin(), m_subs.end(),
+        [](const Subscriber& s) { return s.cb == nullptr; }), m_subs.end());
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "CVector.h"
+#include "IslandRule.h"
+#include "TerritoryStateRule.h"
+#include "TerritoryHandleTable.h"
+
+#include <vector>
+
+// Per-frame player context and territory enter/exit/owner-changed events.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// TerritorySystem::UpdatePlayerContext() fills the context once at the top
+// of every game tick; the war, wave and ambient systems read it instead of
+// each fetching the ped and running their own point query.
+//
+// Temporal coherence: the tracker keeps last frame's territory. While the
+// player is still inside it and it is not contested (overlaps nothing, so
+// no other territory can win the point), it is reused without a lookup. A
+// new geometry epoch or act drops the cached answer.
+
+struct Territory;
+
+struct PlayerContext {
+    bool valid = false;       // a player ped exists this frame
+    CVector pos;
+    bool inVehicle = false;   // in a vehicle, driving or riding as a passenger
+    Island island = Island::UNKNOWN;
+    TerritoryHandle territory; // invalid = outside every active territory
+    int ownerGang = -1;        // as of the start of the frame
+    TerritoryState state = TerritoryState::NEUTRAL;
+
+    bool InTerritory() const { return territory.IsValid(); }
+    bool OnFoot() const { return valid && !inVehicle; }
+};
+
+class PlayerContextTracker {
+public:
+    enum EventKind : unsigned int {
+        kEnter        = 1u << 0,
+        kExit         = 1u << 1,
+        kOwnerChanged = 1u << 2,
+        kAll          = kEnter | kExit | kOwnerChanged,
+    };
+
+    struct Event {
+        EventKind kind;
+        TerritoryHandle territory;
+        int oldOwner; // kOwnerChanged: before; kEnter/kExit: same as newOwner
+        int newOwner;
+    };
+
+    typedef void (*Callback)(const Event& e, void* user);
+
+    // What the tracker needs from the territory list.
+    struct Source {
+        void* user = nullptr;
+        // Full point query: the territory that wins pos, or an invalid handle.
+        TerritoryHandle (*query)(const CVector& pos, void* user) = nullptr;
+        // nullptr once the handle is stale.
+        const Territory* (*resolve)(TerritoryHandle h, void* user) = nullptr;
+        // True when containment alone does not prove h still wins the point
+        // (it overlaps another territory). nullptr = never contested.
+        bool (*contested)(TerritoryHandle h, void* user) = nullptr;
+    };
+
+    // Refreshes the context and fires events (after the context is updated,
+    // so callbacks see the new frame). valid=false means no player ped.
+    void Update(bool valid, const CVector& pos, bool inVehicle, int act,
+        unsigned int geometryEpoch, const Source& src);
+
+    // Exits the current territory (if any) and forgets everything, e.g.
+    // when the session ends. Subscribers are kept.
+    void Reset();
+
+    const PlayerContext& Context() const { return m_ctx; }
+
+    // kinds filters which events reach the callback. Returns an id > 0.
+    int Subscribe(unsigned int kinds, Callback cb, void* user);
+    void Unsubscribe(int id);
+
+    // Frames that ran a full point query / reused last frame's territory.
+    unsigned int Lookups() const { return m_lookups; }
+    unsigned int Reuses() const { return m_reuses; }
+
+private:
+    struct Subscriber {
+        int id;
+        unsigned int kinds;
+        Callback cb; // nullptr once unsubscribed during dispatch
+        void* user;
+    };
+
+    PlayerContext m_ctx;
+    int m_act = -1;
+    unsigned int m_geometryEpoch = 0;
+    unsigned int m_lookups = 0;
+    unsigned int m_reuses = 0;
+
+    std::vector<Subscriber> m_subs;
+    int m_nextSubId = 1;
+    bool m_dispatching = false;
+
+    void Fire(EventKind kind, TerritoryHandle h, int oldOwner, int newOwner);
+};
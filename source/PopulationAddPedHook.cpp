@@ -334,11 +334,11 @@ static void TryAmbientInjectGangPed()
     if (now < s_nextInjectMs) return;
     s_nextInjectMs = now + AMBIENT_INJECT_INTERVAL_MS;
 
-    CPlayerPed* player = CWorld::Players[0].m_pPed;
-    if (!player) return;
+    const PlayerContext& ctx = TerritorySystem::GetPlayerContext();
+    if (!ctx.valid) return;
 
-    const CVector playerPos = player->GetPosition();
-    const Territory* t = TerritorySystem::GetTerritoryAtPoint(playerPos);
+    const CVector playerPos = ctx.pos;
+    const Territory* t = TerritorySystem::Resolve(ctx.territory);
     if (!t) return;
 
     const int ownerGang = t->ownerGang;
@@ -384,6 +384,7 @@ static void TryAmbientInjectGangPed()
     if (spawnPos.x > t->maxX) spawnPos.x = t->maxX - 1.0f;
     if (spawnPos.y < t->minY) spawnPos.y = t->minY + 1.0f;
     if (spawnPos.y > t->maxY) spawnPos.y = t->maxY - 1.0f;
+    t->poly.PullInside(spawnPos.x, spawnPos.y);
 
     bool foundGround = false;
     float gz = CWorld::FindGroundZFor3DCoord(spawnPos.x, spawnPos.y, playerPos.z + 50.0f, &foundGround);
@@ -2,36 +2,38 @@
 #include <cstring>
 #include <cctype>
 
-#ifdef _WIN32
-#include <string.h>  // _stricmp
-#else
-#include <strings.h> // strcasecmp
-#define _stricmp strcasecmp
-#endif
-
 namespace SaveSlotParser {
 
+bool IsSavePathCandidate(const char* filePath, size_t len) {
+    if (!filePath || len < kMinSavePathLen) return false;
+    const char* end = filePath + len;
+    return (end[-1] == 'b' || end[-1] == 'B') && end[-2] == '.'
+        && std::isdigit((unsigned char)end[-3]);
+}
+
 bool TryParseSaveSlot(const char* filePath, int& outSlot) {
     if (!filePath) return false;
+    return TryParseSaveSlot(filePath, std::strlen(filePath), outSlot);
+}
 
-    const char* key = "GTA3sf";
-    const char* p = std::strstr(filePath, key);
-    if (!p) return false;
-    p += std::strlen(key);
+bool TryParseSaveSlot(const char* filePath, size_t len, int& outSlot) {
+    if (!IsSavePathCandidate(filePath, len)) return false;
 
-    if (!std::isdigit((unsigned char)*p)) return false;
+    // Walk back from ".b" over the slot digits to the GTA3sf prefix.
+    const char* digitsEnd = filePath + len - 2;
+    const char* p = digitsEnd;
+    while (p > filePath && std::isdigit((unsigned char)p[-1])) --p;
+
+    const char* key = "GTA3sf";
+    const size_t keyLen = std::strlen(key);
+    if ((size_t)(p - filePath) < keyLen || std::memcmp(p - keyLen, key, keyLen) != 0) return false;
 
     int slot = 0;
-    while (std::isdigit((unsigned char)*p)) {
+    for (; p < digitsEnd; ++p) {
         slot = slot * 10 + (*p - '0');
-        ++p;
+        if (slot > 8) return false;
     }
-
-    if (slot < 1 || slot > 8) return false;
-
-    // Must end with exactly ".b" (not ".bak" etc.)
-    const char* ext = std::strrchr(filePath, '.');
-    if (!ext || _stricmp(ext, ".b") != 0) return false;
+    if (slot < 1) return false;
 
     outSlot = slot;
     return true;
@@ -1,11 +1,21 @@
 #pragma once
+#include <cstddef>
+
 // Pure utility functions for parsing GTA III save-file paths and open modes.
 // No game engine dependencies — safe to include in unit test projects.
 
 namespace SaveSlotParser {
 
-// Returns true and sets outSlot (1..8) if filePath contains a GTA3sf{N}.b pattern.
+// Shortest save path: "GTA3sf1.b".
+constexpr size_t kMinSavePathLen = 9;
+
+// Cheap first test for the OpenFile hook, which sees every file the game
+// opens: length and the "<digit>.b" suffix only. False means not a save.
+bool IsSavePathCandidate(const char* filePath, size_t len);
+
+// Returns true and sets outSlot (1..8) if filePath's file name is GTA3sf{N}.b.
 bool TryParseSaveSlot(const char* filePath, int& outSlot);
+bool TryParseSaveSlot(const char* filePath, size_t len, int& outSlot);
 
 // Returns true if mode is a read-only mode (contains 'r', no 'w' or 'a').
 bool IsReadMode(const char* mode);
@@ -1,14 +1,12 @@
 #include "SidecarFormat.h"
+#include "AffiliationRule.h"
+#include "Crc32c.h"
+#include "TerritoryIdIndex.h"
 
-namespace SidecarFormat {
+#include <algorithm>
+#include <cstdio>
 
-// ------------------------------------------------------------
-// Format constants
-// ------------------------------------------------------------
-static const unsigned int kMagic          = 0x31575447; // 'GTW1' little-endian
-static const unsigned int kLegacyVersion  = 1;
-static const unsigned int kChunkedVersion = 2;
-static const unsigned int kTag_OWNR       = 0x524E574F; // 'OWNR' little-endian
+namespace SidecarFormat {
 
 // ------------------------------------------------------------
 // Binary helpers
@@ -20,14 +18,11 @@ static void PushU32(std::vector<unsigned char>& out, unsigned int v) {
     out.push_back((unsigned char)((v >> 24) & 0xFF));
 }
 
-static bool ReadU32(const std::vector<unsigned char>& b, size_t& i, unsigned int& v) {
-    if (i + 4 > b.size()) return false;
-    v = (unsigned int)b[i]
-      | ((unsigned int)b[i+1] <<  8)
-      | ((unsigned int)b[i+2] << 16)
-      | ((unsigned int)b[i+3] << 24);
-    i += 4;
-    return true;
+static unsigned int LoadU32(const unsigned char* p) {
+    return (unsigned int)p[0]
+         | ((unsigned int)p[1] <<  8)
+         | ((unsigned int)p[2] << 16)
+         | ((unsigned int)p[3] << 24);
 }
 
 static void PushU16(std::vector<unsigned char>& out, unsigned short v) {
@@ -35,179 +30,473 @@ static void PushU16(std::vector<unsigned char>& out, unsigned short v) {
     out.push_back((unsigned char)((v >> 8) & 0xFF));
 }
 
-static bool ReadU16(const std::vector<unsigned char>& b, size_t& i, unsigned short& v) {
-    if (i + 2 > b.size()) return false;
-    v = (unsigned short)b[i] | ((unsigned short)b[i+1] << 8);
-    i += 2;
-    return true;
+static unsigned short LoadU16(const unsigned char* p) {
+    return (unsigned short)(p[0] | (p[1] << 8));
+}
+
+static void PushVarint(std::vector<unsigned char>& out, unsigned int v) {
+    while (v >= 0x80) {
+        out.push_back((unsigned char)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((unsigned char)v);
+}
+
+// At most 5 bytes; false if it runs past end or overflows 32 bits.
+static bool LoadVarint(const unsigned char*& p, const unsigned char* end, unsigned int& v) {
+    v = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        const unsigned char b = *p++;
+        if (shift == 28 && b > 0x0F) return false;
+        v |= (unsigned int)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// ------------------------------------------------------------
+// Packed owner codes
+// ------------------------------------------------------------
+constexpr unsigned int kOwnerNeutral = 0;
+constexpr unsigned int kOwnerCleared = 1;
+constexpr unsigned int kOwnerGang1   = 2;  // GANG1; the nine gang ped types follow
+constexpr unsigned int kOwnerGangEnd = 11;
+constexpr unsigned int kOwnerEscape  = 15;
+
+static unsigned int OwnerCode(int owner) {
+    if (owner == OWNER_NEUTRAL) return kOwnerNeutral;
+    if (owner == OWNER_CLEARED) return kOwnerCleared;
+    if (owner >= GANG1 && owner < GANG1 + (int)(kOwnerGangEnd - kOwnerGang1)) {
+        return kOwnerGang1 + (unsigned int)(owner - GANG1);
+    }
+    return kOwnerEscape;
+}
+
+// ------------------------------------------------------------
+// Public API
+// ------------------------------------------------------------
+std::vector<unsigned char> Serialize(const std::vector<Entry>& entries) {
+    Writer w;
+    w.AddOwnership(entries);
+    return w.Bytes();
+}
+
+unsigned long long DefaultsHashAdd(unsigned long long h, unsigned int id, int defaultOwnerGang) {
+    // splitmix64 finalizer over the pair; summing keeps it order-independent.
+    unsigned long long x = ((unsigned long long)id << 32) | (unsigned int)defaultOwnerGang;
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return h + x;
+}
+
+ParseResult Deserialize(const std::vector<unsigned char>& bytes) {
+    return Deserialize(bytes.data(), bytes.size());
+}
+
+ParseResult Deserialize(const unsigned char* data, size_t size) {
+    ParseResult result;
+
+    Reader reader;
+    if (!reader.Open(data, size, result.error)) return result;
+    if (!reader.Complete()) {
+        result.error = reader.DirectoryError();
+        return result;
+    }
+    if (!reader.Verify(result.error)) return result;
+
+    if (!reader.FindChunk(kTagOwnr) && reader.FindChunk(kTagOwn3)) {
+        PackedCursor packed;
+        if (!reader.PackedOwnership(packed, result.error)) return result;
+
+        result.entries.reserve(packed.Count());
+        IdOwner e;
+        while (packed.Next(e)) {
+            char idbuf[16];
+            std::snprintf(idbuf, sizeof(idbuf), "%u", e.id);
+            result.entries.push_back(Entry{ idbuf, e.ownerGang });
+        }
+        if (packed.Failed()) {
+            result.error = packed.Error();
+            result.entries.clear();
+            return result;
+        }
+        result.ok = true;
+        return result;
+    }
+
+    OwnershipCursor cursor;
+    if (!reader.Ownership(cursor, result.error)) return result;
+
+    result.entries.reserve(cursor.Count());
+    std::string_view id;
+    int owner = 0;
+    while (cursor.Next(id, owner)) {
+        result.entries.push_back(Entry{ std::string(id), owner });
+    }
+    if (cursor.Failed()) {
+        result.error = cursor.Error();
+        result.entries.clear();
+        return result;
+    }
+
+    result.ok = true;
+    return result;
 }
 
 // ------------------------------------------------------------
-// OWNR payload helpers
+// Writer
 // ------------------------------------------------------------
-static std::vector<unsigned char> BuildOwnrPayload(const std::vector<Entry>& entries) {
-    std::vector<unsigned char> out;
-    out.reserve(4 + entries.size() * 16);
-    PushU32(out, (unsigned int)entries.size());
+void Writer::Clear() {
+    m_out.clear();
+    PushU32(m_out, kMagic);
+    PushU32(m_out, kPackedVersion);
+    PushU32(m_out, 0u); // chunkCount, bumped by EndChunk
+}
+
+void Writer::BeginChunk(unsigned int tag) {
+    m_chunkAt = m_out.size();
+    PushU32(m_out, tag);
+    PushU32(m_out, 0u); // payloadLen, patched by EndChunk
+}
+
+void Writer::EndChunk() {
+    const unsigned int len = (unsigned int)(m_out.size() - m_chunkAt - 8);
+    for (int k = 0; k < 4; ++k) m_out[m_chunkAt + 4 + k] = (unsigned char)(len >> (8 * k));
+    const unsigned int chunks = LoadU32(&m_out[8]) + 1;
+    for (int k = 0; k < 4; ++k) m_out[8 + k] = (unsigned char)(chunks >> (8 * k));
+}
+
+void Writer::AddOwnership(const std::vector<Entry>& entries) {
+    BeginChunk(kTagOwnr);
+    m_out.reserve(m_out.size() + 4 + entries.size() * 16);
+    PushU32(m_out, (unsigned int)entries.size());
     for (const auto& e : entries) {
         const auto len = (unsigned short)e.id.size();
-        PushU16(out, len);
-        out.insert(out.end(), e.id.begin(), e.id.end());
-        PushU32(out, (unsigned int)(e.ownerGang));
+        PushU16(m_out, len);
+        m_out.insert(m_out.end(), e.id.begin(), e.id.begin() + len);
+        PushU32(m_out, (unsigned int)e.ownerGang);
     }
-    return out;
+    EndChunk();
 }
 
-static bool ParseOwnrPayload(
-    const std::vector<unsigned char>& bytes,
-    size_t& i,
-    std::vector<Entry>& outEntries,
-    std::string& outErr)
-{
-    outEntries.clear();
+void Writer::AddOwnership(const IdOwner* entries, size_t count) {
+    BeginChunk(kTagOwnr);
+    m_out.reserve(m_out.size() + 4 + count * 16);
+    PushU32(m_out, (unsigned int)count);
+    for (size_t i = 0; i < count; ++i) {
+        char idbuf[16];
+        const int n = std::snprintf(idbuf, sizeof(idbuf), "%u", entries[i].id);
+        const unsigned short len = (unsigned short)(n > 0 ? n : 0);
+        PushU16(m_out, len);
+        m_out.insert(m_out.end(), idbuf, idbuf + len);
+        PushU32(m_out, (unsigned int)entries[i].ownerGang);
+    }
+    EndChunk();
+}
 
-    unsigned int count = 0;
-    if (!ReadU32(bytes, i, count)) { outErr = "OWNR: missing count"; return false; }
-    if (count > 4096)              { outErr = "OWNR: count too large"; return false; }
+void Writer::AddOwnershipPacked(const IdOwner* entries, size_t count) {
+    BeginChunk(kTagOwn3);
+    PushPacked(entries, count);
+    EndChunk();
+}
 
-    outEntries.reserve(count);
-    for (unsigned int n = 0; n < count; ++n) {
-        unsigned short len = 0;
-        if (!ReadU16(bytes, i, len))      { outErr = "OWNR: missing idLen"; return false; }
-        if (i + len > bytes.size())       { outErr = "OWNR: id bytes out of range"; return false; }
+void Writer::AddOwnershipDelta(unsigned long long defaultsHash, const IdOwner* entries, size_t count) {
+    BeginChunk(kTagOdlt);
+    PushU32(m_out, (unsigned int)(defaultsHash & 0xFFFFFFFFu));
+    PushU32(m_out, (unsigned int)(defaultsHash >> 32));
+    PushPacked(entries, count);
+    EndChunk();
+}
 
-        Entry e;
-        e.id.assign((const char*)&bytes[i], (size_t)len);
-        i += len;
+void Writer::PushPacked(const IdOwner* entries, size_t count) {
+    std::vector<IdOwner> sorted(entries, entries + count);
+    std::sort(sorted.begin(), sorted.end(),
+        [](const IdOwner& a, const IdOwner& b) { return a.id < b.id; });
 
-        unsigned int ownerU = 0;
-        if (!ReadU32(bytes, i, ownerU))   { outErr = "OWNR: missing owner"; return false; }
-        e.ownerGang = (int)ownerU;
-        outEntries.push_back(e);
+    std::vector<unsigned char> ids;
+    ids.reserve(count * 2);
+    unsigned int prev = 0;
+    for (const IdOwner& e : sorted) {
+        PushVarint(ids, e.id - prev);
+        prev = e.id;
     }
 
-    if (outEntries.size() != count) {
-        outErr = "OWNR: parsed count mismatch";
-        return false;
+    PushVarint(m_out, (unsigned int)count);
+    PushVarint(m_out, (unsigned int)ids.size());
+    m_out.insert(m_out.end(), ids.begin(), ids.end());
+
+    const size_t nibblesAt = m_out.size();
+    m_out.resize(nibblesAt + (count + 1) / 2, 0);
+    for (size_t i = 0; i < count; ++i) {
+        const unsigned int code = OwnerCode(sorted[i].ownerGang);
+        m_out[nibblesAt + i / 2] |= (unsigned char)(code << ((i & 1) * 4));
     }
-    return true;
+    for (const IdOwner& e : sorted) {
+        if (OwnerCode(e.ownerGang) != kOwnerEscape) continue;
+        const unsigned int v = (unsigned int)e.ownerGang;
+        PushVarint(m_out, (v << 1) ^ (unsigned int)(e.ownerGang >> 31)); // zigzag
+    }
+}
+
+void Writer::AddAct(unsigned int act) {
+    BeginChunk(kTagActl);
+    PushU32(m_out, act);
+    EndChunk();
+}
+
+void Writer::AddChecksum() {
+    for (int k = 0; k < 4; ++k) m_out[4 + k] = (unsigned char)(kChecksumVersion >> (8 * k));
+    BeginChunk(kTagCsum);
+    PushU32(m_out, 0u);
+    EndChunk(); // header now final: the CRC covers the version and chunk count
+
+    const unsigned int crc = Crc32c::Compute(m_out.data(), m_chunkAt);
+    for (int k = 0; k < 4; ++k) m_out[m_chunkAt + 8 + k] = (unsigned char)(crc >> (8 * k));
 }
 
 // ------------------------------------------------------------
-// Public API
+// Reader
 // ------------------------------------------------------------
-std::vector<unsigned char> Serialize(const std::vector<Entry>& entries) {
-    auto ownr = BuildOwnrPayload(entries);
+bool Reader::Open(const unsigned char* data, size_t size, std::string& outErr) {
+    m_data = data;
+    m_size = size;
+    m_version = 0;
+    m_chunkCount = 0;
+    m_dirError = nullptr;
+
+    if (!data || size < 8) { outErr = "corrupt header"; return false; }
+    if (LoadU32(data) != kMagic) { outErr = "bad magic"; return false; }
+    m_version = LoadU32(data + 4);
+
+    if (m_version == kLegacyVersion) {
+        m_chunks[0] = Chunk{ kTagOwnr, 8u, (unsigned int)(size - 8) };
+        m_chunkCount = 1;
+        return true;
+    }
+    if (m_version < kChunkedVersion) { outErr = "unknown version"; return false; }
+
+    if (size < 12) { outErr = "v2: bad chunkCount"; return false; }
+    const unsigned int chunkCount = LoadU32(data + 8);
+    if (chunkCount > (unsigned int)kMaxChunks) { outErr = "v2: bad chunkCount"; return false; }
 
-    std::vector<unsigned char> out;
-    out.reserve(12 + 8 + ownr.size());
+    size_t i = 12;
+    for (unsigned int c = 0; c < chunkCount; ++c) {
+        if (size - i < 8) { m_dirError = "v2: corrupt chunk header"; break; }
+        const unsigned int tag = LoadU32(data + i);
+        const unsigned int len = LoadU32(data + i + 4);
+        i += 8;
+        if (len > size - i) { m_dirError = "v2: chunk len out of range"; break; }
+        m_chunks[m_chunkCount++] = Chunk{ tag, (unsigned int)i, len };
+        i += len;
+    }
+    return true;
+}
+
+const Reader::Chunk* Reader::FindChunk(unsigned int tag) const {
+    for (int i = 0; i < m_chunkCount; ++i) {
+        if (m_chunks[i].tag == tag) return &m_chunks[i];
+    }
+    return nullptr;
+}
 
-    PushU32(out, kMagic);
-    PushU32(out, kChunkedVersion);
-    PushU32(out, 1u); // chunkCount
+bool Reader::Ownership(OwnershipCursor& out, std::string& outErr) const {
+    out = OwnershipCursor();
+    const Chunk* c = FindChunk(kTagOwnr);
+    if (!c) { outErr = "missing OWNR chunk"; return false; }
+    if (c->size < 4) { outErr = "OWNR: missing count"; return false; }
 
-    PushU32(out, kTag_OWNR);
-    PushU32(out, (unsigned int)ownr.size());
-    out.insert(out.end(), ownr.begin(), ownr.end());
+    const unsigned char* p = Payload(*c);
+    const unsigned int count = LoadU32(p);
+    if (count > kMaxEntries) { outErr = "OWNR: count too large"; return false; }
+    // Every entry takes at least its u16 length and u32 owner.
+    if (count > (c->size - 4) / 6) { outErr = "OWNR: count exceeds payload"; return false; }
 
-    return out;
+    out.m_p = p + 4;
+    out.m_end = p + c->size;
+    out.m_count = count;
+    return true;
 }
 
-ParseResult Deserialize(const std::vector<unsigned char>& bytes) {
-    ParseResult result;
-    size_t i = 0;
+bool Reader::OpenPacked(const unsigned char* p, size_t size, PackedCursor& out, const char*& outErr) {
+    const unsigned char* end = p + size;
+    unsigned int count = 0;
+    unsigned int idBytes = 0;
+    if (!LoadVarint(p, end, count) || !LoadVarint(p, end, idBytes)) {
+        outErr = "missing packed header";
+        return false;
+    }
+    // Every id takes at least one byte.
+    if (count > idBytes || idBytes > (size_t)(end - p)) {
+        outErr = "packed ids out of range";
+        return false;
+    }
+    const size_t nibbleBytes = ((size_t)count + 1) / 2;
+    if (nibbleBytes > (size_t)(end - p) - idBytes) {
+        outErr = "packed owners out of range";
+        return false;
+    }
 
-    unsigned int magic = 0, ver = 0;
-    if (!ReadU32(bytes, i, magic) || !ReadU32(bytes, i, ver)) {
-        result.error = "corrupt header";
-        return result;
+    out.m_ids = p;
+    out.m_idsEnd = p + idBytes;
+    out.m_owners = out.m_idsEnd;
+    out.m_escapes = out.m_owners + nibbleBytes;
+    out.m_end = end;
+    out.m_count = count;
+    return true;
+}
+
+bool Reader::PackedOwnership(PackedCursor& out, std::string& outErr) const {
+    out = PackedCursor();
+    const Chunk* c = FindChunk(kTagOwn3);
+    if (!c) { outErr = "missing OWN3 chunk"; return false; }
+
+    const char* err = nullptr;
+    if (!OpenPacked(Payload(*c), c->size, out, err)) {
+        outErr = std::string("OWN3: ") + err;
+        return false;
     }
-    if (magic != kMagic) {
-        result.error = "bad magic";
-        return result;
+    return true;
+}
+
+bool Reader::Delta(unsigned long long& outDefaultsHash, PackedCursor& out, std::string& outErr) const {
+    out = PackedCursor();
+    const Chunk* c = FindChunk(kTagOdlt);
+    if (!c) { outErr = "missing ODLT chunk"; return false; }
+    if (c->size < 8) { outErr = "ODLT: missing hash"; return false; }
+
+    const unsigned char* p = Payload(*c);
+    const char* err = nullptr;
+    if (!OpenPacked(p + 8, c->size - 8, out, err)) {
+        outErr = std::string("ODLT: ") + err;
+        return false;
     }
+    outDefaultsHash = (unsigned long long)LoadU32(p) | ((unsigned long long)LoadU32(p + 4) << 32);
+    return true;
+}
 
-    // -------------------------
-    // v1 legacy format
-    // -------------------------
-    if (ver == kLegacyVersion) {
-        unsigned int count = 0;
-        if (!ReadU32(bytes, i, count) || count > 4096) {
-            result.error = "v1: bad count";
-            return result;
-        }
+bool Reader::Act(unsigned int& outAct) const {
+    const Chunk* c = FindChunk(kTagActl);
+    if (!c || c->size != 4) return false;
+    outAct = LoadU32(Payload(*c));
+    return true;
+}
 
-        result.entries.reserve(count);
-        for (unsigned int n = 0; n < count; ++n) {
-            unsigned short len = 0;
-            if (!ReadU16(bytes, i, len) || i + len > bytes.size()) {
-                result.error = "v1: corrupt entry";
-                return result;
-            }
-            Entry e;
-            e.id.assign((const char*)&bytes[i], (size_t)len);
-            i += len;
-
-            unsigned int ownerU = 0;
-            if (!ReadU32(bytes, i, ownerU)) {
-                result.error = "v1: missing owner";
-                return result;
-            }
-            e.ownerGang = (int)ownerU;
-            result.entries.push_back(e);
-        }
+bool Reader::Verify(std::string& outErr) const {
+    const bool required = !IsLegacy() && m_version >= kChecksumVersion;
+    const Chunk* c = FindChunk(kTagCsum);
+    if (!c) {
+        if (!required) return true;
+        outErr = Complete() ? "CSUM: missing" : DirectoryError();
+        return false;
+    }
+    if (required && !Complete()) { outErr = DirectoryError(); return false; }
+    if (c != &m_chunks[m_chunkCount - 1]) { outErr = "CSUM: not the last chunk"; return false; }
+    if (c->size != 4) { outErr = "CSUM: bad size"; return false; }
 
-        if (result.entries.size() != count) {
-            result.error = "v1: count mismatch";
-            return result;
-        }
-        result.ok = true;
-        return result;
+    const unsigned int crc = Crc32c::Compute(m_data, (size_t)c->offset - 8);
+    if (crc != LoadU32(Payload(*c))) { outErr = "CSUM: mismatch"; return false; }
+    return true;
+}
+
+bool OwnershipCursor::Next(std::string_view& outId, int& outOwner) {
+    if (m_err || m_read >= m_count) return false;
+
+    const size_t left = (size_t)(m_end - m_p);
+    if (left < 2) { m_err = "OWNR: missing idLen"; return false; }
+    const unsigned short len = LoadU16(m_p);
+    if (left - 2 < len) { m_err = "OWNR: id bytes out of range"; return false; }
+    if (left - 2 - len < 4) { m_err = "OWNR: missing owner"; return false; }
+
+    outId = std::string_view((const char*)m_p + 2, len);
+    outOwner = (int)LoadU32(m_p + 2 + len);
+    m_p += 6 + len;
+    ++m_read;
+    return true;
+}
+
+bool PackedCursor::Next(IdOwner& out) {
+    if (m_err || m_read >= m_count) return false;
+
+    unsigned int delta = 0;
+    if (!LoadVarint(m_ids, m_idsEnd, delta)) { m_err = "packed id out of range"; return false; }
+    if (delta > 0xFFFFFFFFu - m_id) { m_err = "packed id overflows"; return false; }
+    m_id += delta;
+
+    const unsigned int code = (m_owners[m_read >> 1] >> ((m_read & 1) * 4)) & 0x0F;
+    int owner;
+    if (code == kOwnerNeutral) owner = OWNER_NEUTRAL;
+    else if (code == kOwnerCleared) owner = OWNER_CLEARED;
+    else if (code < kOwnerGangEnd) owner = GANG1 + (int)(code - kOwnerGang1);
+    else if (code == kOwnerEscape) {
+        unsigned int z = 0;
+        if (!LoadVarint(m_escapes, m_end, z)) { m_err = "packed owner escape out of range"; return false; }
+        owner = (int)(z >> 1) ^ -(int)(z & 1);
     }
+    else { m_err = "packed owner code reserved"; return false; }
 
-    // -------------------------
-    // v2+ chunked format
-    // -------------------------
-    if (ver >= kChunkedVersion) {
-        unsigned int chunkCount = 0;
-        if (!ReadU32(bytes, i, chunkCount) || chunkCount > 64) {
-            result.error = "v2: bad chunkCount";
-            return result;
-        }
+    out = IdOwner{ m_id, owner };
+    ++m_read;
+    return true;
+}
 
-        bool foundOwnr = false;
-        for (unsigned int c = 0; c < chunkCount; ++c) {
-            unsigned int tag = 0, len = 0;
-            if (!ReadU32(bytes, i, tag) || !ReadU32(bytes, i, len)) {
-                result.error = "v2: corrupt chunk header";
-                return result;
-            }
-            if (i + len > bytes.size()) {
-                result.error = "v2: chunk len out of range";
-                return result;
-            }
-
-            if (tag == kTag_OWNR) {
-                size_t pi = i;
-                if (!ParseOwnrPayload(bytes, pi, result.entries, result.error)) {
-                    return result;
-                }
-                foundOwnr = true;
-            }
-            // Unknown chunks are skipped for forward compatibility
-            i += len;
-        }
+// ------------------------------------------------------------
+// Ownership selection
+// ------------------------------------------------------------
+static bool ReadPacked(PackedCursor& cursor, std::vector<IdOwner>& out, std::string& outErr) {
+    out.reserve(cursor.Count());
+    IdOwner e;
+    while (cursor.Next(e)) out.push_back(e);
+    if (cursor.Failed()) {
+        outErr = cursor.Error();
+        out.clear();
+        return false;
+    }
+    return true;
+}
 
-        if (!foundOwnr) {
-            result.error = "v2: missing OWNR chunk";
-            return result;
-        }
-        result.ok = true;
-        return result;
+bool ReadOwnership(const Reader& reader, unsigned long long currentDefaultsHash,
+    std::vector<IdOwner>& out, OwnershipSource& outSource, std::string& outErr)
+{
+    out.clear();
+
+    PackedCursor packed;
+    unsigned long long defaultsHash = 0;
+    std::string deltaErr;
+    const bool hasDelta = reader.Delta(defaultsHash, packed, deltaErr);
+    const bool hasOwn3 = reader.FindChunk(kTagOwn3) != nullptr;
+    const bool hasOwnr = reader.FindChunk(kTagOwnr) != nullptr;
+
+    if (hasDelta && (defaultsHash == currentDefaultsHash || (!hasOwn3 && !hasOwnr))) {
+        outSource = defaultsHash == currentDefaultsHash ? OwnershipSource::Delta : OwnershipSource::DeltaById;
+        return ReadPacked(packed, out, outErr);
     }
 
-    result.error = "unknown version";
-    return result;
+    outSource = OwnershipSource::Snapshot;
+    if (hasOwn3) {
+        return reader.PackedOwnership(packed, outErr) && ReadPacked(packed, out, outErr);
+    }
+
+    OwnershipCursor cursor;
+    if (!reader.Ownership(cursor, outErr)) return false;
+    out.reserve(cursor.Count());
+
+    std::string_view id;
+    int owner = 0;
+    while (cursor.Next(id, owner)) {
+        // Ids that can't exist in territories.txt anymore are dropped.
+        IdOwner e;
+        if (!ParseTerritoryId(id.data(), id.size(), e.id)) continue;
+        e.ownerGang = owner;
+        out.push_back(e);
+    }
+    if (cursor.Failed()) {
+        outErr = cursor.Error();
+        out.clear();
+        return false;
+    }
+    return true;
 }
 
 } // namespace SidecarFormat
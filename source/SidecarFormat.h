@@ -1,28 +1,231 @@
 #pragma once
-#include <vector>
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <vector>
 
 // Pure binary serialization for the GTW1 territory sidecar format.
 // No game engine dependencies — safe to include in unit test projects.
+//
+// v1 (legacy):  [u32 magic 'GTW1'][u32 ver=1][u32 count] then repeated:
+//                 [u16 idLen][idBytes][u32 ownerGang]
+// v2+ (chunked): [u32 magic 'GTW1'][u32 ver>=2][u32 chunkCount] then repeated:
+//                 [u32 tag][u32 payloadLen][payloadBytes...]
+//   'OWNR' - ownership, same layout as the v1 body: [u32 count][entries...]
+//   'OWN3' - ownership as a packed list (below); numeric ids only.
+//   'ODLT' - ownership as deltas from territories.txt defaults:
+//            [u64 defaultsHash][packed list]
+//            Exact only against the defaults that hash to defaultsHash. When
+//            they changed, a reader uses the full snapshot (OWN3 or OWNR),
+//            which every checkpoint writes next to ODLT. A file without one
+//            gets the deltas applied by id over the new defaults.
+//   'ACTL' - [u32 act]
+//   'CSUM' - [u32 crc32c] of every byte before this chunk's header, file
+//            header included. Always the last chunk.
+// Unknown chunks are skipped. v3 and v4 are laid out exactly like v2; v3
+// says the packed chunks may be present, v4 that the file ends in CSUM,
+// so a v4 file without a matching one (bit rot, truncation) is rejected.
+//
+// Packed list: [varint count][varint idBytes]
+//              [varint idDelta] * count    ids ascending, first delta from 0
+//              [owner nibble] * count      low nibble first, padded to a byte
+//              [zigzag varint owner] * n   one per escaped nibble, in order
+//   Varints are LEB128; idBytes is the size of the id deltas, so the nibbles
+//   can be found without decoding them. Owner nibbles: 0 neutral, 1 cleared,
+//   2..10 the gang ped types 7..15, 15 escape. A stock entry costs ~1.5
+//   bytes against OWNR's 10.
 
 namespace SidecarFormat {
 
+constexpr unsigned int kMagic          = 0x31575447; // 'GTW1' little-endian
+constexpr unsigned int kLegacyVersion  = 1;
+constexpr unsigned int kChunkedVersion = 2;
+constexpr unsigned int kPackedVersion  = 3;
+constexpr unsigned int kChecksumVersion = 4;         // what we write
+constexpr unsigned int kTagOwnr        = 0x524E574F; // 'OWNR' little-endian
+constexpr unsigned int kTagOwn3        = 0x334E574F; // 'OWN3' little-endian
+constexpr unsigned int kTagOdlt        = 0x544C444F; // 'ODLT' little-endian
+constexpr unsigned int kTagActl        = 0x4C544341; // 'ACTL' little-endian
+constexpr unsigned int kTagCsum        = 0x4D555343; // 'CSUM' little-endian
+
+constexpr int          kMaxChunks  = 64;
+constexpr unsigned int kMaxEntries = 4096; // OWNR only; a packed list is bounded by its payload
+
 struct Entry {
     std::string id;
     int ownerGang = -1;
 };
 
+// Numeric id + owner, as ownership entries are applied.
+struct IdOwner {
+    unsigned int id;
+    int ownerGang;
+};
+
 struct ParseResult {
     bool ok = false;
     std::string error;
     std::vector<Entry> entries;
 };
 
-// Build a v2 chunked GTW1 binary blob from ownership entries.
+// Build a chunked GTW1 binary blob with an OWNR chunk.
 std::vector<unsigned char> Serialize(const std::vector<Entry>& entries);
 
-// Parse a GTW1 binary blob. Accepts v1 legacy and v2+ chunked formats.
-// Returns ok=false with a descriptive error on any failure.
+// Key for ODLT: folds one territory's id and default owner into h. Start
+// from 0 and add every territory; the order does not matter, so reordered
+// territories.txt lines keep old deltas valid. Geometry is left out —
+// a delta only depends on which ids exist and what they default to.
+unsigned long long DefaultsHashAdd(unsigned long long h, unsigned int id, int defaultOwnerGang);
+
+// Builds a chunked blob chunk by chunk.
+class Writer {
+public:
+    Writer() { Clear(); }
+    void Clear(); // back to an empty header
+
+    void AddOwnership(const std::vector<Entry>& entries);
+    // Ids are written as decimal strings so older builds can read them.
+    void AddOwnership(const IdOwner* entries, size_t count);
+    // OWN3. Entries may come in any order; they are stored sorted by id.
+    void AddOwnershipPacked(const IdOwner* entries, size_t count);
+    void AddOwnershipDelta(unsigned long long defaultsHash, const IdOwner* entries, size_t count);
+    void AddAct(unsigned int act);
+    // Appends CSUM over everything so far and marks the file v4. Call last.
+    void AddChecksum();
+
+    const std::vector<unsigned char>& Bytes() const { return m_out; }
+
+private:
+    std::vector<unsigned char> m_out;
+    size_t m_chunkAt = 0; // current chunk's header offset
+
+    void BeginChunk(unsigned int tag);
+    void EndChunk();
+    void PushPacked(const IdOwner* entries, size_t count);
+};
+
+// Parse a GTW1 binary blob. Accepts v1 legacy and v2+ chunked formats,
+// taking OWNR and falling back to OWN3 (ids come back as decimal strings).
+// Fails when Reader::Verify does.
+// Returns ok=false with a descriptive error on any failure. Copies every
+// id; Reader is the allocation-free way in.
 ParseResult Deserialize(const std::vector<unsigned char>& bytes);
+ParseResult Deserialize(const unsigned char* data, size_t size);
+
+// Walks the ownership entries of a payload in place. Ids are views into the
+// blob the Reader was opened on.
+class OwnershipCursor {
+public:
+    unsigned int Count() const { return m_count; }
+
+    // False at the end, or on a malformed entry (then Failed() is true).
+    bool Next(std::string_view& outId, int& outOwner);
+
+    bool Failed() const { return m_err != nullptr; }
+    const char* Error() const { return m_err ? m_err : ""; }
+
+private:
+    friend class Reader;
+    const unsigned char* m_p = nullptr;
+    const unsigned char* m_end = nullptr;
+    unsigned int m_count = 0;
+    unsigned int m_read = 0;
+    const char* m_err = nullptr;
+};
+
+// Walks a packed list (OWN3, or ODLT after its hash) in place, in id order.
+class PackedCursor {
+public:
+    unsigned int Count() const { return m_count; }
+
+    // False at the end, or on a malformed entry (then Failed() is true).
+    bool Next(IdOwner& out);
+
+    bool Failed() const { return m_err != nullptr; }
+    const char* Error() const { return m_err ? m_err : ""; }
+
+private:
+    friend class Reader;
+    const unsigned char* m_ids = nullptr;
+    const unsigned char* m_idsEnd = nullptr;
+    const unsigned char* m_owners = nullptr;
+    const unsigned char* m_escapes = nullptr;
+    const unsigned char* m_end = nullptr;
+    unsigned int m_count = 0;
+    unsigned int m_read = 0;
+    unsigned int m_id = 0;
+    const char* m_err = nullptr;
+};
+
+// Zero-copy reader. Open() checks the header and lists every chunk in one
+// pass without looking inside them; payloads are decoded only when asked
+// for. The bytes must outlive the reader and its cursors.
+class Reader {
+public:
+    struct Chunk {
+        unsigned int tag;
+        unsigned int offset; // payload start, from the beginning of the blob
+        unsigned int size;
+    };
+
+    // False on a bad magic/version/chunk count. A chunk header that is
+    // corrupt or runs past the end stops the directory there instead:
+    // Open() still succeeds with the chunks before it, Complete() is false.
+    bool Open(const unsigned char* data, size_t size, std::string& outErr);
+
+    unsigned int Version() const { return m_version; }
+    bool IsLegacy() const { return m_version == kLegacyVersion; }
+    bool Complete() const { return m_dirError == nullptr; }
+    const char* DirectoryError() const { return m_dirError ? m_dirError : ""; }
+
+    // A v1 file lists its body as a single OWNR chunk.
+    int ChunkCount() const { return m_chunkCount; }
+    const Chunk& ChunkAt(int i) const { return m_chunks[i]; }
+    const Chunk* FindChunk(unsigned int tag) const; // first with this tag
+    const unsigned char* Payload(const Chunk& c) const { return m_data + c.offset; }
+
+    // OWNR entries. False (with outErr) if the chunk is missing or its
+    // count does not fit; entry-level damage surfaces through the cursor.
+    bool Ownership(OwnershipCursor& out, std::string& outErr) const;
+
+    // OWN3 entries. False (with outErr) if the chunk is missing or its
+    // header does not fit the payload.
+    bool PackedOwnership(PackedCursor& out, std::string& outErr) const;
+
+    // ODLT, same rules as PackedOwnership.
+    bool Delta(unsigned long long& outDefaultsHash, PackedCursor& out, std::string& outErr) const;
+
+    // ACTL value. False if the chunk is missing or not 4 bytes.
+    bool Act(unsigned int& outAct) const;
+
+    // False (with outErr) if CSUM does not match, is not the last chunk, or
+    // a v4+ file has none or a damaged directory. Files older than v4 have
+    // nothing to check and pass.
+    bool Verify(std::string& outErr) const;
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+    unsigned int m_version = 0;
+    int m_chunkCount = 0;
+    Chunk m_chunks[kMaxChunks];
+    const char* m_dirError = nullptr;
+
+    static bool OpenPacked(const unsigned char* p, size_t size, PackedCursor& out, const char*& outErr);
+};
+
+// Which chunk ReadOwnership took its entries from.
+enum class OwnershipSource {
+    Delta,     // ODLT, taken against the current defaults
+    Snapshot,  // OWN3 or OWNR: the defaults changed, or there is no ODLT
+    DeltaById, // ODLT against other defaults, with no snapshot to fall back on
+};
+
+// The ownership a load applies over today's territories.txt defaults,
+// which hash (DefaultsHashAdd over every territory) to currentDefaultsHash.
+// OWNR ids that are not numeric are dropped. False (with outErr) when no
+// ownership chunk is usable or the chosen one is damaged.
+bool ReadOwnership(const Reader& reader, unsigned long long currentDefaultsHash,
+    std::vector<IdOwner>& out, OwnershipSource& outSource, std::string& outErr);
 
 } // namespace SidecarFormat
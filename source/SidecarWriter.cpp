@@ -0,0 +1,256 @@
+#include "SidecarWriter.h"
+#include "Crc32c.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <direct.h>   // _mkdir
+#else
+#include <sys/stat.h> // mkdir
+#endif
+
+// ------------------------------------------------------------
+// Stdio file operations
+// ------------------------------------------------------------
+static bool StdioMakeDir(const char* path, void*) {
+#ifdef _WIN32
+    return _mkdir(path) == 0;
+#else
+    return mkdir(path, 0755) == 0;
+#endif
+}
+
+static bool StdioWriteFile(const char* path, const unsigned char* data, size_t size, void*) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    const size_t wr = std::fwrite(data, 1, size, f);
+    const bool closed = std::fclose(f) == 0;
+    return wr == size && closed;
+}
+
+static bool StdioReadFile(const char* path, std::vector<unsigned char>& out, void*) {
+    out.clear();
+    FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    unsigned char buf[4096];
+    size_t rd;
+    while ((rd = std::fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + rd);
+    const bool ok = !std::ferror(f);
+    std::fclose(f);
+    return ok;
+}
+
+static bool StdioAppendFile(const char* path, const unsigned char* data, size_t size, void*) {
+    FILE* f = std::fopen(path, "r+b"); // never creates: a journal needs its header
+    if (!f) return false;
+    const bool at = std::fseek(f, 0, SEEK_END) == 0;
+    const size_t wr = at ? std::fwrite(data, 1, size, f) : 0;
+    const bool closed = std::fclose(f) == 0;
+    return at && wr == size && closed;
+}
+
+static bool StdioRemove(const char* path, void*) {
+    return std::remove(path) == 0;
+}
+
+static bool StdioRename(const char* from, const char* to, void*) {
+    return std::rename(from, to) == 0;
+}
+
+SidecarWriter::FileOps SidecarWriter::Stdio() {
+    FileOps ops;
+    ops.makeDir = StdioMakeDir;
+    ops.writeFile = StdioWriteFile;
+    ops.readFile = StdioReadFile;
+    ops.appendFile = StdioAppendFile;
+    ops.remove = StdioRemove;
+    ops.rename = StdioRename;
+    return ops;
+}
+
+// ------------------------------------------------------------
+// Writing
+// ------------------------------------------------------------
+bool SidecarWriter::Write(const Job& job, const FileOps& ops, Result& out) {
+    if (!job.checkpoint) return AppendJournal(job, ops, out);
+
+    out = Result();
+    out.slot = job.slot;
+    out.entries = (int)job.deltas.size();
+
+    SidecarFormat::Writer w;
+    w.AddOwnershipPacked(job.owners.data(), job.owners.size());
+    w.AddOwnershipDelta(job.defaultsHash, job.deltas.data(), job.deltas.size());
+    w.AddAct(job.act);
+    w.AddChecksum();
+    const std::vector<unsigned char>& bytes = w.Bytes();
+    out.bytes = (int)bytes.size();
+
+    if (ops.makeDir && !job.dir.empty()) ops.makeDir(job.dir.c_str(), ops.user); // usually exists
+
+    const std::string tmp = job.path + ".tmp";
+    if (!ops.writeFile(tmp.c_str(), bytes.data(), bytes.size(), ops.user)) {
+        out.error = "failed write tmp";
+        ops.remove(tmp.c_str(), ops.user);
+        return false;
+    }
+
+    // What landed on disk must pass the same check a load will run.
+    std::vector<unsigned char> back;
+    SidecarFormat::Reader reader;
+    std::string err;
+    if (!ops.readFile(tmp.c_str(), back, ops.user) || !reader.Open(back.data(), back.size(), err)
+        || !reader.Verify(err))
+    {
+        out.error = "tmp failed verification";
+        ops.remove(tmp.c_str(), ops.user);
+        return false;
+    }
+
+    // rename() does not replace an existing file on Windows.
+    ops.remove(job.path.c_str(), ops.user);
+    if (!ops.rename(tmp.c_str(), job.path.c_str(), ops.user)) {
+        out.error = "rename tmp->final failed";
+        ops.remove(tmp.c_str(), ops.user);
+        return false;
+    }
+
+    if (!job.journalPath.empty() && !WriteJournal(job, Crc32c::Compute(bytes.data(), bytes.size()), ops, out)) {
+        return false;
+    }
+
+    out.ok = true;
+    return true;
+}
+
+// Replaces the journal with a header tied to the checkpoint just written.
+// Until the rename lands, the old journal's CRC no longer matches, so a
+// crash in between loads the bare checkpoint.
+bool SidecarWriter::WriteJournal(const Job& job, unsigned int checkpointCrc, const FileOps& ops, Result& out) {
+    std::vector<unsigned char> bytes;
+    bytes.reserve(OwnershipJournal::kHeaderSize + job.journal.size() * OwnershipJournal::kRecordSize);
+    OwnershipJournal::AppendHeader(bytes, checkpointCrc);
+    for (const OwnershipJournal::Record& r : job.journal) OwnershipJournal::AppendRecord(bytes, r);
+
+    const std::string tmp = job.journalPath + ".tmp";
+    const bool written = ops.writeFile(tmp.c_str(), bytes.data(), bytes.size(), ops.user);
+    if (written) ops.remove(job.journalPath.c_str(), ops.user);
+    if (!written || !ops.rename(tmp.c_str(), job.journalPath.c_str(), ops.user)) {
+        out.error = "failed journal reset";
+        ops.remove(tmp.c_str(), ops.user);
+        return false;
+    }
+    out.bytes += (int)bytes.size();
+    return true;
+}
+
+bool SidecarWriter::AppendJournal(const Job& job, const FileOps& ops, Result& out) {
+    out = Result();
+    out.slot = job.slot;
+    out.checkpoint = false;
+    out.entries = (int)job.journal.size();
+    if (job.journal.empty()) {
+        out.ok = true;
+        return true;
+    }
+
+    std::vector<unsigned char> bytes;
+    bytes.reserve(job.journal.size() * OwnershipJournal::kRecordSize);
+    for (const OwnershipJournal::Record& r : job.journal) OwnershipJournal::AppendRecord(bytes, r);
+    out.bytes = (int)bytes.size();
+
+    if (job.journalPath.empty() || !ops.appendFile
+        || !ops.appendFile(job.journalPath.c_str(), bytes.data(), bytes.size(), ops.user))
+    {
+        out.error = "failed journal append";
+        return false;
+    }
+    out.ok = true;
+    return true;
+}
+
+// ------------------------------------------------------------
+// Queue
+// ------------------------------------------------------------
+void SidecarWriter::Submit(Job job) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    bool merged = false;
+    for (Job& pending : m_jobs) {
+        if (pending.path != job.path) continue;
+        if (job.checkpoint) {
+            pending = std::move(job); // the snapshot covers everything queued
+        }
+        else {
+            pending.journal.insert(pending.journal.end(), job.journal.begin(), job.journal.end());
+        }
+        merged = true;
+        break;
+    }
+    if (!merged) m_jobs.push_back(std::move(job));
+
+    if (!m_thread.joinable()) {
+        m_stopping = false;
+        m_thread = std::thread(&SidecarWriter::Run, this);
+    }
+    m_wake.notify_one();
+}
+
+bool SidecarWriter::Poll(Result& out) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_results.empty()) return false;
+    out = m_results.front();
+    m_results.pop_front();
+    return true;
+}
+
+void SidecarWriter::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_jobs.empty() && !m_inFlight; });
+}
+
+void SidecarWriter::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_thread.joinable()) return;
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void SidecarWriter::Run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+        if (m_jobs.empty()) return; // stopping, and the queue is drained
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_inFlight = true;
+        lock.unlock();
+
+        // Appending after a failed write would land on a journal that no
+        // longer matches memory; only a checkpoint resyncs it.
+        Result r;
+        auto stale = std::find(m_outOfSync.begin(), m_outOfSync.end(), job.journalPath);
+        if (!job.checkpoint && stale != m_outOfSync.end()) {
+            r.slot = job.slot;
+            r.checkpoint = false;
+            r.entries = (int)job.journal.size();
+            r.error = "journal out of sync, waiting for a checkpoint";
+        }
+        else if (Write(job, m_ops, r)) {
+            if (job.checkpoint && stale != m_outOfSync.end()) m_outOfSync.erase(stale);
+        }
+        else if (!job.journalPath.empty() && stale == m_outOfSync.end()) {
+            m_outOfSync.push_back(job.journalPath);
+        }
+
+        lock.lock();
+        m_results.push_back(r);
+        m_inFlight = false;
+        m_idle.notify_all();
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "SidecarFormat.h"
+#include "OwnershipJournal.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Background writer for the territory sidecar.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// The game thread only copies the ownership (deltas and every owner) and
+// the act into a Job and hands it over. One worker thread serializes it,
+// writes <path>.tmp, reads it back to check its CSUM and renames it over
+// <path>. Outcomes come back through Poll(), which
+// TerritoryPersistence::Process() drains every frame; the worker never
+// logs or touches game state.
+//
+// With a journalPath, a checkpoint job then starts a fresh OwnershipJournal
+// tied to the new file, and an append job (checkpoint = false) only adds
+// its records to that journal. Once any write for a journal fails, appends
+// to it are refused until the next checkpoint succeeds.
+//
+// Pending jobs for the same path coalesce: a checkpoint replaces whatever
+// is queued, an append adds its records to the queued job. A job already
+// being written is left to finish.
+
+class SidecarWriter {
+public:
+    // The file operations the worker uses. Each returns false on failure.
+    // Stdio() works on Windows and Linux; tests substitute fakes.
+    struct FileOps {
+        void* user = nullptr;
+        bool (*makeDir)(const char* path, void* user) = nullptr; // optional, best effort
+        bool (*writeFile)(const char* path, const unsigned char* data, size_t size, void* user) = nullptr;
+        bool (*readFile)(const char* path, std::vector<unsigned char>& out, void* user) = nullptr;
+        // Appends to an existing file; false if it does not exist.
+        bool (*appendFile)(const char* path, const unsigned char* data, size_t size, void* user) = nullptr;
+        bool (*remove)(const char* path, void* user) = nullptr;
+        bool (*rename)(const char* from, const char* to, void* user) = nullptr;
+    };
+    static FileOps Stdio();
+
+    struct Job {
+        int slot = 0;
+        std::string dir;  // created first if set
+        std::string path; // final file
+        unsigned long long defaultsHash = 0;
+        unsigned int act = 0;
+        std::vector<SidecarFormat::IdOwner> deltas;
+        std::vector<SidecarFormat::IdOwner> owners; // every territory, written as OWN3
+
+        bool checkpoint = true;  // false: only append to the journal
+        std::string journalPath; // empty: no journal
+        std::vector<OwnershipJournal::Record> journal; // after the snapshot
+    };
+
+    struct Result {
+        int slot = 0;
+        bool ok = false;
+        bool checkpoint = true;
+        int entries = 0; // deltas for a checkpoint, records for an append
+        int bytes = 0;
+        const char* error = ""; // static string, empty when ok
+    };
+
+    explicit SidecarWriter(const FileOps& ops = Stdio()) : m_ops(ops) {}
+    ~SidecarWriter() { Stop(); }
+
+    SidecarWriter(const SidecarWriter&) = delete;
+    SidecarWriter& operator=(const SidecarWriter&) = delete;
+
+    // Queues a snapshot; starts the worker on first use.
+    void Submit(Job job);
+
+    // Non-blocking; false when no write has finished since the last call.
+    bool Poll(Result& out);
+
+    // Blocks until nothing is queued or being written. For a load that
+    // must see the slot's latest save.
+    void WaitIdle();
+
+    // Writes everything still queued, then joins the worker. Submit()
+    // starts a new one.
+    void Stop();
+
+    // The work itself, run on the caller's thread.
+    static bool Write(const Job& job, const FileOps& ops, Result& out);
+
+private:
+    FileOps m_ops;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake; // jobs queued or stopping
+    std::condition_variable m_idle; // a job finished
+    std::deque<Job> m_jobs;
+    std::deque<Result> m_results;
+    bool m_inFlight = false;
+    bool m_stopping = false;
+    std::thread m_thread;
+    std::vector<std::string> m_outOfSync; // journals awaiting a checkpoint; worker only
+
+    void Run();
+
+    static bool WriteJournal(const Job& job, unsigned int checkpointCrc, const FileOps& ops, Result& out);
+    static bool AppendJournal(const Job& job, const FileOps& ops, Result& out);
+};
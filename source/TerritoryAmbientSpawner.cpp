@@ -57,9 +57,35 @@ static unsigned int s_noSpawnBackoffMs = 1800; // if we decide not to spawn, wai
 static unsigned int s_nextGlobalActionMs = 0;
 static unsigned int s_nextTickMs = 0;
 
-// We track per-territory cooldown by current territory vector index.
-// (Territory list is stable-ish; if it changes, we resize.)
-static std::vector<unsigned int> s_nextTerritoryActionMs;
+// Per-territory cooldown, indexed by handle slot. The generation is kept so a
+// slot reused by a different territory after a reload/edit starts fresh,
+// while territories that survive a reload keep their cooldown.
+struct TerritoryCooldown {
+    unsigned int generation;
+    unsigned int nextActionMs;
+};
+static std::vector<TerritoryCooldown> s_territoryCooldowns;
+
+static int s_playerEventsSub = 0;
+static int s_changesSub = 0;
+
+// Entering a territory (or its turf changing hands) is when the density
+// check matters most; skip the rest of the 250ms poll interval.
+static void OnPlayerTerritoryEvent(const PlayerContextTracker::Event& /*e*/, void* /*user*/) {
+    s_nextTickMs = 0;
+}
+
+// A territory that changed hands owes nothing to the old owner's cooldown or
+// backoff; the new gang may seed it on the next poll.
+static void OnTerritoryChanged(const TerritoryChangeLog::Event& e, void* /*user*/) {
+    if (!e.handle.IsValid()) {
+        for (TerritoryCooldown& cd : s_territoryCooldowns) cd.nextActionMs = 0;
+        return;
+    }
+    if ((size_t)e.handle.slot >= s_territoryCooldowns.size()) return;
+    TerritoryCooldown& cd = s_territoryCooldowns[e.handle.slot];
+    if (cd.generation == e.handle.generation) cd.nextActionMs = 0;
+}
 
 static inline float Dist2(const CVector& a, const CVector& b) {
     const float dx = a.x - b.x;
@@ -108,6 +134,7 @@ static bool ClampIntoTerritory(const Territory* t, float& x, float& y) {
     if (!t) return false;
     x = std::max(t->minX, std::min(x, t->maxX));
     y = std::max(t->minY, std::min(y, t->maxY));
+    t->poly.PullInside(x, y);
     return true;
 }
 
@@ -163,7 +190,14 @@ void TerritoryAmbientSpawner::Init() {
     s_enabled = true;
     s_nextGlobalActionMs = 0;
     s_nextTickMs = 0;
-    s_nextTerritoryActionMs.clear();
+    s_territoryCooldowns.clear();
+    if (!s_playerEventsSub) {
+        s_playerEventsSub = TerritorySystem::SubscribePlayerEvents(
+            PlayerContextTracker::kEnter | PlayerContextTracker::kOwnerChanged, OnPlayerTerritoryEvent);
+    }
+    if (!s_changesSub) {
+        s_changesSub = TerritorySystem::SubscribeChanges(TerritoryChangeLog::kOwner, OnTerritoryChanged);
+    }
 
     auto& ini = IniConfig::Instance();
     ini.Load("III.GangTerritoryWars.ini");
@@ -180,7 +214,11 @@ void TerritoryAmbientSpawner::Init() {
 }
 
 void TerritoryAmbientSpawner::Shutdown() {
-    s_nextTerritoryActionMs.clear();
+    s_territoryCooldowns.clear();
+    TerritorySystem::UnsubscribePlayerEvents(s_playerEventsSub);
+    s_playerEventsSub = 0;
+    TerritorySystem::UnsubscribeChanges(s_changesSub);
+    s_changesSub = 0;
     DebugLog::Write("TerritoryAmbientSpawner shutdown");
 }
 
@@ -199,16 +237,16 @@ void TerritoryAmbientSpawner::Update() {
 
     if (!TerritorySystem::HasRealTerritories()) return;
 
-    CPlayerPed* player = CWorld::Players[0].m_pPed;
-    if (!player) return;
+    const PlayerContext& ctx = TerritorySystem::GetPlayerContext();
 
     // Don't seed ambient peds while player is driving — gang members appear on foot
-    if (player->m_bInVehicle) return;
+    if (!ctx.OnFoot()) return;
 
-    const CVector playerPos = player->GetPosition();
+    const CVector playerPos = ctx.pos;
 
     // Only seed when player is inside a territory
-    const Territory* t = TerritorySystem::GetTerritoryAtPoint(playerPos);
+    const TerritoryHandle h = ctx.territory;
+    const Territory* t = TerritorySystem::Resolve(h);
     if (!t) return;
 
     const int ownerGang = t->ownerGang;
@@ -216,36 +254,36 @@ void TerritoryAmbientSpawner::Update() {
     // always inhabit their turf. OWNER_NEUTRAL (-1) and OWNER_CLEARED (-2) return false.
     if (!IsOwnerGangValid(ownerGang)) return;
 
-    // Sync cooldown array to territories size
-    const auto& terrs = TerritorySystem::GetTerritories();
-    if (s_nextTerritoryActionMs.size() != terrs.size()) {
-        s_nextTerritoryActionMs.assign(terrs.size(), 0);
+    // Grow cooldown array to the handle slot range
+    const size_t slotCount = (size_t)TerritorySystem::GetHandleSlotCount();
+    if (s_territoryCooldowns.size() < slotCount) {
+        s_territoryCooldowns.resize(slotCount, TerritoryCooldown{ 0u, 0u });
     }
 
-    // Find territory index (small N; fine)
-    int terrIndex = -1;
-    for (int i = 0; i < (int)terrs.size(); ++i) {
-        if (&terrs[i] == t) { terrIndex = i; break; }
+    TerritoryCooldown& cd = s_territoryCooldowns[h.slot];
+    if (cd.generation != h.generation) {
+        cd.generation = h.generation;
+        cd.nextActionMs = 0;
     }
-    if (terrIndex < 0) return;
+    unsigned int& nextTerritoryActionMs = cd.nextActionMs;
 
     // Rate limits
     if (now < s_nextGlobalActionMs) return;
-    if (now < s_nextTerritoryActionMs[terrIndex]) return;
+    if (now < nextTerritoryActionMs) return;
 
     // Density check
     const int nearby = CountNearbyOwnerGangPeds(playerPos, s_checkRadius, ownerGang);
 
     if (nearby >= s_hardCapGangPeds) {
         s_nextGlobalActionMs = now + s_noSpawnBackoffMs;
-        s_nextTerritoryActionMs[terrIndex] = now + s_noSpawnBackoffMs;
+        nextTerritoryActionMs = now + s_noSpawnBackoffMs;
         return;
     }
 
     if (nearby >= s_targetGangPeds) {
         // We’re “good enough”
         s_nextGlobalActionMs = now + s_noSpawnBackoffMs;
-        s_nextTerritoryActionMs[terrIndex] = now + s_noSpawnBackoffMs;
+        nextTerritoryActionMs = now + s_noSpawnBackoffMs;
         return;
     }
 
@@ -254,21 +292,21 @@ void TerritoryAmbientSpawner::Update() {
     const int modelId = GangManager::GetRandomModelId(ownerType);
     if (modelId < 0) {
         s_nextGlobalActionMs = now + s_noSpawnBackoffMs;
-        s_nextTerritoryActionMs[terrIndex] = now + s_noSpawnBackoffMs;
+        nextTerritoryActionMs = now + s_noSpawnBackoffMs;
         return;
     }
 
     if (!EnsureModelLoaded(modelId)) {
         // Don’t block the frame; just try next time
         s_nextGlobalActionMs = now + 600;
-        s_nextTerritoryActionMs[terrIndex] = now + 600;
+        nextTerritoryActionMs = now + 600;
         return;
     }
 
     CVector spawnPos;
     if (!FindSpawnPos(t, playerPos, spawnPos)) {
         s_nextGlobalActionMs = now + 600;
-        s_nextTerritoryActionMs[terrIndex] = now + 600;
+        nextTerritoryActionMs = now + 600;
         return;
     }
 
@@ -288,10 +326,10 @@ void TerritoryAmbientSpawner::Update() {
 
         // Advance cooldowns
         s_nextGlobalActionMs = now + s_globalCooldownMs;
-        s_nextTerritoryActionMs[terrIndex] = now + s_perTerritoryCooldownMs;
+        nextTerritoryActionMs = now + s_perTerritoryCooldownMs;
     } else {
         // If spawn failed, back off slightly
         s_nextGlobalActionMs = now + 700;
-        s_nextTerritoryActionMs[terrIndex] = now + 700;
+        nextTerritoryActionMs = now + 700;
     }
 }
@@ -0,0 +1,138 @@
+#include "TerritoryBounds.h"
+#include "TerritorySystem.h"
+
+#include <cstdlib>
+#include <limits>
+
+#if GTW_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+// Index of the lowest set bit of a 4-bit movemask (0 is never looked up).
+static const signed char kLowestBit4[16] = { -1, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+
+static float* AllocAligned16(size_t count) {
+#if GTW_HAS_SSE2
+    return (float*)_mm_malloc(count * sizeof(float), 16);
+#else
+    return (float*)std::malloc(count * sizeof(float));
+#endif
+}
+
+static void FreeAligned16(float* p) {
+    if (!p) return;
+#if GTW_HAS_SSE2
+    _mm_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+TerritoryBounds::~TerritoryBounds() {
+    FreeAligned16(m_block);
+}
+
+void TerritoryBounds::Clear() {
+    m_count = 0;
+    m_padded = 0;
+}
+
+void TerritoryBounds::Reserve(int padded) {
+    if (padded <= m_capacity) return;
+
+    FreeAligned16(m_block);
+    m_block = AllocAligned16((size_t)padded * 4);
+    m_capacity = padded;
+
+    // Sub-arrays are strided by capacity, which is a multiple of 4, so each
+    // one stays 16-byte aligned.
+    m_minX = m_block;
+    m_minY = m_block + padded;
+    m_maxX = m_block + padded * 2;
+    m_maxY = m_block + padded * 3;
+}
+
+void TerritoryBounds::Assign(const std::vector<Territory>& territories) {
+    m_count = (int)territories.size();
+    m_padded = (m_count + 3) & ~3;
+    if (m_padded == 0) return;
+
+    Reserve(m_padded);
+
+    for (int i = 0; i < m_count; ++i) {
+        const Territory& t = territories[i];
+        m_minX[i] = t.minX;
+        m_minY[i] = t.minY;
+        m_maxX[i] = t.maxX;
+        m_maxY[i] = t.maxY;
+    }
+
+    // Inverted infinite rects: x >= +inf && x <= -inf is false for every x.
+    const float inf = std::numeric_limits<float>::infinity();
+    for (int i = m_count; i < m_padded; ++i) {
+        m_minX[i] = inf;
+        m_minY[i] = inf;
+        m_maxX[i] = -inf;
+        m_maxY[i] = -inf;
+    }
+}
+
+void TerritoryBounds::Set(int index, const Territory& t) {
+    if (index < 0 || index >= m_count) return;
+    m_minX[index] = t.minX;
+    m_minY[index] = t.minY;
+    m_maxX[index] = t.maxX;
+    m_maxY[index] = t.maxY;
+}
+
+int TerritoryBounds::ContainsPoint4Scalar(float x, float y, int base) const {
+    int mask = 0;
+    for (int k = 0; k < 4; ++k) {
+        const int i = base + k;
+        if (x >= m_minX[i] && x <= m_maxX[i] && y >= m_minY[i] && y <= m_maxY[i]) mask |= (1 << k);
+    }
+    return mask;
+}
+
+int TerritoryBounds::ContainsPoint4(float x, float y, int base) const {
+#if GTW_HAS_SSE2
+    const __m128 px = _mm_set1_ps(x);
+    const __m128 py = _mm_set1_ps(y);
+    __m128 m = _mm_and_ps(_mm_cmpge_ps(px, _mm_load_ps(m_minX + base)),
+                          _mm_cmple_ps(px, _mm_load_ps(m_maxX + base)));
+    m = _mm_and_ps(m, _mm_cmpge_ps(py, _mm_load_ps(m_minY + base)));
+    m = _mm_and_ps(m, _mm_cmple_ps(py, _mm_load_ps(m_maxY + base)));
+    return _mm_movemask_ps(m);
+#else
+    return ContainsPoint4Scalar(x, y, base);
+#endif
+}
+
+int TerritoryBounds::FindFirstContainingScalar(float x, float y, int from) const {
+    for (int i = (from > 0 ? from : 0); i < m_count; ++i) {
+        if (x >= m_minX[i] && x <= m_maxX[i] && y >= m_minY[i] && y <= m_maxY[i]) return i;
+    }
+    return -1;
+}
+
+int TerritoryBounds::FindFirstContaining(float x, float y, int from) const {
+#if GTW_HAS_SSE2
+    if (from < 0) from = 0;
+    const __m128 px = _mm_set1_ps(x);
+    const __m128 py = _mm_set1_ps(y);
+    // The first block may start mid-way; lanes below from are masked off.
+    int skip = (15 << (from & 3)) & 15;
+    for (int base = from & ~3; base < m_padded; base += 4) {
+        __m128 m = _mm_and_ps(_mm_cmpge_ps(px, _mm_load_ps(m_minX + base)),
+                              _mm_cmple_ps(px, _mm_load_ps(m_maxX + base)));
+        m = _mm_and_ps(m, _mm_cmpge_ps(py, _mm_load_ps(m_minY + base)));
+        m = _mm_and_ps(m, _mm_cmple_ps(py, _mm_load_ps(m_maxY + base)));
+        const int mask = _mm_movemask_ps(m) & skip;
+        if (mask) return base + kLowestBit4[mask];
+        skip = 15;
+    }
+    return -1;
+#else
+    return FindFirstContainingScalar(x, y, from);
+#endif
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+
+// Structure-of-arrays copy of territory bounds with a 4-wide containment kernel.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Territory mixes the four hot floats with an id string and ownership/timer
+// fields, so scanning std::vector<Territory> drags a whole cache line in per
+// rect. This keeps minX/minY/maxX/maxY in four 16-byte aligned arrays, padded
+// to a multiple of 4 with rects that can never contain a point, so the SSE2
+// kernel tests four rects per iteration without a scalar tail.
+//
+// Must be re-assigned whenever the source vector changes (TerritorySystem
+// does this next to the grid rebuild). Containment is edge-inclusive and
+// bit-for-bit identical to Territory::ContainsPoint.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GTW_HAS_SSE2 1
+#else
+#define GTW_HAS_SSE2 0
+#endif
+
+struct Territory;
+
+class TerritoryBounds {
+public:
+    TerritoryBounds() = default;
+    ~TerritoryBounds();
+    TerritoryBounds(const TerritoryBounds&) = delete;
+    TerritoryBounds& operator=(const TerritoryBounds&) = delete;
+
+    void Assign(const std::vector<Territory>& territories);
+    void Clear();
+
+    // Overwrites one rect in place (hot reload of a changed rect).
+    // index must be < Count().
+    void Set(int index, const Territory& t);
+
+    // Bitmask (bit k = rect base+k) of the four rects starting at base that
+    // contain the point. base must be a multiple of 4 and < PaddedCount().
+    int ContainsPoint4(float x, float y, int base) const;
+    int ContainsPoint4Scalar(float x, float y, int base) const;
+
+    // Lowest index >= from whose rect contains the point, or -1 (same result
+    // as a linear box scan). Polygon outlines are not tested here; callers
+    // re-test a hit and continue from hit + 1 if the outline rejects it.
+    int FindFirstContaining(float x, float y, int from = 0) const;
+    int FindFirstContainingScalar(float x, float y, int from = 0) const;
+
+    int Count()       const { return m_count; }
+    int PaddedCount() const { return m_padded; }
+
+    const float* MinX() const { return m_minX; }
+    const float* MinY() const { return m_minY; }
+    const float* MaxX() const { return m_maxX; }
+    const float* MaxY() const { return m_maxY; }
+
+private:
+    int m_count    = 0;
+    int m_padded   = 0;
+    int m_capacity = 0;
+
+    // One aligned allocation split four ways.
+    float* m_block = nullptr;
+    float* m_minX  = nullptr;
+    float* m_minY  = nullptr;
+    float* m_maxX  = nullptr;
+    float* m_maxY  = nullptr;
+
+    void Reserve(int padded);
+};
@@ -0,0 +1,218 @@
+#include "TerritoryCache.h"
+#include "Fnv1a.h"
+#include "TerritoryGrid.h"
+#include "TerritorySystem.h"
+
+#include <cstring>
+
+namespace TerritoryCache {
+
+namespace {
+
+struct Header {
+    unsigned int magic;
+    unsigned int version;
+    unsigned long long sourceHash;
+    unsigned int count;
+    unsigned int padded;
+    unsigned int fileSize;
+    unsigned int numIdOff;
+    unsigned int boundsOff;
+    unsigned int ownerOff;
+    unsigned int defenseOff;
+    unsigned int idOffsetsOff;
+    unsigned int idCharsOff;
+    unsigned int idCharsSize;
+    unsigned int gridOff;
+    unsigned int gridSize;
+    unsigned int polyOffsetsOff;
+    unsigned int polyXYOff;
+    unsigned int polyVertices;
+    unsigned int priorityOff;
+};
+
+void AlignTo16(std::vector<unsigned char>& out) {
+    while (out.size() & 15) out.push_back(0);
+}
+
+template <typename T>
+unsigned int AppendSection(std::vector<unsigned char>& out, const T* src, size_t n) {
+    AlignTo16(out);
+    const unsigned int off = (unsigned int)out.size();
+    const unsigned char* p = (const unsigned char*)src;
+    out.insert(out.end(), p, p + n * sizeof(T));
+    return off;
+}
+
+bool SectionFits(unsigned int off, size_t bytes, size_t fileSize) {
+    return off <= fileSize && bytes <= fileSize - off;
+}
+
+} // namespace
+
+unsigned long long HashText(const char* data, size_t size) {
+    return Fnv1a::Hash(data, size);
+}
+
+void Build(const std::vector<Territory>& territories, const TerritoryGrid* grid,
+           unsigned long long sourceHash, std::vector<unsigned char>& out)
+{
+    const unsigned int count = (unsigned int)territories.size();
+    const unsigned int padded = (count + 3) & ~3u;
+
+    std::vector<unsigned int> numIds(count);
+    std::vector<float> bounds((size_t)padded * 4, 0.0f);
+    std::vector<int> owners(count), defense(count), priority(count);
+    std::vector<unsigned int> idOffsets(count + 1);
+    std::string idChars;
+    std::vector<unsigned int> polyOffsets(count + 1);
+    std::vector<float> polyXY;
+
+    for (unsigned int i = 0; i < count; ++i) {
+        const Territory& t = territories[i];
+        numIds[i] = t.numId;
+        bounds[i]              = t.minX;
+        bounds[padded + i]     = t.minY;
+        bounds[padded * 2 + i] = t.maxX;
+        bounds[padded * 3 + i] = t.maxY;
+        owners[i] = t.defaultOwnerGang;
+        defense[i] = t.defenseLevel;
+        priority[i] = t.priority;
+        idOffsets[i] = (unsigned int)idChars.size();
+        idChars += t.id;
+        polyOffsets[i] = (unsigned int)(polyXY.size() / 2);
+        for (int v = 0; v < t.poly.VertexCount(); ++v) {
+            polyXY.push_back(t.poly.X()[v]);
+            polyXY.push_back(t.poly.Y()[v]);
+        }
+    }
+    idOffsets[count] = (unsigned int)idChars.size();
+    polyOffsets[count] = (unsigned int)(polyXY.size() / 2);
+
+    Header h{};
+    h.magic = kMagic;
+    h.version = kVersion;
+    h.sourceHash = sourceHash;
+    h.count = count;
+    h.padded = padded;
+
+    out.clear();
+    out.resize(sizeof(Header));
+    h.numIdOff     = AppendSection(out, numIds.data(), numIds.size());
+    h.boundsOff    = AppendSection(out, bounds.data(), bounds.size());
+    h.ownerOff     = AppendSection(out, owners.data(), owners.size());
+    h.defenseOff   = AppendSection(out, defense.data(), defense.size());
+    h.idOffsetsOff = AppendSection(out, idOffsets.data(), idOffsets.size());
+    h.idCharsOff   = AppendSection(out, idChars.data(), idChars.size());
+    h.idCharsSize  = (unsigned int)idChars.size();
+    h.polyOffsetsOff = AppendSection(out, polyOffsets.data(), polyOffsets.size());
+    h.polyXYOff      = AppendSection(out, polyXY.data(), polyXY.size());
+    h.polyVertices   = polyOffsets[count];
+    h.priorityOff    = AppendSection(out, priority.data(), priority.size());
+
+    if (grid && !grid->IsEmpty()) {
+        std::vector<unsigned char> image;
+        grid->Serialize(image);
+        h.gridOff  = AppendSection(out, image.data(), image.size());
+        h.gridSize = (unsigned int)image.size();
+    }
+
+    AlignTo16(out);
+    h.fileSize = (unsigned int)out.size();
+    std::memcpy(out.data(), &h, sizeof(h));
+}
+
+bool Load(const unsigned char* data, size_t size, unsigned long long expectedHash,
+          std::vector<Territory>& out, TerritoryGrid* grid, std::string& outErr)
+{
+    out.clear();
+    if (grid) grid->Clear();
+
+    Header h;
+    if (!data || size < sizeof(h)) { outErr = "cache: truncated header"; return false; }
+    std::memcpy(&h, data, sizeof(h));
+
+    if (h.magic != kMagic)             { outErr = "cache: bad magic"; return false; }
+    if (h.version != kVersion)         { outErr = "cache: version mismatch"; return false; }
+    if (h.sourceHash != expectedHash)  { outErr = "cache: stale (source hash differs)"; return false; }
+    if (h.fileSize != size)            { outErr = "cache: size mismatch"; return false; }
+    if (h.count == 0 || h.padded != ((h.count + 3) & ~3u)) { outErr = "cache: bad count"; return false; }
+
+    const size_t n = h.count;
+    if (!SectionFits(h.numIdOff, n * 4, size) ||
+        !SectionFits(h.boundsOff, (size_t)h.padded * 16, size) ||
+        !SectionFits(h.ownerOff, n * 4, size) ||
+        !SectionFits(h.defenseOff, n * 4, size) ||
+        !SectionFits(h.idOffsetsOff, (n + 1) * 4, size) ||
+        !SectionFits(h.idCharsOff, h.idCharsSize, size) ||
+        !SectionFits(h.gridOff, h.gridSize, size) ||
+        !SectionFits(h.polyOffsetsOff, (n + 1) * 4, size) ||
+        !SectionFits(h.polyXYOff, (size_t)h.polyVertices * 8, size) ||
+        !SectionFits(h.priorityOff, n * 4, size)) {
+        outErr = "cache: section out of range";
+        return false;
+    }
+
+    // Copy out the columns (the image may not be 4-byte aligned in memory).
+    std::vector<unsigned int> numIds(n), idOffsets(n + 1), polyOffsets(n + 1);
+    std::vector<float> bounds((size_t)h.padded * 4);
+    std::vector<int> owners(n), defense(n), priority(n);
+    std::memcpy(numIds.data(), data + h.numIdOff, n * 4);
+    std::memcpy(bounds.data(), data + h.boundsOff, (size_t)h.padded * 16);
+    std::memcpy(owners.data(), data + h.ownerOff, n * 4);
+    std::memcpy(defense.data(), data + h.defenseOff, n * 4);
+    std::memcpy(priority.data(), data + h.priorityOff, n * 4);
+    std::memcpy(idOffsets.data(), data + h.idOffsetsOff, (n + 1) * 4);
+    std::memcpy(polyOffsets.data(), data + h.polyOffsetsOff, (n + 1) * 4);
+
+    if (idOffsets[0] != 0 || idOffsets[n] != h.idCharsSize) { outErr = "cache: bad id table"; return false; }
+    for (size_t i = 0; i < n; ++i) {
+        if (idOffsets[i] > idOffsets[i + 1]) { outErr = "cache: bad id table"; return false; }
+    }
+
+    if (polyOffsets[0] != 0 || polyOffsets[n] != h.polyVertices) { outErr = "cache: bad polygon table"; return false; }
+    for (size_t i = 0; i < n; ++i) {
+        if (polyOffsets[i] > polyOffsets[i + 1]) { outErr = "cache: bad polygon table"; return false; }
+    }
+    std::vector<float> polyXY((size_t)h.polyVertices * 2);
+    if (!polyXY.empty()) std::memcpy(polyXY.data(), data + h.polyXYOff, polyXY.size() * 4);
+
+    const char* idChars = (const char*)(data + h.idCharsOff);
+    const size_t padded = h.padded;
+
+    out.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        Territory& t = out[i];
+        t.id.assign(idChars + idOffsets[i], idChars + idOffsets[i + 1]);
+        t.numId = numIds[i];
+        t.minX = bounds[i];
+        t.minY = bounds[padded + i];
+        t.maxX = bounds[padded * 2 + i];
+        t.maxY = bounds[padded * 3 + i];
+        t.ownerGang = owners[i];
+        t.defaultOwnerGang = owners[i];
+        t.defenseLevel = defense[i];
+        t.priority = priority[i];
+
+        // Outlines are stored as vertices only; the edge table and
+        // triangulation are cheap to redo and never go stale this way.
+        const unsigned int vb = polyOffsets[i], ve = polyOffsets[i + 1];
+        if (vb != ve) {
+            std::string polyErr;
+            if (!t.poly.Build(polyXY.data() + (size_t)vb * 2, (int)(ve - vb), polyErr)) {
+                outErr = "cache: bad polygon (" + polyErr + ")";
+                out.clear();
+                return false;
+            }
+        }
+    }
+
+    // A bad grid section is not fatal; the caller just builds the grid itself.
+    if (grid && h.gridSize) {
+        grid->Deserialize(data + h.gridOff, h.gridSize, (int)n);
+    }
+
+    return true;
+}
+
+} // namespace TerritoryCache
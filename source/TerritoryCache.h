@@ -0,0 +1,49 @@
+#pragma once
+// Compiled territories.bin cache: the parsed territory list plus its built
+// grid, keyed by a hash of the territories.txt bytes it was compiled from.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Layout (little-endian, every section 16-byte aligned, offsets from the
+// start of the file so the image can be used straight from a mapping):
+//
+//   Header      magic "GTWB", version, source hash, count, section offsets
+//   numId       u32[count]
+//   bounds      f32[padded] x4 (minX, minY, maxX, maxY; padded to 4)
+//   owner       i32[count]   default owner gang
+//   defense     i32[count]
+//   idOffsets   u32[count + 1] into idChars
+//   idChars     id strings, not NUL-terminated
+//   grid        TerritoryGrid::Serialize image (optional, gridSize may be 0)
+//   polyOffsets u32[count + 1] into polyXY, in vertices (equal = no outline)
+//   polyXY      f32 x, y pairs of every outline, rebuilt with Build() on load
+//   priority    i32[count]   overlap priority ("prio:")
+//
+// Anything that does not validate (magic, version, hash, sizes) is treated
+// as a miss; the caller re-parses the text and writes a fresh cache.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct Territory;
+class TerritoryGrid;
+
+namespace TerritoryCache {
+
+constexpr unsigned int kMagic   = 0x42575447u; // "GTWB"
+constexpr unsigned int kVersion = 3u;
+
+// 64-bit FNV-1a over the source text (Fnv1a::Hash).
+unsigned long long HashText(const char* data, size_t size);
+
+// Builds a cache image. grid may be null (or empty) to omit the grid section.
+void Build(const std::vector<Territory>& territories, const TerritoryGrid* grid,
+           unsigned long long sourceHash, std::vector<unsigned char>& out);
+
+// Loads a cache image compiled from text with hash expectedHash. Fills out
+// with runtime defaults (ownerGang = default owner). If grid is non-null it
+// receives the stored grid, or is left empty when the image has none.
+bool Load(const unsigned char* data, size_t size, unsigned long long expectedHash,
+          std::vector<Territory>& out, TerritoryGrid* grid, std::string& outErr);
+
+} // namespace TerritoryCache
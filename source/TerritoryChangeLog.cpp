@@ -0,0 +1,107 @@
+#include "TerritoryChangeLog.h"
+
+#include <algorithm>
+
+unsigned int TerritoryChangeLog::Bump(unsigned int kinds) {
+    ++m_epoch;
+    for (int k = 0; k < 3; ++k) {
+        if (kinds & (1u << k)) m_kindEpoch[k] = m_epoch;
+    }
+    return m_epoch;
+}
+
+void TerritoryChangeLog::Mark(TerritoryHandle h, unsigned int kinds) {
+    kinds &= kAll;
+    if (!kinds || !h.IsValid()) return;
+
+    const unsigned int e = Bump(kinds);
+    const size_t slot = (size_t)h.slot;
+    if (slot >= m_pendingAt.size()) m_pendingAt.resize(slot + 1, -1);
+
+    const int at = m_pendingAt[slot];
+    if (at >= 0 && m_pending[at].handle == h) {
+        m_pending[at].kinds |= kinds;
+        m_pending[at].epoch = e;
+        return;
+    }
+    m_pendingAt[slot] = (int)m_pending.size();
+    m_pending.push_back(Event{ h, kinds, e });
+}
+
+void TerritoryChangeLog::MarkAll(unsigned int kinds) {
+    kinds &= kAll;
+    if (!kinds) return;
+
+    // A bulk event covers whatever was queued before it.
+    for (const Event& p : m_pending) {
+        kinds |= p.kinds;
+        if (p.handle.IsValid()) m_pendingAt[p.handle.slot] = -1;
+    }
+    m_pending.clear();
+
+    const unsigned int e = Bump(kinds);
+    m_pending.push_back(Event{ TerritoryHandle{}, kinds, e });
+}
+
+void TerritoryChangeLog::Reset() {
+    m_pending.clear();
+    m_pendingAt.clear();
+}
+
+unsigned int TerritoryChangeLog::Epoch(unsigned int kinds) const {
+    unsigned int e = 0;
+    for (int k = 0; k < 3; ++k) {
+        if (kinds & (1u << k)) e = std::max(e, m_kindEpoch[k]);
+    }
+    return e;
+}
+
+int TerritoryChangeLog::Subscribe(unsigned int kinds, Callback cb, void* user) {
+    if (!cb) return 0;
+    const int id = m_nextSubId++;
+    m_subs.push_back(Subscriber{ id, kinds & kAll, cb, user });
+    return id;
+}
+
+void TerritoryChangeLog::Unsubscribe(int id) {
+    for (size_t i = 0; i < m_subs.size(); ++i) {
+        if (m_subs[i].id != id) continue;
+        if (m_flushing) m_subs[i].cb = nullptr; // compacted when Flush finishes
+        else m_subs.erase(m_subs.begin() + i);
+        return;
+    }
+}
+
+int TerritoryChangeLog::SubscriberCount() const {
+    int n = 0;
+    for (const Subscriber& s : m_subs) n += s.cb ? 1 : 0;
+    return n;
+}
+
+int TerritoryChangeLog::Flush() {
+    if (m_pending.empty() || m_flushing) return 0;
+
+    // Take the batch first so callbacks that Mark() start the next one.
+    m_delivering.swap(m_pending);
+    m_pending.clear();
+    for (const Event& e : m_delivering) {
+        if (e.handle.IsValid()) m_pendingAt[e.handle.slot] = -1;
+    }
+
+    m_flushing = true;
+    const size_t subCount = m_subs.size(); // subscribers added mid-flush wait for the next batch
+    for (const Event& e : m_delivering) {
+        for (size_t i = 0; i < subCount; ++i) {
+            const Subscriber s = m_subs[i];
+            if (s.cb && (s.kinds & e.kinds)) s.cb(e, s.user);
+        }
+    }
+    m_flushing = false;
+
+    m_subs.erase(std::remove_if(m_subs.begin(), m_subs.end(),
+        [](const Subscriber& s) { return s.cb == nullptr; }), m_subs.end());
+
+    const int delivered = (int)m_delivering.size();
+    m_delivering.clear();
+    return delivered;
+}
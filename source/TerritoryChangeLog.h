@@ -0,0 +1,77 @@
+#pragma once
+#include "TerritoryHandleTable.h"
+
+#include <vector>
+
+// Territory change journal: epochs plus batched change notifications.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Every Mark() bumps one global epoch and stamps it on each changed kind, so
+// a consumer that caches anything derived from territory state only has to
+// remember the epoch it built from and compare one integer per frame. Epochs only ever grow (Reset() keeps counting), so
+// a stored value can never match again by accident.
+//
+// Subscribers are not called from inside Mark(); changes are queued,
+// coalesced per slot, and delivered by Flush() once per frame. A callback
+// may Mark() again (delivered on the next Flush) or Unsubscribe() itself.
+// With nothing marked, Flush() returns without touching the subscribers.
+
+class TerritoryChangeLog {
+public:
+    enum Kind : unsigned int {
+        kOwner       = 1u << 0,
+        kUnderAttack = 1u << 1,
+        kGeometry    = 1u << 2, // rect/outline changed, or territories added, removed or reordered
+        kAll         = kOwner | kUnderAttack | kGeometry,
+    };
+
+    struct Event {
+        TerritoryHandle handle; // invalid for a bulk change (any territory may have changed)
+        unsigned int kinds;     // Kind bits, OR'd over everything coalesced into this event
+        unsigned int epoch;     // epoch of the latest change folded in
+    };
+
+    typedef void (*Callback)(const Event& e, void* user);
+
+    void Mark(TerritoryHandle h, unsigned int kinds);
+    // Every territory, e.g. after indices were rebuilt and handles re-issued.
+    void MarkAll(unsigned int kinds);
+
+    // Drops pending events; subscribers and the epoch counter are kept.
+    void Reset();
+
+    unsigned int Epoch() const { return m_epoch; }
+    // Latest epoch at which any of the given kinds changed (0 = never).
+    unsigned int Epoch(unsigned int kinds) const;
+
+    // kinds filters which events reach the callback. Returns an id > 0.
+    int Subscribe(unsigned int kinds, Callback cb, void* user);
+    void Unsubscribe(int id);
+    int SubscriberCount() const;
+
+    bool HasPending() const { return !m_pending.empty(); }
+    // Delivers pending events in the order their slots first changed.
+    // Returns the number of events delivered (before subscriber filtering).
+    int Flush();
+
+private:
+    struct Subscriber {
+        int id;
+        unsigned int kinds;
+        Callback cb; // nullptr once unsubscribed during a Flush
+        void* user;
+    };
+
+    unsigned int m_epoch = 0;
+    unsigned int m_kindEpoch[3] = {};
+
+    std::vector<Event> m_pending;
+    std::vector<int> m_pendingAt; // per slot: index into m_pending, or -1
+    std::vector<Event> m_delivering;
+
+    std::vector<Subscriber> m_subs;
+    int m_nextSubId = 1;
+    bool m_flushing = false;
+
+    unsigned int Bump(unsigned int kinds);
+};
@@ -0,0 +1,92 @@
+#include "TerritoryDiff.h"
+#include "TerritoryIdIndex.h"
+#include "TerritorySystem.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace TerritoryDiff {
+
+bool Result::AddedAtTail() const {
+    const int survivors = (int)source.size() - (int)added.size();
+    return added.empty() || added.front() == survivors;
+}
+
+bool SameGeometry(const Territory& a, const Territory& b) {
+    return a.minX == b.minX && a.minY == b.minY && a.maxX == b.maxX && a.maxY == b.maxY &&
+           a.poly.SameShape(b.poly);
+}
+
+static bool SameDefinition(const Territory& a, const Territory& b) {
+    return SameGeometry(a, b) &&
+        a.defaultOwnerGang == b.defaultOwnerGang &&
+        a.defenseLevel == b.defenseLevel &&
+        a.priority == b.priority &&
+        a.id == b.id;
+}
+
+void Compute(const std::vector<Territory>& current, const TerritoryIdIndex& currentIndex,
+             const std::vector<Territory>& next, Result& out)
+{
+    out.removed.clear();
+    out.added.clear();
+    out.changed.clear();
+    out.source.assign(next.size(), -1);
+    out.reordered = false;
+
+    std::vector<char> matched(current.size(), 0);
+    int lastMatched = -1;
+
+    for (int j = 0; j < (int)next.size(); ++j) {
+        const int i = currentIndex.Find(next[j].numId);
+        if (i < 0) {
+            out.added.push_back(j);
+            continue;
+        }
+
+        out.source[j] = i;
+        matched[i] = 1;
+        if (i < lastMatched) out.reordered = true;
+        lastMatched = i;
+
+        if (!SameDefinition(current[i], next[j])) {
+            out.changed.push_back(Change{ i, j, !SameGeometry(current[i], next[j]) });
+        }
+    }
+
+    for (int i = 0; i < (int)current.size(); ++i) {
+        if (!matched[i]) out.removed.push_back(i);
+    }
+
+    if (out.reordered) {
+        // Matches were visited in next order; callers expect current order.
+        std::sort(out.changed.begin(), out.changed.end(),
+            [](const Change& a, const Change& b) { return a.index < b.index; });
+    }
+}
+
+void Apply(std::vector<Territory>& current, std::vector<Territory>& next, const Result& diff) {
+    for (const Change& c : diff.changed) {
+        Territory& t = current[c.index];
+        const Territory& n = next[c.nextIndex];
+        t.id = n.id;
+        t.minX = n.minX; t.minY = n.minY;
+        t.maxX = n.maxX; t.maxY = n.maxY;
+        if (c.geometry) t.poly = n.poly;
+        t.defaultOwnerGang = n.defaultOwnerGang;
+        t.defenseLevel = n.defenseLevel;
+        t.priority = n.priority;
+    }
+
+    if (!diff.Structural()) return;
+
+    std::vector<Territory> merged;
+    merged.reserve(next.size());
+    for (int j = 0; j < (int)next.size(); ++j) {
+        const int i = diff.source[j];
+        merged.push_back(i >= 0 ? std::move(current[i]) : std::move(next[j]));
+    }
+    current.swap(merged);
+}
+
+} // namespace TerritoryDiff
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+
+// Id-keyed diff between the live territory list and a freshly loaded one.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Hot reload used to swap in the whole new vector and rebuild every index
+// from scratch. Compute() matches records by numId so the reload can patch
+// only what actually changed; Apply() then brings the live vector to the new
+// file's content and order while surviving records keep their runtime state
+// (owner, neutral timer, underAttack).
+
+struct Territory;
+class TerritoryIdIndex;
+
+namespace TerritoryDiff {
+
+struct Change {
+    int index;      // into current
+    int nextIndex;  // into next
+    bool geometry;  // rect or outline changed (otherwise only defaults or id spelling)
+};
+
+struct Result {
+    std::vector<int> removed;    // indices into current, ascending
+    std::vector<int> added;      // indices into next, ascending
+    std::vector<Change> changed; // ascending by index
+    std::vector<int> source;     // per next index: matching current index, or -1 if added
+    bool reordered = false;      // surviving ids appear in a different relative order
+
+    bool Empty() const { return removed.empty() && added.empty() && changed.empty() && !reordered; }
+
+    // Anything that moves indices around (vs. edits to records in place).
+    bool Structural() const { return !removed.empty() || !added.empty() || reordered; }
+
+    // Every added record sits after all surviving ones in next, so a
+    // structural change with no reorder is "erase some, append the rest".
+    bool AddedAtTail() const;
+};
+
+bool SameGeometry(const Territory& a, const Territory& b);
+
+// currentIndex must be built over current.
+void Compute(const std::vector<Territory>& current, const TerritoryIdIndex& currentIndex,
+             const std::vector<Territory>& next, Result& out);
+
+// Brings current to next's content and order. Changed records take next's id
+// spelling, rect, outline, default owner, defense level and priority; added records come in as
+// loaded. next is consumed when the diff is structural.
+void Apply(std::vector<Territory>& current, std::vector<Territory>& next, const Result& diff);
+
+} // namespace TerritoryDiff
@@ -0,0 +1,162 @@
+#include "TerritoryEditJournal.h"
+#include "TerritoryFileParser.h"
+#include "TerritorySystem.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char kHeader[] = "#journal base=";
+
+static TerritoryEditJournal::Op MakeOp(TerritoryEditJournal::OpKind kind, const Territory& t) {
+    TerritoryEditJournal::Op op;
+    op.kind = kind;
+    op.numId = t.numId;
+    TerritoryFileParser::FormatLine(t, op.line);
+    return op;
+}
+
+TerritoryEditJournal::Op TerritoryEditJournal::MakeAdd(const Territory& t) {
+    return MakeOp(kAdd, t);
+}
+
+TerritoryEditJournal::Op TerritoryEditJournal::MakeRemove(const Territory& t) {
+    return MakeOp(kRemove, t);
+}
+
+TerritoryEditJournal::Op TerritoryEditJournal::Inverse(const Op& op) {
+    Op inv = op;
+    inv.kind = (op.kind == kAdd) ? kRemove : kAdd;
+    return inv;
+}
+
+bool TerritoryEditJournal::Apply(std::vector<Territory>& terrs, const Op& op, std::string& outErr) {
+    int at = -1;
+    for (int i = 0; i < (int)terrs.size(); ++i) {
+        if (terrs[i].numId == op.numId) { at = i; break; }
+    }
+
+    if (op.kind == kRemove) {
+        if (at >= 0) terrs.erase(terrs.begin() + at);
+        return true;
+    }
+
+    Territory t;
+    if (!TerritoryFileParser::ParseLine(op.line.data(), op.line.data() + op.line.size(), t, outErr)) {
+        return false;
+    }
+    if (at >= 0) terrs[at] = std::move(t);
+    else terrs.push_back(std::move(t));
+    return true;
+}
+
+bool TerritoryEditJournal::Parse(const char* data, size_t size, unsigned long long& outBase,
+    std::vector<Op>& outOps, std::string& outErr)
+{
+    outBase = 0;
+    outOps.clear();
+
+    const char* p = data;
+    const char* end = data + size;
+    for (int lineNo = 1; p < end; ++lineNo) {
+        const char* nl = (const char*)std::memchr(p, '\n', (size_t)(end - p));
+        if (!nl) break; // torn append
+        const char* b = p;
+        const char* e = (nl > b && nl[-1] == '\r') ? nl - 1 : nl;
+        p = nl + 1;
+        if (b == e) continue;
+
+        if (*b == '#') {
+            const size_t n = sizeof(kHeader) - 1;
+            if ((size_t)(e - b) > n && std::memcmp(b, kHeader, n) == 0) {
+                outBase = std::strtoull(std::string(b + n, e).c_str(), nullptr, 16);
+            }
+            continue;
+        }
+
+        char msg[64];
+        if (*b != '+' && *b != '-') {
+            std::snprintf(msg, sizeof(msg), "Journal line %d: ", lineNo);
+            outErr = std::string(msg) + "Expected '+' or '-'";
+            return false;
+        }
+
+        Territory t;
+        std::string err;
+        if (!TerritoryFileParser::ParseLine(b + 1, e, t, err)) {
+            std::snprintf(msg, sizeof(msg), "Journal line %d: ", lineNo);
+            outErr = std::string(msg) + err;
+            return false;
+        }
+        Op op;
+        op.kind = (*b == '+') ? kAdd : kRemove;
+        op.numId = t.numId;
+        op.line.assign(b + 1, e);
+        outOps.push_back(std::move(op));
+    }
+    return true;
+}
+
+void TerritoryEditJournal::Reset(unsigned long long baseHash) {
+    m_baseHash = baseHash;
+    m_ops.clear();
+    m_undo.clear();
+    m_redo.clear();
+    m_append.clear();
+    m_headerWritten = false;
+}
+
+void TerritoryEditJournal::Adopt(unsigned long long baseHash, std::vector<Op>& ops) {
+    Reset(baseHash);
+    m_ops.swap(ops);
+    m_headerWritten = true;
+}
+
+void TerritoryEditJournal::Journal(const Op& op) {
+    if (!m_headerWritten) {
+        char header[64];
+        std::snprintf(header, sizeof(header), "%s%016llx\n", kHeader, m_baseHash);
+        m_append += header;
+        m_headerWritten = true;
+    }
+    m_append += (op.kind == kAdd) ? '+' : '-';
+    m_append += op.line;
+    m_append += '\n';
+    m_ops.push_back(op);
+}
+
+void TerritoryEditJournal::Record(const Op& op) {
+    Journal(op);
+    m_undo.push_back(op);
+    m_redo.clear();
+}
+
+bool TerritoryEditJournal::Undo(Op& outOp) {
+    if (m_undo.empty()) return false;
+    outOp = Inverse(m_undo.back());
+    m_redo.push_back(std::move(m_undo.back()));
+    m_undo.pop_back();
+    Journal(outOp);
+    return true;
+}
+
+bool TerritoryEditJournal::Redo(Op& outOp) {
+    if (m_redo.empty()) return false;
+    outOp = m_redo.back();
+    m_undo.push_back(std::move(m_redo.back()));
+    m_redo.pop_back();
+    Journal(outOp);
+    return true;
+}
+
+void TerritoryEditJournal::TakeAppendText(std::string& out) {
+    out.clear();
+    out.swap(m_append);
+}
+
+void TerritoryEditJournal::MarkCompacted(unsigned long long newBase) {
+    m_baseHash = newBase;
+    m_ops.clear();
+    m_append.clear();
+    m_headerWritten = false;
+}
@@ -0,0 +1,81 @@
+#pragma once
+// Editor journal: territory adds/removes appended to territories.txt.journal
+// instead of rewriting territories.txt on every edit, plus undo/redo.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// File format (text, one record per line, '\n' terminated):
+//   #journal base=<16 hex digits>   hash of the territories.txt it applies to
+//   +<territories.txt line>         add, or replace the territory with that id
+//   -<territories.txt line>         remove that id (full record kept for undo)
+//
+// Records are keyed by territory id, so replaying is idempotent and still
+// meaningful if territories.txt was edited by hand underneath the journal.
+// A last line without '\n' is a torn append and is dropped.
+//
+// Undo and redo never rewrite history: each one appends the op it performs
+// (the inverse for undo, the original for redo). Compaction folds the file
+// into territories.txt; the undo/redo stacks survive it.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct Territory;
+
+class TerritoryEditJournal {
+public:
+    enum OpKind { kAdd, kRemove };
+
+    struct Op {
+        OpKind kind;
+        unsigned int numId;
+        std::string line; // territories.txt record, without newline
+    };
+
+    static Op MakeAdd(const Territory& t);
+    static Op MakeRemove(const Territory& t);
+    static Op Inverse(const Op& op);
+
+    // Applies op to terrs by id. Returns false only if an add record does not
+    // parse; removing an id that is not there is a no-op.
+    static bool Apply(std::vector<Territory>& terrs, const Op& op, std::string& outErr);
+
+    // Parses a journal file. Ops before a bad record are kept in outOps;
+    // outErr is "Journal line N: <reason>" for the first bad one.
+    static bool Parse(const char* data, size_t size, unsigned long long& outBase,
+        std::vector<Op>& outOps, std::string& outErr);
+
+    // Starts over on top of territories.txt with this content hash, dropping
+    // every op and the undo/redo history.
+    void Reset(unsigned long long baseHash);
+    // Adopts ops read back from disk (they stay in the file; not undoable).
+    void Adopt(unsigned long long baseHash, std::vector<Op>& ops);
+
+    // A fresh edit: journaled, undoable, clears the redo stack.
+    void Record(const Op& op);
+    // Fill outOp with what to apply to the live set; false if nothing to do.
+    bool Undo(Op& outOp);
+    bool Redo(Op& outOp);
+    bool CanUndo() const { return !m_undo.empty(); }
+    bool CanRedo() const { return !m_redo.empty(); }
+
+    // Ops journaled since the last compaction, in order.
+    const std::vector<Op>& Ops() const { return m_ops; }
+    unsigned long long BaseHash() const { return m_baseHash; }
+
+    // Bytes to append to the journal file since the last call (the header
+    // first if the file is new). Empty when there is nothing to write.
+    void TakeAppendText(std::string& out);
+    // Ops are now part of territories.txt (hash newBase); the file is gone.
+    void MarkCompacted(unsigned long long newBase);
+
+private:
+    unsigned long long m_baseHash = 0;
+    std::vector<Op> m_ops;
+    std::vector<Op> m_undo; // ops as performed; undo applies the inverse
+    std::vector<Op> m_redo;
+    std::string m_append;
+    bool m_headerWritten = false;
+
+    void Journal(const Op& op);
+};
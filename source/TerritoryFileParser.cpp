@@ -0,0 +1,343 @@
+#include "TerritoryFileParser.h"
+#include "TerritoryIdIndex.h"
+#include "TerritorySystem.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace TerritoryFileParser {
+
+// Same set as std::isspace in the "C" locale, without the locale lookup.
+static inline bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static void Trim(const char*& b, const char*& e) {
+    while (b < e && IsSpace(*b)) ++b;
+    while (e > b && IsSpace(e[-1])) --e;
+}
+
+// sscanf("%f"/"%d") accepted a leading '+', from_chars does not. Trailing
+// junk after the number is ignored, as it was with sscanf.
+static bool ParseFloat(const char* b, const char* e, float& out) {
+    if (b < e && *b == '+') ++b;
+    return std::from_chars(b, e, out).ec == std::errc();
+}
+
+static bool ParseInt(const char* b, const char* e, int& out) {
+    if (b < e && *b == '+') ++b;
+    return std::from_chars(b, e, out).ec == std::errc();
+}
+
+// "x y;x y;x y" (the part after "poly:"). Vertices are ';'-separated so the
+// outline fits in one comma field.
+static bool ParsePolygon(const char* b, const char* e, TerritoryPolygon& out, std::string& outErr) {
+    std::vector<float> xy;
+    int vertex = 0;
+    while (b < e) {
+        const char* semi = (const char*)std::memchr(b, ';', (size_t)(e - b));
+        const char* vb = b;
+        const char* ve = semi ? semi : e;
+        b = semi ? semi + 1 : e;
+        Trim(vb, ve);
+        if (vb == ve) continue; // tolerate a trailing ';'
+
+        ++vertex;
+        float x = 0.0f, y = 0.0f;
+        const char* p = vb;
+        if (p < ve && *p == '+') ++p;
+        auto rx = std::from_chars(p, ve, x);
+        p = rx.ptr;
+        while (p < ve && IsSpace(*p)) ++p;
+        if (p < ve && *p == '+') ++p;
+        auto ry = std::from_chars(p, ve, y);
+        if (rx.ec != std::errc() || ry.ec != std::errc() || ry.ptr != ve) {
+            outErr = "Bad polygon vertex " + std::to_string(vertex);
+            return false;
+        }
+        xy.push_back(x);
+        xy.push_back(y);
+    }
+    return out.Build(xy.data(), (int)(xy.size() / 2), outErr);
+}
+
+bool ParseLine(const char* begin, const char* end, Territory& outT, std::string& outErr) {
+    if (begin >= end) { outErr = "Empty line"; return false; }
+
+    // Up to 8 comma-separated fields; anything past the 7th comma stays in
+    // the last token.
+    const char* tokB[8];
+    const char* tokE[8];
+    int count = 0;
+
+    const char* p = begin;
+    while (count < 8) {
+        tokB[count] = p;
+        const char* comma = (count < 7) ? (const char*)std::memchr(p, ',', (size_t)(end - p)) : nullptr;
+        tokE[count] = comma ? comma : end;
+        ++count;
+        if (!comma) break;
+        p = comma + 1;
+    }
+
+    // Fields past the 8th are ignored, except the tagged "prio:" and "poly:".
+    const char* restB = nullptr;
+    const char* restE = nullptr;
+    if (count == 8) {
+        const char* comma = (const char*)std::memchr(tokB[7], ',', (size_t)(tokE[7] - tokB[7]));
+        if (comma) {
+            restB = comma + 1;
+            restE = tokE[7];
+            tokE[7] = comma;
+        }
+    }
+
+    for (int i = 0; i < count; i++) Trim(tokB[i], tokE[i]);
+
+    if (count < 5) {
+        outErr = "Expected at least 5 comma-separated fields";
+        return false;
+    }
+
+    Territory t{};
+    if (tokB[0] == tokE[0]) { outErr = "Missing id"; return false; }
+    if (!ParseTerritoryId(tokB[0], (size_t)(tokE[0] - tokB[0]), t.numId)) {
+        outErr = "Id must be numeric (e.g. 1001)";
+        return false;
+    }
+    t.id.assign(tokB[0], tokE[0]);
+
+    if (!ParseFloat(tokB[1], tokE[1], t.minX)) { outErr = "Bad minX"; return false; }
+    if (!ParseFloat(tokB[2], tokE[2], t.minY)) { outErr = "Bad minY"; return false; }
+    if (!ParseFloat(tokB[3], tokE[3], t.maxX)) { outErr = "Bad maxX"; return false; }
+    if (!ParseFloat(tokB[4], tokE[4], t.maxY)) { outErr = "Bad maxY"; return false; }
+
+    t.ownerGang = -1;
+    t.defaultOwnerGang = -1;
+    t.underAttack = false;
+    t.defenseLevel = 1;
+
+    if (count >= 6 && tokB[5] < tokE[5]) {
+        int code = -1;
+        if (!ParseInt(tokB[5], tokE[5], code)) { outErr = "Bad ownerGangCode"; return false; }
+        t.ownerGang = code;
+        t.defaultOwnerGang = code;
+    }
+
+    // UnderAttack in file is ignored for defaults; always runtime-only
+    // Defense level optional
+    if (count >= 8 && tokB[7] < tokE[7]) {
+        int dl = 1;
+        if (!ParseInt(tokB[7], tokE[7], dl)) { outErr = "Bad defenseLevel"; return false; }
+        if (dl < 0) dl = 0;
+        if (dl > 2) dl = 2;
+        t.defenseLevel = dl;
+    }
+
+    if (t.minX > t.maxX) std::swap(t.minX, t.maxX);
+    if (t.minY > t.maxY) std::swap(t.minY, t.maxY);
+
+    while (restB && restB < restE) {
+        const char* comma = (const char*)std::memchr(restB, ',', (size_t)(restE - restB));
+        const char* fb = restB;
+        const char* fe = comma ? comma : restE;
+        restB = comma ? comma + 1 : restE;
+        Trim(fb, fe);
+        if (fe - fb >= 5 && std::memcmp(fb, "prio:", 5) == 0) {
+            if (!ParseInt(fb + 5, fe, t.priority)) { outErr = "Bad priority"; return false; }
+            continue;
+        }
+        if (fe - fb < 5 || std::memcmp(fb, "poly:", 5) != 0) continue;
+
+        if (!ParsePolygon(fb + 5, fe, t.poly, outErr)) return false;
+        // The outline wins over the rect columns; its box is what the
+        // spatial indices see.
+        t.minX = t.poly.MinX(); t.minY = t.poly.MinY();
+        t.maxX = t.poly.MaxX(); t.maxY = t.poly.MaxY();
+    }
+
+    outT = std::move(t);
+    return true;
+}
+
+void FormatLine(const Territory& t, std::string& out) {
+    char buf[160];
+    std::snprintf(buf, sizeof(buf), "%s,%.3f,%.3f,%.3f,%.3f,%d,%d,%d",
+        t.id.c_str(), t.minX, t.minY, t.maxX, t.maxY, t.defaultOwnerGang, 0, t.defenseLevel);
+    out += buf;
+    if (t.priority != 0) {
+        std::snprintf(buf, sizeof(buf), ",prio:%d", t.priority);
+        out += buf;
+    }
+    if (t.poly.Empty()) return;
+    out += ",poly:";
+    for (int v = 0; v < t.poly.VertexCount(); ++v) {
+        std::snprintf(buf, sizeof(buf), v ? ";%.3f %.3f" : "%.3f %.3f", t.poly.X()[v], t.poly.Y()[v]);
+        out += buf;
+    }
+}
+
+// One slice of the buffer. Line numbers are chunk-relative until the merge
+// adds the line counts of the chunks before it.
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end   = nullptr;
+    std::vector<Territory> territories;
+    std::vector<int> lines;
+    int lineCount = 0;
+    int errLine = 0;      // 0 = no parse error
+    std::string err;
+};
+
+static void ParseChunk(Chunk& c) {
+    const char* p = c.begin;
+    int lineNo = 0;
+
+    while (p < c.end) {
+        const char* nl = (const char*)std::memchr(p, '\n', (size_t)(c.end - p));
+        const char* lineEnd = nl ? nl : c.end;
+        ++lineNo;
+
+        // A stray '\r' ends the line's content, as the old fgets loop did.
+        const char* cr = (const char*)std::memchr(p, '\r', (size_t)(lineEnd - p));
+        const char* b = p;
+        const char* e = cr ? cr : lineEnd;
+        Trim(b, e);
+
+        p = nl ? nl + 1 : c.end;
+
+        if (b == e || *b == '#') continue;
+
+        Territory t;
+        if (!ParseLine(b, e, t, c.err)) {
+            c.errLine = lineNo;
+            break;
+        }
+        c.territories.push_back(std::move(t));
+        c.lines.push_back(lineNo);
+    }
+
+    c.lineCount = lineNo;
+}
+
+// Splits [data, data + size) into roughly equal chunks, each ending just
+// after a '\n' (the last one ends at the buffer end).
+static void SplitChunks(const char* data, size_t size, int want, std::vector<Chunk>& chunks) {
+    chunks.clear();
+    const char* end = data + size;
+    const char* p = data;
+    const size_t step = size / (size_t)want;
+
+    for (int i = 0; i < want - 1 && p < end; ++i) {
+        const char* target = p + step;
+        if (target >= end) break;
+        const char* nl = (const char*)std::memchr(target, '\n', (size_t)(end - target));
+        if (!nl) break;
+
+        Chunk c;
+        c.begin = p;
+        c.end = nl + 1;
+        chunks.push_back(std::move(c));
+        p = nl + 1;
+    }
+
+    if (p < end || chunks.empty()) {
+        Chunk c;
+        c.begin = p;
+        c.end = end;
+        chunks.push_back(std::move(c));
+    }
+}
+
+void ScanIdLines(const char* data, size_t size, std::vector<IdLine>& out) {
+    out.clear();
+    const char* end = data + size;
+    const char* p = data;
+    int lineNo = 0;
+
+    while (p < end) {
+        const char* nl = (const char*)std::memchr(p, '\n', (size_t)(end - p));
+        const char* lineEnd = nl ? nl : end;
+        ++lineNo;
+        const char* comma = (const char*)std::memchr(p, ',', (size_t)(lineEnd - p));
+        const char* b = p;
+        const char* e = comma ? comma : lineEnd;
+        p = nl ? nl + 1 : end;
+
+        Trim(b, e);
+        unsigned int numId = 0;
+        if (b == e || *b == '#' || !ParseTerritoryId(b, (size_t)(e - b), numId)) continue;
+        out.push_back(IdLine{ numId, lineNo });
+    }
+
+    std::stable_sort(out.begin(), out.end(), [](const IdLine& a, const IdLine& b) {
+        return a.numId < b.numId;
+    });
+}
+
+bool ParseBuffer(const char* data, size_t size, std::vector<Territory>& out,
+                 std::string& outErr, int maxThreads)
+{
+    out.clear();
+
+    int threads = maxThreads > 0 ? maxThreads : (int)std::thread::hardware_concurrency();
+    threads = std::clamp(threads, 1, kMaxParseThreads);
+    if (size < kParallelThresholdBytes) threads = 1;
+
+    std::vector<Chunk> chunks;
+    SplitChunks(data, size, threads, chunks);
+
+    if (chunks.size() == 1) {
+        ParseChunk(chunks[0]);
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(chunks.size() - 1);
+        for (size_t i = 1; i < chunks.size(); ++i) {
+            workers.emplace_back(ParseChunk, std::ref(chunks[i]));
+        }
+        ParseChunk(chunks[0]);
+        for (auto& w : workers) w.join();
+    }
+
+    // Merge in file order so the first problem in the file is the one
+    // reported, whether it is a duplicate or a parse error.
+    size_t total = 0;
+    for (const auto& c : chunks) total += c.territories.size();
+    out.reserve(total);
+
+    TerritoryIdIndex seen;
+    int lineBase = 0;
+    char buf[256];
+
+    for (auto& c : chunks) {
+        for (size_t k = 0; k < c.territories.size(); ++k) {
+            Territory& t = c.territories[k];
+            if (!seen.Insert(t.numId, (int)out.size())) {
+                std::snprintf(buf, sizeof(buf), "Duplicate id '%s' at line %d", t.id.c_str(), lineBase + c.lines[k]);
+                outErr = buf;
+                return false;
+            }
+            out.push_back(std::move(t));
+        }
+
+        if (c.errLine) {
+            std::snprintf(buf, sizeof(buf), "Parse error line %d: %s", lineBase + c.errLine, c.err.c_str());
+            outErr = buf;
+            return false;
+        }
+
+        lineBase += c.lineCount;
+    }
+
+    if (out.empty()) {
+        outErr = "No territories loaded";
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace TerritoryFileParser
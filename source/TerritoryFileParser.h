@@ -0,0 +1,57 @@
+#pragma once
+// territories.txt parser: whole-file buffer in, territory list out.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Line format: id, minX, minY, maxX, maxY [, ownerGang [, underAttack [, defenseLevel [, tagged...]]]]
+// Tagged fields, in any order:
+//   poly:x y;x y;x y...   outline (see TerritoryPolygon); when present the
+//                         rect columns are replaced by its bounding box
+//   prio:N                lookup priority where territories overlap (see
+//                         TerritoryOverlap); default 0
+// Other fields past the 8th are ignored.
+// Blank lines and lines starting with '#' are skipped. Tokens are sliced out
+// of the caller's buffer in place (no per-line copies) and numbers are read
+// with std::from_chars. Buffers of kParallelThresholdBytes or more are split
+// on line boundaries and the chunks parsed on worker threads; results and
+// error reporting are identical to a serial parse.
+//
+// Error strings (returned in outErr):
+//   "Parse error line N: <reason>"
+//   "Duplicate id '<id>' at line N"
+//   "No territories loaded"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct Territory;
+
+namespace TerritoryFileParser {
+
+constexpr size_t kParallelThresholdBytes = 512 * 1024;
+constexpr int    kMaxParseThreads        = 8;
+
+// Parses one trimmed, non-comment line [begin, end). outErr gets the bare
+// reason ("Bad minX", ...) without a line number.
+bool ParseLine(const char* begin, const char* end, Territory& outT, std::string& outErr);
+
+// Appends t as one line (no newline) that ParseLine reads back: the default
+// owner in the owner column, underAttack 0, and the outline if there is one.
+void FormatLine(const Territory& t, std::string& out);
+
+struct IdLine {
+    unsigned int numId;
+    int line; // 1-based
+};
+
+// Line number of every well-formed id in a territories.txt buffer, sorted by
+// numId. Reads only the id column; for error reports on territories that did
+// not come through ParseBuffer (territories.bin hits, journal replays).
+void ScanIdLines(const char* data, size_t size, std::vector<IdLine>& out);
+
+// Parses a whole territories.txt buffer. maxThreads: 0 = hardware
+// concurrency (capped at kMaxParseThreads), 1 = always serial.
+bool ParseBuffer(const char* data, size_t size, std::vector<Territory>& out,
+                 std::string& outErr, int maxThreads = 0);
+
+} // namespace TerritoryFileParser
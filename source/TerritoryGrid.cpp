@@ -0,0 +1,467 @@
+#include "TerritoryGrid.h"
+#include "TerritorySystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void TerritoryGrid::Clear() {
+    m_count = 0;
+    m_cellsX = 0;
+    m_cellsY = 0;
+    m_rectStart.clear();
+    m_rects.clear();
+    m_centerStart.clear();
+    m_centers.clear();
+}
+
+void TerritoryGrid::Build(const std::vector<Territory>& territories) {
+    BuildFrom(territories, nullptr, (int)territories.size());
+}
+
+void TerritoryGrid::Build(const std::vector<Territory>& territories, const std::vector<int>& subset) {
+    BuildFrom(territories, subset.data(), (int)subset.size());
+}
+
+// subset == nullptr means every territory, in order.
+void TerritoryGrid::BuildFrom(const std::vector<Territory>& territories, const int* subset, int count) {
+    Clear();
+    if (count == 0) return;
+
+    m_count = count;
+    auto indexAt = [&](int k) { return subset ? subset[k] : k; };
+
+    // World bounds = union of all rects; extents feed the cell-size heuristic.
+    const Territory& first = territories[indexAt(0)];
+    float minX = first.minX, minY = first.minY;
+    float maxX = first.maxX, maxY = first.maxY;
+    double sumW = 0.0, sumH = 0.0;
+    for (int k = 0; k < count; ++k) {
+        const Territory& t = territories[indexAt(k)];
+        minX = std::min(minX, t.minX);
+        minY = std::min(minY, t.minY);
+        maxX = std::max(maxX, t.maxX);
+        maxY = std::max(maxY, t.maxY);
+        sumW += (double)(t.maxX - t.minX);
+        sumH += (double)(t.maxY - t.minY);
+    }
+
+    m_originX = minX;
+    m_originY = minY;
+    m_limitX = maxX;
+    m_limitY = maxY;
+
+    const float worldW = std::max(maxX - minX, 1.0f);
+    const float worldH = std::max(maxY - minY, 1.0f);
+
+    // Aim for roughly one territory per cell, but never make cells smaller than
+    // the average rect — otherwise big rects get registered in too many cells.
+    const float perRect = std::sqrt((worldW * worldH) / (float)m_count);
+    const float cellW = std::max({ perRect, (float)(sumW / m_count), 1.0f });
+    const float cellH = std::max({ perRect, (float)(sumH / m_count), 1.0f });
+
+    m_cellsX = std::clamp((int)std::ceil(worldW / cellW), 1, kMaxCellsPerAxis);
+    m_cellsY = std::clamp((int)std::ceil(worldH / cellH), 1, kMaxCellsPerAxis);
+    m_cellW = worldW / (float)m_cellsX;
+    m_cellH = worldH / (float)m_cellsY;
+    m_invCellW = 1.0f / m_cellW;
+    m_invCellH = 1.0f / m_cellH;
+
+    const int cellCount = m_cellsX * m_cellsY;
+
+    // Pass 1: count registrations per cell.
+    m_rectStart.assign(cellCount + 1, 0);
+    m_centerStart.assign(cellCount + 1, 0);
+    for (int k = 0; k < count; ++k) {
+        const Territory& t = territories[indexAt(k)];
+        const int x0 = CellX(t.minX), x1 = CellX(t.maxX);
+        const int y0 = CellY(t.minY), y1 = CellY(t.maxY);
+        for (int cy = y0; cy <= y1; ++cy)
+            for (int cx = x0; cx <= x1; ++cx)
+                ++m_rectStart[cy * m_cellsX + cx + 1];
+
+        const float cx = (t.minX + t.maxX) * 0.5f;
+        const float cy = (t.minY + t.maxY) * 0.5f;
+        ++m_centerStart[CellY(cy) * m_cellsX + CellX(cx) + 1];
+    }
+
+    for (int c = 0; c < cellCount; ++c) {
+        m_rectStart[c + 1] += m_rectStart[c];
+        m_centerStart[c + 1] += m_centerStart[c];
+    }
+
+    // Pass 2: fill. Territories are visited in file order (a subset is
+    // ascending), so every cell list is sorted by index and the first hit in
+    // QueryPoint is the lowest index.
+    m_rects.resize(m_rectStart[cellCount]);
+    m_centers.resize(m_centerStart[cellCount]);
+    std::vector<int> rectCursor(m_rectStart.begin(), m_rectStart.end() - 1);
+    std::vector<int> centerCursor(m_centerStart.begin(), m_centerStart.end() - 1);
+
+    for (int k = 0; k < count; ++k) {
+        const int i = indexAt(k);
+        const Territory& t = territories[i];
+        const int x0 = CellX(t.minX), x1 = CellX(t.maxX);
+        const int y0 = CellY(t.minY), y1 = CellY(t.maxY);
+        for (int cy = y0; cy <= y1; ++cy)
+            for (int cx = x0; cx <= x1; ++cx)
+                m_rects[rectCursor[cy * m_cellsX + cx]++] = RectEntry{ t.minX, t.minY, t.maxX, t.maxY, i };
+
+        const float cx = (t.minX + t.maxX) * 0.5f;
+        const float cy = (t.minY + t.maxY) * 0.5f;
+        m_centers[centerCursor[CellY(cy) * m_cellsX + CellX(cx)]++] = CenterEntry{ cx, cy, i };
+    }
+}
+
+// Clamped cell lookup. Written so NaN and far-out coordinates land on an edge
+// cell instead of overflowing the int conversion.
+int TerritoryGrid::CellX(float x) const {
+    const float f = (x - m_originX) * m_invCellW;
+    if (!(f > 0.0f)) return 0;
+    if (f >= (float)m_cellsX) return m_cellsX - 1;
+    return (int)f;
+}
+
+int TerritoryGrid::CellY(float y) const {
+    const float f = (y - m_originY) * m_invCellH;
+    if (!(f > 0.0f)) return 0;
+    if (f >= (float)m_cellsY) return m_cellsY - 1;
+    return (int)f;
+}
+
+int TerritoryGrid::QueryPoint(float x, float y, int from) const {
+    if (m_count == 0) return -1;
+    if (!(x >= m_originX && x <= m_limitX && y >= m_originY && y <= m_limitY)) return -1;
+
+    const int c = CellY(y) * m_cellsX + CellX(x);
+    for (int i = m_rectStart[c], end = m_rectStart[c + 1]; i < end; ++i) {
+        const RectEntry& e = m_rects[i];
+        if (e.index < from) continue;
+        // Same comparison as Territory::ContainsPoint (edges inclusive).
+        if (x >= e.minX && x <= e.maxX && y >= e.minY && y <= e.maxY) return e.index;
+    }
+    return -1;
+}
+
+void TerritoryGrid::QueryRect(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const {
+    out.clear();
+    if (m_count == 0) return;
+    if (minX > maxX) std::swap(minX, maxX);
+    if (minY > maxY) std::swap(minY, maxY);
+    if (maxX < m_originX || minX > m_limitX || maxY < m_originY || minY > m_limitY) return;
+
+    const int x0 = CellX(minX), x1 = CellX(maxX);
+    const int y0 = CellY(minY), y1 = CellY(maxY);
+
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const int c = cy * m_cellsX + cx;
+            for (int i = m_rectStart[c], end = m_rectStart[c + 1]; i < end; ++i) {
+                const RectEntry& e = m_rects[i];
+                if (!(e.minX <= maxX && e.maxX >= minX && e.minY <= maxY && e.maxY >= minY)) continue;
+
+                // A rect registered in several cells is reported only from the
+                // first cell it shares with the query window.
+                if (cx != std::max(x0, CellX(e.minX)) || cy != std::max(y0, CellY(e.minY))) continue;
+                out.push_back(e.index);
+            }
+        }
+    }
+
+    if (x0 != x1 || y0 != y1) std::sort(out.begin(), out.end());
+}
+
+int TerritoryGrid::QueryNearest(float x, float y) const {
+    if (m_count == 0) return -1;
+
+    const int cx0 = CellX(x);
+    const int cy0 = CellY(y);
+    const float minCell = std::min(m_cellW, m_cellH);
+    const int maxRing = std::max(m_cellsX, m_cellsY);
+
+    int best = -1;
+    float bestD2 = 0.0f;
+
+    for (int r = 0; r <= maxRing; ++r) {
+        // Every cell in ring r is at least (r - 1) whole cells away from the query.
+        if (best >= 0 && r > 0) {
+            const float bound = (float)(r - 1) * minCell;
+            if (bestD2 < bound * bound) break;
+        }
+
+        for (int cy = cy0 - r; cy <= cy0 + r; ++cy) {
+            if (cy < 0 || cy >= m_cellsY) continue;
+            const bool edgeRow = (cy == cy0 - r || cy == cy0 + r);
+            const int step = edgeRow ? 1 : std::max(2 * r, 1);
+
+            for (int cx = cx0 - r; cx <= cx0 + r; cx += step) {
+                if (cx < 0 || cx >= m_cellsX) continue;
+                const int c = cy * m_cellsX + cx;
+                for (int i = m_centerStart[c], end = m_centerStart[c + 1]; i < end; ++i) {
+                    const CenterEntry& e = m_centers[i];
+                    const float dx = x - e.x;
+                    const float dy = y - e.y;
+                    const float d2 = dx * dx + dy * dy;
+                    if (best < 0 || d2 < bestD2 || (d2 == bestD2 && e.index < best)) {
+                        best = e.index;
+                        bestD2 = d2;
+                    }
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+// ------------------------------------------------------------
+// Incremental edits
+// ------------------------------------------------------------
+bool TerritoryGrid::Covers(const Territory& t) const {
+    return m_count > 0 &&
+        t.minX >= m_originX && t.maxX <= m_limitX &&
+        t.minY >= m_originY && t.maxY <= m_limitY;
+}
+
+template <typename Entry, typename AddsTo>
+void TerritoryGrid::SpliceList(const std::vector<int>& start, const std::vector<Entry>& in,
+    std::vector<int>& outStart, std::vector<Entry>& out, const std::vector<int>* touched,
+    int removeIndex, bool renumber, const Entry& add, AddsTo addsTo)
+{
+    const int cellCount = (int)start.size() - 1;
+    outStart.resize(cellCount + 1);
+    out.clear();
+    out.reserve(in.size() + 16);
+
+    auto walk = [&](int c) {
+        outStart[c] = (int)out.size();
+        bool placed = !addsTo(c);
+        for (int i = start[c], end = start[c + 1]; i < end; ++i) {
+            Entry e = in[i];
+            if (e.index == removeIndex) continue;
+            if (renumber && e.index > removeIndex) --e.index;
+            if (!placed && e.index > add.index) { out.push_back(add); placed = true; }
+            out.push_back(e);
+        }
+        if (!placed) out.push_back(add);
+    };
+
+    // Cells [c0, c1) are unaffected: one block copy, offsets shifted by the
+    // entries added or dropped so far.
+    auto copyCells = [&](int c0, int c1) {
+        if (c0 >= c1) return;
+        const int delta = (int)out.size() - start[c0];
+        for (int c = c0; c < c1; ++c) outStart[c] = start[c] + delta;
+        out.insert(out.end(), in.begin() + start[c0], in.begin() + start[c1]);
+    };
+
+    if (!touched) {
+        for (int c = 0; c < cellCount; ++c) walk(c);
+    } else {
+        int next = 0;
+        for (int c : *touched) {
+            copyCells(next, c);
+            walk(c);
+            next = c + 1;
+        }
+        copyCells(next, cellCount);
+    }
+    outStart[cellCount] = (int)out.size();
+}
+
+void TerritoryGrid::Splice(const Territory* removed, int removeIndex, bool renumber,
+    const Territory* add, int addIndex)
+{
+    // Cell spans; empty unless there is something to add.
+    int ax0 = 1, ax1 = 0, ay0 = 1, ay1 = 0, addCenterCell = -1;
+    RectEntry addRect{ 0, 0, 0, 0, addIndex };
+    CenterEntry addCenter{ 0, 0, addIndex };
+    if (add) {
+        ax0 = CellX(add->minX); ax1 = CellX(add->maxX);
+        ay0 = CellY(add->minY); ay1 = CellY(add->maxY);
+        addRect = RectEntry{ add->minX, add->minY, add->maxX, add->maxY, addIndex };
+        addCenter = CenterEntry{ (add->minX + add->maxX) * 0.5f, (add->minY + add->maxY) * 0.5f, addIndex };
+        addCenterCell = CellY(addCenter.y) * m_cellsX + CellX(addCenter.x);
+    }
+
+    // Renumbering touches every entry anyway; otherwise only the cells the
+    // removed and added rects cover have to be walked.
+    std::vector<int> rectCells, centerCells;
+    if (!renumber) {
+        auto addSpan = [&](int x0, int x1, int y0, int y1) {
+            for (int cy = y0; cy <= y1; ++cy)
+                for (int cx = x0; cx <= x1; ++cx) rectCells.push_back(cy * m_cellsX + cx);
+        };
+        addSpan(ax0, ax1, ay0, ay1);
+        if (add) centerCells.push_back(addCenterCell);
+        if (removed) {
+            addSpan(CellX(removed->minX), CellX(removed->maxX), CellY(removed->minY), CellY(removed->maxY));
+            centerCells.push_back(CellY((removed->minY + removed->maxY) * 0.5f) * m_cellsX +
+                                  CellX((removed->minX + removed->maxX) * 0.5f));
+        }
+        for (auto* cells : { &rectCells, &centerCells }) {
+            std::sort(cells->begin(), cells->end());
+            cells->erase(std::unique(cells->begin(), cells->end()), cells->end());
+        }
+    }
+
+    SpliceList(m_rectStart, m_rects, m_spliceRectStart, m_spliceRects,
+        renumber ? nullptr : &rectCells, removeIndex, renumber, addRect,
+        [&](int c) {
+            const int cx = c % m_cellsX, cy = c / m_cellsX;
+            return cx >= ax0 && cx <= ax1 && cy >= ay0 && cy <= ay1;
+        });
+    SpliceList(m_centerStart, m_centers, m_spliceCenterStart, m_spliceCenters,
+        renumber ? nullptr : &centerCells, removeIndex, renumber, addCenter,
+        [&](int c) { return c == addCenterCell; });
+
+    m_rectStart.swap(m_spliceRectStart);
+    m_rects.swap(m_spliceRects);
+    m_centerStart.swap(m_spliceCenterStart);
+    m_centers.swap(m_spliceCenters);
+}
+
+bool TerritoryGrid::Update(int index, const Territory& before, const Territory& after) {
+    if (index < 0 || index >= m_count || !Covers(after)) return false;
+
+    const float bcx = (before.minX + before.maxX) * 0.5f, bcy = (before.minY + before.maxY) * 0.5f;
+    const float acx = (after.minX + after.maxX) * 0.5f,   acy = (after.minY + after.maxY) * 0.5f;
+
+    const bool sameCells =
+        CellX(before.minX) == CellX(after.minX) && CellX(before.maxX) == CellX(after.maxX) &&
+        CellY(before.minY) == CellY(after.minY) && CellY(before.maxY) == CellY(after.maxY) &&
+        CellX(bcx) == CellX(acx) && CellY(bcy) == CellY(acy);
+
+    if (!sameCells) {
+        Splice(&before, index, false, &after, index);
+        return true;
+    }
+
+    // Same cell coverage: patch the copied bounds where they sit.
+    for (int cy = CellY(after.minY), y1 = CellY(after.maxY); cy <= y1; ++cy) {
+        for (int cx = CellX(after.minX), x1 = CellX(after.maxX); cx <= x1; ++cx) {
+            const int c = cy * m_cellsX + cx;
+            for (int i = m_rectStart[c], end = m_rectStart[c + 1]; i < end; ++i) {
+                if (m_rects[i].index == index) {
+                    m_rects[i] = RectEntry{ after.minX, after.minY, after.maxX, after.maxY, index };
+                    break;
+                }
+            }
+        }
+    }
+    const int c = CellY(acy) * m_cellsX + CellX(acx);
+    for (int i = m_centerStart[c], end = m_centerStart[c + 1]; i < end; ++i) {
+        if (m_centers[i].index == index) {
+            m_centers[i] = CenterEntry{ acx, acy, index };
+            break;
+        }
+    }
+    return true;
+}
+
+bool TerritoryGrid::Append(const Territory& t) {
+    if (!Covers(t)) return false;
+    Splice(nullptr, -1, false, &t, m_count);
+    ++m_count;
+    return true;
+}
+
+void TerritoryGrid::Erase(int index) {
+    if (index < 0 || index >= m_count) return;
+    if (m_count == 1) { Clear(); return; }
+    Splice(nullptr, index, true, nullptr, -1);
+    --m_count;
+}
+
+// ------------------------------------------------------------
+// Serialization
+// ------------------------------------------------------------
+namespace {
+
+struct GridImageHeader {
+    int   count, cellsX, cellsY;
+    float originX, originY, limitX, limitY;
+    float cellW, cellH, invCellW, invCellH;
+    int   rectCount, centerCount;
+};
+
+template <typename T>
+void AppendRaw(std::vector<unsigned char>& out, const T* src, size_t n) {
+    const unsigned char* p = (const unsigned char*)src;
+    out.insert(out.end(), p, p + n * sizeof(T));
+}
+
+template <typename T>
+bool ReadRaw(const unsigned char*& p, const unsigned char* end, std::vector<T>& dst, size_t n) {
+    if ((size_t)(end - p) < n * sizeof(T)) return false;
+    dst.resize(n);
+    if (n) std::memcpy(dst.data(), p, n * sizeof(T));
+    p += n * sizeof(T);
+    return true;
+}
+
+} // namespace
+
+void TerritoryGrid::Serialize(std::vector<unsigned char>& out) const {
+    GridImageHeader h;
+    h.count = m_count;
+    h.cellsX = m_cellsX;
+    h.cellsY = m_cellsY;
+    h.originX = m_originX; h.originY = m_originY;
+    h.limitX = m_limitX;   h.limitY = m_limitY;
+    h.cellW = m_cellW;     h.cellH = m_cellH;
+    h.invCellW = m_invCellW; h.invCellH = m_invCellH;
+    h.rectCount = (int)m_rects.size();
+    h.centerCount = (int)m_centers.size();
+
+    AppendRaw(out, &h, 1);
+    AppendRaw(out, m_rectStart.data(), m_rectStart.size());
+    AppendRaw(out, m_rects.data(), m_rects.size());
+    AppendRaw(out, m_centerStart.data(), m_centerStart.size());
+    AppendRaw(out, m_centers.data(), m_centers.size());
+}
+
+bool TerritoryGrid::Deserialize(const unsigned char* data, size_t size, int territoryCount) {
+    Clear();
+
+    GridImageHeader h;
+    if (!data || size < sizeof(h)) return false;
+    std::memcpy(&h, data, sizeof(h));
+
+    if (h.count != territoryCount || h.count <= 0) return false;
+    if (h.cellsX < 1 || h.cellsX > kMaxCellsPerAxis || h.cellsY < 1 || h.cellsY > kMaxCellsPerAxis) return false;
+    if (h.rectCount < h.count || h.centerCount != h.count) return false;
+
+    const size_t cellCount = (size_t)h.cellsX * (size_t)h.cellsY;
+    const unsigned char* p = data + sizeof(h);
+    const unsigned char* end = data + size;
+
+    bool ok = ReadRaw(p, end, m_rectStart, cellCount + 1)
+           && ReadRaw(p, end, m_rects, (size_t)h.rectCount)
+           && ReadRaw(p, end, m_centerStart, cellCount + 1)
+           && ReadRaw(p, end, m_centers, (size_t)h.centerCount);
+
+    // CSR offsets must be monotonic and end at the entry count, and every
+    // entry must point at a real territory, or queries could read past the end.
+    ok = ok && m_rectStart[0] == 0 && m_rectStart[cellCount] == h.rectCount
+            && m_centerStart[0] == 0 && m_centerStart[cellCount] == h.centerCount;
+    for (size_t c = 0; ok && c < cellCount; ++c) {
+        ok = m_rectStart[c] <= m_rectStart[c + 1] && m_centerStart[c] <= m_centerStart[c + 1];
+    }
+    for (size_t i = 0; ok && i < m_rects.size(); ++i) ok = m_rects[i].index >= 0 && m_rects[i].index < h.count;
+    for (size_t i = 0; ok && i < m_centers.size(); ++i) ok = m_centers[i].index >= 0 && m_centers[i].index < h.count;
+
+    if (!ok) {
+        Clear();
+        return false;
+    }
+
+    m_count = h.count;
+    m_cellsX = h.cellsX;
+    m_cellsY = h.cellsY;
+    m_originX = h.originX; m_originY = h.originY;
+    m_limitX = h.limitX;   m_limitY = h.limitY;
+    m_cellW = h.cellW;     m_cellH = h.cellH;
+    m_invCellW = h.invCellW; m_invCellH = h.invCellH;
+    return true;
+}
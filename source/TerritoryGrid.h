@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Uniform-grid spatial index over territory rectangles.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Built once from the territory list (load, hot reload, editor commit) and
+// queried many times per frame. Query results are indices into the vector
+// that was passed to Build(); the index must be rebuilt (or patched with
+// Update/Erase/Append) whenever that vector changes.
+//
+// Result semantics match the linear scans they replace:
+//   QueryPoint   — lowest index (>= from) whose rect contains the point (edges inclusive)
+//   QueryRect    — every index whose rect overlaps the query rect, ascending
+//   QueryNearest — index whose rect CENTER is closest; ties go to the lowest index
+
+struct Territory;
+
+class TerritoryGrid {
+public:
+    static constexpr int kMaxCellsPerAxis = 1024;
+
+    void Build(const std::vector<Territory>& territories);
+    // Indexes only territories[subset[k]] (subset ascending); queries still
+    // return indices into territories. Subset grids are rebuilt, not patched
+    // or serialized: Count() is the subset size.
+    void Build(const std::vector<Territory>& territories, const std::vector<int>& subset);
+    void Clear();
+
+    // Incremental edits for hot reload. Each one keeps query results identical
+    // to a fresh Build over the edited vector; cost is one pass over the cell
+    // lists (or just the covered cells when a rect stays in the same cells).
+    // Update/Append return false without touching the grid when the rect
+    // reaches outside the built extents — the caller must Build() instead.
+    bool Update(int index, const Territory& before, const Territory& after);
+    bool Append(const Territory& t); // registers t as index Count()
+    void Erase(int index);           // indices above it shift down by one
+
+    // from lets a caller with a finer test (polygon outlines) continue past
+    // a box hit that its own test rejected.
+    int  QueryPoint(float x, float y, int from = 0) const;
+    void QueryRect(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const;
+    int  QueryNearest(float x, float y) const;
+
+    // Flat little-endian image of the built grid, for the territories.bin
+    // cache. Deserialize validates sizes and index ranges against
+    // territoryCount and leaves the grid empty on failure.
+    void Serialize(std::vector<unsigned char>& out) const;
+    bool Deserialize(const unsigned char* data, size_t size, int territoryCount);
+
+    bool IsEmpty()    const { return m_count == 0; }
+    int  Count()      const { return m_count; }
+    int  CellsX()     const { return m_cellsX; }
+    int  CellsY()     const { return m_cellsY; }
+
+private:
+    // Bounds are copied into the cell lists so a query only touches
+    // contiguous memory for the one cell it lands in.
+    struct RectEntry   { float minX, minY, maxX, maxY; int index; };
+    struct CenterEntry { float x, y; int index; };
+
+    int   m_count  = 0;
+    int   m_cellsX = 0;
+    int   m_cellsY = 0;
+    float m_originX = 0.0f, m_originY = 0.0f;
+    float m_limitX  = 0.0f, m_limitY  = 0.0f;
+    float m_cellW   = 1.0f, m_cellH   = 1.0f;
+    float m_invCellW = 1.0f, m_invCellH = 1.0f;
+
+    // CSR layout: cell c owns entries [start[c], start[c + 1]).
+    std::vector<int>         m_rectStart;
+    std::vector<RectEntry>   m_rects;
+    std::vector<int>         m_centerStart;
+    std::vector<CenterEntry> m_centers;
+
+    // Splice() output, swapped with the live lists so repeated edits reuse
+    // the allocations.
+    std::vector<int>         m_spliceRectStart;
+    std::vector<RectEntry>   m_spliceRects;
+    std::vector<int>         m_spliceCenterStart;
+    std::vector<CenterEntry> m_spliceCenters;
+
+    void BuildFrom(const std::vector<Territory>& territories, const int* subset, int count);
+    int CellX(float x) const;
+    int CellY(float y) const;
+    bool Covers(const Territory& t) const;
+
+    // Rewrites the cell lists: drops removeIndex (-1 = none) and inserts add
+    // (may be null) as addIndex, keeping every cell sorted by index. Only the
+    // cells covered by removed/add are walked; the rest is block-copied. With
+    // renumber set, every cell is walked and indices above removeIndex shift
+    // down by one.
+    void Splice(const Territory* removed, int removeIndex, bool renumber,
+        const Territory* add, int addIndex);
+
+    template <typename Entry, typename AddsTo>
+    static void SpliceList(const std::vector<int>& start, const std::vector<Entry>& in,
+        std::vector<int>& outStart, std::vector<Entry>& out, const std::vector<int>* touched,
+        int removeIndex, bool renumber, const Entry& add, AddsTo addsTo);
+};
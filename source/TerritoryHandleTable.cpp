@@ -0,0 +1,88 @@
+#include "TerritoryHandleTable.h"
+#include "TerritorySystem.h"
+
+int TerritoryHandleTable::AllocSlot(unsigned int id, int index) {
+    int s;
+    if (!m_freeSlots.empty()) {
+        s = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        s = (int)m_slots.size();
+        m_slots.push_back(Slot{ 0u, 1u, -1, false });
+    }
+
+    Slot& slot = m_slots[s];
+    slot.id = id;
+    slot.index = index;
+    slot.live = true;
+    return s;
+}
+
+void TerritoryHandleTable::Sync(const std::vector<Territory>& territories) {
+    const int n = (int)territories.size();
+
+    // Unbind everything; surviving ids claim their slot back below.
+    for (Slot& slot : m_slots) slot.index = -1;
+    m_slotOfIndex.assign(n, -1);
+
+    std::vector<int> pending;
+    for (int i = 0; i < n; ++i) {
+        const int s = m_slotOfId.Find(territories[i].numId);
+        if (s >= 0 && m_slots[s].live && m_slots[s].index < 0) {
+            m_slots[s].index = i;
+            m_slotOfIndex[i] = s;
+        } else {
+            pending.push_back(i);
+        }
+    }
+
+    // Release slots whose id is gone before handing out new ones, so the
+    // table does not grow across repeated add/remove edits.
+    for (int s = 0; s < (int)m_slots.size(); ++s) {
+        Slot& slot = m_slots[s];
+        if (slot.live && slot.index < 0) {
+            slot.live = false;
+            ++slot.generation;
+            m_freeSlots.push_back(s);
+        }
+    }
+
+    for (int i : pending) {
+        m_slotOfIndex[i] = AllocSlot(territories[i].numId, i);
+    }
+
+    // Duplicate ids (rejected by the loader anyway) get their own slot but
+    // only the first one is reachable by id.
+    m_slotOfId.Clear();
+    for (int i = 0; i < n; ++i) {
+        m_slotOfId.Insert(territories[i].numId, m_slotOfIndex[i]);
+    }
+}
+
+void TerritoryHandleTable::Clear() {
+    Sync(std::vector<Territory>());
+}
+
+int TerritoryHandleTable::IndexOf(TerritoryHandle h) const {
+    if (h.slot < 0 || h.slot >= (int)m_slots.size()) return -1;
+    const Slot& slot = m_slots[h.slot];
+    if (!slot.live || slot.generation != h.generation) return -1;
+    return slot.index;
+}
+
+TerritoryHandle TerritoryHandleTable::HandleAt(int index) const {
+    TerritoryHandle h;
+    if (index < 0 || index >= (int)m_slotOfIndex.size()) return h;
+    h.slot = m_slotOfIndex[index];
+    h.generation = m_slots[h.slot].generation;
+    return h;
+}
+
+TerritoryHandle TerritoryHandleTable::HandleForId(unsigned int id) const {
+    TerritoryHandle h;
+    const int s = m_slotOfId.Find(id);
+    if (s < 0) return h;
+    h.slot = s;
+    h.generation = m_slots[s].generation;
+    return h;
+}
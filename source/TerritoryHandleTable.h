@@ -0,0 +1,60 @@
+#pragma once
+#include "TerritoryIdIndex.h"
+
+#include <vector>
+
+// Generation-checked handles to territories that survive list rebuilds.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Each territory id owns a slot for as long as it stays in the list. Sync()
+// is called after every rebuild (hot reload, editor commit/delete) and
+// re-points surviving slots at their new vector index, so a handle taken
+// before a reload still resolves afterwards. When an id disappears its slot
+// is freed and the generation bumped; old handles to it then resolve to -1
+// instead of aliasing whatever territory reuses the slot.
+
+struct Territory;
+
+struct TerritoryHandle {
+    int slot = -1;
+    unsigned int generation = 0;
+
+    bool IsValid() const { return slot >= 0; }
+    bool operator==(const TerritoryHandle& o) const { return slot == o.slot && generation == o.generation; }
+    bool operator!=(const TerritoryHandle& o) const { return !(*this == o); }
+};
+
+class TerritoryHandleTable {
+public:
+    // Re-binds slots to territories[i] by numId. Ids seen before keep their
+    // slot and generation; vanished ids are released.
+    void Sync(const std::vector<Territory>& territories);
+
+    // Releases every slot (generations still advance, so no old handle
+    // becomes valid again after a later Sync).
+    void Clear();
+
+    // Vector index the handle currently points at, or -1 if stale/invalid.
+    int IndexOf(TerritoryHandle h) const;
+
+    TerritoryHandle HandleAt(int index) const;
+    TerritoryHandle HandleForId(unsigned int id) const;
+
+    // Upper bound on slot numbers, for callers keeping per-slot arrays.
+    int SlotCount() const { return (int)m_slots.size(); }
+
+private:
+    struct Slot {
+        unsigned int id;
+        unsigned int generation;
+        int index;  // -1 = not bound to a territory
+        bool live;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<int>  m_freeSlots;
+    std::vector<int>  m_slotOfIndex;
+    TerritoryIdIndex  m_slotOfId;
+
+    int AllocSlot(unsigned int id, int index);
+};
@@ -0,0 +1,85 @@
+#include "TerritoryIdIndex.h"
+#include "TerritorySystem.h"
+
+bool ParseTerritoryId(const char* s, size_t len, unsigned int& outId) {
+    if (!s || len == 0) return false;
+
+    unsigned long long v = 0;
+    for (size_t i = 0; i < len; ++i) {
+        const char c = s[i];
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (unsigned int)(c - '0');
+        if (v > 0xFFFFFFFFull) return false;
+    }
+    outId = (unsigned int)v;
+    return true;
+}
+
+// murmur3 finalizer: sequential ids (1001, 1002, ...) spread across the table.
+unsigned int TerritoryIdIndex::Hash(unsigned int id) {
+    id ^= id >> 16;
+    id *= 0x85EBCA6Bu;
+    id ^= id >> 13;
+    id *= 0xC2B2AE35u;
+    id ^= id >> 16;
+    return id;
+}
+
+void TerritoryIdIndex::Clear() {
+    m_slots.clear();
+    m_mask = 0;
+    m_count = 0;
+}
+
+void TerritoryIdIndex::Rehash(size_t capacity) {
+    std::vector<Slot> old;
+    old.swap(m_slots);
+
+    m_slots.assign(capacity, Slot{ 0u, -1 });
+    m_mask = (unsigned int)(capacity - 1);
+    m_count = 0;
+
+    for (const Slot& s : old) {
+        if (s.index >= 0) Insert(s.key, s.index);
+    }
+}
+
+void TerritoryIdIndex::Build(const std::vector<Territory>& territories) {
+    size_t capacity = 16;
+    while (capacity < territories.size() * 2) capacity <<= 1;
+
+    m_slots.assign(capacity, Slot{ 0u, -1 });
+    m_mask = (unsigned int)(capacity - 1);
+    m_count = 0;
+
+    for (int i = 0; i < (int)territories.size(); ++i) {
+        Insert(territories[i].numId, i);
+    }
+}
+
+bool TerritoryIdIndex::Insert(unsigned int id, int index) {
+    if (m_slots.empty() || (size_t)(m_count + 1) * 2 > m_slots.size()) {
+        Rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+    }
+
+    unsigned int pos = Hash(id) & m_mask;
+    while (m_slots[pos].index >= 0) {
+        if (m_slots[pos].key == id) return false;
+        pos = (pos + 1) & m_mask;
+    }
+
+    m_slots[pos] = Slot{ id, index };
+    ++m_count;
+    return true;
+}
+
+int TerritoryIdIndex::Find(unsigned int id) const {
+    if (m_slots.empty()) return -1;
+
+    unsigned int pos = Hash(id) & m_mask;
+    while (m_slots[pos].index >= 0) {
+        if (m_slots[pos].key == id) return m_slots[pos].index;
+        pos = (pos + 1) & m_mask;
+    }
+    return -1;
+}
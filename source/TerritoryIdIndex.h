@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Open-addressed numeric territory id -> vector index table.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// territories.txt ids are required to be all digits, so the loader parses
+// them once into Territory::numId and every by-id lookup after that is a
+// hash probe instead of a std::string compare over the whole vector.
+// Linear probing, power-of-two capacity, load factor <= 0.5.
+
+struct Territory;
+
+// Parses a territory id ("1001") into outId. Rejects empty input, non-digits
+// and values that do not fit in 32 bits.
+bool ParseTerritoryId(const char* s, size_t len, unsigned int& outId);
+
+class TerritoryIdIndex {
+public:
+    // Indexes territories[i].numId -> i. If an id repeats, the first one wins
+    // (the loader rejects duplicates before this is ever built).
+    void Build(const std::vector<Territory>& territories);
+    void Clear();
+
+    // Returns false (and leaves the table unchanged) if id is already present.
+    bool Insert(unsigned int id, int index);
+
+    // Vector index for id, or -1.
+    int Find(unsigned int id) const;
+
+    int Count() const { return m_count; }
+
+private:
+    struct Slot {
+        unsigned int key;
+        int index; // -1 = empty
+    };
+
+    std::vector<Slot> m_slots;
+    unsigned int m_mask = 0;
+    int m_count = 0;
+
+    static unsigned int Hash(unsigned int id);
+    void Rehash(size_t capacity);
+};
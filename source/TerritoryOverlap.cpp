@@ -0,0 +1,214 @@
+#include "TerritoryOverlap.h"
+#include "TerritorySystem.h"
+
+#include <algorithm>
+
+namespace TerritoryOverlap {
+
+namespace {
+
+constexpr int kMaxBuckets = 4096;
+
+struct Pt { double x, y; };
+
+// Convex pieces of one shape, flattened: piece k is pts[start[k], start[k + 1]).
+struct Pieces {
+    std::vector<Pt> pts;
+    std::vector<int> start;
+    int Count() const { return (int)start.size() - 1; }
+};
+
+// Reused across every pair of one Find() so the sweep does not allocate per test.
+struct Scratch {
+    Pieces a, b;
+    std::vector<Pt> poly, buf;
+};
+
+// Convex pieces of a territory's shape, counter-clockwise.
+void BuildPieces(const Territory& t, Pieces& out) {
+    out.pts.clear();
+    out.start.assign(1, 0);
+    const TerritoryPolygon& p = t.poly;
+    if (p.Empty()) {
+        out.pts.insert(out.pts.end(), { { t.minX, t.minY }, { t.maxX, t.minY }, { t.maxX, t.maxY }, { t.minX, t.maxY } });
+        out.start.push_back((int)out.pts.size());
+        return;
+    }
+    if (p.IsConvex()) {
+        for (int v = 0; v < p.VertexCount(); ++v) out.pts.push_back({ p.X()[v], p.Y()[v] });
+        out.start.push_back((int)out.pts.size());
+        return;
+    }
+    const auto& tris = p.Triangles();
+    for (size_t k = 0; k + 2 < tris.size(); k += 3) {
+        for (size_t c = 0; c < 3; ++c) out.pts.push_back({ p.X()[tris[k + c]], p.Y()[tris[k + c]] });
+        out.start.push_back((int)out.pts.size());
+    }
+}
+
+double Cross(const Pt& o, const Pt& a, const Pt& b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// Area of subject clipped to the convex, counter-clockwise clip polygon
+// (Sutherland-Hodgman).
+double ClippedArea(const Pt* subject, int subjectCount, const Pt* clip, int clipCount, Scratch& s) {
+    std::vector<Pt>& poly = s.poly;
+    poly.assign(subject, subject + subjectCount);
+    for (int e = 0; e < clipCount && !poly.empty(); ++e) {
+        const Pt& c0 = clip[e];
+        const Pt& c1 = clip[(e + 1) % clipCount];
+        s.buf.clear();
+        for (size_t i = 0; i < poly.size(); ++i) {
+            const Pt& p = poly[i];
+            const Pt& q = poly[(i + 1) % poly.size()];
+            const double sp = Cross(c0, c1, p);
+            const double sq = Cross(c0, c1, q);
+            if (sp >= 0.0) s.buf.push_back(p);
+            if ((sp >= 0.0) != (sq >= 0.0)) {
+                const double t = sp / (sp - sq);
+                s.buf.push_back({ p.x + (q.x - p.x) * t, p.y + (q.y - p.y) * t });
+            }
+        }
+        poly.swap(s.buf);
+    }
+    double area2 = 0.0;
+    for (size_t i = 0; i < poly.size(); ++i) {
+        const Pt& p = poly[i];
+        const Pt& q = poly[(i + 1) % poly.size()];
+        area2 += p.x * q.y - q.x * p.y;
+    }
+    return area2 * 0.5;
+}
+
+void PieceBox(const Pt* piece, int count, double box[4]) {
+    box[0] = box[2] = piece[0].x;
+    box[1] = box[3] = piece[0].y;
+    for (int i = 1; i < count; ++i) {
+        box[0] = std::min(box[0], piece[i].x); box[2] = std::max(box[2], piece[i].x);
+        box[1] = std::min(box[1], piece[i].y); box[3] = std::max(box[3], piece[i].y);
+    }
+}
+
+bool ShapesOverlap(const Territory& a, const Territory& b, Scratch& s) {
+    if (a.poly.Empty() && b.poly.Empty()) {
+        return a.minX < b.maxX && b.minX < a.maxX && a.minY < b.maxY && b.minY < a.maxY;
+    }
+
+    BuildPieces(a, s.a);
+    BuildPieces(b, s.b);
+
+    double shared = 0.0;
+    double ba[4], bb[4];
+    for (int i = 0; i < s.a.Count(); ++i) {
+        const Pt* x = s.a.pts.data() + s.a.start[i];
+        const int xn = s.a.start[i + 1] - s.a.start[i];
+        PieceBox(x, xn, ba);
+        for (int j = 0; j < s.b.Count(); ++j) {
+            const Pt* y = s.b.pts.data() + s.b.start[j];
+            const int yn = s.b.start[j + 1] - s.b.start[j];
+            PieceBox(y, yn, bb);
+            if (ba[0] >= bb[2] || bb[0] >= ba[2] || ba[1] >= bb[3] || bb[1] >= ba[3]) continue;
+            shared += ClippedArea(x, xn, y, yn, s);
+            if (shared > kMinSharedArea) return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool ShapesOverlap(const Territory& a, const Territory& b) {
+    Scratch s;
+    return ShapesOverlap(a, b, s);
+}
+
+void Find(const std::vector<Territory>& terrs, std::vector<Pair>& out) {
+    out.clear();
+    const int n = (int)terrs.size();
+    if (n < 2) return;
+
+    // The sweep only touches this compact copy, in sweep order; Territory
+    // itself is read again only for pairs involving an outline.
+    struct Box {
+        float minX, minY, maxX, maxY;
+        int index;
+        bool outline;
+    };
+    std::vector<Box> boxes(n);
+    float lo = terrs[0].minY, hi = terrs[0].maxY;
+    double sumH = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const Territory& t = terrs[i];
+        boxes[i] = Box{ t.minX, t.minY, t.maxX, t.maxY, i, !t.poly.Empty() };
+        lo = std::min(lo, t.minY);
+        hi = std::max(hi, t.maxY);
+        sumH += t.maxY - t.minY;
+    }
+    std::sort(boxes.begin(), boxes.end(), [](const Box& x, const Box& y) {
+        return x.minX != y.minX ? x.minX < y.minX : x.index < y.index;
+    });
+
+    const float span = hi - lo;
+    const float bucketH = std::max({ (float)(sumH / n), span / (float)kMaxBuckets, 1e-3f });
+    const int buckets = std::min(kMaxBuckets, (int)(span / bucketH) + 1);
+    auto bucketOf = [&](float y) {
+        const int b = (int)((y - lo) / bucketH);
+        return b < 0 ? 0 : (b >= buckets ? buckets - 1 : b);
+    };
+
+    // Active entries are positions in boxes.
+    std::vector<std::vector<int>> active(buckets);
+    Scratch scratch;
+    for (int r = 0; r < n; ++r) {
+        const Box& a = boxes[r];
+        if (a.minX >= a.maxX || a.minY >= a.maxY) continue; // no interior
+        const int b0 = bucketOf(a.minY), b1 = bucketOf(a.maxY);
+        for (int b = b0; b <= b1; ++b) {
+            std::vector<int>& list = active[b];
+            for (size_t k = 0; k < list.size();) {
+                const Box& o = boxes[list[k]];
+                if (o.maxX <= a.minX) { // closed before the sweep got here
+                    list[k] = list.back();
+                    list.pop_back();
+                    continue;
+                }
+                ++k;
+                if (o.minY >= a.maxY || a.minY >= o.maxY) continue;
+                if (bucketOf(std::max(a.minY, o.minY)) != b) continue; // reported from another bucket
+                if ((a.outline || o.outline) && !ShapesOverlap(terrs[a.index], terrs[o.index], scratch)) continue;
+                out.push_back(Pair{ std::min(a.index, o.index), std::max(a.index, o.index) });
+            }
+            list.push_back(r);
+        }
+    }
+
+    // Counting sort on a, then each (short) run on b: linear in the pair
+    // count, where one comparison sort over every pair was not.
+    std::vector<int> first(n + 1, 0);
+    for (const Pair& p : out) ++first[p.a + 1];
+    for (int i = 0; i < n; ++i) first[i + 1] += first[i];
+    std::vector<Pair> sorted(out.size());
+    std::vector<int> fill(first.begin(), first.end() - 1);
+    for (const Pair& p : out) sorted[fill[p.a]++] = p;
+    for (int i = 0; i < n; ++i) {
+        std::sort(sorted.begin() + first[i], sorted.begin() + first[i + 1],
+            [](const Pair& x, const Pair& y) { return x.b < y.b; });
+    }
+    out.swap(sorted);
+}
+
+bool TakesPrecedence(const Territory& a, const Territory& b) {
+    if (a.priority != b.priority) return a.priority > b.priority;
+    return a.numId < b.numId;
+}
+
+void MarkOverlapping(int count, const std::vector<Pair>& pairs, std::vector<unsigned char>& flags) {
+    flags.assign(count, 0);
+    for (const Pair& p : pairs) {
+        flags[p.a] = 1;
+        flags[p.b] = 1;
+    }
+}
+
+} // namespace TerritoryOverlap
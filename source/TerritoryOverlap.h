@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+
+// Overlap validation and lookup precedence for territories.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Find() is a sweep over x (territories sorted by minX) with the active set
+// kept in y buckets about one average territory tall, so each territory is
+// only tested against the still-open ones that share a bucket with it:
+// O(n log n) for the sort plus roughly O(n + k) tests for k overlapping
+// pairs on hand-authored or generated layouts. A pair is reported from one
+// bucket only (the one holding the top of their shared y range).
+//
+// Overlap means a shared interior: rects that only touch along an edge or
+// at a corner do not overlap. When either side has an outline the boxes are
+// only the prefilter; the shapes are then clipped piece by piece (convex
+// outline or rect as one piece, concave outlines per triangle) and must
+// share more than kMinSharedArea.
+//
+// Where territories overlap, GetTerritoryAtPoint returns the one that
+// TakesPrecedence: higher priority first, then the lower numeric id, so the
+// answer never depends on file order.
+
+struct Territory;
+
+namespace TerritoryOverlap {
+
+constexpr double kMinSharedArea = 0.01; // world units squared
+
+struct Pair {
+    int a, b; // indices into the territory list, a < b
+};
+
+// Every overlapping pair, sorted by (a, b).
+void Find(const std::vector<Territory>& terrs, std::vector<Pair>& out);
+
+// Exact shape test for two territories whose boxes overlap.
+bool ShapesOverlap(const Territory& a, const Territory& b);
+
+bool TakesPrecedence(const Territory& a, const Territory& b);
+
+// flags[i] = 1 when territory i is in any pair; sized to count.
+void MarkOverlapping(int count, const std::vector<Pair>& pairs, std::vector<unsigned char>& flags);
+
+} // namespace TerritoryOverlap
@@ -0,0 +1,194 @@
+#include "TerritoryOwnershipIndex.h"
+#include "TerritorySystem.h"
+#include "AffiliationRule.h"
+
+#include <algorithm>
+
+int TerritoryOwnershipIndex::BucketOf(int ownerGang) {
+    if (ownerGang >= GANG1 && ownerGang <= GANG6) return ownerGang - GANG1;
+    if (ownerGang == OWNER_NEUTRAL) return kBucketNeutral;
+    if (ownerGang == OWNER_CLEARED) return kBucketCleared;
+    return kBucketOther;
+}
+
+unsigned int TerritoryOwnershipIndex::HostileGangMask(int act) {
+    unsigned int mask = 0;
+    for (int g = 0; g < kGangBuckets; ++g) {
+        if (IsGangHostileInAct(act, GANG1 + g)) mask |= 1u << g;
+    }
+    return mask;
+}
+
+unsigned int TerritoryOwnershipIndex::UnlockedIslandMask(int act) {
+    unsigned int mask = 0;
+    for (int i = 0; i < kIslandCount; ++i) {
+        if (IsIslandUnlocked((Island)i, act)) mask |= 1u << i;
+    }
+    return mask;
+}
+
+int TerritoryOwnershipIndex::PopCount(Word w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(w);
+#else
+    w = w - ((w >> 1) & 0x55555555u);
+    w = (w & 0x33333333u) + ((w >> 2) & 0x33333333u);
+    return (int)((((w + (w >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+}
+
+int TerritoryOwnershipIndex::CountBits(const std::vector<Word>& bits) {
+    int n = 0;
+    for (Word w : bits) n += PopCount(w);
+    return n;
+}
+
+void TerritoryOwnershipIndex::Clear() {
+    m_count = 0;
+    for (auto& b : m_ownerBits) b.clear();
+    for (auto& b : m_islandBits) b.clear();
+    m_bucket.clear();
+    m_area.clear();
+    std::fill(m_bucketCount, m_bucketCount + kBucketCount, 0);
+    std::fill(m_bucketArea, m_bucketArea + kBucketCount, 0.0);
+}
+
+void TerritoryOwnershipIndex::Build(const std::vector<Territory>& territories) {
+    Clear();
+    m_count = (int)territories.size();
+    const size_t words = (size_t)(m_count + kWordBits - 1) / kWordBits;
+    for (auto& b : m_ownerBits) b.assign(words, 0);
+    for (auto& b : m_islandBits) b.assign(words, 0);
+    m_bucket.resize(m_count);
+    m_area.resize(m_count);
+
+    for (int i = 0; i < m_count; ++i) {
+        const Territory& t = territories[i];
+        const Word bit = 1u << (i % kWordBits);
+        const int w = i / kWordBits;
+
+        const int bucket = BucketOf(t.ownerGang);
+        m_bucket[i] = (unsigned char)bucket;
+        m_area[i] = t.GetArea();
+        m_ownerBits[bucket][w] |= bit;
+        ++m_bucketCount[bucket];
+        m_bucketArea[bucket] += m_area[i];
+
+        const Island island = GetIslandForPosition((t.minX + t.maxX) * 0.5f, (t.minY + t.maxY) * 0.5f);
+        if (island != Island::UNKNOWN) m_islandBits[(int)island][w] |= bit;
+    }
+}
+
+void TerritoryOwnershipIndex::SetOwner(int index, int newOwner) {
+    if (index < 0 || index >= m_count) return;
+    const int from = m_bucket[index];
+    const int to = BucketOf(newOwner);
+    if (from == to) return;
+
+    const Word bit = 1u << (index % kWordBits);
+    const int w = index / kWordBits;
+    m_ownerBits[from][w] &= ~bit;
+    m_ownerBits[to][w] |= bit;
+    --m_bucketCount[from];
+    ++m_bucketCount[to];
+    m_bucketArea[from] -= m_area[index];
+    m_bucketArea[to] += m_area[index];
+    if (m_bucketCount[from] == 0) m_bucketArea[from] = 0.0; // no drift once a bucket empties
+    m_bucket[index] = (unsigned char)to;
+}
+
+const TerritoryOwnershipIndex::Word* TerritoryOwnershipIndex::IslandBits(Island island) const {
+    const int i = (int)island;
+    return (i >= 0 && i < kIslandCount) ? m_islandBits[i].data() : nullptr;
+}
+
+void TerritoryOwnershipIndex::Hostile(int act, std::vector<Word>& out) const {
+    const int words = WordCount();
+    out.assign(words, 0);
+    const unsigned int gangs = HostileGangMask(act);
+    for (int g = 0; g < kGangBuckets; ++g) {
+        if (!(gangs & (1u << g))) continue;
+        const Word* src = m_ownerBits[g].data();
+        for (int w = 0; w < words; ++w) out[w] |= src[w];
+    }
+}
+
+void TerritoryOwnershipIndex::Unlocked(int act, std::vector<Word>& out) const {
+    const int words = WordCount();
+    out.assign(words, 0);
+    const unsigned int islands = UnlockedIslandMask(act);
+    for (int i = 0; i < kIslandCount; ++i) {
+        if (!(islands & (1u << i))) continue;
+        const Word* src = m_islandBits[i].data();
+        for (int w = 0; w < words; ++w) out[w] |= src[w];
+    }
+}
+
+void TerritoryOwnershipIndex::Attackable(int act, std::vector<Word>& out) const {
+    Hostile(act, out);
+    const Word* open[kIslandCount];
+    const int islands = UnlockedIslandSets(act, open);
+    const int words = WordCount();
+    for (int w = 0; w < words; ++w) {
+        Word o = 0;
+        for (int i = 0; i < islands; ++i) o |= open[i][w];
+        out[w] &= o;
+    }
+}
+
+int TerritoryOwnershipIndex::CountHostile(int act) const {
+    const unsigned int gangs = HostileGangMask(act);
+    int n = 0;
+    for (int g = 0; g < kGangBuckets; ++g) {
+        if (gangs & (1u << g)) n += m_bucketCount[g];
+    }
+    return n;
+}
+
+int TerritoryOwnershipIndex::CountAttackable(int act) const {
+    const Word* owned[kGangBuckets];
+    int gangs = 0;
+    const unsigned int gangMask = HostileGangMask(act);
+    for (int g = 0; g < kGangBuckets; ++g) {
+        if (gangMask & (1u << g)) owned[gangs++] = m_ownerBits[g].data();
+    }
+    const Word* open[kIslandCount];
+    const int islands = UnlockedIslandSets(act, open);
+    if (!gangs || !islands) return 0;
+
+    int n = 0;
+    const int words = WordCount();
+    for (int w = 0; w < words; ++w) {
+        Word hostile = 0, o = 0;
+        for (int g = 0; g < gangs; ++g) hostile |= owned[g][w];
+        for (int i = 0; i < islands; ++i) o |= open[i][w];
+        n += PopCount(hostile & o);
+    }
+    return n;
+}
+
+int TerritoryOwnershipIndex::CountAttackable(int act, int ownerGang) const {
+    const int bucket = BucketOf(ownerGang);
+    if (bucket >= kGangBuckets || !(HostileGangMask(act) & (1u << bucket))) return 0;
+    const Word* open[kIslandCount];
+    const int islands = UnlockedIslandSets(act, open);
+    const Word* owned = m_ownerBits[bucket].data();
+
+    int n = 0;
+    const int words = WordCount();
+    for (int w = 0; w < words; ++w) {
+        Word o = 0;
+        for (int i = 0; i < islands; ++i) o |= open[i][w];
+        n += PopCount(owned[w] & o);
+    }
+    return n;
+}
+
+int TerritoryOwnershipIndex::UnlockedIslandSets(int act, const Word* out[kIslandCount]) const {
+    const unsigned int mask = UnlockedIslandMask(act);
+    int n = 0;
+    for (int i = 0; i < kIslandCount; ++i) {
+        if (mask & (1u << i)) out[n++] = m_islandBits[i].data();
+    }
+    return n;
+}
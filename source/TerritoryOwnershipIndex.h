@@ -0,0 +1,98 @@
+#pragma once
+#include "IslandRule.h"
+
+#include <vector>
+
+// Packed ownership sets over the territory list, kept in step with owner writes.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Bit i of every set stands for territories[i]. Each territory sits in
+// exactly one owner bucket (one per gang GANG1..GANG6, neutral, cleared, or
+// "other" for codes outside those) and one island set (by rect center).
+// Counts and areas per bucket are updated with each SetOwner(), so
+// aggregate questions never walk the list.
+//
+// Act-dependent sets are ORs/ANDs of those words against masks derived once
+// from AffiliationRule.h / IslandRule.h:
+//   Hostile(act)    — owner is a gang IsGangHostileInAct
+//   Unlocked(act)   — territory's island IsIslandUnlocked; the radar's
+//                     visible set (IsTerritoryVisible)
+//   Attackable(act) — Hostile & Unlocked, i.e. exactly the territories where
+//                     CanStartWarInTerritory(ComputeTerritoryState(...)) holds
+
+struct Territory;
+
+class TerritoryOwnershipIndex {
+public:
+    typedef unsigned int Word; // 32-bit: the game build is x86
+    static constexpr int kWordBits = 32;
+
+    static constexpr int kGangBuckets = 6; // GANG1..GANG6
+    static constexpr int kBucketNeutral = 6;
+    static constexpr int kBucketCleared = 7;
+    static constexpr int kBucketOther = 8;
+    static constexpr int kBucketCount = 9;
+    static constexpr int kIslandCount = 3;
+
+    static int BucketOf(int ownerGang);
+
+    // Bit g (0..5) set when GANG1 + g is hostile in act.
+    static unsigned int HostileGangMask(int act);
+    // Bit i set when Island(i) is unlocked in act.
+    static unsigned int UnlockedIslandMask(int act);
+
+    void Build(const std::vector<Territory>& territories);
+    void Clear();
+
+    // Moves territory index into newOwner's bucket. O(1).
+    void SetOwner(int index, int newOwner);
+
+    int Count() const { return m_count; }
+    int WordCount() const { return (int)m_islandBits[0].size(); }
+
+    int   OwnedCount(int ownerGang) const { return m_bucketCount[BucketOf(ownerGang)]; }
+    float OwnedArea(int ownerGang) const  { return (float)m_bucketArea[BucketOf(ownerGang)]; }
+
+    const Word* OwnerBits(int ownerGang) const { return m_ownerBits[BucketOf(ownerGang)].data(); }
+    const Word* IslandBits(Island island) const;
+
+    // out receives WordCount() words.
+    void Hostile(int act, std::vector<Word>& out) const;
+    void Unlocked(int act, std::vector<Word>& out) const;
+    void Attackable(int act, std::vector<Word>& out) const;
+
+    int CountHostile(int act) const;
+    int CountAttackable(int act) const;
+    // Attackable territories owned by one gang (0 if the gang is not hostile in act).
+    int CountAttackable(int act, int ownerGang) const;
+
+    static int PopCount(Word w);
+    static int CountBits(const std::vector<Word>& bits);
+
+    // Calls fn(index) for every set bit, ascending.
+    template <typename Fn>
+    static void ForEach(const std::vector<Word>& bits, Fn fn);
+
+private:
+    int m_count = 0;
+    std::vector<Word> m_ownerBits[kBucketCount];
+    std::vector<Word> m_islandBits[kIslandCount];
+    std::vector<unsigned char> m_bucket; // per territory
+    std::vector<float> m_area;           // per territory
+    int m_bucketCount[kBucketCount] = {};
+    double m_bucketArea[kBucketCount] = {};
+
+    // Fills out with the island sets unlocked in act; returns how many.
+    int UnlockedIslandSets(int act, const Word* out[kIslandCount]) const;
+};
+
+template <typename Fn>
+void TerritoryOwnershipIndex::ForEach(const std::vector<Word>& bits, Fn fn) {
+    for (int w = 0; w < (int)bits.size(); ++w) {
+        Word word = bits[w];
+        while (word) {
+            fn(w * kWordBits + PopCount((word & (0u - word)) - 1)); // index of lowest set bit
+            word &= word - 1;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include "TerritoryPartitions.h"
+#include "TerritorySystem.h"
+
+#include <algorithm>
+
+unsigned int TerritoryPartitions::ActiveMask(int act) {
+    unsigned int mask = 0;
+    for (int i = 0; i < kIslandCount; ++i) {
+        if (IsIslandActive((Island)i, act)) mask |= 1u << i;
+    }
+    return mask;
+}
+
+void TerritoryPartitions::Build(const std::vector<Territory>& territories, int act) {
+    Clear();
+    m_act = act;
+    m_activeMask = ActiveMask(act);
+    m_island.resize(territories.size());
+    for (int i = 0; i < (int)territories.size(); ++i) {
+        const Territory& t = territories[i];
+        const Island island = GetIslandForPosition((t.minX + t.maxX) * 0.5f, (t.minY + t.maxY) * 0.5f);
+        m_island[i] = (unsigned char)island;
+        m_members[(int)island].push_back(i);
+    }
+    MergeActive();
+}
+
+void TerritoryPartitions::Clear() {
+    m_island.clear();
+    for (auto& m : m_members) m.clear();
+    m_active.clear();
+}
+
+bool TerritoryPartitions::SetAct(int act) {
+    m_act = act;
+    const unsigned int mask = ActiveMask(act);
+    if (mask == m_activeMask) return false;
+    m_activeMask = mask;
+    MergeActive();
+    return true;
+}
+
+int TerritoryPartitions::PartitionSize(Island island) const {
+    const int i = (int)island;
+    return (i >= 0 && i < kIslandCount) ? (int)m_members[i].size() : 0;
+}
+
+void TerritoryPartitions::MergeActive() {
+    m_active.clear();
+    for (int i = 0; i < kIslandCount; ++i) {
+        if (!((m_activeMask >> i) & 1u)) continue;
+        const size_t mid = m_active.size();
+        m_active.insert(m_active.end(), m_members[i].begin(), m_members[i].end());
+        std::inplace_merge(m_active.begin(), m_active.begin() + mid, m_active.end());
+    }
+}
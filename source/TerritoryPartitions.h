@@ -0,0 +1,48 @@
+#pragma once
+#include "IslandRule.h"
+
+#include <vector>
+
+// Island partitions of the territory list and the act-gated active set.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// Every territory belongs to the island under its rect center, the same
+// test the radar and TerritoryOwnershipIndex use. A partition is active
+// while IsIslandActive(island, act) holds, so an early-game session only
+// queries and draws Portland; SetAct promotes (or, when a save with an
+// earlier act is loaded, demotes) whole partitions at once.
+//
+// Active() lists the active indices in ascending order, so a TerritoryGrid
+// built over it keeps QueryPoint's lowest-index-first answer.
+
+struct Territory;
+
+class TerritoryPartitions {
+public:
+    static constexpr int kIslandCount = 3;
+
+    void Build(const std::vector<Territory>& territories, int act);
+    void Clear();
+
+    // Re-gates every partition for act. Returns true when the active set
+    // changed (the caller then rebuilds whatever it built over Active()).
+    bool SetAct(int act);
+
+    int  Act() const { return m_act; }
+    bool IsActive(int index) const { return (m_activeMask >> m_island[index]) & 1u; }
+    Island IslandOf(int index) const { return (Island)m_island[index]; }
+    int  PartitionSize(Island island) const;
+
+    const std::vector<int>& Active() const { return m_active; }
+    bool AllActive() const { return m_active.size() == m_island.size(); }
+
+private:
+    int m_act = 0;
+    unsigned int m_activeMask = 0;      // bit i = Island(i) active
+    std::vector<unsigned char> m_island; // per territory
+    std::vector<int> m_members[kIslandCount];
+    std::vector<int> m_active;
+
+    static unsigned int ActiveMask(int act);
+    void MergeActive();
+};
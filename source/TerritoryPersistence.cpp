@@ -3,6 +3,12 @@
 #include "ActManager.h"
 #include "IniConfig.h"
 #include "TerritorySystem.h"
+#include "SidecarFormat.h"
+#include "SidecarWriter.h"
+#include "OwnershipJournal.h"
+#include "Crc32c.h"
+#include "SaveSlotParser.h"
+#include "FileHandleTable.h"
 #include "TerritoryRadarRenderer.h"
 #include "WaveManager.h"
 #include "WarSystem.h"
@@ -17,6 +23,7 @@
 #include <cstring>
 #include <cctype>
 #include <vector>
+#include <unordered_map>
 #include <direct.h>
 #include <algorithm>
 
@@ -29,9 +36,6 @@ bool TerritoryPersistence::s_installed = false;
 TerritoryPersistence::OpenFile_t  TerritoryPersistence::s_originalOpen = nullptr;
 TerritoryPersistence::CloseFile_t TerritoryPersistence::s_originalClose = nullptr;
 
-TerritoryPersistence::HandleOp TerritoryPersistence::s_ops[64]{};
-bool TerritoryPersistence::s_used[64]{};
-
 int TerritoryPersistence::s_pendingApplySlot = -1;
 int TerritoryPersistence::s_pendingWriteSlot = -1;
 
@@ -47,71 +51,33 @@ static unsigned int s_lastArmedLoadMs = 0;
 static int s_lastArmedSaveSlot = -1;
 static unsigned int s_lastArmedSaveMs = 0;
 
+// Sidecar saves are written off the game thread; see SidecarWriter.h.
+static SidecarWriter s_writer;
+
+// Save-file handles between OpenFile and CloseFile; see FileHandleTable.h.
+static FileHandleTable s_handles;
+
 // ------------------------------------------------------------
-// Sidecar format
-// ------------------------------------------------------------
-//
-// v1 (legacy, already in the wild):
-//   [u32 magic 'GTW1'][u32 ver=1][u32 count] then repeated:
-//     [u16 idLen][idBytes][u32 ownerGang]
-//
-// v2+ (chunked):
-//   [u32 magic 'GTW1'][u32 ver>=2][u32 chunkCount] then repeated:
-//     [u32 tag][u32 payloadLen][payloadBytes...]
-//
-// Chunks we define now:
-//   'OWNR' - ownership snapshot (same content as v1, inside payload):
-//     [u32 count] then repeated: [u16 idLen][idBytes][u32 ownerGang]
-//
-// Unknown chunks are skipped.
-// Missing OWNR chunk => fallback to defaults.
+// Sidecar format: see SidecarFormat.h. We write v4 with every owner as
+// OWN3, a packed ODLT, ACTL and CSUM, and read anything
+// SidecarFormat::Reader accepts: ODLT while territories.txt defaults are
+// unchanged, else the full OWN3 or OWNR (what older builds wrote). Unknown
+// chunks are skipped; a file with no ownership chunk, or one that fails its
+// CSUM, falls back to defaults.
 //
+// slot_N.dat is a checkpoint; slot_N.jnl holds the transitions made after
+// it (OwnershipJournal.h). Most saves only append to the journal.
 // ------------------------------------------------------------
 
-static const unsigned int kMagic = 0x31575447; // 'GTW1'
-static const unsigned int kLegacyVersion = 1;
-static const unsigned int kChunkedVersion = 2; // what we WRITE going forward
 static int s_pendingResetSlot = -1;
 
-static const unsigned int kTag_OWNR = 0x524E574F; // 'OWNR' little-endian
-static const unsigned int kTag_ACTL = 0x4C544341; // 'ACTL' little-endian
-
-static void PushU32(std::vector<unsigned char>& out, unsigned int v) {
-    out.push_back((unsigned char)(v & 0xFF));
-    out.push_back((unsigned char)((v >> 8) & 0xFF));
-    out.push_back((unsigned char)((v >> 16) & 0xFF));
-    out.push_back((unsigned char)((v >> 24) & 0xFF));
-}
-
-static bool ReadU32(const std::vector<unsigned char>& b, size_t& i, unsigned int& v) {
-    if (i + 4 > b.size()) return false;
-    v = (unsigned int)b[i]
-        | ((unsigned int)b[i + 1] << 8)
-        | ((unsigned int)b[i + 2] << 16)
-        | ((unsigned int)b[i + 3] << 24);
-    i += 4;
-    return true;
-}
-
-static void PushU16(std::vector<unsigned char>& out, unsigned short v) {
-    out.push_back((unsigned char)(v & 0xFF));
-    out.push_back((unsigned char)((v >> 8) & 0xFF));
-}
-
-static bool ReadU16(const std::vector<unsigned char>& b, size_t& i, unsigned short& v) {
-    if (i + 2 > b.size()) return false;
-    v = (unsigned short)b[i] | ((unsigned short)b[i + 1] << 8);
-    i += 2;
-    return true;
-}
-
 static void LogOwnershipEntries(const char* tag, const std::vector<TerritorySystem::OwnershipEntry>& entries)
 {
     int found1001 = 0;
     int owner1001 = -1;
 
     for (const auto& e : entries) {
-        if (e.id == "1001") {
+        if (e.id == 1001u) {
             found1001 = 1;
             owner1001 = e.ownerGang;
             break;
@@ -123,7 +89,7 @@ static void LogOwnershipEntries(const char* tag, const std::vector<TerritorySyst
 
     // Optional: dump all (small counts)
     for (const auto& e : entries) {
-        DebugLog::Write("%s: id=%s owner=%d", tag, e.id.c_str(), e.ownerGang);
+        DebugLog::Write("%s: id=%u owner=%d", tag, e.id, e.ownerGang);
     }
 }
 
@@ -198,71 +164,6 @@ void TerritoryPersistence::EnsureDirExists(const char* path) {
     _mkdir(path); // best effort
 }
 
-bool TerritoryPersistence::IsReadMode(const char* mode) {
-    if (!mode) return false;
-    const bool hasR = (std::strchr(mode, 'r') != nullptr);
-    const bool hasW = (std::strchr(mode, 'w') != nullptr);
-    const bool hasA = (std::strchr(mode, 'a') != nullptr);
-    return hasR && !hasW && !hasA;
-}
-
-bool TerritoryPersistence::IsWriteMode(const char* mode) {
-    if (!mode) return false;
-    return (std::strchr(mode, 'w') != nullptr) || (std::strchr(mode, 'a') != nullptr);
-}
-
-bool TerritoryPersistence::TryParseSaveSlotFromPath(const char* filePath, int& outSlot) {
-    if (!filePath) return false;
-
-    // Look for GTA3sf{N}.b
-    const char* key = "GTA3sf";
-    const char* p = std::strstr(filePath, key);
-    if (!p) return false;
-    p += (int)std::strlen(key);
-
-    if (!std::isdigit((unsigned char)*p)) return false;
-
-    int slot = 0;
-    while (std::isdigit((unsigned char)*p)) {
-        slot = slot * 10 + (*p - '0');
-        ++p;
-    }
-
-    if (slot < 1 || slot > 8) return false;
-
-    // Require exact ".b" extension (avoid matching ".bak", etc.)
-    const char* ext = std::strrchr(filePath, '.');
-    if (!ext || _stricmp(ext, ".b") != 0) return false;
-
-    outSlot = slot;
-    return true;
-}
-
-// ------------------------------------------------------------
-// Tracking
-// ------------------------------------------------------------
-void TerritoryPersistence::Track(FILESTREAM h, int slot, bool isSave, bool isLoad) {
-    for (int i = 0; i < 64; ++i) {
-        if (!s_used[i]) {
-            s_used[i] = true;
-            s_ops[i] = HandleOp{ h, slot, isSave, isLoad };
-            return;
-        }
-    }
-}
-
-bool TerritoryPersistence::Untrack(FILESTREAM h, HandleOp& out) {
-    for (int i = 0; i < 64; ++i) {
-        if (s_used[i] && s_ops[i].h == h) {
-            out = s_ops[i];
-            s_used[i] = false;
-            s_ops[i].h = 0;
-            return true;
-        }
-    }
-    return false;
-}
-
 // ------------------------------------------------------------
 // Hook install (DamageHook style)
 // ------------------------------------------------------------
@@ -319,7 +220,7 @@ void TerritoryPersistence::Init() {
     std::snprintf(persistDir, sizeof(persistDir), "%spersistence", GetAsiDir());
     EnsureDirExists(persistDir);
 
-    std::memset(s_used, 0, sizeof(s_used));
+    s_handles.Clear();
     s_pendingApplySlot = -1;
     s_pendingResetSlot = -1;
     s_pendingWriteSlot = -1;
@@ -331,6 +232,7 @@ void TerritoryPersistence::Init() {
 }
 
 void TerritoryPersistence::Shutdown() {
+    s_writer.Stop(); // finish any save still queued
     s_inited = false;
 }
 
@@ -339,6 +241,22 @@ void TerritoryPersistence::Process() {
 
     const unsigned int now = CTimer::m_snTimeInMilliseconds;
 
+    SidecarWriter::Result saved;
+    while (s_writer.Poll(saved)) {
+        if (!saved.ok) {
+            DebugLog::Write("TerritoryPersistence: %s slot %d", saved.error, saved.slot);
+            TerritorySystem::GetOwnershipJournal().SaveFailed(saved.slot);
+        }
+        else if (saved.checkpoint) {
+            DebugLog::Write("TerritoryPersistence: saved slot %d checkpoint deltas=%d (%d bytes)",
+                saved.slot, saved.entries, saved.bytes);
+        }
+        else {
+            DebugLog::Write("TerritoryPersistence: saved slot %d journal +%d transitions (%d bytes)",
+                saved.slot, saved.entries, saved.bytes);
+        }
+    }
+
     if (s_pendingApplySlot != -1) {
         if (!FrontEndMenuManager.m_bMenuActive) { // wait until back in-game
             if (s_pendingResetSlot != -1) {
@@ -363,6 +281,8 @@ void TerritoryPersistence::Process() {
             else {
                 s_lastAppliedSlot = slot;
                 s_lastAppliedMs = now;
+                // Only waits when a save of this session is still being written.
+                s_writer.WaitIdle();
                 LoadSidecarAndApply(slot);
                 // Dev override: if GTW.ini sets [Dev] StartingAct, it wins over
                 // everything — sidecar, inference, and CStats. Set to -1 to disable.
@@ -393,16 +313,20 @@ void TerritoryPersistence::Process() {
 // ------------------------------------------------------------
 // Hook bodies
 // ------------------------------------------------------------
+// Both hooks see every file the game opens, possibly from its streaming
+// thread. Anything that is not a save file leaves after the suffix check
+// (open) or one hash probe (close), before touching any other state.
 FILESTREAM __cdecl TerritoryPersistence::OpenFileHook(const char* filePath, const char* mode)
 {
     FILESTREAM h = s_originalOpen(filePath, mode);
     if (!h || !filePath || !mode) return h;
 
+    // Rejects on length and the "<digit>.b" suffix before looking further.
     int slot = 0;
-    if (!TryParseSaveSlotFromPath(filePath, slot)) return h;
+    if (!SaveSlotParser::TryParseSaveSlot(filePath, std::strlen(filePath), slot)) return h;
 
-    const bool isRead = IsReadMode(mode);
-    const bool isWrite = IsWriteMode(mode);
+    const bool isRead = SaveSlotParser::IsReadMode(mode);
+    const bool isWrite = SaveSlotParser::IsWriteMode(mode);
 
     bool willLoad = false;
     bool willSave = false;
@@ -459,7 +383,9 @@ FILESTREAM __cdecl TerritoryPersistence::OpenFileHook(const char* filePath, cons
     }
 
     if (willLoad || willSave) {
-        Track(h, slot, willSave, willLoad);
+        if (!s_handles.Insert((std::intptr_t)h, FileHandleTable::Op{ slot, willSave, willLoad })) {
+            DebugLog::Write("TerritoryPersistence: handle table full, slot %d untracked", slot);
+        }
     }
 
     return h;
@@ -468,8 +394,8 @@ FILESTREAM __cdecl TerritoryPersistence::OpenFileHook(const char* filePath, cons
 
 int __cdecl TerritoryPersistence::CloseFileHook(FILESTREAM fileHandle)
 {
-    HandleOp op{};
-    if (fileHandle && Untrack(fileHandle, op)) {
+    FileHandleTable::Op op{};
+    if (s_handles.Take((std::intptr_t)fileHandle, op)) {
         if (op.isLoad) OnLoadCompleted(op.slot);
         if (op.isSave) OnSaveCompleted(op.slot);
     }
@@ -510,43 +436,101 @@ void TerritoryPersistence::OnLoadCompleted(int slot)
 // ------------------------------------------------------------
 // Parsing helpers
 // ------------------------------------------------------------
-static bool ParseOwnershipPayload(
-    const std::vector<unsigned char>& bytes,
-    size_t& i,
-    std::vector<TerritorySystem::OwnershipEntry>& outEntries,
-    std::string& outErr)
+// SidecarFormat::ReadOwnership picks the chunk; this logs the choice.
+static bool ReadOwnership(const SidecarFormat::Reader& reader, int slot,
+    std::vector<TerritorySystem::OwnershipEntry>& out, std::string& outErr)
 {
-    outEntries.clear();
-
-    unsigned int count = 0;
-    if (!ReadU32(bytes, i, count)) { outErr = "OWNR: missing count"; return false; }
-    if (count > 4096) { outErr = "OWNR: count too large"; return false; }
+    out.clear();
+    std::vector<SidecarFormat::IdOwner> owners;
+    SidecarFormat::OwnershipSource source;
+    if (!SidecarFormat::ReadOwnership(reader, TerritorySystem::GetDefaultsHash(), owners, source, outErr)) return false;
+
+    if (source == SidecarFormat::OwnershipSource::DeltaById) {
+        DebugLog::Write("TerritoryPersistence: territories.txt defaults changed since slot %d was saved and it has no "
+            "full snapshot; applying %d deltas by id", slot, (int)owners.size());
+    }
+    else if (source == SidecarFormat::OwnershipSource::Snapshot && reader.FindChunk(SidecarFormat::kTagOdlt)) {
+        unsigned long long defaultsHash = 0;
+        SidecarFormat::PackedCursor unused;
+        std::string deltaErr;
+        if (reader.Delta(defaultsHash, unused, deltaErr)) {
+            DebugLog::Write("TerritoryPersistence: territories.txt defaults changed since slot %d was saved -> full snapshot", slot);
+        }
+        else {
+            DebugLog::Write("TerritoryPersistence: ODLT unusable slot %d: %s", slot, deltaErr.c_str());
+        }
+    }
 
-    outEntries.reserve(count);
+    out.reserve(owners.size());
+    for (const SidecarFormat::IdOwner& e : owners) out.push_back(TerritorySystem::OwnershipEntry{ e.id, e.ownerGang });
+    return true;
+}
 
-    for (unsigned int n = 0; n < count; ++n) {
-        unsigned short len = 0;
-        if (!ReadU16(bytes, i, len)) { outErr = "OWNR: missing idLen"; return false; }
-        if (i + len > bytes.size()) { outErr = "OWNR: id bytes out of range"; return false; }
+// Applies the journal over the checkpoint just loaded and logs it as a
+// timeline. Returns the records replayed, or -1 when the journal is
+// missing, belongs to another checkpoint or is damaged; the next save of
+// the slot then writes a fresh checkpoint.
+static int ReplayJournal(int slot, const char* path, unsigned int checkpointCrc)
+{
+    FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        DebugLog::Write("TerritoryPersistence: no journal slot %d", slot);
+        return -1;
+    }
+    std::vector<unsigned char> bytes;
+    unsigned char buf[4096];
+    size_t rd;
+    while ((rd = std::fread(buf, 1, sizeof(buf), f)) > 0 && bytes.size() < 1024 * 1024) {
+        bytes.insert(bytes.end(), buf, buf + rd);
+    }
+    std::fclose(f);
 
-        TerritorySystem::OwnershipEntry e;
-        e.id.assign((const char*)&bytes[i], (size_t)len);
-        i += len;
+    unsigned int crc = 0;
+    std::vector<OwnershipJournal::Record> records;
+    std::string err;
+    const bool clean = OwnershipJournal::Parse(bytes.data(), bytes.size(), crc, records, err);
+    if (crc != checkpointCrc) {
+        DebugLog::Write("TerritoryPersistence: journal slot %d is not for this checkpoint -> ignored", slot);
+        return -1;
+    }
 
-        unsigned int ownerU = 0;
-        if (!ReadU32(bytes, i, ownerU)) { outErr = "OWNR: missing owner"; return false; }
+    // Replays by id, like ODLT. A record whose old owner disagrees with
+    // what came before it is applied anyway and counted.
+    std::vector<TerritorySystem::OwnershipEntry> entries;
+    entries.reserve(records.size());
+    std::unordered_map<unsigned int, int> owners; // id -> owner after the records so far
+    int mismatched = 0;
+    for (const OwnershipJournal::Record& r : records) {
+#ifdef _DEBUG
+        DebugLog::Write("TerritoryPersistence: journal slot %d: t=%ums id=%u %d -> %d",
+            slot, r.timeMs, r.id, r.oldOwner, r.newOwner);
+#endif
+
+        auto it = owners.find(r.id);
+        if (it == owners.end()) {
+            const Territory* t = TerritorySystem::Resolve(TerritorySystem::FindTerritoryById(r.id));
+            if (!t) continue; // territory no longer exists
+            it = owners.emplace(r.id, t->ownerGang).first;
+        }
+        if (it->second != r.oldOwner) ++mismatched;
+        it->second = r.newOwner;
 
-        e.ownerGang = (int)ownerU;
-        outEntries.push_back(e);
+        entries.push_back(TerritorySystem::OwnershipEntry{ r.id, r.newOwner });
     }
+    TerritorySystem::ApplyOwnershipState(entries);
 
-    // Must match declared count
-    if (outEntries.size() != count) {
-        outErr = "OWNR: parsed count mismatch";
-        return false;
-    }
+    DebugLog::Write("TerritoryPersistence: journal slot %d: replayed %d records over %d territories",
+        slot, (int)entries.size(), (int)owners.size());
 
-    return true;
+    if (mismatched > 0) {
+        DebugLog::Write("TerritoryPersistence: journal slot %d: %d records did not follow from the previous state",
+            slot, mismatched);
+    }
+    if (!clean) {
+        DebugLog::Write("TerritoryPersistence: journal slot %d: %s (%d records kept)", slot, err.c_str(), (int)records.size());
+        return -1;
+    }
+    return (int)records.size();
 }
 
 // ------------------------------------------------------------
@@ -556,6 +540,10 @@ void TerritoryPersistence::LoadSidecarAndApply(int slot) {
     char path[MAX_PATH];
     std::snprintf(path, sizeof(path), "%spersistence\\slot_%d.dat", GetAsiDir(), slot);
 
+    // Until the checkpoint and journal are both in, the next save checkpoints.
+    OwnershipJournal& journal = TerritorySystem::GetOwnershipJournal();
+    journal.Reset();
+
     FILE* f = std::fopen(path, "rb");
     if (!f) {
         DebugLog::Write("TerritoryPersistence: no sidecar for slot %d -> defaults", slot);
@@ -589,142 +577,51 @@ void TerritoryPersistence::LoadSidecarAndApply(int slot) {
         return;
     }
 
-    size_t i = 0;
-    unsigned int magic = 0, ver = 0;
-    if (!ReadU32(bytes, i, magic) || !ReadU32(bytes, i, ver)) {
-        DebugLog::Write("TerritoryPersistence: corrupt header slot %d", slot);
+    SidecarFormat::Reader reader;
+    std::string err;
+    if (!reader.Open(bytes.data(), bytes.size(), err)) {
+        DebugLog::Write("TerritoryPersistence: unreadable sidecar slot %d: %s", slot, err.c_str());
         TerritorySystem::ResetOwnershipToDefaults();
         TerritorySystem::ClearAllWarsAndTransientState();
         return;
     }
-
-    if (magic != kMagic) {
-        DebugLog::Write("TerritoryPersistence: bad magic slot %d", slot);
+    if (!reader.Verify(err)) {
+        DebugLog::Write("TerritoryPersistence: sidecar failed integrity check slot %d: %s -> defaults", slot, err.c_str());
         TerritorySystem::ResetOwnershipToDefaults();
         TerritorySystem::ClearAllWarsAndTransientState();
         return;
     }
-
-    std::vector<TerritorySystem::OwnershipEntry> entries;
-    bool ok = false;
-
-    // -------------------------
-    // v1 legacy format
-    // -------------------------
-    if (ver == kLegacyVersion) {
-        unsigned int count = 0;
-        if (!ReadU32(bytes, i, count) || count > 4096) {
-            DebugLog::Write("TerritoryPersistence: v1 bad count slot %d", slot);
-            TerritorySystem::ResetOwnershipToDefaults();
-            TerritorySystem::ClearAllWarsAndTransientState();
-            return;
-        }
-
-        entries.reserve(count);
-
-        bool corrupt = false;
-        for (unsigned int n = 0; n < count; ++n) {
-            unsigned short len = 0;
-            if (!ReadU16(bytes, i, len)) { corrupt = true; break; }
-            if (i + len > bytes.size()) { corrupt = true; break; }
-
-            TerritorySystem::OwnershipEntry e;
-            e.id.assign((const char*)&bytes[i], (size_t)len);
-            i += len;
-
-            unsigned int ownerU = 0;
-            if (!ReadU32(bytes, i, ownerU)) { corrupt = true; break; }
-
-            e.ownerGang = (int)ownerU;
-            entries.push_back(e);
-        }
-
-        if (!corrupt && entries.size() == count) {
-            ok = true;
-        }
-        else {
-            DebugLog::Write("TerritoryPersistence: v1 corrupt payload slot %d (parsed=%d expected=%u)",
-                slot, (int)entries.size(), count);
-        }
+    if (!reader.Complete()) {
+        // Pre-v4 files carry no checksum; keep whatever chunks came before the damage.
+        DebugLog::Write("TerritoryPersistence: %s slot %d (%d chunks usable)",
+            reader.DirectoryError(), slot, reader.ChunkCount());
     }
-    // -------------------------
-    // v2+ chunked format
-    // -------------------------
-    else if (ver >= kChunkedVersion) {
-        if (ver > kChunkedVersion) {
-            DebugLog::Write("TerritoryPersistence: sidecar version %u newer than supported %u (slot %d) - best effort",
-                ver, kChunkedVersion, slot);
-        }
 
-        unsigned int chunkCount = 0;
-        if (!ReadU32(bytes, i, chunkCount) || chunkCount > 64) {
-            DebugLog::Write("TerritoryPersistence: v2 bad chunkCount slot %d", slot);
-            TerritorySystem::ResetOwnershipToDefaults();
-            TerritorySystem::ClearAllWarsAndTransientState();
-            return;
+    // v1 predates the act system and leaves the act alone.
+    if (!reader.IsLegacy()) {
+        if (reader.Version() > SidecarFormat::kChecksumVersion) {
+            DebugLog::Write("TerritoryPersistence: sidecar version %u newer than supported %u (slot %d) - best effort",
+                reader.Version(), SidecarFormat::kChecksumVersion, slot);
         }
 
-        bool foundOwnr = false;
-        bool foundActl = false;
-        std::string perr;
         ActManager::Init(); // default to act 0; overwritten if ACTL chunk present
-
-        for (unsigned int c = 0; c < chunkCount; ++c) {
-            unsigned int tag = 0, len = 0;
-            if (!ReadU32(bytes, i, tag) || !ReadU32(bytes, i, len)) {
-                DebugLog::Write("TerritoryPersistence: v2 corrupt chunk header slot %d", slot);
-                break;
-            }
-
-            if (i + len > bytes.size()) {
-                DebugLog::Write("TerritoryPersistence: v2 chunk len out of range slot %d", slot);
-                break;
-            }
-
-            if (tag == kTag_OWNR) {
-                size_t pi = i;
-                perr.clear();
-                if (ParseOwnershipPayload(bytes, pi, entries, perr)) {
-                    foundOwnr = true;
-                    ok = true;
-                }
-                else {
-                    DebugLog::Write("TerritoryPersistence: v2 OWNR parse failed slot %d: %s", slot, perr.c_str());
-                }
-            }
-
-            else if (tag == kTag_ACTL && len == 4) {
-                unsigned int actVal = 0;
-                size_t pi = i;
-                if (ReadU32(bytes, pi, actVal) && actVal <= 3) {
-                    ActManager::SetAct((int)actVal);
-                    foundActl = true;
-                    DebugLog::Write("TerritoryPersistence: loaded act %u slot %d", actVal, slot);
-                }
-            }
-
-            // Skip payload (even if parsed) to continue scanning for other chunks
-            i += len;
-        }
-
-        if (!foundOwnr) {
-            DebugLog::Write("TerritoryPersistence: v2 missing OWNR chunk slot %d", slot);
-            ok = false;
+        unsigned int actVal = 0;
+        if (reader.Act(actVal) && actVal <= 3) {
+            ActManager::SetAct((int)actVal);
+            DebugLog::Write("TerritoryPersistence: loaded act %u slot %d", actVal, slot);
         }
-
-        if (!foundActl) {
+        else {
             // Older sidecar without ACTL — mod installed before act system existed.
             DebugLog::Write("TerritoryPersistence: no ACTL chunk slot %d -> inferring act", slot);
             ActManager::InferActOnFirstLoad();
         }
     }
-    else {
-        DebugLog::Write("TerritoryPersistence: unknown sidecar version %u slot %d", ver, slot);
-        ok = false;
-    }
+
+    std::vector<TerritorySystem::OwnershipEntry> entries;
+    const bool ok = ReadOwnership(reader, slot, entries, err);
 
     if (!ok) {
-        DebugLog::Write("TerritoryPersistence: sidecar unusable slot %d -> defaults", slot);
+        DebugLog::Write("TerritoryPersistence: sidecar unusable slot %d (%s) -> defaults", slot, err.c_str());
         TerritorySystem::ResetOwnershipToDefaults();
         TerritorySystem::ClearAllWarsAndTransientState();
         return;
@@ -735,83 +632,68 @@ void TerritoryPersistence::LoadSidecarAndApply(int slot) {
     TerritorySystem::ResetOwnershipToDefaults();
     TerritorySystem::ApplyOwnershipState(entries);
 
+    char journalPath[MAX_PATH];
+    std::snprintf(journalPath, sizeof(journalPath), "%spersistence\\slot_%d.jnl", GetAsiDir(), slot);
+    const int replayed = ReplayJournal(slot, journalPath, Crc32c::Compute(bytes.data(), bytes.size()));
+
+    unsigned int act = 0;
+    unsigned long long defaultsHash = 0;
+    SidecarFormat::PackedCursor unused;
+    if (replayed >= 0 && reader.Act(act) && reader.Delta(defaultsHash, unused, err)) {
+        journal.Adopt(slot, act, defaultsHash, replayed);
+    }
+
     // DO NOT clear transient here; it was cleared at OnLoadCompleted()
 
     // Note: do NOT overwrite defaultOwnerGang here.
     // defaultOwnerGang represents territories.txt defaults; overwriting it causes
     // loading a slot with *no* sidecar to incorrectly inherit the last-loaded slot's ownership.
 
-    DebugLog::Write("TerritoryPersistence: applied slot %d entries=%d", slot, (int)entries.size());
+    DebugLog::Write("TerritoryPersistence: applied slot %d entries=%d journal=%d", slot, (int)entries.size(), replayed);
 }
 
 void TerritoryPersistence::SaveSidecar(int slot) {
     char persistDir[MAX_PATH];
-    std::snprintf(persistDir, sizeof(persistDir), "%spersistence", GetAsiDir());
-    EnsureDirExists(persistDir);
-
     char finalPath[MAX_PATH];
-    char tmpPath[MAX_PATH];
+    char journalPath[MAX_PATH];
+    std::snprintf(persistDir, sizeof(persistDir), "%spersistence", GetAsiDir());
     std::snprintf(finalPath, sizeof(finalPath), "%s\\slot_%d.dat", persistDir, slot);
-    std::snprintf(tmpPath, sizeof(tmpPath), "%s\\slot_%d.dat.tmp", persistDir, slot);
-
-    std::vector<TerritorySystem::OwnershipEntry> entries;
-    TerritorySystem::GetOwnershipState(entries);
-
-    LogOwnershipEntries("TerritoryPersistence: SAVE snapshot", entries);
-
-    // Build OWNR payload
-    std::vector<unsigned char> ownr;
-    ownr.reserve(8 + entries.size() * 16);
-
-    PushU32(ownr, (unsigned int)entries.size());
-    for (auto& e : entries) {
-        const unsigned short len = (unsigned short)e.id.size();
-        PushU16(ownr, len);
-        ownr.insert(ownr.end(), e.id.begin(), e.id.end());
-        PushU32(ownr, (unsigned int)e.ownerGang);
-    }
-
-    // Build ACTL payload (4 bytes: current act 0-3)
-    std::vector<unsigned char> actl;
-    PushU32(actl, (unsigned int)ActManager::GetCurrentAct());
-
-    // Write container (v2 chunked)
-    std::vector<unsigned char> out;
-    out.reserve(16 + 8 + ownr.size() + 8 + actl.size());
-
-    PushU32(out, kMagic);
-    PushU32(out, kChunkedVersion);
-    PushU32(out, 2); // chunkCount: OWNR + ACTL
-
-    PushU32(out, kTag_OWNR);
-    PushU32(out, (unsigned int)ownr.size());
-    out.insert(out.end(), ownr.begin(), ownr.end());
-
-    PushU32(out, kTag_ACTL);
-    PushU32(out, (unsigned int)actl.size());
-    out.insert(out.end(), actl.begin(), actl.end());
-
-    FILE* f = std::fopen(tmpPath, "wb");
-    if (!f) {
-        DebugLog::Write("TerritoryPersistence: failed open tmp slot %d", slot);
+    std::snprintf(journalPath, sizeof(journalPath), "%s\\slot_%d.jnl", persistDir, slot);
+
+    // Snapshot now; serializing and file IO happen on the writer thread.
+    SidecarWriter::Job job;
+    job.slot = slot;
+    job.dir = persistDir;
+    job.path = finalPath;
+    job.journalPath = journalPath;
+    job.defaultsHash = TerritorySystem::GetDefaultsHash();
+    job.act = (unsigned int)ActManager::GetCurrentAct();
+
+    std::vector<OwnershipJournal::Record> transitions;
+    job.checkpoint = TerritorySystem::GetOwnershipJournal().BeginSave(slot, job.act, job.defaultsHash, transitions);
+
+    if (!job.checkpoint) {
+        // Same lineage as the slot on disk: just the transitions since.
+        DebugLog::Write("TerritoryPersistence: SAVE journal slot %d: %d transitions", slot, (int)transitions.size());
+        job.journal = std::move(transitions);
+        s_writer.Submit(std::move(job));
         return;
     }
 
-    size_t wr = std::fwrite(out.data(), 1, out.size(), f);
-    std::fclose(f);
+    // Only what differs from territories.txt defaults; a fresh campaign
+    // saves an empty ODLT.
+    std::vector<TerritorySystem::OwnershipEntry> entries;
+    TerritorySystem::GetOwnershipDeltas(entries);
 
-    if (wr != out.size()) {
-        DebugLog::Write("TerritoryPersistence: failed write tmp slot %d", slot);
-        std::remove(tmpPath);
-        return;
-    }
+    LogOwnershipEntries("TerritoryPersistence: SAVE deltas", entries);
 
-    std::remove(finalPath);
-    if (std::rename(tmpPath, finalPath) != 0) {
-        DebugLog::Write("TerritoryPersistence: rename tmp->final failed slot %d", slot);
-        std::remove(tmpPath);
-        return;
-    }
+    job.deltas.resize(entries.size());
+    for (size_t k = 0; k < entries.size(); ++k) job.deltas[k] = SidecarFormat::IdOwner{ entries[k].id, entries[k].ownerGang };
+
+    // Every owner too (OWN3), for a load after the defaults were edited.
+    TerritorySystem::GetOwnershipState(entries);
+    job.owners.resize(entries.size());
+    for (size_t k = 0; k < entries.size(); ++k) job.owners[k] = SidecarFormat::IdOwner{ entries[k].id, entries[k].ownerGang };
 
-    DebugLog::Write("TerritoryPersistence: saved slot %d entries=%d (v2 chunked)", slot, (int)entries.size());
+    s_writer.Submit(std::move(job));
 }
@@ -24,18 +24,6 @@ private:
     static int __cdecl CloseFileHook(FILESTREAM fileHandle);
 
 private:
-    // handle tracking (fixed arrays, safe inside hook)
-    struct HandleOp { FILESTREAM h; int slot; bool isSave; bool isLoad; };
-    static HandleOp s_ops[64];
-    static bool s_used[64];
-
-    static void Track(FILESTREAM h, int slot, bool isSave, bool isLoad);
-    static bool Untrack(FILESTREAM h, HandleOp& out);
-
-    static bool TryParseSaveSlotFromPath(const char* filePath, int& outSlot); // 1..8
-    static bool IsReadMode(const char* mode);
-    static bool IsWriteMode(const char* mode);
-
     static void OnSaveCompleted(int slot);
     static void OnLoadCompleted(int slot);
 
@@ -0,0 +1,246 @@
+#include "TerritoryPolygon.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+float Cross(float ax, float ay, float bx, float by, float cx, float cy) {
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+// Proper or touching intersection of segments ab and cd.
+bool SegmentsIntersect(float ax, float ay, float bx, float by,
+                       float cx, float cy, float dx, float dy)
+{
+    const float d1 = Cross(cx, cy, dx, dy, ax, ay);
+    const float d2 = Cross(cx, cy, dx, dy, bx, by);
+    const float d3 = Cross(ax, ay, bx, by, cx, cy);
+    const float d4 = Cross(ax, ay, bx, by, dx, dy);
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) &&
+        ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) return true;
+
+    auto onSegment = [](float px, float py, float qx, float qy, float rx, float ry) {
+        return std::min(px, qx) <= rx && rx <= std::max(px, qx) &&
+               std::min(py, qy) <= ry && ry <= std::max(py, qy);
+    };
+    if (d1 == 0 && onSegment(cx, cy, dx, dy, ax, ay)) return true;
+    if (d2 == 0 && onSegment(cx, cy, dx, dy, bx, by)) return true;
+    if (d3 == 0 && onSegment(ax, ay, bx, by, cx, cy)) return true;
+    if (d4 == 0 && onSegment(ax, ay, bx, by, dx, dy)) return true;
+    return false;
+}
+
+} // namespace
+
+void TerritoryPolygon::Clear() {
+    m_x.clear();
+    m_y.clear();
+    m_edges.clear();
+    m_tris.clear();
+    m_minX = m_minY = m_maxX = m_maxY = 0.0f;
+    m_interiorX = m_interiorY = 0.0f;
+    m_area = 0.0f;
+    m_convex = false;
+}
+
+bool TerritoryPolygon::Build(const float* xy, int vertexCount, std::string& outErr) {
+    Clear();
+
+    std::vector<float> xs, ys;
+    for (int i = 0; i < vertexCount; ++i) {
+        const float x = xy[i * 2], y = xy[i * 2 + 1];
+        if (!std::isfinite(x) || !std::isfinite(y)) { outErr = "Polygon vertex is not a number"; return false; }
+        if (!xs.empty() && x == xs.back() && y == ys.back()) continue; // repeated vertex
+        xs.push_back(x);
+        ys.push_back(y);
+    }
+    if (xs.size() > 1 && xs.front() == xs.back() && ys.front() == ys.back()) {
+        xs.pop_back();
+        ys.pop_back();
+    }
+
+    const int n = (int)xs.size();
+    if (n < 3) { outErr = "Polygon needs at least 3 vertices"; return false; }
+    if (n > kMaxVertices) { outErr = "Polygon has too many vertices"; return false; }
+
+    double area2 = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const int j = (i + 1) % n;
+        area2 += (double)xs[i] * ys[j] - (double)xs[j] * ys[i];
+    }
+    if (std::fabs(area2) < 1e-3) { outErr = "Polygon has no area"; return false; }
+    if (area2 < 0.0) {
+        std::reverse(xs.begin(), xs.end());
+        std::reverse(ys.begin(), ys.end());
+    }
+
+    // Non-adjacent edges must not touch.
+    for (int i = 0; i < n; ++i) {
+        const int i1 = (i + 1) % n;
+        for (int j = i + 1; j < n; ++j) {
+            const int j1 = (j + 1) % n;
+            if (j == i1 || j1 == i) continue;
+            if (SegmentsIntersect(xs[i], ys[i], xs[i1], ys[i1], xs[j], ys[j], xs[j1], ys[j1])) {
+                outErr = "Polygon edges cross";
+                return false;
+            }
+        }
+    }
+
+    m_x.swap(xs);
+    m_y.swap(ys);
+    m_area = (float)(std::fabs(area2) * 0.5);
+
+    m_minX = *std::min_element(m_x.begin(), m_x.end());
+    m_maxX = *std::max_element(m_x.begin(), m_x.end());
+    m_minY = *std::min_element(m_y.begin(), m_y.end());
+    m_maxY = *std::max_element(m_y.begin(), m_y.end());
+
+    m_edges.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        const int j = (i + 1) % n;
+        float ax = m_x[i], ay = m_y[i], bx = m_x[j], by = m_y[j];
+        if (ay == by) continue;
+        if (ay > by) { std::swap(ax, bx); std::swap(ay, by); }
+        m_edges.push_back(Edge{ ay, by, ax, (bx - ax) / (by - ay) });
+    }
+    std::sort(m_edges.begin(), m_edges.end(), [](const Edge& a, const Edge& b) { return a.y0 < b.y0; });
+
+    m_convex = true;
+    for (int i = 0; i < n && m_convex; ++i) {
+        const int j = (i + 1) % n, k = (i + 2) % n;
+        if (Cross(m_x[i], m_y[i], m_x[j], m_y[j], m_x[k], m_y[k]) < 0.0f) m_convex = false;
+    }
+
+    if (!Triangulate()) {
+        Clear();
+        outErr = "Polygon could not be triangulated";
+        return false;
+    }
+
+    // Area centroid; a concave outline can put it outside, in which case the
+    // middle of the largest triangle is used instead.
+    double cx = 0.0, cy = 0.0, a = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const int j = (i + 1) % n;
+        const double c = (double)m_x[i] * m_y[j] - (double)m_x[j] * m_y[i];
+        a += c;
+        cx += (m_x[i] + m_x[j]) * c;
+        cy += (m_y[i] + m_y[j]) * c;
+    }
+    m_interiorX = (float)(cx / (3.0 * a));
+    m_interiorY = (float)(cy / (3.0 * a));
+
+    if (!Contains(m_interiorX, m_interiorY)) {
+        float best = -1.0f;
+        for (size_t t = 0; t + 2 < m_tris.size(); t += 3) {
+            const int p = m_tris[t], q = m_tris[t + 1], r = m_tris[t + 2];
+            const float area = Cross(m_x[p], m_y[p], m_x[q], m_y[q], m_x[r], m_y[r]);
+            if (area > best) {
+                best = area;
+                m_interiorX = (m_x[p] + m_x[q] + m_x[r]) / 3.0f;
+                m_interiorY = (m_y[p] + m_y[q] + m_y[r]) / 3.0f;
+            }
+        }
+    }
+    return true;
+}
+
+bool TerritoryPolygon::Triangulate() {
+    const int n = (int)m_x.size();
+    m_tris.clear();
+    m_tris.reserve((size_t)(n - 2) * 3);
+
+    if (m_convex) {
+        for (int i = 1; i + 1 < n; ++i) {
+            m_tris.push_back(0);
+            m_tris.push_back((unsigned short)i);
+            m_tris.push_back((unsigned short)(i + 1));
+        }
+        return true;
+    }
+
+    // Ear clipping over the remaining vertex ring.
+    std::vector<int> ring(n);
+    for (int i = 0; i < n; ++i) ring[i] = i;
+
+    int guard = n * n;
+    while (ring.size() > 3 && guard-- > 0) {
+        const int m = (int)ring.size();
+        bool clipped = false;
+        // Second pass also takes collinear "ears" (zero-area triangles), so
+        // a straight run of vertices cannot stall the loop.
+        for (int k = 0, pass = 0; !clipped && pass < 2; k = (k + 1 == m) ? (++pass, 0) : k + 1) {
+            const int a = ring[(k + m - 1) % m], b = ring[k], c = ring[(k + 1) % m];
+            const float turn = Cross(m_x[a], m_y[a], m_x[b], m_y[b], m_x[c], m_y[c]);
+            if (turn < 0.0f || (turn == 0.0f && pass == 0)) continue; // reflex
+
+            bool empty = true;
+            for (int v : ring) {
+                if (v == a || v == b || v == c) continue;
+                if (Cross(m_x[a], m_y[a], m_x[b], m_y[b], m_x[v], m_y[v]) >= 0.0f &&
+                    Cross(m_x[b], m_y[b], m_x[c], m_y[c], m_x[v], m_y[v]) >= 0.0f &&
+                    Cross(m_x[c], m_y[c], m_x[a], m_y[a], m_x[v], m_y[v]) >= 0.0f) {
+                    empty = false;
+                    break;
+                }
+            }
+            if (!empty) continue;
+
+            m_tris.push_back((unsigned short)a);
+            m_tris.push_back((unsigned short)b);
+            m_tris.push_back((unsigned short)c);
+            ring.erase(ring.begin() + k);
+            clipped = true;
+        }
+        if (!clipped) return false;
+    }
+
+    if (ring.size() != 3) return false;
+    m_tris.push_back((unsigned short)ring[0]);
+    m_tris.push_back((unsigned short)ring[1]);
+    m_tris.push_back((unsigned short)ring[2]);
+    return true;
+}
+
+bool TerritoryPolygon::Contains(float x, float y) const {
+    if (!(x >= m_minX && x <= m_maxX && y >= m_minY && y <= m_maxY)) return false;
+
+    bool inside = false;
+    for (const Edge& e : m_edges) {
+        if (e.y0 > y) break; // sorted by y0: nothing further up can span y
+        if (y < e.y1 && x < e.x0 + (y - e.y0) * e.dxdy) inside = !inside;
+    }
+    return inside;
+}
+
+void TerritoryPolygon::PullInside(float& x, float& y) const {
+    if (Empty() || Contains(x, y)) return;
+
+    // Nearest point on the outline.
+    const int n = (int)m_x.size();
+    float bestX = m_interiorX, bestY = m_interiorY, bestD2 = -1.0f;
+    for (int i = 0; i < n; ++i) {
+        const int j = (i + 1) % n;
+        const float ex = m_x[j] - m_x[i], ey = m_y[j] - m_y[i];
+        const float len2 = ex * ex + ey * ey;
+        float t = len2 > 0.0f ? ((x - m_x[i]) * ex + (y - m_y[i]) * ey) / len2 : 0.0f;
+        t = std::clamp(t, 0.0f, 1.0f);
+        const float px = m_x[i] + ex * t, py = m_y[i] + ey * t;
+        const float d2 = (px - x) * (px - x) + (py - y) * (py - y);
+        if (bestD2 < 0.0f || d2 < bestD2) { bestD2 = d2; bestX = px; bestY = py; }
+    }
+
+    // One unit toward the interior point gets off the edge.
+    const float dx = m_interiorX - bestX, dy = m_interiorY - bestY;
+    const float len = std::sqrt(dx * dx + dy * dy);
+    const float step = (len > 1.0f) ? 1.0f / len : 1.0f;
+    x = bestX + dx * step;
+    y = bestY + dy * step;
+
+    if (!Contains(x, y)) {
+        x = m_interiorX;
+        y = m_interiorY;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Optional polygon outline for a territory.
+// No game engine dependencies — safe to include in unit test projects.
+//
+// A territory with an outline keeps its rect fields set to the outline's
+// bounding box, so the grid, the SoA bounds and every other box-based path
+// act as the prefilter; Contains() repeats that box test and only then runs
+// a crossing-number test over a per-edge table (y range, x at the lower end,
+// dx/dy) sorted by lower y, so it stops at the first edge above the point.
+//
+// Build() normalizes the outline to counter-clockwise, rejects degenerate or
+// self-crossing outlines, and precomputes a triangulation (a fan when convex)
+// for the radar fill. Points exactly on an edge may test either way; the
+// rect path stays edge-inclusive.
+
+class TerritoryPolygon {
+public:
+    static constexpr int kMaxVertices = 256;
+
+    // xy holds vertexCount (x, y) pairs. A closing vertex equal to the first
+    // is dropped. On failure the polygon is left empty and outErr says why.
+    bool Build(const float* xy, int vertexCount, std::string& outErr);
+    void Clear();
+
+    bool Empty()       const { return m_x.empty(); }
+    int  VertexCount() const { return (int)m_x.size(); }
+    const std::vector<float>& X() const { return m_x; }
+    const std::vector<float>& Y() const { return m_y; }
+
+    float MinX() const { return m_minX; }
+    float MinY() const { return m_minY; }
+    float MaxX() const { return m_maxX; }
+    float MaxY() const { return m_maxY; }
+    float Area() const { return m_area; }
+
+    bool Contains(float x, float y) const;
+
+    bool IsConvex() const { return m_convex; }
+    // Vertex index triples, counter-clockwise.
+    const std::vector<unsigned short>& Triangles() const { return m_tris; }
+
+    // A point guaranteed to be inside (area centroid when it is inside,
+    // otherwise the centroid of the largest triangle).
+    float InteriorX() const { return m_interiorX; }
+    float InteriorY() const { return m_interiorY; }
+
+    // Leaves an inside point alone; moves an outside one to just inside the
+    // nearest edge (falling back to the interior point).
+    void PullInside(float& x, float& y) const;
+
+    bool SameShape(const TerritoryPolygon& o) const { return m_x == o.m_x && m_y == o.m_y; }
+
+private:
+    struct Edge {
+        float y0, y1; // y0 < y1; horizontal edges are never crossed and are left out
+        float x0;     // x at y0
+        float dxdy;
+    };
+
+    std::vector<float> m_x, m_y;
+    std::vector<Edge> m_edges;
+    std::vector<unsigned short> m_tris;
+    float m_minX = 0.0f, m_minY = 0.0f, m_maxX = 0.0f, m_maxY = 0.0f;
+    float m_interiorX = 0.0f, m_interiorY = 0.0f;
+    float m_area = 0.0f;
+    bool m_convex = false;
+
+    bool Triangulate();
+};
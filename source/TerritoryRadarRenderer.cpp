@@ -1,6 +1,8 @@
 #include "TerritoryRadarRenderer.h"
 #include "TerritorySystem.h"
+#include "TerritoryOwnershipIndex.h"
 #include "IniConfig.h"
+#include "FileWatch.h"
 #include "DebugLog.h"
 #include "WaveManager.h"
 #include "TerritoryStateRule.h"
@@ -26,25 +28,23 @@ namespace {
     static int s_flashingTerritoryId = -1;
     static unsigned int s_flashStartTimeMs = 0;
 
-    // [AttackFlash] INI settings
+    // [AttackFlash] INI settings, read from the IniConfig snapshot. The draw
+    // path only reads these fields.
     struct FlashConfig {
         unsigned int cycleMs = 1000;
         unsigned char maxAlpha = 180;
         unsigned char colorR = 160;
         unsigned char colorG = 15;
         unsigned char colorB = 15;
-        unsigned int lastLoadTime = 0;
+        unsigned int generation = 0; // IniConfig::Generation() these came from
+        int watchId = 0; // FileWatch subscription while liveReload is on
         bool liveReload = true;
         bool initialized = false;
     };
 
     static FlashConfig gFlashConfig;
 
-    // Load config from INI
-    static void LoadFlashConfig() {
-        auto& ini = IniConfig::Instance();
-        ini.Load("III.GangTerritoryWars.ini");
-
+    static void ReadFlashConfig(const IniConfig& ini) {
         auto ClampInt = [](int v, int lo, int hi) -> int {
             return std::clamp(v, lo, hi);
             };
@@ -56,25 +56,38 @@ namespace {
         gFlashConfig.colorG = (unsigned char)ClampInt(ini.GetInt("AttackFlash", "ColorG", 25), 0, 255);
         gFlashConfig.colorB = (unsigned char)ClampInt(ini.GetInt("AttackFlash", "ColorB", 25), 0, 255);
         gFlashConfig.liveReload = ini.GetInt("AttackFlash", "LiveReload", 1) != 0;
-
-        gFlashConfig.lastLoadTime = CTimer::m_snTimeInMilliseconds;
-        gFlashConfig.initialized = true;
+        gFlashConfig.generation = ini.Generation();
     }
 
+    // FileWatch callback: the INI changed on disk. The snapshot is rebuilt
+    // from the bytes the watch already read; the fields only if it changed.
+    static void OnIniFileChanged(const std::vector<char>& content, unsigned long long, void*) {
+        auto& ini = IniConfig::Instance();
+        ini.LoadFromString(std::string_view(content.data(), content.size()));
+        if (ini.Generation() == gFlashConfig.generation) return;
 
-    // Reload config every ~500ms to allow live tuning (can be disabled via INI setting to boost performance)
-    static void RefreshConfigIfNeeded() {
-        if (!gFlashConfig.initialized) {
-            LoadFlashConfig();
-            return;
+        ReadFlashConfig(ini);
+        if (!gFlashConfig.liveReload) {
+            FileWatch::Instance().Unwatch(gFlashConfig.watchId);
+            gFlashConfig.watchId = 0;
         }
+    }
 
-        if (!gFlashConfig.liveReload) return;
+    // Load config from INI. With LiveReload (the default) the shared file
+    // watch reports later edits to allow live tuning.
+    static void LoadFlashConfig() {
+        auto& ini = IniConfig::Instance();
+        ini.Load("III.GangTerritoryWars.ini");
+        ReadFlashConfig(ini);
 
-        unsigned int now = CTimer::m_snTimeInMilliseconds;
-        if (now - gFlashConfig.lastLoadTime > 500) {
-            LoadFlashConfig();
+        if (gFlashConfig.liveReload && !ini.Path().empty()) {
+            gFlashConfig.watchId = FileWatch::Instance().Watch(ini.Path(), OnIniFileChanged);
         }
+        gFlashConfig.initialized = true;
+    }
+
+    static void RefreshConfigIfNeeded() {
+        if (!gFlashConfig.initialized) LoadFlashConfig();
     }
 
     // -------------------------------
@@ -521,39 +534,15 @@ namespace {
     // -------------------------------
     // Per-territory render
     // -------------------------------
-    static void DrawRadarTerritory(const Territory& t, const CRGBA& fill)
-    {
-#ifdef _DEBUG
-        ++s_drawTerritoryCalls; // DEBUG
-#endif
-        const float x1 = t.minX;
-        const float y1 = t.minY;
-        const float x2 = t.maxX;
-        const float y2 = t.maxY;
-
-
-        CVector2D s0, s1, s2, s3;
-        WorldToRadarScreen(x1, y1, s0);
-        WorldToRadarScreen(x2, y1, s1);
-        WorldToRadarScreen(x2, y2, s2);
-        WorldToRadarScreen(x1, y2, s3);
 
-        // Reuse buffers (no allocations per territory)
-        static std::vector<CVector2D> quadLocal;
+    // Clips one convex piece (local space, either winding) to the fill ellipse and draws it.
+    static void ClipAndFillLocal(std::vector<CVector2D>& pieceLocal, const CRGBA& fill)
+    {
         static std::vector<CVector2D> clippedScreen;
 
-        quadLocal.clear();
-        quadLocal.reserve(4);
-
         const CVector2D& center = gRadarCache.center;
 
-        // Quad in LOCAL space relative to radar center.
-        quadLocal.push_back(Sub(s0, center));
-        quadLocal.push_back(Sub(s1, center));
-        quadLocal.push_back(Sub(s2, center));
-        quadLocal.push_back(Sub(s3, center));
-
-        // Ensure quad is CCW (ClipConvexCCW expects CCW). (unchanged)
+        // Ensure piece is CCW (ClipConvexCCW expects CCW).
         auto PolyArea2 = [](const std::vector<CVector2D>& p) {
             float a = 0.0f;
             for (size_t i = 0; i < p.size(); ++i) {
@@ -563,13 +552,13 @@ namespace {
             }
             return a;
             };
-        if (PolyArea2(quadLocal) < 0.0f) std::reverse(quadLocal.begin(), quadLocal.end());
+        if (PolyArea2(pieceLocal) < 0.0f) std::reverse(pieceLocal.begin(), pieceLocal.end());
 
         // Check ellipse is not empty
         if (gRadarCache.fillEllipseLocal.size() < 3) return;
 
         // Fill clip (same ellipse poly, same segs, same clip code)
-        const std::vector<CVector2D> clippedLocal = ClipConvexCCW(quadLocal, gRadarCache.fillEllipseLocal);
+        const std::vector<CVector2D> clippedLocal = ClipConvexCCW(pieceLocal, gRadarCache.fillEllipseLocal);
         if (clippedLocal.size() < 3) return;
 
 #ifdef _DEBUG
@@ -586,6 +575,68 @@ namespace {
         DrawPolyFilledFan(clippedScreen, fill);
     }
 
+    static void DrawRadarTerritory(const Territory& t, const CRGBA& fill)
+    {
+#ifdef _DEBUG
+        ++s_drawTerritoryCalls; // DEBUG
+#endif
+        // Reuse buffers (no allocations per territory)
+        static std::vector<CVector2D> quadLocal;
+        static std::vector<CVector2D> outlineLocal;
+
+        const CVector2D& center = gRadarCache.center;
+
+        if (!t.poly.Empty()) {
+            const int n = t.poly.VertexCount();
+            outlineLocal.resize(n);
+            for (int i = 0; i < n; ++i) {
+                CVector2D s;
+                WorldToRadarScreen(t.poly.X()[i], t.poly.Y()[i], s);
+                outlineLocal[i] = Sub(s, center);
+            }
+
+            if (t.poly.IsConvex()) {
+                quadLocal = outlineLocal;
+                ClipAndFillLocal(quadLocal, fill);
+                return;
+            }
+
+            // Concave: the clipper only handles convex input, so go per triangle.
+            const std::vector<unsigned short>& tris = t.poly.Triangles();
+            for (size_t i = 0; i + 2 < tris.size(); i += 3) {
+                quadLocal.clear();
+                quadLocal.push_back(outlineLocal[tris[i]]);
+                quadLocal.push_back(outlineLocal[tris[i + 1]]);
+                quadLocal.push_back(outlineLocal[tris[i + 2]]);
+                ClipAndFillLocal(quadLocal, fill);
+            }
+            return;
+        }
+
+        const float x1 = t.minX;
+        const float y1 = t.minY;
+        const float x2 = t.maxX;
+        const float y2 = t.maxY;
+
+
+        CVector2D s0, s1, s2, s3;
+        WorldToRadarScreen(x1, y1, s0);
+        WorldToRadarScreen(x2, y1, s1);
+        WorldToRadarScreen(x2, y2, s2);
+        WorldToRadarScreen(x1, y2, s3);
+
+        quadLocal.clear();
+        quadLocal.reserve(4);
+
+        // Quad in LOCAL space relative to radar center.
+        quadLocal.push_back(Sub(s0, center));
+        quadLocal.push_back(Sub(s1, center));
+        quadLocal.push_back(Sub(s2, center));
+        quadLocal.push_back(Sub(s3, center));
+
+        ClipAndFillLocal(quadLocal, fill);
+    }
+
 
 } // namespace
 
@@ -595,7 +646,7 @@ void TerritoryRadarRenderer::ResetTransientState()
     s_flashStartTimeMs = 0;
 }
 
-void TerritoryRadarRenderer::DrawRadarOverlay(const std::vector<Territory>& territories)
+void TerritoryRadarRenderer::DrawRadarOverlay(const std::vector<Territory>& territories, const TerritoryOwnershipIndex& ownership)
 {
     const auto rs = CaptureRenderState();
 
@@ -616,14 +667,27 @@ void TerritoryRadarRenderer::DrawRadarOverlay(const std::vector<Territory>& terr
 
     const int currentAct = ActManager::GetCurrentAct();
 
-    for (const auto& t : territories) {
+    // A territory is visible when its island is unlocked (so nothing shows
+    // in Act 0, before JM2). That depends on position and act only, and the
+    // ownership index answers it a word at a time; re-derive the list when
+    // geometry or the act moved instead of every frame.
+    static std::vector<int> s_visible;
+    static std::vector<TerritoryOwnershipIndex::Word> s_unlocked;
+    static unsigned int s_visibleEpoch = 0;
+    static int s_visibleAct = -1;
+    static int s_visibleCount = -1;
+    const unsigned int epoch = TerritorySystem::GetChangeEpoch(TerritoryChangeLog::kGeometry);
+    if (epoch != s_visibleEpoch || currentAct != s_visibleAct || ownership.Count() != s_visibleCount) {
+        s_visibleEpoch = epoch;
+        s_visibleAct = currentAct;
+        s_visibleCount = ownership.Count();
+        ownership.Unlocked(currentAct, s_unlocked);
+        s_visible.clear();
+        TerritoryOwnershipIndex::ForEach(s_unlocked, [](int i) { s_visible.push_back(i); });
+    }
 
-        // Hide territories on islands the player hasn't reached yet, and hide
-        // everything in Act 0 (system is unknown to the player before JM2).
-        const float centerX = (t.minX + t.maxX) * 0.5f;
-        const float centerY = (t.minY + t.maxY) * 0.5f;
-        const bool isLocked = !IsIslandUnlocked(GetIslandForPosition(centerX, centerY), currentAct);
-        if (!IsTerritoryVisible(ComputeTerritoryState(t.ownerGang, currentAct, isLocked))) continue;
+    for (int i : s_visible) {
+        const Territory& t = territories[i];
 
         const bool shouldFlash = t.underAttack;
         const CRGBA fill = RGBAForOwner(t.ownerGang, shouldFlash, t.defenseLevel);
@@ -635,8 +699,8 @@ void TerritoryRadarRenderer::DrawRadarOverlay(const std::vector<Territory>& terr
     const unsigned int now2 = CTimer::m_snTimeInMilliseconds;
     if (now2 - s_lastPerfLogMs >= 2500) {
         s_lastPerfLogMs = now2;
-        DebugLog::Write("[RadarPerf] territories=%zu drawCalls=%u cacheUpdates=%u ellipseRebuilds=%u",
-            territories.size(), s_drawTerritoryCalls, s_cacheUpdates, s_ellipseRebuilds);
+        DebugLog::Write("[RadarPerf] territories=%zu visible=%zu drawCalls=%u cacheUpdates=%u ellipseRebuilds=%u",
+            territories.size(), s_visible.size(), s_drawTerritoryCalls, s_cacheUpdates, s_ellipseRebuilds);
         s_drawTerritoryCalls = 0;
         s_cacheUpdates = 0;
         s_ellipseRebuilds = 0;
@@ -2,11 +2,14 @@
 #include <vector>
 
 struct Territory;
+class TerritoryOwnershipIndex;
 
 // All radar drawing + RenderWare Im2D helpers live here.
 // TerritorySystem owns territory state/ownership; renderer is stateless.
 class TerritoryRadarRenderer {
 public:
-    static void DrawRadarOverlay(const std::vector<Territory>& territories);
+    // ownership: TerritorySystem's index over the same list; its unlocked
+    // set for the current act is what gets drawn.
+    static void DrawRadarOverlay(const std::vector<Territory>& territories, const TerritoryOwnershipIndex& ownership);
     static void ResetTransientState();
 };
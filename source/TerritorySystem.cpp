@@ -1,9 +1,21 @@
 #include "TerritorySystem.h"
+#include "TerritoryFileParser.h"
+#include "TerritoryCache.h"
+#include "TerritoryDiff.h"
+#include "TerritoryChangeLog.h"
+#include "TerritoryOwnershipIndex.h"
+#include "TerritoryEditJournal.h"
+#include "TerritoryOverlap.h"
+#include "TerritoryPartitions.h"
+#include "SidecarFormat.h"
 #include "NeutralRevertRule.h"
+#include "NeutralRevertQueue.h"
 #include "TerritoryRadarRenderer.h"
 #include "DebugLog.h"
 #include "WaveManager.h"
+#include "ActManager.h"
 #include "IniConfig.h"
+#include "FileWatch.h"
 
 #include "CRadar.h"
 #include "CWorld.h"
@@ -13,6 +25,7 @@
 
 #include <cstdio>
 #include <algorithm>
+#include <chrono>
 #include <sys/stat.h>
 #include <cctype>
 #include <cstring>
@@ -24,43 +37,11 @@
 //
 // ownerGangCode is treated as DEFAULT owner (loaded into defaultOwnerGang)
 // underAttack is ignored as default and treated runtime-only
+//
+// Editor edits are appended to territories.txt.journal and replayed on top
+// of territories.txt at load until compacted (see TerritoryEditJournal.h).
 // ------------------------------------------------------------
 
-static float Dist2(float ax, float ay, float bx, float by) {
-    const float dx = ax - bx;
-    const float dy = ay - by;
-    return dx * dx + dy * dy;
-}
-
-static bool IsAllDigits(const std::string& s)
-{
-    if (s.empty()) return false;
-    for (char c : s) {
-        if (c < '0' || c > '9') return false;
-    }
-    return true;
-}
-
-static void StripNewline(char* s) {
-    if (!s) return;
-    for (char* p = s; *p; ++p) {
-        if (*p == '\n' || *p == '\r') { *p = 0; break; }
-    }
-}
-
-static char* LTrim(char* s) {
-    while (*s && std::isspace((unsigned char)*s)) ++s;
-    return s;
-}
-
-static void RTrim(char* s) {
-    size_t n = std::strlen(s);
-    while (n > 0 && std::isspace((unsigned char)s[n - 1])) {
-        s[n - 1] = 0;
-        --n;
-    }
-}
-
 static const char* GetConfigPathRelativeToASI()
 {
     static char path[MAX_PATH];
@@ -103,13 +84,63 @@ static const char* GetConfigPathRelativeToASI()
 // Static members
 // ------------------------------------------------------------
 std::vector<Territory> TerritorySystem::s_territories;
+TerritoryGrid TerritorySystem::s_grid;
+TerritoryBounds TerritorySystem::s_bounds;
+TerritoryIdIndex TerritorySystem::s_idIndex;
+TerritoryHandleTable TerritorySystem::s_handles;
+std::vector<int> TerritorySystem::s_rectHits;
+
+// Below this many territories a 4-wide SoA scan beats the grid's cell lookup.
+static constexpr int kSoaScanMaxTerritories = 64;
 bool TerritorySystem::s_overlayEnabled = true;
 
 // Default: 3 minutes before a neutral territory auto-reverts to its last owner
 static unsigned int s_neutralRevertMs = 3 * 60 * 1000;
 
-unsigned int TerritorySystem::s_nextReloadPollMs = 0;
-long long TerritorySystem::s_lastConfigStamp = -1;
+// Pending reverts, pushed by SetTerritoryOwner; Update only pops due ones.
+static NeutralRevertQueue s_revertQueue;
+static unsigned int s_lastRevertTickMs = 0;
+
+// Epochs and change notifications; flushed at the end of Update.
+static TerritoryChangeLog s_changes;
+
+// Per-gang/per-island bitsets; rebuilt with the indices, patched on every owner write.
+static TerritoryOwnershipIndex s_ownership;
+
+// Editor ops not yet folded into territories.txt, plus undo/redo history.
+static TerritoryEditJournal s_journal;
+// Replay cost on the next load grows with the journal; past this it is compacted.
+static constexpr int kJournalCompactOps = 256;
+
+// Owner transitions for the sidecar journal; TerritoryPersistence drains it on save.
+static OwnershipJournal s_ownerJournal;
+
+// Overlapping pairs and per-index membership; recomputed with the indices.
+// GetTerritoryAtPoint only resolves precedence for flagged territories.
+static std::vector<TerritoryOverlap::Pair> s_overlapPairs;
+static std::vector<unsigned char> s_overlapping;
+// Same-priority pairs logged one by one on reload; the rest only counted.
+static constexpr int kMaxReportedOverlaps = 16;
+
+// Island partitions for the current act. Point queries and the radar only
+// see the active ones: through s_activeGrid while some island is still
+// gated, through s_grid once every island is in.
+static TerritoryPartitions s_partitions;
+static TerritoryGrid s_activeGrid;
+
+// The player's territory and state for this tick; see UpdatePlayerContext.
+static PlayerContextTracker s_player;
+
+static void OnNeutralRevert(const Territory& t, int revertTo) {
+    DebugLog::Write("TerritorySystem: %s reverts to gang %d after %us neutral",
+        t.id.c_str(), revertTo, s_neutralRevertMs / 1000);
+    s_ownership.SetOwner((int)(&t - TerritorySystem::GetTerritories().data()), revertTo);
+    s_ownerJournal.Note(t.numId, -1, revertTo, CTimer::m_snTimeInMilliseconds);
+    s_changes.Mark(TerritorySystem::GetHandle(&t), TerritoryChangeLog::kOwner);
+}
+
+int TerritorySystem::s_configWatchId = 0;
+unsigned long long TerritorySystem::s_lastContentHash = 0;
 unsigned int TerritorySystem::s_lastReloadFailToastMs = 0;
 
 TerritorySystem::EditorState TerritorySystem::s_editor{};
@@ -118,161 +149,194 @@ const char* TerritorySystem::ConfigPath() {
     return GetConfigPathRelativeToASI();
 }
 
+const char* TerritorySystem::CachePath() {
+    static char path[MAX_PATH];
+    if (!path[0]) {
+        std::snprintf(path, sizeof(path), "%s", ConfigPath());
+        char* dot = std::strrchr(path, '.');
+        if (dot && (size_t)(dot - path) + 5 <= sizeof(path)) std::strcpy(dot, ".bin");
+    }
+    return path;
+}
+
+const char* TerritorySystem::JournalPath() {
+    static char path[MAX_PATH];
+    if (!path[0]) std::snprintf(path, sizeof(path), "%s.journal", ConfigPath());
+    return path;
+}
+
 void TerritorySystem::NormalizeRect(Territory& t) {
     if (t.minX > t.maxX) std::swap(t.minX, t.maxX);
     if (t.minY > t.maxY) std::swap(t.minY, t.maxY);
 }
 
-long long TerritorySystem::GetConfigStampOrNeg1() {
-    struct stat s {};
-    if (stat(ConfigPath(), &s) != 0) return -1;
-    return (long long)s.st_mtime;
+void TerritorySystem::RebuildIndices(TerritoryGrid* prebuiltGrid) {
+    s_idIndex.Build(s_territories);
+    s_handles.Sync(s_territories);
+    s_bounds.Assign(s_territories);
+    s_ownership.Build(s_territories);
+    if (prebuiltGrid && prebuiltGrid->Count() == (int)s_territories.size() && !s_territories.empty()) {
+        std::swap(s_grid, *prebuiltGrid);
+    } else {
+        s_grid.Build(s_territories);
+    }
+    RefreshOverlaps();
+    RebuildActiveSet();
+    DebugLog::Write("TerritorySystem: spatial index rebuilt (%d territories, %dx%d cells)",
+        s_grid.Count(), s_grid.CellsX(), s_grid.CellsY());
 }
 
-static bool ParseLineTerritory(const char* line, Territory& outT, std::string& outErr) {
-    if (!line || !line[0]) { outErr = "Empty line"; return false; }
-
-    char buf[512];
-    std::snprintf(buf, sizeof(buf), "%s", line);
-
-    char* tokens[8] = { 0 };
-    int count = 0;
-
-    char* p = buf;
-    while (count < 8) {
-        tokens[count++] = p;
-        char* comma = std::strchr(p, ',');
-        if (!comma) break;
-        *comma = 0;
-        p = comma + 1;
-    }
+void TerritorySystem::RebuildActiveSet() {
+    s_partitions.Build(s_territories, ActManager::GetCurrentAct());
+    RebuildActiveGrid();
+}
 
-    for (int i = 0; i < count; i++) {
-        char* t = LTrim(tokens[i]);
-        if (t != tokens[i]) std::memmove(tokens[i], t, std::strlen(t) + 1);
-        RTrim(tokens[i]);
+void TerritorySystem::RebuildActiveGrid() {
+    if (s_partitions.AllActive()) {
+        s_activeGrid.Clear();
+    } else {
+        s_activeGrid.Build(s_territories, s_partitions.Active());
     }
+}
 
-    if (count < 5) {
-        outErr = "Expected at least 5 comma-separated fields";
-        return false;
-    }
+void TerritorySystem::OnActChanged(int act) {
+    if (!s_partitions.SetAct(act)) return;
+    RebuildActiveGrid();
+    DebugLog::Write("TerritorySystem: act %d -> %d of %d territories active (Portland %d, Staunton %d, Shoreside %d)",
+        act, (int)s_partitions.Active().size(), (int)s_territories.size(),
+        s_partitions.PartitionSize(Island::PORTLAND), s_partitions.PartitionSize(Island::STAUNTON),
+        s_partitions.PartitionSize(Island::SHORESIDE));
+}
 
-    Territory t{};
-    t.id = tokens[0];
-    if (t.id.empty()) { outErr = "Missing id"; return false; }
+void TerritorySystem::RefreshOverlaps() {
+    TerritoryOverlap::Find(s_territories, s_overlapPairs);
+    TerritoryOverlap::MarkOverlapping((int)s_territories.size(), s_overlapPairs, s_overlapping);
+}
 
-    if (!IsAllDigits(t.id)) {
-        outErr = "Id must be numeric (e.g. 1001)";
-        return false;
+void TerritorySystem::ReportOverlaps(const std::vector<char>& text) {
+    if (s_overlapPairs.empty()) return;
+
+    std::vector<TerritoryFileParser::IdLine> lines;
+    TerritoryFileParser::ScanIdLines(text.data(), text.size(), lines);
+    // Territories added by journal replay have no line yet.
+    auto where = [&](const Territory& t, char (&buf)[16]) -> const char* {
+        auto it = std::lower_bound(lines.begin(), lines.end(), t.numId,
+            [](const TerritoryFileParser::IdLine& l, unsigned int id) { return l.numId < id; });
+        if (it == lines.end() || it->numId != t.numId) return "journal";
+        std::snprintf(buf, sizeof(buf), "line %d", it->line);
+        return buf;
+    };
+
+    int tied = 0;
+    for (const auto& p : s_overlapPairs) {
+        const Territory& a = s_territories[p.a];
+        const Territory& b = s_territories[p.b];
+        if (a.priority != b.priority) continue;
+        if (++tied > kMaxReportedOverlaps) continue;
+        char la[16], lb[16];
+        DebugLog::Write("TerritorySystem: %s (%s) overlaps %s (%s) at equal priority %d -> %s wins by id",
+            a.id.c_str(), where(a, la), b.id.c_str(), where(b, lb), a.priority,
+            TerritoryOverlap::TakesPrecedence(a, b) ? a.id.c_str() : b.id.c_str());
     }
+    DebugLog::Write("TerritorySystem: %d overlapping pairs (%d settled by prio:, %d by id%s)",
+        (int)s_overlapPairs.size(), (int)s_overlapPairs.size() - tied, tied,
+        tied > kMaxReportedOverlaps ? ", not all listed" : "");
+}
 
-    if (std::sscanf(tokens[1], "%f", &t.minX) != 1) { outErr = "Bad minX"; return false; }
-    if (std::sscanf(tokens[2], "%f", &t.minY) != 1) { outErr = "Bad minY"; return false; }
-    if (std::sscanf(tokens[3], "%f", &t.maxX) != 1) { outErr = "Bad maxX"; return false; }
-    if (std::sscanf(tokens[4], "%f", &t.maxY) != 1) { outErr = "Bad maxY"; return false; }
-
-    t.ownerGang = -1;
-    t.defaultOwnerGang = -1;
-    t.underAttack = false;
-    t.defenseLevel = 1;
+static bool ReadWholeFile(const char* path, std::vector<char>& data) {
+    data.clear();
+    FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
 
-    if (count >= 6 && tokens[5] && tokens[5][0]) {
-        int code = -1;
-        if (std::sscanf(tokens[5], "%d", &code) != 1) { outErr = "Bad ownerGangCode"; return false; }
-        t.ownerGang = code;
-        t.defaultOwnerGang = code;
-    } else {
-        t.ownerGang = -1;
-        t.defaultOwnerGang = -1;
+    if (std::fseek(f, 0, SEEK_END) == 0) {
+        const long size = std::ftell(f);
+        if (size > 0) data.resize((size_t)size);
+        std::fseek(f, 0, SEEK_SET);
     }
+    const size_t got = data.empty() ? 0 : std::fread(data.data(), 1, data.size(), f);
+    std::fclose(f);
+    data.resize(got);
+    return true;
+}
 
-    // UnderAttack in file is ignored for defaults; always runtime-only
-    // Defense level optional
-    if (count >= 8 && tokens[7] && tokens[7][0]) {
-        int dl = 1;
-        if (std::sscanf(tokens[7], "%d", &dl) != 1) { outErr = "Bad defenseLevel"; return false; }
-        if (dl < 0) dl = 0;
-        if (dl > 2) dl = 2;
-        t.defenseLevel = dl;
-    }
+static bool WriteCacheFile(const char* path, const std::vector<unsigned char>& image) {
+    char tmpPath[MAX_PATH];
+    std::snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
 
-    if (t.minX > t.maxX) std::swap(t.minX, t.maxX);
-    if (t.minY > t.maxY) std::swap(t.minY, t.maxY);
+    FILE* f = std::fopen(tmpPath, "wb");
+    if (!f) return false;
+    const bool ok = std::fwrite(image.data(), 1, image.size(), f) == image.size();
+    std::fclose(f);
+    if (!ok) { std::remove(tmpPath); return false; }
 
-    outT = t;
+    std::remove(path);
+    if (std::rename(tmpPath, path) != 0) { std::remove(tmpPath); return false; }
     return true;
 }
 
-bool TerritorySystem::LoadFromFile(std::vector<Territory>& out, std::string& outErr) {
-    out.clear();
+static double MsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
 
-    FILE* f = std::fopen(ConfigPath(), "rb");
-    if (!f) {
+bool TerritorySystem::ReadConfigText(std::vector<char>& text, std::string& outErr) {
+    // One read for the whole file; the parser slices lines out of it in place.
+    if (!ReadWholeFile(ConfigPath(), text)) {
         outErr = "Could not open territories.txt";
         return false;
     }
+    return true;
+}
 
-    char line[512];
-    int lineNo = 0;
-
-    while (std::fgets(line, sizeof(line), f)) {
-        lineNo++;
-
-        StripNewline(line);
-        char* p = LTrim(line);
-        RTrim(p);
-
-        if (!p[0]) continue;
-        if (p[0] == '#') continue;
-
-        Territory t{};
-        std::string perr;
-        if (!ParseLineTerritory(p, t, perr)) {
-            char buf2[256];
-            std::snprintf(buf2, sizeof(buf2), "Parse error line %d: %s", lineNo, perr.c_str());
-            outErr = buf2;
-            std::fclose(f);
-            return false;
-        }
-
-        auto dup = std::find_if(out.begin(), out.end(), [&](const Territory& x) { return x.id == t.id; });
-        if (dup != out.end()) {
-            char buf2[256];
-            std::snprintf(buf2, sizeof(buf2), "Duplicate id '%s' at line %d", t.id.c_str(), lineNo);
-            outErr = buf2;
-            std::fclose(f);
-            return false;
-        }
-
-        out.push_back(t);
+bool TerritorySystem::LoadFromText(const std::vector<char>& text, unsigned long long hash,
+    std::vector<Territory>& out, TerritoryGrid& outGrid, bool& outFromCache, std::string& outErr)
+{
+    out.clear();
+    outGrid.Clear();
+    outFromCache = false;
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    // The compiled cache is only trusted if it was built from these exact bytes.
+    std::vector<char> cache;
+    std::string cacheErr = "cache: missing";
+    if (ReadWholeFile(CachePath(), cache) &&
+        TerritoryCache::Load((const unsigned char*)cache.data(), cache.size(), hash, out, &outGrid, cacheErr)) {
+        outFromCache = true;
+        DebugLog::Write("TerritorySystem: loaded %d territories from territories.bin in %.2f ms (grid %s)",
+            (int)out.size(), MsSince(t0), outGrid.IsEmpty() ? "rebuilt" : "cached");
+        return true;
     }
 
-    std::fclose(f);
-
-    if (out.empty()) {
-        outErr = "No territories loaded";
+    if (!TerritoryFileParser::ParseBuffer(text.data(), text.size(), out, outErr)) {
         return false;
     }
 
+    DebugLog::Write("TerritorySystem: parsed %d territories from text in %.2f ms (%s)",
+        (int)out.size(), MsSince(t0), cacheErr.c_str());
     return true;
 }
 
-// NOTE: SaveToFile is still used by the editor to modify rectangles/defaults.
+void TerritorySystem::WriteCache(unsigned long long hash) {
+    std::vector<unsigned char> image;
+    TerritoryCache::Build(s_territories, &s_grid, hash, image);
+    if (!WriteCacheFile(CachePath(), image)) {
+        DebugLog::Write("TerritorySystem: territories.bin write FAILED");
+    }
+}
+
+// NOTE: only journal compaction rewrites the whole file; editor edits append to the journal.
 static bool AtomicWriteTerritories(const char* finalPath, const char* tmpPath, const char* bakPath,
-    const std::vector<Territory>& terrs, std::string& outErr)
+    const std::string& text, std::string& outErr)
 {
     FILE* f = std::fopen(tmpPath, "wb");
     if (!f) { outErr = "Failed to open temp file for write"; return false; }
-
-    std::fprintf(f, "# id,minX,minY,maxX,maxY,ownerGangCode,underAttack,defenseLevel\n");
-    for (const auto& t : terrs) {
-        std::fprintf(f, "%s,%.3f,%.3f,%.3f,%.3f,%d,%d,%d\n",
-            t.id.c_str(), t.minX, t.minY, t.maxX, t.maxY,
-            t.defaultOwnerGang, 0, t.defenseLevel);
-    }
-
+    const bool written = std::fwrite(text.data(), 1, text.size(), f) == text.size();
     std::fclose(f);
+    if (!written) {
+        outErr = "Failed to write temp file";
+        std::remove(tmpPath);
+        return false;
+    }
 
     std::remove(bakPath);
     std::rename(finalPath, bakPath);
@@ -284,10 +348,20 @@ static bool AtomicWriteTerritories(const char* finalPath, const char* tmpPath, c
     return true;
 }
 
-bool TerritorySystem::SaveToFile(const std::vector<Territory>& terrs, std::string& outErr) {
-    std::vector<Territory> sorted = terrs;
+bool TerritorySystem::SaveToFile(const std::vector<Territory>& terrs, unsigned long long& outHash,
+    std::string& outErr)
+{
+    std::vector<const Territory*> sorted(terrs.size());
+    for (size_t i = 0; i < terrs.size(); ++i) sorted[i] = &terrs[i];
     std::sort(sorted.begin(), sorted.end(),
-        [](const Territory& a, const Territory& b) { return a.id < b.id; });
+        [](const Territory* a, const Territory* b) { return a->id < b->id; });
+
+    std::string text = "# id,minX,minY,maxX,maxY,ownerGangCode,underAttack,defenseLevel[,poly:x y;x y;...]\n";
+    for (const Territory* t : sorted) {
+        TerritoryFileParser::FormatLine(*t, text);
+        text += '\n';
+    }
+    outHash = TerritoryCache::HashText(text.data(), text.size());
 
     const char* finalPath = ConfigPath();
 
@@ -296,16 +370,116 @@ bool TerritorySystem::SaveToFile(const std::vector<Territory>& terrs, std::strin
     std::snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", finalPath);
     std::snprintf(bakPath, sizeof(bakPath), "%s.bak", finalPath);
 
-    return AtomicWriteTerritories(finalPath, tmpPath, bakPath, sorted, outErr);
+    return AtomicWriteTerritories(finalPath, tmpPath, bakPath, text, outErr);
+}
+
+bool TerritorySystem::LoadJournal(unsigned long long textHash) {
+    std::vector<char> data;
+    if (!ReadWholeFile(JournalPath(), data)) {
+        s_journal.Reset(textHash);
+        return false;
+    }
+
+    // Left behind by a session that never compacted (crash or killed process).
+    unsigned long long base = 0;
+    std::vector<TerritoryEditJournal::Op> ops;
+    std::string err;
+    if (!TerritoryEditJournal::Parse(data.data(), data.size(), base, ops, err)) {
+        DebugLog::Write("TerritorySystem: %s (keeping %d ops before it)", err.c_str(), (int)ops.size());
+    }
+    if (base != textHash && !ops.empty()) {
+        DebugLog::Write("TerritorySystem: territories.txt changed under the journal; replaying %d ops by id",
+            (int)ops.size());
+    }
+    s_journal.Adopt(base, ops);
+    return true;
+}
+
+bool TerritorySystem::ReplayJournal(std::vector<Territory>& terrs) {
+    const auto& ops = s_journal.Ops();
+    for (const auto& op : ops) {
+        std::string err;
+        if (!TerritoryEditJournal::Apply(terrs, op, err)) {
+            DebugLog::Write("TerritorySystem: journal op for %u skipped: %s", op.numId, err.c_str());
+        }
+    }
+    return !ops.empty();
+}
+
+bool TerritorySystem::ApplyEditorOp(const TerritoryEditJournal::Op& op) {
+    std::string err;
+    if (!TerritoryEditJournal::Apply(s_territories, op, err)) {
+        DebugLog::Write("TerritoryEditor: edit FAILED: %s", err.c_str());
+        return false;
+    }
+    RebuildIndices();
+    s_changes.MarkAll(TerritoryChangeLog::kGeometry);
+    WaveManager::OnTerritoriesRebuilt();
+
+    const int idx = op.kind == TerritoryEditJournal::kAdd ? s_idIndex.Find(op.numId) : -1;
+    if (idx >= 0 && s_overlapping[idx]) {
+        int with = 0;
+        for (const auto& p : s_overlapPairs) with += (p.a == idx || p.b == idx);
+        DebugLog::Write("TerritoryEditor: %u overlaps %d territories", op.numId, with);
+    }
+    return true;
+}
+
+void TerritorySystem::FlushJournal() {
+    std::string text;
+    s_journal.TakeAppendText(text);
+    if (text.empty()) return;
+
+    // territories.txt is untouched, so the file watch sees no change.
+    FILE* f = std::fopen(JournalPath(), "ab");
+    bool ok = f != nullptr;
+    if (f) {
+        ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+        std::fclose(f);
+    }
+
+    if (!ok) {
+        DebugLog::Write("TerritoryEditor: journal append FAILED -> rewriting territories.txt");
+        CompactJournal();
+    } else if ((int)s_journal.Ops().size() >= kJournalCompactOps) {
+        CompactJournal();
+    }
+}
+
+bool TerritorySystem::CompactJournal() {
+    struct stat st {};
+    if (s_journal.Ops().empty() && stat(JournalPath(), &st) != 0) return true;
+    if (s_territories.empty()) return false; // never loaded (or emptied): leave both files alone
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const int ops = (int)s_journal.Ops().size();
+
+    unsigned long long hash = 0;
+    std::string err;
+    if (!SaveToFile(s_territories, hash, err)) {
+        // The journal stays; the next load replays it.
+        DebugLog::Write("TerritorySystem: journal compaction FAILED: %s", err.c_str());
+        return false;
+    }
+    std::remove(JournalPath());
+    s_journal.MarkCompacted(hash);
+
+    // Our own write: remember it so the file watch does not reload it.
+    s_lastContentHash = hash;
+    FileWatch::Instance().Acknowledge(ConfigPath());
+    WriteCache(hash);
+
+    DebugLog::Write("TerritorySystem: journal compacted (%d ops) into territories.txt in %.2f ms",
+        ops, MsSince(t0));
+    return true;
 }
 
 int TerritorySystem::ComputeNextId(const std::vector<Territory>& terrs) {
-    int best = 1000;
+    unsigned int best = 1000;
     for (const auto& t : terrs) {
-        int id = std::atoi(t.id.c_str());
-        if (id > best) best = id;
+        if (t.numId > best) best = t.numId;
     }
-    return best + 1;
+    return (int)(best + 1);
 }
 
 bool TerritorySystem::GetPlayerXY(float& outX, float& outY) {
@@ -319,76 +493,193 @@ bool TerritorySystem::GetPlayerXY(float& outX, float& outY) {
 
 void TerritorySystem::TryReloadNow(bool showToastOnFail) {
     DebugLog::Write("TerritorySystem::TryReloadNow called (warActive=%d)", (int)WaveManager::IsWarActive());
-    // Snapshot runtime ownership BEFORE we reload the file.
-    // This is the key: hot reload should keep the persisted/runtime ownership in memory,
-    // not revert ownership back to defaults from territories.txt.
-    std::vector<OwnershipEntry> prevOwnership;
-    GetOwnershipState(prevOwnership);
 
+    // Stamped before the read: a write landing after it still gets reported.
+    FileWatch::Instance().Acknowledge(ConfigPath());
+
+    std::vector<char> text;
+    std::string err;
+    if (!ReadConfigText(text, err)) {
+        const unsigned int now = CTimer::m_snTimeInMilliseconds;
+        if (showToastOnFail && (now - s_lastReloadFailToastMs) > 2000) {
+            s_lastReloadFailToastMs = now;
+            DebugLog::Write("TerritorySystem: Reload failed: %s", err.c_str());
+        }
+        return;
+    }
+    ApplyConfigText(text, TerritoryCache::HashText(text.data(), text.size()), showToastOnFail);
+}
+
+void TerritorySystem::OnConfigFileChanged(const std::vector<char>& text, unsigned long long hash, void*) {
+    DebugLog::Write("TerritorySystem: territories.txt changed on disk (warActive=%d)", (int)WaveManager::IsWarActive());
+    ApplyConfigText(text, hash, true);
+}
+
+void TerritorySystem::ApplyConfigText(const std::vector<char>& text, unsigned long long hash, bool showToastOnFail) {
     std::vector<Territory> next;
+    TerritoryGrid nextGrid;
+    bool fromCache = false;
     std::string err;
 
-    if (!LoadFromFile(next, err)) {
+    // Saving without edits (or touching the file) moves the mtime but not the bytes.
+    if (hash == s_lastContentHash && !s_territories.empty()) {
+        DebugLog::Write("TerritorySystem: territories.txt touched but content unchanged -> reload skipped");
+        return;
+    }
+
+    if (!LoadFromText(text, hash, next, nextGrid, fromCache, err)) {
         const unsigned int now = CTimer::m_snTimeInMilliseconds;
         if (showToastOnFail && (now - s_lastReloadFailToastMs) > 2000) {
             s_lastReloadFailToastMs = now;
             DebugLog::Write("TerritorySystem: Reload failed: %s", err.c_str());
         }
-        DebugLog::Write("TerritorySystem::TryReloadNow: LoadFromFile FAILED -> returning early (warActive=%d)",
+        DebugLog::Write("TerritorySystem::ApplyConfigText: load FAILED -> returning early (warActive=%d)",
             (int)WaveManager::IsWarActive());
         return;
     }
 
-    if (WaveManager::IsWarActive()) {
-        DebugLog::Write("TerritorySystem: hot reload during war -> cancel war");
-        WaveManager::CancelWar();
+    // Uncompacted editor ops apply on top of whatever territories.txt holds,
+    // so an outside edit does not drop them. The cached grid no longer
+    // matches next afterwards.
+    const bool firstLoad = s_territories.empty();
+    const bool journalFound = firstLoad && LoadJournal(hash);
+    const bool replayed = ReplayJournal(next);
+    if (replayed) nextGrid.Clear();
+
+    if (firstLoad) {
+        // First load: nothing to preserve, take the whole set.
+        s_territories.swap(next);
+        RebuildIndices(&nextGrid);
+        ClearAllWarsAndTransientState();
+        s_changes.MarkAll(TerritoryChangeLog::kAll);
+        WaveManager::OnTerritoriesRebuilt();
+    } else {
+        ApplyReloadDiff(next, nextGrid);
     }
 
+    // s_grid now answers exactly like a fresh build over the new file, so it
+    // can be cached even when it was only patched (not with journal ops on top).
+    if (!fromCache && !replayed) WriteCache(hash);
+    ReportOverlaps(text);
 
-    // Swap in the new geometry/defaults from file…
-    s_territories.swap(next);
+    s_editor.nextId = ComputeNextId(s_territories);
+    s_lastContentHash = hash;
 
-    // …then re-apply runtime ownership from memory (sidecar state).
-    // Any IDs not found in prevOwnership will remain whatever the file says (defaults).
-    ApplyOwnershipState(prevOwnership);
+    if (journalFound) CompactJournal();
+}
 
-    // Runtime-only flags should stay runtime-only.
-    ClearAllWarsAndTransientState();
+void TerritorySystem::ApplyReloadDiff(std::vector<Territory>& next, TerritoryGrid& nextGrid) {
+    const auto t0 = std::chrono::steady_clock::now();
 
-    s_editor.nextId = ComputeNextId(s_territories);
+    TerritoryDiff::Result diff;
+    TerritoryDiff::Compute(s_territories, s_idIndex, next, diff);
 
-    DebugLog::Write("TerritorySystem: Reloaded %d territories (ownership preserved)", (int)s_territories.size());
-    s_lastConfigStamp = GetConfigStampOrNeg1();
-}
+    if (diff.Empty()) {
+        DebugLog::Write("TerritorySystem: Reloaded, no territory changes");
+        return;
+    }
 
+    // The war only has to stop if the ground it is being fought on moved.
+    bool warGeometryChanged = false;
+    const Territory* war = WaveManager::GetActiveTerritory();
+    const int warIdx = war ? (int)(war - s_territories.data()) : -1;
+
+    int geometryChanges = 0;
+    std::vector<Territory> before;
+    for (const auto& c : diff.changed) {
+        if (!c.geometry) continue;
+        ++geometryChanges;
+        before.push_back(s_territories[c.index]);
+        if (c.index == warIdx) warGeometryChanged = true;
+    }
 
-void TerritorySystem::ForceReloadNow() {
-    TryReloadNow(true);
-}
+    TerritoryDiff::Apply(s_territories, next, diff);
 
-void TerritorySystem::HotReloadTick(unsigned int nowMs) {
-    if (nowMs < s_nextReloadPollMs) return;
-    s_nextReloadPollMs = nowMs + 1000;
+    // Each grid splice is a pass over every cell list, so a large batch of
+    // edits is cheaper as one rebuild.
+    const int edits = (int)(diff.removed.size() + diff.added.size()) + geometryChanges;
+    bool patched = !diff.reordered && diff.AddedAtTail() && edits * 8 <= (int)s_territories.size();
 
-    const long long stamp = GetConfigStampOrNeg1();
-    if (stamp < 0) return;
+    if (patched) {
+        for (auto it = diff.removed.rbegin(); it != diff.removed.rend(); ++it) {
+            s_grid.Erase(*it);
+        }
 
-    if (s_lastConfigStamp < 0) {
-        s_lastConfigStamp = stamp;
-        return;
+        size_t b = 0, r = 0;
+        for (const auto& c : diff.changed) {
+            while (r < diff.removed.size() && diff.removed[r] < c.index) ++r;
+            const int idx = c.index - (int)r; // index after the erases above
+            if (!diff.Structural()) s_bounds.Set(idx, s_territories[idx]);
+            if (c.geometry && patched) patched = s_grid.Update(idx, before[b++], s_territories[idx]);
+        }
+
+        for (size_t k = 0; patched && k < diff.added.size(); ++k) {
+            patched = s_grid.Append(s_territories[diff.added[k]]);
+        }
+    }
+
+    if (diff.Structural() || !patched) {
+        s_changes.MarkAll(TerritoryChangeLog::kGeometry);
+    } else if (geometryChanges) {
+        for (const auto& c : diff.changed) {
+            if (c.geometry) s_changes.Mark(s_handles.HandleAt(c.index), TerritoryChangeLog::kGeometry);
+        }
     }
 
-    if (stamp != s_lastConfigStamp) {
-        TryReloadNow(true);
+    if (!patched) {
+        // Fall back to the full set (the cache grid matches next's order).
+        RebuildIndices(&nextGrid);
+    } else if (diff.Structural()) {
+        if (diff.removed.empty()) {
+            for (int j : diff.added) s_idIndex.Insert(s_territories[j].numId, j);
+        } else {
+            s_idIndex.Build(s_territories);
+        }
+        s_handles.Sync(s_territories);
+        s_bounds.Assign(s_territories);
     }
+    if (patched) {
+        s_ownership.Build(s_territories); // areas and islands may have moved
+        RefreshOverlaps();
+        RebuildActiveSet();
+    }
+
+    DebugLog::Write("TerritorySystem: Reloaded %d territories (+%d -%d ~%d, %d geometry, %s) in %.2f ms",
+        (int)s_territories.size(), (int)diff.added.size(), (int)diff.removed.size(),
+        (int)diff.changed.size(), geometryChanges, patched ? "patched" : "rebuilt", MsSince(t0));
+
+    if (warGeometryChanged) {
+        DebugLog::Write("TerritorySystem: war territory geometry changed -> cancel war");
+        WaveManager::CancelWar();
+    }
+    WaveManager::OnTerritoriesRebuilt();
+}
+
+void TerritorySystem::ForceReloadNow() {
+    TryReloadNow(true);
 }
 
 void TerritorySystem::Init() {
     s_territories.clear();
+    s_grid.Clear();
+    s_bounds.Clear();
+    s_idIndex.Clear();
+    s_handles.Clear();
     s_overlayEnabled = true;
 
-    s_nextReloadPollMs = 0;
     s_lastReloadFailToastMs = 0;
+    s_lastContentHash = 0;
+    s_revertQueue.Clear();
+    s_lastRevertTickMs = 0;
+    s_changes.Reset();
+    s_ownership.Clear();
+    s_journal.Reset(0);
+    s_ownerJournal.Reset();
+    s_overlapPairs.clear();
+    s_overlapping.clear();
+    s_partitions.Clear();
+    s_activeGrid.Clear();
+    s_player.Reset();
 
     // Read neutral revert timer from INI (default 180s = 3 minutes)
     auto& ini = IniConfig::Instance();
@@ -397,6 +688,10 @@ void TerritorySystem::Init() {
     s_neutralRevertMs = (unsigned int)(revertSec * 1000);
     DebugLog::Write("TerritorySystem: neutral revert timer = %ds", revertSec);
 
+    // Hot reload: FileWatch (ticked from the main loop) hands over the new
+    // bytes when territories.txt changes.
+    FileWatch::Instance().Unwatch(s_configWatchId);
+    s_configWatchId = FileWatch::Instance().Watch(ConfigPath(), OnConfigFileChanged);
     TryReloadNow(true);
 
     s_editor.enabled = false;
@@ -406,7 +701,24 @@ void TerritorySystem::Init() {
 }
 
 void TerritorySystem::Shutdown() {
+    FileWatch::Instance().Unwatch(s_configWatchId);
+    s_configWatchId = 0;
+    CompactJournal();
+    s_journal.Reset(0);
+    s_ownerJournal.Reset();
+    s_revertQueue.Clear();
+    s_changes.Reset();
+    s_ownership.Clear();
+    s_overlapPairs.clear();
+    s_overlapping.clear();
+    s_partitions.Clear();
+    s_activeGrid.Clear();
+    s_player.Reset();
     s_territories.clear();
+    s_grid.Clear();
+    s_bounds.Clear();
+    s_idIndex.Clear();
+    s_handles.Clear();
 }
 
 void TerritorySystem::SetNeutralRevertMs(unsigned int ms) { s_neutralRevertMs = ms; }
@@ -414,20 +726,34 @@ unsigned int TerritorySystem::GetNeutralRevertMs() { return s_neutralRevertMs; }
 
 void TerritorySystem::Update() {
     const unsigned int now = CTimer::m_snTimeInMilliseconds;
-    HotReloadTick(now);
+
+    // Game time only runs backwards across a save load, which leaves the
+    // queue's ordering meaningless: take one full pass and re-seed it.
+    if (now < s_lastRevertTickMs) RescanNeutralReverts(now, true);
+    s_lastRevertTickMs = now;
 
     // Auto-revert neutral territories to their last owner after the configured window
-    for (auto& t : s_territories) {
-        if (t.ownerGang == -1 && !t.underAttack &&
-            NeutralRevertDue(t.neutralSinceMs, now, s_neutralRevertMs)) {
-            const int revertTo = NeutralRevertTarget(t.lastOwnerGang, t.defaultOwnerGang);
-            if (revertTo != -1) {
-                DebugLog::Write("TerritorySystem: %s reverts to gang %d after %us neutral",
-                    t.id.c_str(), revertTo, s_neutralRevertMs / 1000);
-                t.ownerGang = revertTo;
-                t.neutralSinceMs = 0;
-            }
+    s_revertQueue.ProcessDue(now, s_neutralRevertMs,
+        [](TerritoryHandle h) -> Territory* {
+            const int idx = s_handles.IndexOf(h);
+            return (idx >= 0) ? &s_territories[idx] : nullptr;
+        },
+        OnNeutralRevert);
+
+    s_changes.Flush();
+}
+
+void TerritorySystem::RescanNeutralReverts(unsigned int nowMs, bool applyDue) {
+    s_revertQueue.Clear();
+    for (int i = 0; i < (int)s_territories.size(); ++i) {
+        Territory& t = s_territories[i];
+        if (t.ownerGang != -1 || t.neutralSinceMs == 0) continue;
+
+        if (applyDue && NeutralRevertDue(t.neutralSinceMs, nowMs, s_neutralRevertMs) &&
+            NeutralRevertQueue::TryRevert(t, OnNeutralRevert)) {
+            continue;
         }
+        s_revertQueue.Push(s_handles.HandleAt(i), t.neutralSinceMs);
     }
 }
 
@@ -441,94 +767,233 @@ bool TerritorySystem::IsOverlayEnabled() {
 }
 
 const Territory* TerritorySystem::GetTerritoryAtPoint(const CVector& pos) {
-    for (const auto& t : s_territories) {
-        if (t.ContainsPoint(pos)) return &t;
+    // The SoA scan covers every territory and skips gated ones; the grid
+    // only holds the active ones to begin with.
+    const bool scan = s_bounds.Count() <= kSoaScanMaxTerritories;
+    const TerritoryGrid& grid = s_partitions.AllActive() ? s_grid : s_activeGrid;
+    const Territory* best = nullptr;
+    for (int idx = 0;; ++idx) {
+        idx = scan ? s_bounds.FindFirstContaining(pos.x, pos.y, idx)
+                   : grid.QueryPoint(pos.x, pos.y, idx);
+        if (idx < 0) return best;
+        if (scan && !s_partitions.IsActive(idx)) continue;
+
+        // Both indices only know boxes; outlines get the exact test here.
+        const Territory& t = s_territories[idx];
+        if (!t.poly.Empty() && !t.poly.Contains(pos.x, pos.y)) continue;
+
+        // A territory that overlaps nothing has no rival at this point; only
+        // flagged ones keep scanning for the one that takes precedence.
+        if (!best && !s_overlapping[idx]) return &t;
+        if (!best || TerritoryOverlap::TakesPrecedence(t, *best)) best = &t;
     }
-    return nullptr;
+}
+
+void TerritorySystem::GetTerritoriesInRect(float minX, float minY, float maxX, float maxY,
+    std::vector<const Territory*>& out)
+{
+    s_grid.QueryRect(minX, minY, maxX, maxY, s_rectHits);
+
+    out.clear();
+    out.reserve(s_rectHits.size());
+    for (int idx : s_rectHits) out.push_back(&s_territories[idx]);
+}
+
+const Territory* TerritorySystem::GetNearestTerritory(float x, float y) {
+    const int idx = s_grid.QueryNearest(x, y);
+    return (idx >= 0) ? &s_territories[idx] : nullptr;
 }
 
 const Territory* TerritorySystem::GetTerritoryAtPlayer() {
+    return Resolve(s_player.Context().territory);
+}
+
+void TerritorySystem::UpdatePlayerContext() {
+    static PlayerContextTracker::Source s_source;
+    if (!s_source.query) {
+        s_source.query = [](const CVector& pos, void*) { return GetHandle(GetTerritoryAtPoint(pos)); };
+        s_source.resolve = [](TerritoryHandle h, void*) { return Resolve(h); };
+        // A flagged territory may lose the point to a rival without the
+        // player leaving it, so it always gets the full query.
+        s_source.contested = [](TerritoryHandle h, void*) {
+            const int idx = s_handles.IndexOf(h);
+            return idx >= 0 && idx < (int)s_overlapping.size() && s_overlapping[idx] != 0;
+        };
+    }
+
     CPlayerPed* player = CWorld::Players[0].m_pPed;
-    if (!player) return nullptr;
-    return GetTerritoryAtPoint(player->GetPosition());
+    const bool inVehicle = player && (player->m_bInVehicle ||
+        player->m_ePedState == PEDSTATE_DRIVING ||
+        player->m_ePedState == PEDSTATE_PASSENGER);
+    s_player.Update(player != nullptr, player ? player->GetPosition() : CVector(0, 0, 0), inVehicle,
+        ActManager::GetCurrentAct(), s_changes.Epoch(TerritoryChangeLog::kGeometry), s_source);
+}
+
+const PlayerContext& TerritorySystem::GetPlayerContext() {
+    return s_player.Context();
+}
+
+int TerritorySystem::SubscribePlayerEvents(unsigned int kinds, PlayerContextTracker::Callback cb, void* user) {
+    return s_player.Subscribe(kinds, cb, user);
+}
+
+void TerritorySystem::UnsubscribePlayerEvents(int id) {
+    s_player.Unsubscribe(id);
 }
 
 bool TerritorySystem::HasRealTerritories() {
     return !s_territories.empty();
 }
 
+TerritoryHandle TerritorySystem::FindTerritoryById(unsigned int id) {
+    return s_handles.HandleForId(id);
+}
+
+TerritoryHandle TerritorySystem::GetHandle(const Territory* t) {
+    if (!t || s_territories.empty()) return TerritoryHandle();
+
+    // Pointers into the live list map straight to their index…
+    const Territory* base = s_territories.data();
+    if (t >= base && t < base + s_territories.size()) {
+        return s_handles.HandleAt((int)(t - base));
+    }
+
+    // …anything else (a copy, or a pointer from before a rebuild) goes by id.
+    return s_handles.HandleForId(t->numId);
+}
+
+const Territory* TerritorySystem::Resolve(TerritoryHandle h) {
+    const int idx = s_handles.IndexOf(h);
+    if (idx < 0 || idx >= (int)s_territories.size()) return nullptr;
+    return &s_territories[idx];
+}
+
+int TerritorySystem::GetHandleSlotCount() {
+    return s_handles.SlotCount();
+}
+
 int TerritorySystem::GetPlayerGang() {
     return PEDTYPE_GANG1;
 }
 
+unsigned int TerritorySystem::GetChangeEpoch(unsigned int kinds) {
+    return s_changes.Epoch(kinds);
+}
+
+const TerritoryOwnershipIndex& TerritorySystem::GetOwnershipIndex() {
+    return s_ownership;
+}
+
+int TerritorySystem::SubscribeChanges(unsigned int kinds, TerritoryChangeLog::Callback cb, void* user) {
+    return s_changes.Subscribe(kinds, cb, user);
+}
+
+void TerritorySystem::UnsubscribeChanges(int id) {
+    s_changes.Unsubscribe(id);
+}
+
 // ------------------------------------------------------------
 // Runtime-only mutations (no territories.txt writes)
 // ------------------------------------------------------------
-void TerritorySystem::SetTerritoryOwner(const Territory* t, int newOwnerGang) {
-    if (!t) return;
+void TerritorySystem::SetTerritoryOwner(TerritoryHandle h, int newOwnerGang) {
+    const int idx = s_handles.IndexOf(h);
+    if (idx < 0) return;
+    Territory& terr = s_territories[idx];
 
     const unsigned int now = CTimer::m_snTimeInMilliseconds;
 
-    for (auto& terr : s_territories) {
-        if (terr.id == t->id) {
-            // Track last real owner before going neutral so auto-revert knows who to restore
-            if (newOwnerGang == -1 && terr.ownerGang != -1) {
-                terr.lastOwnerGang = terr.ownerGang;
-                terr.neutralSinceMs = now;
-            } else if (newOwnerGang != -1) {
-                terr.neutralSinceMs = 0; // no longer neutral — clear timer
-            }
-            terr.ownerGang = newOwnerGang;
-            terr.underAttack = false;
-            DebugLog::Write("TerritorySystem: %s owner=%d (runtime, lastOwner=%d)",
-                t->id.c_str(), newOwnerGang, terr.lastOwnerGang);
-            break;
-        }
+    // Track last real owner before going neutral so auto-revert knows who to restore
+    if (newOwnerGang == -1 && terr.ownerGang != -1) {
+        terr.lastOwnerGang = terr.ownerGang;
+        terr.neutralSinceMs = now;
+        s_revertQueue.Push(h, now);
+    } else if (newOwnerGang != -1) {
+        terr.neutralSinceMs = 0; // no longer neutral — clear timer (queued entry goes stale)
     }
+    unsigned int changed = 0;
+    if (terr.ownerGang != newOwnerGang) changed |= TerritoryChangeLog::kOwner;
+    if (terr.underAttack) changed |= TerritoryChangeLog::kUnderAttack;
+    s_changes.Mark(h, changed);
+    s_ownership.SetOwner(idx, newOwnerGang);
+    s_ownerJournal.Note(terr.numId, terr.ownerGang, newOwnerGang, now);
+
+    terr.ownerGang = newOwnerGang;
+    terr.underAttack = false;
+    DebugLog::Write("TerritorySystem: %s owner=%d (runtime, lastOwner=%d)",
+        terr.id.c_str(), newOwnerGang, terr.lastOwnerGang);
 }
 
-void TerritorySystem::SetUnderAttack(const Territory* t, bool underAttack) {
-    if (!t) return;
+void TerritorySystem::SetTerritoryOwner(const Territory* t, int newOwnerGang) {
+    SetTerritoryOwner(GetHandle(t), newOwnerGang);
+}
 
-    for (auto& terr : s_territories) {
-        if (terr.id == t->id) {
-            terr.underAttack = underAttack;
-            DebugLog::Write("TerritorySystem: %s underAttack=%d (runtime)", t->id.c_str(), underAttack ? 1 : 0);
-            break;
-        }
-    }
+void TerritorySystem::SetUnderAttack(TerritoryHandle h, bool underAttack) {
+    const int idx = s_handles.IndexOf(h);
+    if (idx < 0) return;
+    Territory& terr = s_territories[idx];
+
+    if (terr.underAttack != underAttack) s_changes.Mark(h, TerritoryChangeLog::kUnderAttack);
+    terr.underAttack = underAttack;
+    DebugLog::Write("TerritorySystem: %s underAttack=%d (runtime)", terr.id.c_str(), underAttack ? 1 : 0);
+}
+
+void TerritorySystem::SetUnderAttack(const Territory* t, bool underAttack) {
+    SetUnderAttack(GetHandle(t), underAttack);
 }
 
 void TerritorySystem::ResetOwnershipToDefaults() {
-    for (auto& t : s_territories) {
+    for (int i = 0; i < (int)s_territories.size(); ++i) {
+        Territory& t = s_territories[i];
+        if (t.ownerGang == t.defaultOwnerGang) continue;
         t.ownerGang = t.defaultOwnerGang;
+        s_ownership.SetOwner(i, t.ownerGang);
+        s_changes.Mark(s_handles.HandleAt(i), TerritoryChangeLog::kOwner);
     }
+    RescanNeutralReverts(CTimer::m_snTimeInMilliseconds, false);
 }
 
 void TerritorySystem::ApplyOwnershipState(const std::vector<OwnershipEntry>& entries) {
     for (const auto& e : entries) {
-        for (auto& t : s_territories) {
-            if (t.id == e.id) {
-                t.ownerGang = e.ownerGang;
-                break;
-            }
-        }
+        const int idx = s_idIndex.Find(e.id);
+        if (idx < 0 || s_territories[idx].ownerGang == e.ownerGang) continue;
+        s_territories[idx].ownerGang = e.ownerGang;
+        s_ownership.SetOwner(idx, e.ownerGang);
+        s_changes.Mark(s_handles.HandleAt(idx), TerritoryChangeLog::kOwner);
     }
+    // Owners were written directly; a territory set back to neutral here
+    // keeps its old stamp and must be re-queued.
+    RescanNeutralReverts(CTimer::m_snTimeInMilliseconds, false);
 }
 
 void TerritorySystem::GetOwnershipState(std::vector<OwnershipEntry>& out) {
+    out.resize(s_territories.size());
+    for (size_t i = 0; i < s_territories.size(); ++i) {
+        out[i].id = s_territories[i].numId;
+        out[i].ownerGang = s_territories[i].ownerGang;
+    }
+}
+
+void TerritorySystem::GetOwnershipDeltas(std::vector<OwnershipEntry>& out) {
     out.clear();
-    out.reserve(s_territories.size());
-    for (const auto& t : s_territories) {
-        OwnershipEntry e;
-        e.id = t.id;
-        e.ownerGang = t.ownerGang;
-        out.push_back(e);
+    for (const Territory& t : s_territories) {
+        if (t.ownerGang != t.defaultOwnerGang) out.push_back(OwnershipEntry{ t.numId, t.ownerGang });
     }
 }
 
+OwnershipJournal& TerritorySystem::GetOwnershipJournal() {
+    return s_ownerJournal;
+}
+
+unsigned long long TerritorySystem::GetDefaultsHash() {
+    unsigned long long h = 0;
+    for (const Territory& t : s_territories) h = SidecarFormat::DefaultsHashAdd(h, t.numId, t.defaultOwnerGang);
+    return h;
+}
+
 void TerritorySystem::ClearAllWarsAndTransientState() {
-    for (auto& t : s_territories) {
+    for (int i = 0; i < (int)s_territories.size(); ++i) {
+        Territory& t = s_territories[i];
+        if (t.underAttack) s_changes.Mark(s_handles.HandleAt(i), TerritoryChangeLog::kUnderAttack);
         t.underAttack = false;
 
         // If we ever add any other runtime-only fields, clear them here too.
@@ -540,8 +1005,10 @@ void TerritorySystem::ClearAllWarsAndTransientState() {
 }
 
 void TerritorySystem::ClearAllUnderAttackFlags() {
-    for (Territory& t : s_territories) {
+    for (int i = 0; i < (int)s_territories.size(); ++i) {
+        Territory& t = s_territories[i];
         if (t.underAttack) {
+            s_changes.Mark(s_handles.HandleAt(i), TerritoryChangeLog::kUnderAttack);
             t.underAttack = false;
             DebugLog::Write(
                 "TerritorySystem: %s underAttack cleared due to load",
@@ -557,7 +1024,7 @@ const std::vector<Territory>& TerritorySystem::GetTerritories() {
 
 void TerritorySystem::DrawRadarOverlay() {
     if (!s_overlayEnabled) return;
-    TerritoryRadarRenderer::DrawRadarOverlay(s_territories);
+    TerritoryRadarRenderer::DrawRadarOverlay(s_territories, s_ownership);
 }
 
 // ------------------------------------------------------------
@@ -568,6 +1035,9 @@ void TerritorySystem::EditorToggle() {
     s_editor.hasA = false;
     s_editor.hasB = false;
     DebugLog::Write(s_editor.enabled ? "Territory editor: ON" : "Territory editor: OFF");
+
+    // Closing the editor is the natural pause to fold the journal in.
+    if (!s_editor.enabled) CompactJournal();
 }
 
 bool TerritorySystem::EditorEnabled() {
@@ -614,7 +1084,8 @@ void TerritorySystem::EditorCommitTerritory() {
 
     Territory t{};
     char idbuf[64];
-    std::snprintf(idbuf, sizeof(idbuf), "%d", s_editor.nextId++);
+    t.numId = (unsigned int)s_editor.nextId++;
+    std::snprintf(idbuf, sizeof(idbuf), "%u", t.numId);
     t.id = idbuf;
 
     t.minX = std::min(s_editor.ax, s_editor.bx);
@@ -634,16 +1105,11 @@ void TerritorySystem::EditorCommitTerritory() {
         return;
     }
 
-    s_territories.push_back(t);
+    const TerritoryEditJournal::Op op = TerritoryEditJournal::MakeAdd(t);
+    if (!ApplyEditorOp(op)) return;
+    s_journal.Record(op);
+    FlushJournal();
 
-    std::string err;
-    if (!SaveToFile(s_territories, err)) {
-        DebugLog::Write("TerritoryEditor: Save FAILED: %s", err.c_str());
-        s_territories.pop_back();
-        return;
-    }
-
-    s_lastConfigStamp = GetConfigStampOrNeg1();
     s_editor.hasA = false;
     s_editor.hasB = false;
 
@@ -660,28 +1126,40 @@ void TerritorySystem::EditorDeleteClosestToPlayer() {
     float px, py;
     if (!GetPlayerXY(px, py)) return;
 
-    int bestIdx = -1;
-    float bestD2 = 0.0f;
+    const Territory* closest = GetNearestTerritory(px, py);
+    if (!closest) return;
 
-    for (int i = 0; i < (int)s_territories.size(); i++) {
-        const auto& t = s_territories[i];
-        const float cx = (t.minX + t.maxX) * 0.5f;
-        const float cy = (t.minY + t.maxY) * 0.5f;
-        const float d2 = Dist2(px, py, cx, cy);
-        if (bestIdx < 0 || d2 < bestD2) { bestIdx = i; bestD2 = d2; }
-    }
+    const std::string deletedId = closest->id;
+    const TerritoryEditJournal::Op op = TerritoryEditJournal::MakeRemove(*closest);
+    if (!ApplyEditorOp(op)) return;
+    s_journal.Record(op);
+    FlushJournal();
 
-    if (bestIdx < 0) return;
+    DebugLog::Write("Editor: Deleted %s", deletedId.c_str());
+}
 
-    const std::string deletedId = s_territories[bestIdx].id;
-    s_territories.erase(s_territories.begin() + bestIdx);
+void TerritorySystem::EditorUndo() {
+    if (!s_editor.enabled) return;
 
-    std::string err;
-    if (!SaveToFile(s_territories, err)) {
-        DebugLog::Write("Editor: Delete save FAILED");
+    TerritoryEditJournal::Op op;
+    if (!s_journal.Undo(op)) {
+        DebugLog::Write("Editor: Nothing to undo");
         return;
     }
+    ApplyEditorOp(op);
+    FlushJournal();
+    DebugLog::Write("Editor: Undo (%s %u)", op.kind == TerritoryEditJournal::kAdd ? "restored" : "removed", op.numId);
+}
 
-    s_lastConfigStamp = GetConfigStampOrNeg1();
-    DebugLog::Write("Editor: Deleted %s", deletedId.c_str());
+void TerritorySystem::EditorRedo() {
+    if (!s_editor.enabled) return;
+
+    TerritoryEditJournal::Op op;
+    if (!s_journal.Redo(op)) {
+        DebugLog::Write("Editor: Nothing to redo");
+        return;
+    }
+    ApplyEditorOp(op);
+    FlushJournal();
+    DebugLog::Write("Editor: Redo (%s %u)", op.kind == TerritoryEditJournal::kAdd ? "added" : "removed", op.numId);
 }
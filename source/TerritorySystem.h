@@ -2,6 +2,16 @@
 
 #include "plugin.h"
 #include "CVector.h"
+#include "TerritoryGrid.h"
+#include "TerritoryBounds.h"
+#include "TerritoryIdIndex.h"
+#include "TerritoryHandleTable.h"
+#include "TerritoryChangeLog.h"
+#include "TerritoryOwnershipIndex.h"
+#include "TerritoryEditJournal.h"
+#include "OwnershipJournal.h"
+#include "TerritoryPolygon.h"
+#include "PlayerContext.h"
 
 #include <vector>
 #include <string>
@@ -9,22 +19,26 @@
 
 struct Territory {
     std::string id;
-    float minX, minY, maxX, maxY;
+    unsigned int numId;    // id parsed at load; key for by-id lookups
+    float minX, minY, maxX, maxY; // the rect, or the outline's bounding box
+    TerritoryPolygon poly;         // optional outline; empty = plain rect
     int ownerGang;         // runtime owner (-1 = neutral)
     int defaultOwnerGang;  // loaded from territories.txt
     int lastOwnerGang;     // owner before going neutral; used for auto-revert
     unsigned int neutralSinceMs; // game time when territory went neutral (0 = not neutral)
     bool underAttack;      // runtime
     int defenseLevel;
+    int priority;          // lookup precedence where territories overlap (higher wins)
 
     Territory()
-        : minX(0), minY(0), maxX(0), maxY(0),
+        : numId(0), minX(0), minY(0), maxX(0), maxY(0),
         ownerGang(-1), defaultOwnerGang(-1), lastOwnerGang(-1),
         neutralSinceMs(0),
-        underAttack(false), defenseLevel(1) {}
+        underAttack(false), defenseLevel(1), priority(0) {}
 
     bool ContainsPoint(const CVector& pos) const {
-        return pos.x >= minX && pos.x <= maxX && pos.y >= minY && pos.y <= maxY;
+        if (!(pos.x >= minX && pos.x <= maxX && pos.y >= minY && pos.y <= maxY)) return false;
+        return poly.Empty() || poly.Contains(pos.x, pos.y);
     }
 
     float GetRadius() const {
@@ -32,12 +46,16 @@ struct Territory {
         float halfH = (maxY - minY) * 0.5f;
         return std::sqrt(halfW * halfW + halfH * halfH);
     }
+
+    float GetArea() const {
+        return poly.Empty() ? (maxX - minX) * (maxY - minY) : poly.Area();
+    }
 };
 
 class TerritorySystem {
 public:
     struct OwnershipEntry {
-        std::string id;
+        unsigned int id; // numeric territory id
         int ownerGang;
     };
 
@@ -48,20 +66,70 @@ public:
     static void Update();
     static inline void Process() { Update(); }
 
+    // Where territories overlap, the higher "prio:" wins, then the lower id.
+    // Territories on islands the current act has not unlocked are skipped.
     static const Territory* GetTerritoryAtPoint(const CVector& pos);
-    static const Territory* GetTerritoryAtPlayer();
+    static const Territory* GetTerritoryAtPlayer(); // from the player context; no lookup
+    // Unlike GetTerritoryAtPoint these see every territory, gated islands
+    // included (the editor works on all of them).
+    static void GetTerritoriesInRect(float minX, float minY, float maxX, float maxY,
+        std::vector<const Territory*>& out); // bounding boxes overlapping the rect
+    static const Territory* GetNearestTerritory(float x, float y); // by rect (bounding box) center
     static bool HasRealTerritories();
 
+    // Handles — O(1) id/pointer -> territory resolution. Handles stay valid
+    // across hot reload and editor edits while the territory id exists;
+    // Resolve() returns nullptr once it is gone.
+    static TerritoryHandle FindTerritoryById(unsigned int id);
+    static TerritoryHandle GetHandle(const Territory* t);
+    static const Territory* Resolve(TerritoryHandle h);
+    static int GetHandleSlotCount(); // bound on TerritoryHandle::slot, for per-slot arrays
+
     // Runtime state changes (DO NOT write territories.txt)
+    static void SetTerritoryOwner(TerritoryHandle h, int newOwnerGang);
     static void SetTerritoryOwner(const Territory* t, int newOwnerGang);
+    static void SetUnderAttack(TerritoryHandle h, bool underAttack);
     static void SetUnderAttack(const Territory* t, bool underAttack);
 
     static int GetPlayerGang();
 
+    // Change tracking. Epochs only grow; a cache stores the epoch it was built
+    // at and is still valid while it compares equal. Subscribers are called
+    // once per frame from Update() with the changes since the last frame.
+    static unsigned int GetChangeEpoch(unsigned int kinds = TerritoryChangeLog::kAll);
+    static int SubscribeChanges(unsigned int kinds, TerritoryChangeLog::Callback cb, void* user = nullptr);
+    static void UnsubscribeChanges(int id);
+
+    // Per-gang counts/areas and hostile/unlocked/attackable sets, indexed like
+    // GetTerritories(); always current (updated with every owner write).
+    static const TerritoryOwnershipIndex& GetOwnershipIndex();
+
+    // Player context — refreshed once per tick by UpdatePlayerContext(), the
+    // first thing gameProcessEvent runs; read it instead of fetching the ped
+    // and querying the territory again. Resolve(ctx.territory) for the live
+    // territory (its owner may change later in the frame).
+    static void UpdatePlayerContext();
+    static const PlayerContext& GetPlayerContext();
+    static int SubscribePlayerEvents(unsigned int kinds, PlayerContextTracker::Callback cb, void* user = nullptr);
+    static void UnsubscribePlayerEvents(int id);
+
+    // Called by ActManager on every act change. Point queries and the radar
+    // only see islands active for the act (TerritoryPartitions); this
+    // promotes or demotes whole islands.
+    static void OnActChanged(int act);
+
     // Sidecar helpers
     static void ResetOwnershipToDefaults();
     static void ApplyOwnershipState(const std::vector<OwnershipEntry>& entries);
     static void GetOwnershipState(std::vector<OwnershipEntry>& out);
+    // Only territories whose owner differs from their territories.txt
+    // default, plus the SidecarFormat::DefaultsHashAdd key those deltas are
+    // relative to.
+    static void GetOwnershipDeltas(std::vector<OwnershipEntry>& out);
+    static unsigned long long GetDefaultsHash();
+    // Gameplay owner changes (captures, neutral reverts) since the last
+    // sidecar load or save; bulk writes above are not noted.
+    static OwnershipJournal& GetOwnershipJournal();
 
     // Transient cleanup
     static void ClearAllWarsAndTransientState();
@@ -87,13 +155,20 @@ public:
     static void EditorSetCornerBAtPlayer();
     static void EditorCommitTerritory();
     static void EditorDeleteClosestToPlayer();
+    static void EditorUndo();
+    static void EditorRedo();
 
 private:
     static std::vector<Territory> s_territories;
+    static TerritoryGrid s_grid;     // spatial index over s_territories; patched or rebuilt on any add/remove/reorder
+    static TerritoryBounds s_bounds; // SoA copy of s_territories bounds; rebuilt with s_grid
+    static TerritoryIdIndex s_idIndex; // numId -> index into s_territories; rebuilt with s_grid
+    static TerritoryHandleTable s_handles; // stable handles; re-synced with s_grid
+    static std::vector<int> s_rectHits; // GetTerritoriesInRect scratch; keeps its capacity
 
     static bool s_overlayEnabled;
-    static unsigned int s_nextReloadPollMs;
-    static long long s_lastConfigStamp;
+    static int s_configWatchId; // FileWatch subscription for territories.txt
+    static unsigned long long s_lastContentHash; // territories.txt bytes behind s_territories
     static unsigned int s_lastReloadFailToastMs;
 
     struct EditorState {
@@ -110,15 +185,46 @@ private:
 
 private:
     static const char* ConfigPath();
+    static const char* CachePath(); // territories.bin next to territories.txt
+    static const char* JournalPath(); // territories.txt.journal
 
     static void NormalizeRect(Territory& t);
-    static long long GetConfigStampOrNeg1();
-
-    static bool LoadFromFile(std::vector<Territory>& out, std::string& outErr);
-    static bool SaveToFile(const std::vector<Territory>& terrs, std::string& outErr);
-
-    static void HotReloadTick(unsigned int nowMs);
-    static void TryReloadNow(bool showToastOnFail);
+    static void RebuildIndices(TerritoryGrid* prebuiltGrid = nullptr); // prebuiltGrid is consumed if it matches
+
+    static bool ReadConfigText(std::vector<char>& text, std::string& outErr);
+    static bool LoadFromText(const std::vector<char>& text, unsigned long long hash,
+        std::vector<Territory>& out, TerritoryGrid& outGrid, bool& outFromCache, std::string& outErr);
+    static void WriteCache(unsigned long long hash); // territories.bin from s_territories + s_grid
+    static bool SaveToFile(const std::vector<Territory>& terrs, unsigned long long& outHash, std::string& outErr);
+
+    // Editor edits go to the journal; territories.txt is only rewritten by
+    // CompactJournal (editor closed, too many ops, failed append, shutdown).
+    static bool LoadJournal(unsigned long long textHash); // true if a journal file was found
+    static bool ReplayJournal(std::vector<Territory>& terrs); // true if any op was applied
+    static bool ApplyEditorOp(const TerritoryEditJournal::Op& op);
+    static void FlushJournal();
+    static bool CompactJournal();
+
+    // Overlap validation (TerritoryOverlap). RefreshOverlaps runs with every
+    // index rebuild or patch; ReportOverlaps logs the pairs after a reload
+    // with their territories.txt line numbers.
+    static void RefreshOverlaps();
+
+    // Act-gated island partitions (TerritoryPartitions): RebuildActiveSet
+    // re-classifies after any index rebuild or patch; RebuildActiveGrid
+    // re-indexes the active territories after the set changed.
+    static void RebuildActiveSet();
+    static void RebuildActiveGrid();
+    static void ReportOverlaps(const std::vector<char>& text);
+
+    // FileWatch callback: territories.txt changed on disk.
+    static void OnConfigFileChanged(const std::vector<char>& text, unsigned long long hash, void* user);
+    // Re-seeds the neutral revert queue from every territory; with applyDue,
+    // first reverts whatever is due (the old per-frame scan, run once).
+    static void RescanNeutralReverts(unsigned int nowMs, bool applyDue);
+    static void TryReloadNow(bool showToastOnFail); // reads territories.txt, then ApplyConfigText
+    static void ApplyConfigText(const std::vector<char>& text, unsigned long long hash, bool showToastOnFail);
+    static void ApplyReloadDiff(std::vector<Territory>& next, TerritoryGrid& nextGrid);
 
     static bool GetPlayerXY(float& outX, float& outY);
     static int ComputeNextId(const std::vector<Territory>& terrs);
@@ -3,8 +3,6 @@
 #include "AffiliationRule.h"
 #include "ActManager.h"
 
-#include "CWorld.h"
-#include "CPlayerPed.h"
 #include "CTimer.h"
 
 #include "TerritorySystem.h"
@@ -49,22 +47,21 @@ void WarSystem::Process() {
     // Check for war trigger every 500ms
     static unsigned int lastCheck = 0;
     if (now - lastCheck > CHECK_INTERVAL_MS) {
-        CPlayerPed* player = CWorld::Players[0].m_pPed;
-        if (player && !s_recentKills.empty()) {
-            const CVector playerPos = player->GetPosition();
-            const Territory* currentTerr = GetTerritoryAtPosition(playerPos);
+        const PlayerContext& player = TerritorySystem::GetPlayerContext();
+        if (player.valid && !s_recentKills.empty()) {
+            const Territory* currentTerr = TerritorySystem::Resolve(player.territory);
 
             if (currentTerr) {
                 // Check if we have enough kills for this territory
                 for (int gangType = PEDTYPE_GANG1; gangType <= PEDTYPE_GANG6; gangType++) {
                     if (currentTerr->ownerGang == gangType) {
-                        int killCount = CountRecentKillsForTerritory(currentTerr->id, (ePedType)gangType);
+                        int killCount = CountRecentKillsForTerritory(TerritorySystem::GetHandle(currentTerr), (ePedType)gangType);
 
                         if (killCount >= s_minKillsToTrigger) {
                             DebugLog::Write("Attempting to trigger war: %d kills in %s",
                                 killCount, currentTerr->id.c_str());
 
-                            if (CheckAndStartWar(playerPos, (ePedType)gangType)) {
+                            if (CheckAndStartWar(currentTerr, (ePedType)gangType)) {
                                 ClearRecentKills();
                                 break;
                             }
@@ -88,18 +85,12 @@ void WarSystem::RecordGangKill(ePedType gangType, const CVector& /*killPos*/) {
         return;
     }
 
-    CPlayerPed* player = CWorld::Players[0].m_pPed;
-    if (!player) return;
+    // Player must be on foot (in-vehicle covers the driving/passenger states)
+    const PlayerContext& player = TerritorySystem::GetPlayerContext();
+    if (!player.OnFoot()) return;
 
-    // Player must be on foot (use reliable state flags)
-    if (player->m_bInVehicle ||
-        player->m_ePedState == PEDSTATE_DRIVING ||
-        player->m_ePedState == PEDSTATE_PASSENGER) {
-        return;
-    }
-
-    const CVector playerPos = player->GetPosition();
-    const Territory* terr = GetTerritoryAtPosition(playerPos);
+    const CVector playerPos = player.pos;
+    const Territory* terr = TerritorySystem::Resolve(player.territory);
     if (!terr) {
         DebugLog::Write("RecordGangKill: Player not in any territory at (%.1f, %.1f)",
             playerPos.x, playerPos.y);
@@ -132,12 +123,12 @@ void WarSystem::RecordGangKill(ePedType gangType, const CVector& /*killPos*/) {
     KillRecord record;
     record.gangType = gangType;
     record.playerPosition = playerPos;
-    record.territoryId = terr->id;
+    record.territory = TerritorySystem::GetHandle(terr);
     record.timestamp = CTimer::m_snTimeInMilliseconds;
     s_recentKills.push_back(record);
 
     // Debug: count how many kills for this territory/gang combo
-    int count = CountRecentKillsForTerritory(terr->id, gangType);
+    int count = CountRecentKillsForTerritory(record.territory, gangType);
     DebugLog::Write("Recorded kill: gang=%d, territory=%s, total recent=%d/3",
         (int)gangType, terr->id.c_str(), count);
 
@@ -157,11 +148,7 @@ bool WarSystem::CanTriggerWarInTerritory(int territoryOwner) {
     return CanAttackTerritoryOwner(territoryOwner, ActManager::GetCurrentAct(), /*isLocked=*/false);
 }
 
-const Territory* WarSystem::GetTerritoryAtPosition(const CVector& pos) {
-    return TerritorySystem::GetTerritoryAtPoint(pos);
-}
-
-int WarSystem::CountRecentKillsForTerritory(const std::string& territoryId, ePedType gangType) {
+int WarSystem::CountRecentKillsForTerritory(TerritoryHandle territory, ePedType gangType) {
     unsigned int now = CTimer::m_snTimeInMilliseconds;
     int count = 0;
 
@@ -169,7 +156,7 @@ int WarSystem::CountRecentKillsForTerritory(const std::string& territoryId, ePed
         // Only count recent kills (within trigger window)
         // For the SAME territory and SAME gang type
         if ((now - kill.timestamp) <= s_triggerWindowMs &&
-            kill.territoryId == territoryId &&
+            kill.territory == territory &&
             kill.gangType == gangType) {
             count++;
         }
@@ -177,23 +164,15 @@ int WarSystem::CountRecentKillsForTerritory(const std::string& territoryId, ePed
     return count;
 }
 
-bool WarSystem::CheckAndStartWar(const CVector& pos, ePedType hostileGang) {
+bool WarSystem::CheckAndStartWar(const Territory* terr, ePedType hostileGang) {
     // Don't start during missions
     if (IsMissionActive()) {
         return false;
     }
 
     // Player must be on foot
-    CPlayerPed* player = CWorld::Players[0].m_pPed;
-    if (!player) return false;
-
-    if (player->m_bInVehicle ||
-        player->m_ePedState == PEDSTATE_DRIVING ||
-        player->m_ePedState == PEDSTATE_PASSENGER) {
-        return false;
-    }
+    if (!TerritorySystem::GetPlayerContext().OnFoot()) return false;
 
-    const Territory* terr = GetTerritoryAtPosition(pos);
     if (!terr) return false;
 
     // Must be owned by this gang
@@ -21,7 +21,7 @@ private:
     struct KillRecord {
         ePedType gangType;
         CVector playerPosition;     // Player position when kill happened
-        std::string territoryId;    // Territory player was in when kill happened
+        TerritoryHandle territory;  // Territory player was in when kill happened
         unsigned int timestamp;
     };
 
@@ -31,8 +31,7 @@ private:
 
     static constexpr unsigned int CHECK_INTERVAL_MS = 500;
 
-    static const Territory* GetTerritoryAtPosition(const CVector& pos);
-    static int CountRecentKillsForTerritory(const std::string& territoryId, ePedType gangType);
-    static bool CheckAndStartWar(const CVector& pos, ePedType hostileGang);
+    static int CountRecentKillsForTerritory(TerritoryHandle territory, ePedType gangType);
+    static bool CheckAndStartWar(const Territory* terr, ePedType hostileGang); // terr: the player's, from the player context
     static void ClearRecentKills();
 };
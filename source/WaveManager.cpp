@@ -33,7 +33,7 @@ unsigned char WaveManager::s_originalWantedFlags = 0;
 bool WaveManager::s_wantedLevelFrozen = false;
 unsigned int WaveManager::s_nextActionTime = 0;
 ePedType WaveManager::s_defendingGang = PEDTYPE_GANG1;
-const Territory* WaveManager::s_activeTerritory = nullptr;
+TerritoryHandle WaveManager::s_activeTerritory;
 bool WaveManager::s_isShuttingDown = false;
 unsigned int WaveManager::s_showWaveMessageAtTime = 0;
 int WaveManager::s_pendingWaveMessage = -1;
@@ -58,7 +58,7 @@ void WaveManager::Initialize() {
     WaveCombat::Initialize();
 
     s_state = WarState::Idle;
-    s_activeTerritory = nullptr;
+    s_activeTerritory = TerritoryHandle();
     s_currentWave = -1;
     s_enemiesSpawned = 0;
     s_enemiesTarget = 0;
@@ -109,7 +109,7 @@ int WaveManager::GetAliveCount() {
 }
 
 const Territory* WaveManager::GetActiveTerritory() {
-    return s_activeTerritory;
+    return TerritorySystem::Resolve(s_activeTerritory);
 }
 
 ePedType WaveManager::GetDefendingGang() {
@@ -133,31 +133,17 @@ void WaveManager::StartWar(ePedType defendingGang, const Territory* territory) {
     s_pickupCleanupTime = 0;
 
     s_defendingGang = defendingGang;
-    s_activeTerritory = territory;
+    s_activeTerritory = TerritorySystem::GetHandle(territory);
     s_currentWave = -1;
 
     // Ensure territory is marked as under attack
     TerritorySystem::SetUnderAttack(s_activeTerritory, true);
-    s_warCenter.x = (s_activeTerritory->minX + s_activeTerritory->maxX) / 2.0f;
-    s_warCenter.y = (s_activeTerritory->minY + s_activeTerritory->maxY) / 2.0f;
-    s_warCenter.z = 0.0f;
-
-    // Calculate radius as half the territory diagonal
-    float width = s_activeTerritory->maxX - s_activeTerritory->minX;
-    float height = s_activeTerritory->maxY - s_activeTerritory->minY;
-    s_warRadius = sqrtf(width * width + height * height) / 2.0f;
+    UpdateWarArea(territory);
 
-    // Add buffer (SA seems to use generous bounds)
-    s_warRadius *= s_fleeRadiusMultiplier;
-
-    // NEW: Use territory defense level for wave config
-    int defenseLevel = WaveConfig::DEFENSE_MODERATE; // Default
-    if (s_activeTerritory) {
-        // Clamp to valid range
-        defenseLevel = s_activeTerritory->defenseLevel;
-        if (defenseLevel < 0) defenseLevel = 0;
-        if (defenseLevel > 2) defenseLevel = 2;
-    }
+    // NEW: Use territory defense level for wave config, clamped to valid range
+    int defenseLevel = territory->defenseLevel;
+    if (defenseLevel < 0) defenseLevel = 0;
+    if (defenseLevel > 2) defenseLevel = 2;
 
     WaveConfig::InitializeWaveConfigs(defenseLevel);
 
@@ -186,17 +172,15 @@ void WaveManager::CancelWar() {
     // Clean up under attack in all territories
     TerritorySystem::ClearAllWarsAndTransientState();
 
-    // Reset underAttack flag
-    if (s_activeTerritory) {
-        TerritorySystem::SetUnderAttack(s_activeTerritory, false);
-    }
+    // Reset underAttack flag (no-op if the handle went stale)
+    TerritorySystem::SetUnderAttack(s_activeTerritory, false);
 
     // Unfreeze wanted level
     s_wantedLevelFrozen = false;
 
     // Reset to idle
     s_state = WarState::Idle;
-    s_activeTerritory = nullptr;
+    s_activeTerritory = TerritoryHandle();
     s_currentWave = -1;
     s_enemiesSpawned = 0;
     s_enemiesTarget = 0;
@@ -213,11 +197,11 @@ void WaveManager::CompleteWar() {
     DebugLog::Write("Completing war cleanup");
 
     // Capture territory
-    if (s_activeTerritory) {
+    if (const Territory* terr = TerritorySystem::Resolve(s_activeTerritory)) {
         int playerGang = TerritorySystem::GetPlayerGang();
         if (playerGang >= 0) {
             DebugLog::Write("Capturing territory %s for gang %d",
-                s_activeTerritory->id.c_str(), playerGang);
+                terr->id.c_str(), playerGang);
 
             TerritorySystem::SetTerritoryOwner(s_activeTerritory, playerGang);
             TerritorySystem::SetUnderAttack(s_activeTerritory, false);
@@ -257,7 +241,7 @@ void WaveManager::CompleteWar() {
 
     // Set state to Completed
     s_state = WarState::Completed;
-    s_activeTerritory = nullptr;
+    s_activeTerritory = TerritoryHandle();
 
     DebugLog::Write("War cleanup complete - wanted system unfrozen");
 }
@@ -293,7 +277,7 @@ void WaveManager::BeginWave(int waveIndex) {
     // Plan the wave (find cluster centers and sizes)
     auto plan = WaveSpawning::PlanWaveSpawn(
         s_defendingGang,
-        s_activeTerritory,
+        GetActiveTerritory(),
         waveIndex,
         s_enemiesTarget
     );
@@ -319,7 +303,7 @@ void WaveManager::SpawnNextCluster() {
     // Spawn current cluster
     auto results = WaveSpawning::SpawnSingleClusterEnemies(
         s_defendingGang,
-        s_activeTerritory,
+        GetActiveTerritory(),
         s_currentWave,
         s_clusterCenters[s_currentClusterIndex],
         s_clusterSizes[s_currentClusterIndex]
@@ -356,6 +340,36 @@ float WaveManager::Dist2D(const CVector& a, const CVector& b) {
     return sqrtf(dx * dx + dy * dy);
 }
 
+void WaveManager::UpdateWarArea(const Territory* territory) {
+    s_warCenter.x = (territory->minX + territory->maxX) / 2.0f;
+    s_warCenter.y = (territory->minY + territory->maxY) / 2.0f;
+    s_warCenter.z = 0.0f;
+
+    // Calculate radius as half the territory diagonal
+    float width = territory->maxX - territory->minX;
+    float height = territory->maxY - territory->minY;
+    s_warRadius = sqrtf(width * width + height * height) / 2.0f;
+
+    // Add buffer (SA seems to use generous bounds)
+    s_warRadius *= s_fleeRadiusMultiplier;
+}
+
+void WaveManager::OnTerritoriesRebuilt() {
+    if (!IsWarActive()) return;
+
+    const Territory* territory = GetActiveTerritory();
+    if (!territory) {
+        DebugLog::Write("WaveManager: war territory removed by rebuild -> cancel war");
+        CancelWar();
+        return;
+    }
+
+    // Rebuilt entries come back with file defaults for runtime flags.
+    TerritorySystem::SetUnderAttack(s_activeTerritory, true);
+    UpdateWarArea(territory);
+    DebugLog::Write("WaveManager: war territory %s survived rebuild", territory->id.c_str());
+}
+
 void WaveManager::CheckWaveCompletion() {
     // DEFENSIVE: Don't check if we shouldn't be checking
     if (s_state != WarState::Combat && s_state != WarState::Spawning) {
@@ -519,13 +533,14 @@ CPickup* WaveManager::ResolvePickup(int handle) {
 }
 
 void WaveManager::SpawnInitialHealthPickup() {
-    if (!s_activeTerritory || s_isShuttingDown) return;
+    const Territory* territory = GetActiveTerritory();
+    if (!territory || s_isShuttingDown) return;
 
     // Wave 1 start in SA: health only.
     CleanupPickup(s_healthPickupHandle);
     CleanupPickup(s_armorPickupHandle);
 
-    CVector spawnPos = FindPickupPositionInTerritory(s_activeTerritory, nullptr);
+    CVector spawnPos = FindPickupPositionInTerritory(territory, nullptr);
 
     if (spawnPos.x != 0.0f || spawnPos.y != 0.0f) {
         s_healthPickupHandle = SpawnPickupAtPosition_Handle(spawnPos, PICKUP_ONCE, 1362, 50);
@@ -538,7 +553,8 @@ void WaveManager::SpawnInitialHealthPickup() {
 }
 
 void WaveManager::SpawnWaveArmorPickup() {
-    if (!s_activeTerritory || s_isShuttingDown) return;
+    const Territory* territory = GetActiveTerritory();
+    if (!territory || s_isShuttingDown) return;
 
     // Wave 2 start in SA: armor only; previous wave’s pickup should be gone by now.
     CleanupPickup(s_healthPickupHandle);
@@ -546,7 +562,7 @@ void WaveManager::SpawnWaveArmorPickup() {
 
     // Avoid spawning right on top of the player’s last health pickup location doesn’t matter now,
     // but we can still avoid a dummy position if you want. For now, just use nullptr.
-    CVector spawnPos = FindPickupPositionInTerritory(s_activeTerritory, nullptr);
+    CVector spawnPos = FindPickupPositionInTerritory(territory, nullptr);
 
     if (spawnPos.x != 0.0f || spawnPos.y != 0.0f) {
         s_armorPickupHandle = SpawnPickupAtPosition_Handle(spawnPos, PICKUP_ONCE, 1364, 50);
@@ -562,10 +578,10 @@ void WaveManager::SpawnWaveArmorPickup() {
 CVector WaveManager::FindPickupPositionInTerritory(const Territory* territory, CPickup* avoidPickup) {
     if (!territory) return CVector(0, 0, 0);
 
-    CPlayerPed* player = CWorld::Players[0].m_pPed;
-    if (!player) return CVector(0, 0, 0);
+    const PlayerContext& player = TerritorySystem::GetPlayerContext();
+    if (!player.valid) return CVector(0, 0, 0);
 
-    CVector playerPos = player->GetPosition();
+    CVector playerPos = player.pos;
     CVector avoidPos = avoidPickup ? avoidPickup->m_vecPos : CVector(0, 0, 0);
 
     DebugLog::Write("FindPickup: player at (%.1f, %.1f), territory bounds (%.1f-%.1f, %.1f-%.1f)",
@@ -584,8 +600,7 @@ CVector WaveManager::FindPickupPositionInTerritory(const Territory* territory, C
         candidate.z = playerPos.z;
 
         // Must be inside territory bounds
-        if (candidate.x < territory->minX || candidate.x > territory->maxX ||
-            candidate.y < territory->minY || candidate.y > territory->maxY) {
+        if (!territory->ContainsPoint(candidate)) {
             continue;
         }
 
@@ -615,6 +630,11 @@ CVector WaveManager::FindPickupPositionInTerritory(const Territory* territory, C
     CVector center;
     center.x = (territory->minX + territory->maxX) * 0.5f;
     center.y = (territory->minY + territory->maxY) * 0.5f;
+    if (!territory->poly.Empty()) {
+        // The box middle can sit outside a concave outline.
+        center.x = territory->poly.InteriorX();
+        center.y = territory->poly.InteriorY();
+    }
     center.z = 100.0f;
 
     float groundZ;
@@ -737,7 +757,7 @@ void WaveManager::ResetForLoad()
     s_pendingWaveMessage = -1;
 
     // Clear active war identity
-    s_activeTerritory = nullptr;
+    s_activeTerritory = TerritoryHandle();
 
     // IMPORTANT: kill wanted freeze so it can’t stomp the loaded save’s wanted state
     s_wantedLevelFrozen = false;
@@ -761,7 +781,8 @@ void WaveManager::CheckPlayerDeath() {
         // Apply SA-accurate death rule:
         //   Wave 1 death (s_currentWave == 0) → defending gang keeps the territory
         //   Wave 2+ death (s_currentWave >= 1) → territory goes neutral (-1)
-        const int defendingGang = s_activeTerritory ? s_activeTerritory->ownerGang : -1;
+        const Territory* territory = GetActiveTerritory();
+        const int defendingGang = territory ? territory->ownerGang : -1;
         const int newOwner = ComputeWaveDeathOwner(s_currentWave, defendingGang);
 
         if (newOwner == defendingGang) {
@@ -772,7 +793,7 @@ void WaveManager::CheckPlayerDeath() {
             CMessages::AddMessageJumpQ("You died — the territory is now contested!", DEATH_MESSAGE_DISPLAY_MS, 0);
         }
 
-        if (s_activeTerritory) {
+        if (territory) {
             TerritorySystem::SetTerritoryOwner(s_activeTerritory, newOwner);
             TerritorySystem::SetUnderAttack(s_activeTerritory, false);
         }
@@ -783,7 +804,7 @@ void WaveManager::CheckPlayerDeath() {
 
         // Reset everything
         s_state = WarState::Idle;
-        s_activeTerritory = nullptr;
+        s_activeTerritory = TerritoryHandle();
         s_wantedLevelFrozen = false;
         s_originalWantedLevel = 0;
         s_originalChaosLevel = 0;
@@ -794,14 +815,13 @@ void WaveManager::CheckPlayerDeath() {
 }
 
 void WaveManager::CheckForFleeing() {
-    if (!s_activeTerritory) return;
+    if (!GetActiveTerritory()) return;
     if (s_state == WarState::Idle || s_state == WarState::Completed) return;
 
-    CPlayerPed* player = CWorld::Players[0].m_pPed;
-    if (!player) return;
+    const PlayerContext& player = TerritorySystem::GetPlayerContext();
+    if (!player.valid) return;
 
-    CVector playerPos = player->GetPosition();
-    float distance = Dist2D(playerPos, s_warCenter);
+    float distance = Dist2D(player.pos, s_warCenter);
 
     static unsigned int s_fleeMessageShownTime = 0;
     static bool s_fleeMessageShown = false;
@@ -926,7 +946,7 @@ void WaveManager::Shutdown() {
     s_wantedLevelFrozen = false;
 
     s_state = WarState::Idle;
-    s_activeTerritory = nullptr;
+    s_activeTerritory = TerritoryHandle();
     s_defendingGang = PEDTYPE_GANG1;
     s_currentWave = -1;
     s_enemiesSpawned = 0;
@@ -48,6 +48,10 @@ public:
 
     static void ResetForLoad();
 
+    // Called by TerritorySystem after its territory list is rebuilt (hot
+    // reload, editor edits). Keeps the war running if its territory survived.
+    static void OnTerritoriesRebuilt();
+
 private:
     // Wave progression
     static void BeginWave(int waveIndex);
@@ -84,6 +88,7 @@ private:
     static void CheckForFleeing();
     static void CheckPlayerDeath();
     static float Dist2D(const CVector& a, const CVector& b);
+    static void UpdateWarArea(const Territory* territory);
 
     // Delayed wave completion messages
     static const unsigned int s_waveCompletionMessageDelayMs = 800; // 800ms delay
@@ -108,7 +113,7 @@ private:
     static unsigned int s_nextActionTime;
     static unsigned int s_nextClusterSpawnTime;  // NEW: Time for next cluster
     static ePedType s_defendingGang;
-    static const Territory* s_activeTerritory;
+    static TerritoryHandle s_activeTerritory; // resolve via TerritorySystem::Resolve
     static bool s_isShuttingDown;
 
     // NEW: Cluster spawning state
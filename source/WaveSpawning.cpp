@@ -158,6 +158,7 @@ namespace WaveSpawning {
         if (territory) {
             center.x = std::clamp(center.x, territory->minX + 10.0f, territory->maxX - 10.0f);
             center.y = std::clamp(center.y, territory->minY + 10.0f, territory->maxY - 10.0f);
+            territory->poly.PullInside(center.x, center.y);
         }
 
         return center;
@@ -223,6 +224,7 @@ namespace WaveSpawning {
                 if (territory) {
                     newCenter.x = std::clamp(newCenter.x, territory->minX + 10.0f, territory->maxX - 10.0f);
                     newCenter.y = std::clamp(newCenter.y, territory->minY + 10.0f, territory->maxY - 10.0f);
+                    territory->poly.PullInside(newCenter.x, newCenter.y);
                 }
 
                 DebugLog::Write("Cluster %d forced at %.1f, %.1f",
@@ -471,11 +473,8 @@ namespace WaveSpawning {
                 candidate.y = playerPos.y + distance * sin(angle);
                 candidate.z = playerPos.z;  // Use player's Z initially
 
-                if (terr) {
-                    if (candidate.x < terr->minX || candidate.x > terr->maxX ||
-                        candidate.y < terr->minY || candidate.y > terr->maxY) {
-                        continue;
-                    }
+                if (terr && !terr->ContainsPoint(candidate)) {
+                    continue;
                 }
 
                 float groundZ;
@@ -530,11 +529,8 @@ namespace WaveSpawning {
             candidate.y = playerPos.y + distance * sin(angle);
             candidate.z = playerPos.z;
 
-            if (terr) {
-                if (candidate.x < terr->minX || candidate.x > terr->maxX ||
-                    candidate.y < terr->minY || candidate.y > terr->maxY) {
-                    continue;
-                }
+            if (terr && !terr->ContainsPoint(candidate)) {
+                continue;
             }
 
             float groundZ = 0.0f;
@@ -0,0 +1,122 @@
+#pragma once
+// Minimal micro-benchmark harness — no external dependencies.
+// Companion to TestFramework.h; build GTWBench in Release for meaningful numbers.
+//
+// Command line (see bench_main.cpp):
+//   --filter <text>     only run cases whose "suite / name" contains text
+//   --csv <path>        write every result as suite,name,ns_per_op,ops
+//   --baseline <path>   a CSV from an earlier run; each case prints its change
+//                       and cases more than kRegressionPct slower are counted
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+// Defeats dead-code elimination of benchmark results.
+inline volatile long long g_sink = 0;
+inline void DoNotOptimize(long long v) { g_sink = g_sink + v; }
+
+constexpr double kRegressionPct = 10.0;
+
+struct Result {
+    std::string suite;
+    std::string name;
+    double nsPerOp;
+    long long ops;
+};
+
+struct Runner {
+    int cases = 0;
+    int regressions = 0;
+    std::string currentSuite;
+    std::string filter;
+    std::vector<Result> results;
+    std::map<std::string, double> baseline; // "suite / name" -> ns/op
+
+    void suite(const char* name) {
+        currentSuite = name;
+        std::printf("\n[bench] %s\n", name);
+    }
+
+    bool enabled(const char* name) const {
+        return filter.empty() || (currentSuite + " / " + name).find(filter) != std::string::npos;
+    }
+
+    // Runs fn(iterations) once as warm-up, then once timed.
+    // fn must perform `iterations` operations; reports time per operation.
+    // Returns 0 without running fn when the case is filtered out.
+    double run(const char* name, long long iterations, const std::function<void(long long)>& fn) {
+        if (!enabled(name)) return 0.0;
+        fn(iterations < 16 ? iterations : iterations / 16);
+
+        const auto t0 = std::chrono::steady_clock::now();
+        fn(iterations);
+        const auto t1 = std::chrono::steady_clock::now();
+
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        const double perOp = iterations > 0 ? ns / (double)iterations : 0.0;
+        std::printf("  %-48s %12.1f ns/op  (%lld ops)", name, perOp, iterations);
+
+        const auto base = baseline.find(currentSuite + " / " + name);
+        if (base != baseline.end() && base->second > 0.0) {
+            const double pct = (perOp - base->second) * 100.0 / base->second;
+            const bool slower = pct > kRegressionPct;
+            std::printf("  %+6.1f%%%s", pct, slower ? "  SLOWER" : "");
+            if (slower) ++regressions;
+        }
+        std::printf("\n");
+
+        results.push_back(Result{ currentSuite, name, perOp, iterations });
+        ++cases;
+        return perOp;
+    }
+
+    bool writeCsv(const char* path) const {
+        FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "suite,name,ns_per_op,ops\n");
+        for (const Result& r : results) {
+            std::fprintf(f, "\"%s\",\"%s\",%.3f,%lld\n", r.suite.c_str(), r.name.c_str(), r.nsPerOp, r.ops);
+        }
+        return std::fclose(f) == 0;
+    }
+
+    // Reads a CSV written by writeCsv. Names never contain quotes.
+    bool loadBaseline(const char* path) {
+        FILE* f = std::fopen(path, "r");
+        if (!f) return false;
+        char line[512];
+        while (std::fgets(line, sizeof(line), f)) {
+            char* q[4];
+            int n = 0;
+            for (char* p = line; *p && n < 4; ++p) {
+                if (*p == '"') q[n++] = p;
+            }
+            if (n < 4) continue; // header
+            *q[1] = '\0';
+            *q[3] = '\0';
+            baseline[std::string(q[0] + 1) + " / " + (q[2] + 1)] = std::atof(q[3] + 2);
+        }
+        std::fclose(f);
+        return true;
+    }
+
+    int report() const {
+        std::printf("\n========================================\n");
+        std::printf("  %d benchmark cases\n", cases);
+        if (!baseline.empty()) {
+            std::printf("  %d slower than baseline by more than %.0f%%\n", regressions, kRegressionPct);
+        }
+        std::printf("========================================\n");
+        return 0;
+    }
+};
+
+} // namespace Bench
@@ -0,0 +1,135 @@
+#include "SyntheticWorld.h"
+#include "../source/TerritoryFileParser.h"
+#include "../source/AffiliationRule.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace SyntheticWorld {
+
+const char* LayoutName(Layout layout) {
+    switch (layout) {
+    case Layout::Grid:          return "grid";
+    case Layout::RandomOverlap: return "random";
+    case Layout::City:          return "city";
+    }
+    return "?";
+}
+
+static void AssignOwner(Territory& t, std::mt19937& rng) {
+    const int r = (int)(rng() % 8);
+    t.defaultOwnerGang = (r < 6) ? GANG1 + r : -1;
+    t.ownerGang = t.defaultOwnerGang;
+    t.lastOwnerGang = -1;
+    t.defenseLevel = (int)(rng() % 3);
+}
+
+static Territory MakeRect(unsigned int id, float minX, float minY, float maxX, float maxY) {
+    Territory t;
+    t.numId = id;
+    t.id = std::to_string(id);
+    t.minX = minX; t.minY = minY;
+    t.maxX = maxX; t.maxY = maxY;
+    return t;
+}
+
+static void MakeHexagon(Territory& t) {
+    const float cx = (t.minX + t.maxX) * 0.5f, cy = (t.minY + t.maxY) * 0.5f;
+    const float rx = (t.maxX - t.minX) * 0.5f, ry = (t.maxY - t.minY) * 0.5f;
+    float xy[12];
+    for (int k = 0; k < 6; ++k) {
+        const float a = (float)k * 1.0471976f; // 60 degrees
+        xy[2 * k]     = cx + rx * std::cos(a);
+        xy[2 * k + 1] = cy + ry * std::sin(a);
+    }
+    std::string err;
+    if (!t.poly.Build(xy, 6, err)) return;
+    t.minX = t.poly.MinX(); t.minY = t.poly.MinY();
+    t.maxX = t.poly.MaxX(); t.maxY = t.poly.MaxY();
+}
+
+std::vector<Territory> Generate(Layout layout, int count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::vector<Territory> out;
+    out.reserve(count);
+    const float span = kWorldMax - kWorldMin;
+
+    if (layout == Layout::Grid) {
+        int side = 1;
+        while (side * side < count) ++side;
+        const float cell = span / (float)side;
+        for (int i = 0; i < count; ++i) {
+            const float x = kWorldMin + (float)(i % side) * cell;
+            const float y = kWorldMin + (float)(i / side) * cell;
+            out.push_back(MakeRect(1001u + i, x, y, x + cell, y + cell));
+            AssignOwner(out.back(), rng);
+        }
+        return out;
+    }
+
+    if (layout == Layout::RandomOverlap) {
+        // Mean box area = 2 * world area / count -> about two deep.
+        const float mean = span * std::sqrt(2.0f / (float)count);
+        std::uniform_real_distribution<float> pos(kWorldMin, kWorldMax);
+        std::uniform_real_distribution<float> size(0.5f * mean, 1.5f * mean);
+        for (int i = 0; i < count; ++i) {
+            const float x = pos(rng), y = pos(rng);
+            out.push_back(MakeRect(1001u + i, x, y,
+                std::min(x + size(rng), kWorldMax), std::min(y + size(rng), kWorldMax)));
+            AssignOwner(out.back(), rng);
+        }
+        return out;
+    }
+
+    // City: districts hold 80% of the blocks in a tight spread, the rest are
+    // larger lots scattered over the whole map.
+    const int districts = std::max(3, count / 64);
+    std::uniform_real_distribution<float> pos(kWorldMin * 0.9f, kWorldMax * 0.9f);
+    std::vector<float> cx(districts), cy(districts);
+    for (int d = 0; d < districts; ++d) { cx[d] = pos(rng); cy[d] = pos(rng); }
+
+    const float block = span / std::sqrt((float)count) * 0.35f;
+    std::normal_distribution<float> spread(0.0f, block * 4.0f);
+    std::uniform_real_distribution<float> blockSize(0.6f * block, 1.4f * block);
+    std::uniform_real_distribution<float> lotSize(1.5f * block, 4.0f * block);
+    for (int i = 0; i < count; ++i) {
+        float x, y, w, h;
+        if (rng() % 5 != 0) {
+            const int d = (int)(rng() % districts);
+            x = cx[d] + spread(rng); y = cy[d] + spread(rng);
+            w = blockSize(rng); h = blockSize(rng);
+        } else {
+            x = pos(rng); y = pos(rng);
+            w = lotSize(rng); h = lotSize(rng);
+        }
+        x = std::max(kWorldMin, std::min(x, kWorldMax - w));
+        y = std::max(kWorldMin, std::min(y, kWorldMax - h));
+        out.push_back(MakeRect(1001u + i, x, y, x + w, y + h));
+        if (rng() % 8 == 0) MakeHexagon(out.back());
+        AssignOwner(out.back(), rng);
+    }
+    return out;
+}
+
+std::string ToText(const std::vector<Territory>& terrs) {
+    std::string text = "# id,minX,minY,maxX,maxY,ownerGangCode,underAttack,defenseLevel[,poly:x y;x y;...]\n";
+    text.reserve(terrs.size() * 48);
+    for (const Territory& t : terrs) {
+        TerritoryFileParser::FormatLine(t, text);
+        text += '\n';
+    }
+    return text;
+}
+
+std::vector<CVector> Points(int count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    const float margin = (kWorldMax - kWorldMin) * 0.05f;
+    std::uniform_real_distribution<float> d(kWorldMin - margin, kWorldMax + margin);
+    std::vector<CVector> out;
+    out.reserve(count);
+    for (int i = 0; i < count; ++i) out.push_back(CVector(d(rng), d(rng), 0.0f));
+    return out;
+}
+
+} // namespace SyntheticWorld
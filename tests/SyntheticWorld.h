@@ -0,0 +1,40 @@
+#pragma once
+// Seeded synthetic territory layouts for scaling benchmarks.
+// No game engine dependencies — builds against tests/stubs.
+//
+// Every layout covers the same 3200x3200 box around the map origin, so the
+// three islands (IslandRule.h splits on x) all get territories, and sizes
+// shrink with the count so the average overlap depth stays about the same
+// at 1x and 100x. Ids are 1001.., owners spread over the six gangs with
+// about one in eight neutral. Same (layout, count, seed) = same world.
+//
+//   Grid          exact tiling, no gaps or overlap
+//   RandomOverlap uniform random boxes, about two deep on average
+//   City          dense districts of small blocks with sparse outskirts;
+//                 one in eight blocks is a hexagon outline instead of a rect
+
+#include "../source/TerritorySystem.h"
+
+#include <string>
+#include <vector>
+
+namespace SyntheticWorld {
+
+enum class Layout { Grid, RandomOverlap, City };
+
+constexpr float kWorldMin = -1600.0f;
+constexpr float kWorldMax =  1600.0f;
+// Roughly a full hand-authored territories.txt; scales are multiples of it.
+constexpr int kStockCount = 128;
+
+const char* LayoutName(Layout layout);
+
+std::vector<Territory> Generate(Layout layout, int count, unsigned int seed);
+
+// territories.txt text for terrs (one line per territory, header comment).
+std::string ToText(const std::vector<Territory>& terrs);
+
+// Uniform points over the world box plus a 5% margin.
+std::vector<CVector> Points(int count, unsigned int seed);
+
+} // namespace SyntheticWorld
@@ -0,0 +1,141 @@
+#include "BenchFramework.h"
+#include "../source/SaveSlotParser.h"
+#include "../source/FileHandleTable.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// File opens seen by the CFileMgr hooks over one session, in order: boot,
+// the load menu previewing every slot, loading slot 2, then in-game data
+// reloads and a save to slot 2. Paths as the game passes them. One entry
+// is one OpenFile + CloseFile pair.
+static const char* const kSessionTrace[] = {
+    "DATA\\DEFAULT.DAT", "DATA\\GTA3.DAT", "DATA\\DEFAULT.IDE", "DATA\\MAPS\\GENERIC.IDE",
+    "DATA\\MAPS\\TEMPPART\\TEMPPART.IDE", "DATA\\MAPS\\COMNTOP\\COMNTOP.IDE", "DATA\\MAPS\\COMNBTM\\COMNBTM.IDE",
+    "DATA\\MAPS\\COMSE\\COMSE.IDE", "DATA\\MAPS\\COMSW\\COMSW.IDE", "DATA\\MAPS\\INDUSTNE\\INDUSTNE.IDE",
+    "DATA\\MAPS\\INDUSTNW\\INDUSTNW.IDE", "DATA\\MAPS\\INDUSTSE\\INDUSTSE.IDE", "DATA\\MAPS\\INDUSTSW\\INDUSTSW.IDE",
+    "DATA\\MAPS\\SUBURBNE\\SUBURBNE.IDE", "DATA\\MAPS\\SUBURBSW\\SUBURBSW.IDE", "DATA\\MAPS\\OVERVIEW.IPL",
+    "DATA\\MAPS\\PROPS.IPL", "DATA\\MAPS\\COMNTOP\\COMNTOP.IPL", "DATA\\MAPS\\COMNBTM\\COMNBTM.IPL",
+    "DATA\\MAPS\\COMSE\\COMSE.IPL", "DATA\\MAPS\\COMSW\\COMSW.IPL", "DATA\\MAPS\\INDUSTNE\\INDUSTNE.IPL",
+    "DATA\\MAPS\\INDUSTNW\\INDUSTNW.IPL", "DATA\\MAPS\\INDUSTSE\\INDUSTSE.IPL", "DATA\\MAPS\\INDUSTSW\\INDUSTSW.IPL",
+    "DATA\\MAPS\\SUBURBNE\\SUBURBNE.IPL", "DATA\\MAPS\\SUBURBSW\\SUBURBSW.IPL", "DATA\\MAPS\\CULL.IPL",
+    "DATA\\HANDLING.CFG", "DATA\\PEDSTATS.DAT", "DATA\\PED.DAT", "DATA\\TIMECYC.DAT", "DATA\\CARCOLS.DAT",
+    "DATA\\OBJECT.DAT", "DATA\\PARTICLE.CFG", "DATA\\SURFACE.DAT", "DATA\\WEAPON.DAT", "DATA\\WATERPRO.DAT",
+    "DATA\\CULLZONE.DAT", "DATA\\FISTFITE.DAT", "DATA\\PEDGRP.DAT", "DATA\\ZONES.ZON", "DATA\\MAIN.SCM",
+    "TEXT\\AMERICAN.GXT", "MODELS\\FONTS.TXD", "MODELS\\GENERIC.TXD", "MODELS\\FRONTEND.TXD", "MODELS\\HUD.TXD",
+    "MODELS\\PARTICLE.TXD", "MODELS\\MISC.TXD", "MODELS\\MENU.TXD", "MODELS\\GTA3.DIR", "MODELS\\COLL\\GENERIC.COL",
+    "MODELS\\COLL\\WEAPONS.COL", "MODELS\\COLL\\VEHICLES.COL", "ANIM\\PED.IFP", "ANIM\\CUTS.DIR", "AUDIO\\SFX.SDT",
+    "C:\\Users\\Player\\Documents\\GTA3 User Files\\gta3.set",
+    "C:\\Users\\Player\\Documents\\GTA3 User Files\\GTA3sf1.b", "C:\\Users\\Player\\Documents\\GTA3 User Files\\GTA3sf2.b",
+    "C:\\Users\\Player\\Documents\\GTA3 User Files\\GTA3sf3.b", "C:\\Users\\Player\\Documents\\GTA3 User Files\\GTA3sf4.b",
+    "C:\\Users\\Player\\Documents\\GTA3 User Files\\GTA3sf5.b", "C:\\Users\\Player\\Documents\\GTA3 User Files\\GTA3sf6.b",
+    "C:\\Users\\Player\\Documents\\GTA3 User Files\\GTA3sf7.b", "C:\\Users\\Player\\Documents\\GTA3 User Files\\GTA3sf8.b",
+    "C:\\Users\\Player\\Documents\\GTA3 User Files\\GTA3sf2.b",
+    "DATA\\MAIN.SCM", "TEXT\\AMERICAN.GXT", "ANIM\\CUTS.IMG", "MODELS\\GTA3.IMG", "MODELS\\TXD.IMG",
+    "DATA\\PATHS\\FLIGHT.DAT", "DATA\\PATHS\\FLIGHT2.DAT", "DATA\\PATHS\\TRACKS.DAT", "DATA\\PATHS\\TRACKS2.DAT",
+    "ANIM\\CUTS.IMG", "ANIM\\CUTS.IMG", "MODELS\\TXD.IMG", "MODELS\\GTA3.IMG", "TEXT\\AMERICAN.GXT",
+    "C:\\Users\\Player\\Documents\\GTA3 User Files\\GTA3sf2.b",
+};
+
+// What the hooks did before: strstr over the whole path, then a 64-slot
+// linear scan on every close.
+namespace Legacy {
+
+static bool TryParseSaveSlotFromPath(const char* filePath, int& outSlot) {
+    const char* key = "GTA3sf";
+    const char* p = std::strstr(filePath, key);
+    if (!p) return false;
+    p += std::strlen(key);
+    if (!std::isdigit((unsigned char)*p)) return false;
+    int slot = 0;
+    while (std::isdigit((unsigned char)*p)) slot = slot * 10 + (*p++ - '0');
+    if (slot < 1 || slot > 8) return false;
+    const char* ext = std::strrchr(filePath, '.');
+    if (!ext || ext[1] != 'b' || ext[2] != '\0') return false;
+    outSlot = slot;
+    return true;
+}
+
+struct HandleOp { std::intptr_t h; int slot; bool isSave; bool isLoad; };
+static HandleOp s_ops[64];
+static bool s_used[64];
+
+static void Track(std::intptr_t h, int slot) {
+    for (int i = 0; i < 64; ++i) {
+        if (!s_used[i]) { s_used[i] = true; s_ops[i] = HandleOp{ h, slot, false, true }; return; }
+    }
+}
+
+static bool Untrack(std::intptr_t h, HandleOp& out) {
+    for (int i = 0; i < 64; ++i) {
+        if (s_used[i] && s_ops[i].h == h) { out = s_ops[i]; s_used[i] = false; return true; }
+    }
+    return false;
+}
+
+} // namespace Legacy
+
+void RunFileHookBenchmarks(Bench::Runner& b) {
+    b.suite("File hooks: replay of a session's opens");
+
+    const int n = (int)(sizeof(kSessionTrace) / sizeof(kSessionTrace[0]));
+    // CRT FILE* values recycle; a few pointer-like handles, as in game.
+    std::vector<std::intptr_t> handles(n);
+    for (int i = 0; i < n; ++i) handles[i] = (std::intptr_t)0x00A1C000 + (i % 20) * 32;
+
+    char name[96];
+    const long long iters = 20000;
+
+    std::snprintf(name, sizeof(name), "legacy: strstr + linear table  x%d", n);
+    b.run(name, iters, [&](long long it) {
+        long long acc = 0;
+        for (long long r = 0; r < it; ++r) {
+            for (int i = 0; i < n; ++i) {
+                int slot = 0;
+                if (Legacy::TryParseSaveSlotFromPath(kSessionTrace[i], slot)) Legacy::Track(handles[i], slot);
+                Legacy::HandleOp op{};
+                if (Legacy::Untrack(handles[i], op)) acc += op.slot;
+            }
+        }
+        Bench::DoNotOptimize(acc);
+    });
+
+    FileHandleTable table;
+    std::snprintf(name, sizeof(name), "suffix reject + hash table     x%d", n);
+    b.run(name, iters, [&](long long it) {
+        long long acc = 0;
+        for (long long r = 0; r < it; ++r) {
+            for (int i = 0; i < n; ++i) {
+                const char* path = kSessionTrace[i];
+                int slot = 0;
+                if (SaveSlotParser::TryParseSaveSlot(path, std::strlen(path), slot)) {
+                    table.Insert(handles[i], FileHandleTable::Op{ slot, false, true });
+                }
+                FileHandleTable::Op op{};
+                if (table.Take(handles[i], op)) acc += op.slot;
+            }
+        }
+        Bench::DoNotOptimize(acc);
+    });
+
+    // The close side alone, for a handle that was never tracked (the common case).
+    std::snprintf(name, sizeof(name), "close miss: linear scan");
+    b.run(name, 5000000, [&](long long it) {
+        long long acc = 0;
+        Legacy::HandleOp op{};
+        for (long long r = 0; r < it; ++r) acc += Legacy::Untrack(handles[r % n] + 1, op);
+        Bench::DoNotOptimize(acc);
+    });
+
+    std::snprintf(name, sizeof(name), "close miss: hash probe");
+    b.run(name, 5000000, [&](long long it) {
+        long long acc = 0;
+        FileHandleTable::Op op{};
+        for (long long r = 0; r < it; ++r) acc += table.Take(handles[r % n] + 1, op);
+        Bench::DoNotOptimize(acc);
+    });
+}
@@ -0,0 +1,106 @@
+#include "BenchFramework.h"
+#include "../source/IniConfig.h"
+
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <string>
+
+// Every key the mod reads, laid out like the shipped INI.
+static const char kIniText[] =
+    "[Territory]\nNeutralRevertSeconds=180\n\n"
+    "[AttackFlash]\nCycleMs=1300\nMaxAlpha=125\nColorR=210\nColorG=25\nColorB=25\nLiveReload=1\n\n"
+    "[Spawning]\nCivReplaceProbability=0.35\nGangDensityRadius=40.0\nMaxGangInArea=8\n"
+    "VehicleOccupantRadius=12.0\nAmbientIntervalMs=4000\nAmbientRadiusMin=30.0\nAmbientRadiusMax=70.0\n"
+    "AmbientMaxPlayerDist=120.0\nGangReplaceProb=0.5\nGangVehicleInjectProb=0.2\n\n"
+    "[AmbientSpawning]\nCheckRadius=60.0\nTargetGangPeds=6\nHardCapGangPeds=10\nSpawnMinDist=35.0\n"
+    "SpawnMaxDist=80.0\nGlobalCooldownMs=1500\nPerTerritoryCooldownMs=6000\n\n"
+    "[Dev]\nStartingAct=-1 ; -1 disables\n";
+
+// What IniConfig did before: std::map keyed by section + "." + key, parsed
+// from a stream, stoi/stof on every read.
+namespace Legacy {
+
+struct Ini {
+    std::map<std::string, std::string> data;
+
+    void Load(const std::string& content) {
+        std::istringstream stream(content);
+        std::string line, section;
+        while (std::getline(stream, line)) {
+            line.erase(0, line.find_first_not_of(" \t\r\n"));
+            line.erase(line.find_last_not_of(" \t\r\n") + 1);
+            if (line.empty() || line[0] == ';' || line[0] == '#') continue;
+            if (line[0] == '[') {
+                section = line.substr(1, line.find(']') - 1);
+            } else {
+                size_t pos = line.find('=');
+                if (pos == std::string::npos) continue;
+                std::string key = line.substr(0, pos);
+                std::string value = line.substr(pos + 1);
+                key.erase(key.find_last_not_of(" \t") + 1);
+                value.erase(0, value.find_first_not_of(" \t"));
+                size_t cmtPos = value.find_first_of(";#");
+                if (cmtPos != std::string::npos) value = value.substr(0, cmtPos);
+                value.erase(value.find_last_not_of(" \t") + 1);
+                data[section + "." + key] = value;
+            }
+        }
+    }
+
+    int GetInt(const std::string& section, const std::string& key, int def) {
+        auto it = data.find(section + "." + key);
+        return it != data.end() ? std::stoi(it->second) : def;
+    }
+};
+
+} // namespace Legacy
+
+void RunIniConfigBenchmarks(Bench::Runner& b) {
+    b.suite("IniConfig: the radar's [AttackFlash] refresh");
+
+    // Before: every 500 ms the radar re-read the file and did six lookups.
+    Legacy::Ini legacy;
+    b.run("legacy: parse + 6 lookups", 20000, [&](long long it) {
+        long long acc = 0;
+        for (long long i = 0; i < it; ++i) {
+            legacy.Load(kIniText);
+            acc += legacy.GetInt("AttackFlash", "CycleMs", 0) + legacy.GetInt("AttackFlash", "MaxAlpha", 0)
+                + legacy.GetInt("AttackFlash", "ColorR", 0) + legacy.GetInt("AttackFlash", "ColorG", 0)
+                + legacy.GetInt("AttackFlash", "ColorB", 0) + legacy.GetInt("AttackFlash", "LiveReload", 0);
+        }
+        Bench::DoNotOptimize(acc);
+    });
+
+    // Now: the content hash says unchanged, nothing is rebuilt or read.
+    IniConfig cfg;
+    cfg.LoadFromString(kIniText);
+    b.run("snapshot: same text, hash only", 20000, [&](long long it) {
+        long long acc = 0;
+        for (long long i = 0; i < it; ++i) acc += cfg.LoadFromString(kIniText) ? 1 : 0;
+        Bench::DoNotOptimize(acc);
+    });
+
+    b.run("snapshot: rebuild from changed text", 20000, [&](long long it) {
+        IniConfig fresh;
+        long long acc = 0;
+        for (long long i = 0; i < it; ++i) {
+            fresh.LoadFromString(kIniText);
+            fresh.LoadFromString(""); // force the next one to rebuild
+            acc += fresh.Generation();
+        }
+        Bench::DoNotOptimize(acc);
+    });
+
+    b.run("legacy: GetInt", 1000000, [&](long long it) {
+        long long acc = 0;
+        for (long long i = 0; i < it; ++i) acc += legacy.GetInt("Dev", "StartingAct", 0);
+        Bench::DoNotOptimize(acc);
+    });
+
+    b.run("snapshot: GetInt", 1000000, [&](long long it) {
+        long long acc = 0;
+        for (long long i = 0; i < it; ++i) acc += cfg.GetInt("Dev", "StartingAct", 0);
+        Bench::DoNotOptimize(acc);
+    });
+}
@@ -0,0 +1,51 @@
+#include "BenchFramework.h"
+
+#include <cstring>
+
+void RunTerritoryGridBenchmarks(Bench::Runner& b);
+void RunTerritoryParserBenchmarks(Bench::Runner& b);
+void RunTerritoryOwnershipBenchmarks(Bench::Runner& b);
+void RunCrc32cBenchmarks(Bench::Runner& b);
+void RunSidecarFormatBenchmarks(Bench::Runner& b);
+void RunFileHookBenchmarks(Bench::Runner& b);
+void RunIniConfigBenchmarks(Bench::Runner& b);
+void RunScalingBenchmarks(Bench::Runner& b);
+
+static int Usage() {
+    std::printf("usage: GTWBench [--filter text] [--csv out.csv] [--baseline old.csv]\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    Bench::Runner b;
+
+    const char* csvPath = nullptr;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return Usage();
+        } else if (std::strcmp(argv[i], "--filter") == 0) {
+            b.filter = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--csv") == 0) {
+            csvPath = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--baseline") == 0) {
+            if (!b.loadBaseline(argv[i + 1])) std::printf("[bench] could not read baseline %s\n", argv[i + 1]);
+        } else {
+            return Usage();
+        }
+    }
+
+    RunTerritoryGridBenchmarks(b);
+    RunTerritoryParserBenchmarks(b);
+    RunTerritoryOwnershipBenchmarks(b);
+    RunCrc32cBenchmarks(b);
+    RunSidecarFormatBenchmarks(b);
+    RunFileHookBenchmarks(b);
+    RunIniConfigBenchmarks(b);
+    RunScalingBenchmarks(b);
+
+    if (csvPath && !b.writeCsv(csvPath)) {
+        std::printf("[bench] could not write %s\n", csvPath);
+        return 1;
+    }
+    return b.report();
+}
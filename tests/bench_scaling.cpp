@@ -0,0 +1,316 @@
+#include "BenchFramework.h"
+#include "SyntheticWorld.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryFileParser.h"
+#include "../source/TerritoryCache.h"
+#include "../source/TerritoryGrid.h"
+#include "../source/TerritoryBounds.h"
+#include "../source/TerritoryIdIndex.h"
+#include "../source/TerritoryOverlap.h"
+#include "../source/TerritoryPartitions.h"
+#include "../source/TerritoryHandleTable.h"
+#include "../source/TerritoryOwnershipIndex.h"
+#include "../source/NeutralRevertQueue.h"
+#include "../source/SidecarFormat.h"
+#include "../source/WarKillTracker.h"
+#include "../source/TerritoryStateRule.h"
+#include "../source/AffiliationRule.h"
+#include "../source/IslandRule.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+// TerritorySystem itself needs the game, so each case drives the same pure
+// pieces its entry points are made of, in the same order:
+//   load       ReadConfigText + LoadFromText (text parse, or territories.bin)
+//              and RebuildIndices, which also runs the overlap validator
+//   query      GetTerritoryAtPoint, with every island active and in act 1
+//              (Portland only, the other partitions gated out)
+//   ownership  ApplyOwnershipState / GetOwnershipState
+//   sidecar    what TerritoryPersistence writes and reads per save slot
+//   revert     the Update() neutral revert tick
+// at 1x, 10x and 100x SyntheticWorld::kStockCount for every layout.
+
+using SyntheticWorld::Layout;
+
+static const int kScales[] = { 1, 10, 100 };
+static const unsigned int kSeed = 20240601u;
+static const unsigned int kFrameMs = 16;
+
+// Keeps the whole suite to seconds: big worlds get fewer repetitions.
+static long long Reps(long long budget, int n, long long minimum) {
+    return std::max(minimum, budget / n);
+}
+
+static std::string CaseName(const char* what, int n) {
+    return std::string(what) + " n=" + std::to_string(n);
+}
+
+// GetTerritoryAtPoint's grid path.
+static int PointQuery(const std::vector<Territory>& terrs, const TerritoryGrid& grid, float x, float y) {
+    for (int idx = 0;; ++idx) {
+        idx = grid.QueryPoint(x, y, idx);
+        if (idx < 0) return -1;
+        const Territory& t = terrs[idx];
+        if (t.poly.Empty() || t.poly.Contains(x, y)) return idx;
+    }
+}
+
+static void RunLayout(Bench::Runner& b, Layout layout) {
+    char suiteName[96];
+    std::snprintf(suiteName, sizeof(suiteName), "Scaling: %s layout (x1, x10, x100 of %d territories)",
+        SyntheticWorld::LayoutName(layout), SyntheticWorld::kStockCount);
+    b.suite(suiteName);
+
+    for (int scale : kScales) {
+        const int n = SyntheticWorld::kStockCount * scale;
+        std::vector<Territory> terrs = SyntheticWorld::Generate(layout, n, kSeed + (unsigned int)scale);
+        const std::string text = SyntheticWorld::ToText(terrs);
+        const unsigned long long hash = TerritoryCache::HashText(text.data(), text.size());
+
+        TerritoryGrid grid;
+        grid.Build(terrs);
+        std::vector<unsigned char> image;
+        TerritoryCache::Build(terrs, &grid, hash, image);
+
+        // -- load ----------------------------------------------------------
+        b.run(CaseName("load: parse territories.txt", n).c_str(), Reps(2000000, n, 4), [&](long long iters) {
+            std::vector<Territory> out;
+            std::string err;
+            for (long long i = 0; i < iters; ++i) TerritoryFileParser::ParseBuffer(text.data(), text.size(), out, err);
+            Bench::DoNotOptimize((long long)out.size());
+        });
+
+        b.run(CaseName("load: territories.bin + grid", n).c_str(), Reps(4000000, n, 4), [&](long long iters) {
+            std::vector<Territory> out;
+            TerritoryGrid g;
+            std::string err;
+            for (long long i = 0; i < iters; ++i) {
+                TerritoryCache::Load(image.data(), image.size(), hash, out, &g, err);
+            }
+            Bench::DoNotOptimize((long long)out.size() + g.Count());
+        });
+
+        b.run(CaseName("load: rebuild indices", n).c_str(), Reps(2000000, n, 4), [&](long long iters) {
+            TerritoryGrid g;
+            TerritoryBounds bounds;
+            TerritoryIdIndex ids;
+            TerritoryHandleTable handles;
+            TerritoryOwnershipIndex owners;
+            for (long long i = 0; i < iters; ++i) {
+                ids.Build(terrs);
+                handles.Sync(terrs);
+                bounds.Assign(terrs);
+                owners.Build(terrs);
+                g.Build(terrs);
+            }
+            Bench::DoNotOptimize(g.Count() + ids.Count() + owners.Count());
+        });
+
+        b.run(CaseName("load: overlap validation", n).c_str(), Reps(400000, n, 2), [&](long long iters) {
+            std::vector<TerritoryOverlap::Pair> pairs;
+            for (long long i = 0; i < iters; ++i) TerritoryOverlap::Find(terrs, pairs);
+            Bench::DoNotOptimize((long long)pairs.size());
+        });
+
+        // -- query ---------------------------------------------------------
+        const std::vector<CVector> points = SyntheticWorld::Points(4096, kSeed);
+        b.run(CaseName("query: territory at point", n).c_str(), 400000, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                const CVector& p = points[(size_t)i & 4095];
+                acc += PointQuery(terrs, grid, p.x, p.y);
+            }
+            Bench::DoNotOptimize(acc);
+        });
+
+        TerritoryPartitions partitions;
+        partitions.Build(terrs, 1);
+        TerritoryGrid activeGrid;
+        activeGrid.Build(terrs, partitions.Active());
+        b.run(CaseName("query: territory at point, act 1", n).c_str(), 400000, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                const CVector& p = points[(size_t)i & 4095];
+                acc += PointQuery(terrs, activeGrid, p.x, p.y);
+            }
+            Bench::DoNotOptimize(acc);
+        });
+
+        // -- ownership -----------------------------------------------------
+        TerritoryIdIndex ids;
+        ids.Build(terrs);
+        TerritoryOwnershipIndex owners;
+        owners.Build(terrs);
+        std::vector<TerritorySystem::OwnershipEntry> entries[2];
+        for (int k = 0; k < 2; ++k) {
+            entries[k].resize(n);
+            for (int i = 0; i < n; ++i) {
+                entries[k][i].id = terrs[i].numId;
+                entries[k][i].ownerGang = GANG1 + (i + k) % 6; // every entry flips between the two
+            }
+        }
+
+        b.run(CaseName("ownership: apply state", n).c_str(), Reps(4000000, n, 8), [&](long long iters) {
+            for (long long i = 0; i < iters; ++i) {
+                for (const auto& e : entries[i & 1]) {
+                    const int idx = ids.Find(e.id);
+                    if (idx < 0 || terrs[idx].ownerGang == e.ownerGang) continue;
+                    terrs[idx].ownerGang = e.ownerGang;
+                    owners.SetOwner(idx, e.ownerGang);
+                }
+            }
+            Bench::DoNotOptimize(owners.OwnedCount(GANG1));
+        });
+
+        std::vector<TerritorySystem::OwnershipEntry> state;
+        b.run(CaseName("ownership: get state", n).c_str(), Reps(20000000, n, 8), [&](long long iters) {
+            for (long long i = 0; i < iters; ++i) {
+                state.resize(terrs.size());
+                for (size_t k = 0; k < terrs.size(); ++k) {
+                    state[k].id = terrs[k].numId;
+                    state[k].ownerGang = terrs[k].ownerGang;
+                }
+            }
+            Bench::DoNotOptimize((long long)state.size());
+        });
+
+        // -- sidecar -------------------------------------------------------
+        std::vector<SidecarFormat::Entry> sidecar(n);
+        for (int i = 0; i < n; ++i) {
+            sidecar[i].id = terrs[i].id;
+            sidecar[i].ownerGang = terrs[i].ownerGang;
+        }
+        const std::vector<unsigned char> blob = SidecarFormat::Serialize(sidecar);
+
+        b.run(CaseName("sidecar: serialize", n).c_str(), Reps(4000000, n, 8), [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) acc += (long long)SidecarFormat::Serialize(sidecar).size();
+            Bench::DoNotOptimize(acc);
+        });
+
+        // A blob the reader refuses (OWNR caps the entry count) would only
+        // time the early-out; say so instead.
+        const std::string deserializeName = CaseName("sidecar: deserialize", n);
+        const SidecarFormat::ParseResult check = SidecarFormat::Deserialize(blob);
+        if (!check.ok) {
+            if (b.enabled(deserializeName.c_str())) {
+                std::printf("  %-48s not loadable: %s\n", deserializeName.c_str(), check.error.c_str());
+            }
+        } else {
+            b.run(deserializeName.c_str(), Reps(4000000, n, 8), [&](long long iters) {
+                long long acc = 0;
+                for (long long i = 0; i < iters; ++i) acc += (long long)SidecarFormat::Deserialize(blob).entries.size();
+                Bench::DoNotOptimize(acc);
+            });
+        }
+
+        // -- neutral revert ------------------------------------------------
+        // One in eight territories neutral, stamps spread over the window so
+        // a few come due every frame; each revert goes straight back to
+        // neutral to keep the load steady.
+        const unsigned int revertMs = 10000;
+        TerritoryHandleTable handles;
+        handles.Sync(terrs);
+        NeutralRevertQueue queue;
+        for (int i = 0; i < n; i += 8) {
+            Territory& t = terrs[i];
+            t.ownerGang = -1;
+            t.lastOwnerGang = GANG1 + i % 6;
+            t.neutralSinceMs = 1 + (unsigned int)(((unsigned long long)i * revertMs) / (unsigned int)n);
+            queue.Push(handles.HandleAt(i), t.neutralSinceMs);
+        }
+        auto resolve = [&](TerritoryHandle h) -> Territory* {
+            const int idx = handles.IndexOf(h);
+            return idx >= 0 ? &terrs[idx] : nullptr;
+        };
+
+        b.run(CaseName("revert: tick, nothing due", n).c_str(), 2000000, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                acc += queue.ProcessDue(revertMs, revertMs, resolve, [](Territory&, int) {});
+            }
+            Bench::DoNotOptimize(acc + queue.Size());
+        });
+
+        unsigned int now = revertMs;
+        b.run(CaseName("revert: tick, steady churn", n).c_str(), 200000, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                now += kFrameMs;
+                acc += queue.ProcessDue(now, revertMs, resolve, [&](Territory& t, int revertTo) {
+                    t.ownerGang = -1;
+                    t.lastOwnerGang = revertTo;
+                    t.neutralSinceMs = now;
+                    queue.Push(handles.HandleAt((int)(&t - terrs.data())), now);
+                });
+            }
+            Bench::DoNotOptimize(acc);
+        });
+
+        // -- rules ---------------------------------------------------------
+        b.run(CaseName("rules: state pass", n).c_str(), Reps(20000000, n, 8), [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                const int act = 1 + (int)(i % 3);
+                for (const Territory& t : terrs) {
+                    const bool isLocked = !IsIslandUnlocked(
+                        GetIslandForPosition((t.minX + t.maxX) * 0.5f, (t.minY + t.maxY) * 0.5f), act);
+                    acc += GetTerritoryBlipColor(ComputeTerritoryState(t.ownerGang, act, isLocked));
+                }
+            }
+            Bench::DoNotOptimize(acc);
+        });
+    }
+}
+
+// The kill tracker is capped at kMaxRecords, so the world size only changes
+// which ids are in play; one pass per scale shows it stays flat.
+static void RunKillTracker(Bench::Runner& b) {
+    b.suite("Scaling: WarKillTracker at capacity");
+    for (int scale : kScales) {
+        const int n = SyntheticWorld::kStockCount * scale;
+        const auto terrs = SyntheticWorld::Generate(Layout::City, n, kSeed);
+        WarKillTracker tracker;
+        tracker.Init();
+
+        unsigned int now = 1;
+        b.run(CaseName("kills: add + prune + count", n).c_str(), 200000, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                now += kFrameMs;
+                const std::string& id = terrs[(size_t)(i * 7919) % terrs.size()].id;
+                tracker.AddRecord(GANG1 + (int)(i % 6), id, now);
+                tracker.PruneExpired(now, WarKillTracker::kDefaultWindowMs);
+                acc += tracker.CountForTerritory(id, GANG1, now, WarKillTracker::kDefaultWindowMs);
+            }
+            Bench::DoNotOptimize(acc);
+        });
+    }
+}
+
+// The validator runs on every load and hot reload; it has to stay well
+// inside a frame hitch even for a world far past anything hand-authored.
+static void RunOverlapAtScale(Bench::Runner& b) {
+    b.suite("Scaling: overlap validation at 100k rects");
+    const int n = 100000;
+    for (Layout layout : { Layout::Grid, Layout::RandomOverlap, Layout::City }) {
+        const auto terrs = SyntheticWorld::Generate(layout, n, kSeed);
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s layout", SyntheticWorld::LayoutName(layout));
+        b.run(CaseName(name, n).c_str(), 2, [&](long long iters) {
+            std::vector<TerritoryOverlap::Pair> pairs;
+            for (long long i = 0; i < iters; ++i) TerritoryOverlap::Find(terrs, pairs);
+            Bench::DoNotOptimize((long long)pairs.size());
+        });
+    }
+}
+
+void RunScalingBenchmarks(Bench::Runner& b) {
+    RunLayout(b, Layout::Grid);
+    RunLayout(b, Layout::RandomOverlap);
+    RunLayout(b, Layout::City);
+    RunKillTracker(b);
+    RunOverlapAtScale(b);
+}
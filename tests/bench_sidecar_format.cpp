@@ -0,0 +1,174 @@
+#include "BenchFramework.h"
+#include "../source/SidecarFormat.h"
+#include "../source/TerritoryIdIndex.h"
+
+#include <cstdio>
+#include <string>
+
+// A full sidecar at the reader's entry cap: ids as the game writes them
+// ("1000".."5095"), owners cycling through the gangs and neutral.
+static std::vector<SidecarFormat::Entry> MakeEntries(int count) {
+    std::vector<SidecarFormat::Entry> out(count);
+    for (int i = 0; i < count; ++i) {
+        out[i].id = std::to_string(1000 + i);
+        out[i].ownerGang = (i % 7 == 6) ? -1 : 7 + i % 6;
+    }
+    return out;
+}
+
+static std::vector<SidecarFormat::IdOwner> MakeIdOwners(int count) {
+    std::vector<SidecarFormat::IdOwner> out(count);
+    for (int i = 0; i < count; ++i) {
+        out[i] = SidecarFormat::IdOwner{ 1000u + (unsigned int)i, (i % 7 == 6) ? -1 : 7 + i % 6 };
+    }
+    return out;
+}
+
+// OWNR (v2) vs the packed OWN3 (v3) at the stock cap and a mod pack's size.
+// OWNR is only decoded at the cap; the reader refuses more entries than that.
+static void RunPackedBenchmarks(Bench::Runner& b) {
+    b.suite("SidecarFormat: v2 OWNR vs v3 packed");
+
+    char name[96];
+    const int sizes[] = { (int)SidecarFormat::kMaxEntries, 65536 };
+    for (int n : sizes) {
+        const auto entries = MakeIdOwners(n);
+        SidecarFormat::Writer v2, v3;
+        v2.AddOwnership(entries.data(), entries.size());
+        v3.AddOwnershipPacked(entries.data(), entries.size());
+        const std::vector<unsigned char>& blob2 = v2.Bytes();
+        const std::vector<unsigned char>& blob3 = v3.Bytes();
+
+        // A checkpoint as SidecarWriter::Write builds it: every owner as
+        // OWN3, plus ODLT with an eighth of them off their defaults.
+        std::vector<SidecarFormat::IdOwner> deltas;
+        for (int i = 0; i < n; i += 8) deltas.push_back(entries[i]);
+        auto checkpoint = [&](SidecarFormat::Writer& w) {
+            w.AddOwnershipPacked(entries.data(), entries.size());
+            w.AddOwnershipDelta(1, deltas.data(), deltas.size());
+            w.AddAct(1);
+            w.AddChecksum();
+        };
+
+        if (b.enabled("size")) {
+            SidecarFormat::Writer saved;
+            checkpoint(saved);
+            std::printf("  size n=%-6d v2 %8zu bytes (%.2f/entry)   v3 %7zu bytes (%.2f/entry)   checkpoint %7zu bytes\n",
+                n, blob2.size(), (double)blob2.size() / n, blob3.size(), (double)blob3.size() / n, saved.Bytes().size());
+        }
+
+        if (n <= (int)SidecarFormat::kMaxEntries) {
+            std::snprintf(name, sizeof(name), "v2 decode (ids parsed)    n=%d", n);
+            b.run(name, 20000, [&](long long iters) {
+                long long acc = 0;
+                std::string err;
+                for (long long i = 0; i < iters; ++i) {
+                    SidecarFormat::Reader reader;
+                    SidecarFormat::OwnershipCursor cursor;
+                    if (!reader.Open(blob2.data(), blob2.size(), err) || !reader.Ownership(cursor, err)) continue;
+                    std::string_view id;
+                    int owner = 0;
+                    unsigned int numId = 0;
+                    while (cursor.Next(id, owner)) {
+                        if (ParseTerritoryId(id.data(), id.size(), numId)) acc += numId + owner;
+                    }
+                }
+                Bench::DoNotOptimize(acc);
+            });
+        }
+
+        std::snprintf(name, sizeof(name), "v3 decode                 n=%d", n);
+        b.run(name, n > 10000 ? 2000 : 20000, [&](long long iters) {
+            long long acc = 0;
+            std::string err;
+            for (long long i = 0; i < iters; ++i) {
+                SidecarFormat::Reader reader;
+                SidecarFormat::PackedCursor cursor;
+                if (!reader.Open(blob3.data(), blob3.size(), err) || !reader.PackedOwnership(cursor, err)) continue;
+                SidecarFormat::IdOwner e;
+                while (cursor.Next(e)) acc += e.id + e.ownerGang;
+            }
+            Bench::DoNotOptimize(acc);
+        });
+
+        std::snprintf(name, sizeof(name), "v3 encode                 n=%d", n);
+        b.run(name, n > 10000 ? 200 : 2000, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                SidecarFormat::Writer w;
+                w.AddOwnershipPacked(entries.data(), entries.size());
+                acc += (long long)w.Bytes().size();
+            }
+            Bench::DoNotOptimize(acc);
+        });
+
+        std::snprintf(name, sizeof(name), "checkpoint encode         n=%d", n);
+        b.run(name, n > 10000 ? 200 : 2000, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                SidecarFormat::Writer w;
+                checkpoint(w);
+                acc += (long long)w.Bytes().size();
+            }
+            Bench::DoNotOptimize(acc);
+        });
+    }
+}
+
+void RunSidecarFormatBenchmarks(Bench::Runner& b) {
+    b.suite("SidecarFormat: owning vs in-place reader");
+
+    const int n = (int)SidecarFormat::kMaxEntries;
+    const auto entries = MakeEntries(n);
+    const std::vector<unsigned char> blob = SidecarFormat::Serialize(entries);
+
+    char name[96];
+
+    std::snprintf(name, sizeof(name), "serialize                 n=%d", n);
+    b.run(name, 2000, [&](long long iters) {
+        long long acc = 0;
+        for (long long i = 0; i < iters; ++i) acc += (long long)SidecarFormat::Serialize(entries).size();
+        Bench::DoNotOptimize(acc);
+    });
+
+    // One std::string per entry, the old Deserialize contract.
+    std::snprintf(name, sizeof(name), "deserialize (copies)      n=%d", n);
+    b.run(name, 2000, [&](long long iters) {
+        long long acc = 0;
+        for (long long i = 0; i < iters; ++i) acc += (long long)SidecarFormat::Deserialize(blob).entries.size();
+        Bench::DoNotOptimize(acc);
+    });
+
+    // What LoadSidecarAndApply does: views plus ParseTerritoryId, no allocation.
+    std::snprintf(name, sizeof(name), "reader: open + walk ids   n=%d", n);
+    b.run(name, 20000, [&](long long iters) {
+        long long acc = 0;
+        std::string err;
+        for (long long i = 0; i < iters; ++i) {
+            SidecarFormat::Reader reader;
+            SidecarFormat::OwnershipCursor cursor;
+            if (!reader.Open(blob.data(), blob.size(), err) || !reader.Ownership(cursor, err)) continue;
+            std::string_view id;
+            int owner = 0;
+            unsigned int numId = 0;
+            while (cursor.Next(id, owner)) {
+                if (ParseTerritoryId(id.data(), id.size(), numId)) acc += numId + owner;
+            }
+        }
+        Bench::DoNotOptimize(acc);
+    });
+
+    // Chunk directory only; OWNR is never touched.
+    std::snprintf(name, sizeof(name), "reader: open only         n=%d", n);
+    b.run(name, 2000000, [&](long long iters) {
+        long long acc = 0;
+        std::string err;
+        for (long long i = 0; i < iters; ++i) {
+            SidecarFormat::Reader reader;
+            if (reader.Open(blob.data(), blob.size(), err)) acc += reader.ChunkCount();
+        }
+        Bench::DoNotOptimize(acc);
+    });
+
+    RunPackedBenchmarks(b);
+}
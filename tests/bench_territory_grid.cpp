@@ -0,0 +1,239 @@
+#include "BenchFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryGrid.h"
+#include "../source/TerritoryBounds.h"
+#include "../source/TerritoryPolygon.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// Jittered tiling across a 4000x4000 world, similar in shape to a hand-authored
+// territories.txt: mostly adjacent rects with small gaps and a little overlap.
+static std::vector<Territory> MakeTiledLayout(int count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> jitter(-0.15f, 0.15f);
+
+    int side = 1;
+    while (side * side < count) ++side;
+    const float cell = 4000.0f / (float)side;
+
+    std::vector<Territory> out;
+    out.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const float x = -2000.0f + (float)(i % side) * cell;
+        const float y = -2000.0f + (float)(i / side) * cell;
+        Territory t;
+        t.minX = x + jitter(rng) * cell;
+        t.minY = y + jitter(rng) * cell;
+        t.maxX = x + cell * (1.0f + jitter(rng));
+        t.maxY = y + cell * (1.0f + jitter(rng));
+        out.push_back(t);
+    }
+    return out;
+}
+
+static std::vector<CVector> MakeQueries(int count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> d(-2100.0f, 2100.0f);
+    std::vector<CVector> out;
+    out.reserve(count);
+    for (int i = 0; i < count; ++i) out.push_back(CVector(d(rng), d(rng), 0.0f));
+    return out;
+}
+
+// The pre-grid TerritorySystem::GetTerritoryAtPoint.
+static int LinearPoint(const std::vector<Territory>& terrs, const CVector& p) {
+    for (int i = 0; i < (int)terrs.size(); ++i)
+        if (terrs[i].ContainsPoint(p)) return i;
+    return -1;
+}
+
+// The pre-grid EditorDeleteClosestToPlayer scan.
+static int LinearNearest(const std::vector<Territory>& terrs, const CVector& p) {
+    int best = -1;
+    float bestD2 = 0.0f;
+    for (int i = 0; i < (int)terrs.size(); ++i) {
+        const float dx = p.x - (terrs[i].minX + terrs[i].maxX) * 0.5f;
+        const float dy = p.y - (terrs[i].minY + terrs[i].maxY) * 0.5f;
+        const float d2 = dx * dx + dy * dy;
+        if (best < 0 || d2 < bestD2) { best = i; bestD2 = d2; }
+    }
+    return best;
+}
+
+void RunTerritoryGridBenchmarks(Bench::Runner& b) {
+    b.suite("TerritoryGrid / TerritoryBounds vs linear scan");
+
+    const auto queries = MakeQueries(4096, 42u);
+    const int sizes[] = { 100, 10000, 100000 };
+
+    for (int n : sizes) {
+        const auto terrs = MakeTiledLayout(n, 1337u);
+        TerritoryGrid grid;
+        TerritoryBounds bounds;
+        bounds.Assign(terrs);
+
+        char name[96];
+
+        std::snprintf(name, sizeof(name), "build            n=%d", n);
+        b.run(name, 20, [&](long long iters) {
+            for (long long i = 0; i < iters; ++i) {
+                grid.Build(terrs);
+                Bench::DoNotOptimize(grid.Count());
+            }
+        });
+
+        // Keep the linear runs bounded: ~2e8 rect tests at most.
+        const long long linearIters = std::max(256LL, 200000000LL / n);
+
+        std::snprintf(name, sizeof(name), "point  linear    n=%d", n);
+        b.run(name, linearIters, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) acc += LinearPoint(terrs, queries[i & 4095]);
+            Bench::DoNotOptimize(acc);
+        });
+
+        std::snprintf(name, sizeof(name), "point  soa-scalar n=%d", n);
+        b.run(name, linearIters, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                const CVector& q = queries[i & 4095];
+                acc += bounds.FindFirstContainingScalar(q.x, q.y);
+            }
+            Bench::DoNotOptimize(acc);
+        });
+
+        std::snprintf(name, sizeof(name), "point  soa-sse2  n=%d", n);
+        b.run(name, linearIters, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                const CVector& q = queries[i & 4095];
+                acc += bounds.FindFirstContaining(q.x, q.y);
+            }
+            Bench::DoNotOptimize(acc);
+        });
+
+        std::snprintf(name, sizeof(name), "point  grid      n=%d", n);
+        b.run(name, 2000000, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                const CVector& q = queries[i & 4095];
+                acc += grid.QueryPoint(q.x, q.y);
+            }
+            Bench::DoNotOptimize(acc);
+        });
+
+        std::snprintf(name, sizeof(name), "nearest linear   n=%d", n);
+        b.run(name, linearIters, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) acc += LinearNearest(terrs, queries[i & 4095]);
+            Bench::DoNotOptimize(acc);
+        });
+
+        std::snprintf(name, sizeof(name), "nearest grid     n=%d", n);
+        b.run(name, 500000, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                const CVector& q = queries[i & 4095];
+                acc += grid.QueryNearest(q.x, q.y);
+            }
+            Bench::DoNotOptimize(acc);
+        });
+
+        std::snprintf(name, sizeof(name), "rect 200x200 grid n=%d", n);
+        b.run(name, 200000, [&](long long iters) {
+            std::vector<int> hits;
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                const CVector& q = queries[i & 4095];
+                grid.QueryRect(q.x, q.y, q.x + 200.0f, q.y + 200.0f, hits);
+                acc += (long long)hits.size();
+            }
+            Bench::DoNotOptimize(acc);
+        });
+    }
+
+    // Hot reload of a file where one rect was nudged: patch vs rebuild.
+    {
+        const int n = 5000;
+        auto terrs = MakeTiledLayout(n, 1337u);
+        TerritoryGrid grid;
+        grid.Build(terrs);
+        const Territory original = terrs[n / 2];
+        Territory moved = original;
+        moved.maxX -= 1.0f;
+        Territory farAway = terrs[n / 4];
+
+        b.run("reload 1 rect: full Build     n=5000", 200, [&](long long iters) {
+            for (long long i = 0; i < iters; ++i) {
+                terrs[n / 2] = (i & 1) ? original : moved;
+                grid.Build(terrs);
+            }
+            Bench::DoNotOptimize(grid.Count());
+        });
+
+        grid.Build(terrs);
+        b.run("reload 1 rect: Update in-cell n=5000", 200000, [&](long long iters) {
+            for (long long i = 0; i < iters; ++i) {
+                if (i & 1) grid.Update(n / 2, moved, original);
+                else       grid.Update(n / 2, original, moved);
+            }
+            Bench::DoNotOptimize(grid.Count());
+        });
+
+        terrs[n / 2] = original;
+        grid.Build(terrs);
+        b.run("reload 1 rect: Update moved   n=5000", 2000, [&](long long iters) {
+            for (long long i = 0; i < iters; ++i) {
+                if (i & 1) grid.Update(n / 2, farAway, original);
+                else       grid.Update(n / 2, original, farAway);
+            }
+            Bench::DoNotOptimize(grid.Count());
+        });
+    }
+    // One 64-vertex outline: per-edge table (sorted, early out) vs the plain
+    // ring walk; queries spread over the box and its surroundings.
+    {
+        std::mt19937 rng(5u);
+        std::uniform_real_distribution<float> radius(300.0f, 900.0f);
+        std::vector<float> xy;
+        for (int i = 0; i < 64; ++i) {
+            const float a = 6.2831853f * (float)i / 64.0f;
+            const float r = radius(rng);
+            xy.push_back(r * std::cos(a));
+            xy.push_back(r * std::sin(a));
+        }
+        TerritoryPolygon poly;
+        std::string err;
+        poly.Build(xy.data(), 64, err);
+        const auto queries = MakeQueries(4096, 7u);
+
+        b.run("polygon 64v: ring walk", 2000000, [&](long long iters) {
+            long long acc = 0;
+            const int nv = poly.VertexCount();
+            const float* px = poly.X().data();
+            const float* py = poly.Y().data();
+            for (long long i = 0; i < iters; ++i) {
+                const CVector& q = queries[i & 4095];
+                bool inside = false;
+                for (int k = 0, j = nv - 1; k < nv; j = k++) {
+                    if ((py[k] > q.y) != (py[j] > q.y) &&
+                        q.x < (px[j] - px[k]) * (q.y - py[k]) / (py[j] - py[k]) + px[k]) inside = !inside;
+                }
+                acc += inside;
+            }
+            Bench::DoNotOptimize(acc);
+        });
+
+        b.run("polygon 64v: edge table", 2000000, [&](long long iters) {
+            long long acc = 0;
+            for (long long i = 0; i < iters; ++i) {
+                const CVector& q = queries[i & 4095];
+                acc += poly.Contains(q.x, q.y);
+            }
+            Bench::DoNotOptimize(acc);
+        });
+    }
+}
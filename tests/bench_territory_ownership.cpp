@@ -0,0 +1,107 @@
+#include "BenchFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryOwnershipIndex.h"
+#include "../source/TerritoryStateRule.h"
+#include "../source/IslandRule.h"
+
+#include <cstdio>
+#include <random>
+
+// Owners spread over every gang plus neutral/cleared, positions over all islands.
+static std::vector<Territory> MakeOwnedWorld(int count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(-1500.0f, 1500.0f);
+    std::uniform_real_distribution<float> size(10.0f, 150.0f);
+    std::vector<Territory> out(count);
+    for (int i = 0; i < count; ++i) {
+        Territory& t = out[i];
+        t.minX = pos(rng); t.minY = pos(rng);
+        t.maxX = t.minX + size(rng); t.maxY = t.minY + size(rng);
+        const int r = (int)(rng() % 8);
+        t.ownerGang = (r < 6) ? GANG1 + r : (r == 6) ? OWNER_NEUTRAL : OWNER_CLEARED;
+    }
+    return out;
+}
+
+// What a caller has to do without the index.
+static int RuleCountAttackable(const std::vector<Territory>& terrs, int act) {
+    int n = 0;
+    for (const Territory& t : terrs) {
+        const bool isLocked = !IsIslandUnlocked(
+            GetIslandForPosition((t.minX + t.maxX) * 0.5f, (t.minY + t.maxY) * 0.5f), act);
+        if (CanStartWarInTerritory(ComputeTerritoryState(t.ownerGang, act, isLocked))) ++n;
+    }
+    return n;
+}
+
+static int RuleCountOwned(const std::vector<Territory>& terrs, int gang, float& outArea) {
+    int n = 0;
+    outArea = 0.0f;
+    for (const Territory& t : terrs) {
+        if (t.ownerGang != gang) continue;
+        ++n;
+        outArea += t.GetArea();
+    }
+    return n;
+}
+
+void RunTerritoryOwnershipBenchmarks(Bench::Runner& b) {
+    b.suite("TerritoryOwnershipIndex vs per-territory rules");
+
+    const int n = 10000;
+    auto terrs = MakeOwnedWorld(n, 99u);
+    TerritoryOwnershipIndex idx;
+    idx.Build(terrs);
+
+    b.run("attackable count: rules     n=10000", 2000, [&](long long iters) {
+        long long acc = 0;
+        for (long long i = 0; i < iters; ++i) acc += RuleCountAttackable(terrs, 1 + (int)(i % 3));
+        Bench::DoNotOptimize(acc);
+    });
+
+    b.run("attackable count: bitsets   n=10000", 200000, [&](long long iters) {
+        long long acc = 0;
+        for (long long i = 0; i < iters; ++i) acc += idx.CountAttackable(1 + (int)(i % 3));
+        Bench::DoNotOptimize(acc);
+    });
+
+    std::vector<TerritoryOwnershipIndex::Word> set;
+    b.run("attackable set: bitsets     n=10000", 200000, [&](long long iters) {
+        long long acc = 0;
+        for (long long i = 0; i < iters; ++i) {
+            idx.Attackable(1 + (int)(i % 3), set);
+            acc += set[0];
+        }
+        Bench::DoNotOptimize(acc);
+    });
+
+    b.run("owned count+area: scan      n=10000", 2000, [&](long long iters) {
+        float area = 0.0f;
+        long long acc = 0;
+        for (long long i = 0; i < iters; ++i) acc += RuleCountOwned(terrs, GANG1 + (int)(i % 6), area);
+        Bench::DoNotOptimize(acc + (long long)area);
+    });
+
+    b.run("owned count+area: counters  n=10000", 2000000, [&](long long iters) {
+        float area = 0.0f;
+        long long acc = 0;
+        for (long long i = 0; i < iters; ++i) {
+            const int g = GANG1 + (int)(i % 6);
+            acc += idx.OwnedCount(g);
+            area += idx.OwnedArea(g);
+        }
+        Bench::DoNotOptimize(acc + (long long)area);
+    });
+
+    b.run("SetOwner (incremental)      n=10000", 2000000, [&](long long iters) {
+        for (long long i = 0; i < iters; ++i) {
+            idx.SetOwner((int)((i * 7919) % n), GANG1 + (int)(i % 6));
+        }
+        Bench::DoNotOptimize(idx.OwnedCount(GANG1));
+    });
+
+    b.run("Build                       n=10000", 500, [&](long long iters) {
+        for (long long i = 0; i < iters; ++i) idx.Build(terrs);
+        Bench::DoNotOptimize(idx.Count());
+    });
+}
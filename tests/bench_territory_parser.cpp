@@ -0,0 +1,152 @@
+#include "BenchFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryFileParser.h"
+#include "../source/TerritoryCache.h"
+#include "../source/TerritoryGrid.h"
+#include "../source/TerritoryIdIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+// territories.txt-shaped text: one rect per line, a comment every 64 lines,
+// CRLF endings like a file saved from Notepad.
+static std::string MakeTerritoryText(int lines, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(-2000.0f, 2000.0f);
+    std::uniform_real_distribution<float> size(5.0f, 300.0f);
+
+    std::string text;
+    text.reserve((size_t)lines * 52);
+    char buf[160];
+    for (int i = 0; i < lines; ++i) {
+        if ((i & 63) == 0) text += "# generated block\r\n";
+        const float x = pos(rng), y = pos(rng);
+        std::snprintf(buf, sizeof(buf), "%d,%.2f,%.2f,%.2f,%.2f,%d,0,%d\r\n",
+            1001 + i, x, y, x + size(rng), y + size(rng), 7 + (i % 6), i % 3);
+        text += buf;
+    }
+    return text;
+}
+
+// The pre-rewrite LoadFromFile: fgets-style 512-byte lines, snprintf copy,
+// sscanf per field and a find_if duplicate scan over everything so far.
+static bool LegacyParse(const std::string& text, std::vector<Territory>& out) {
+    out.clear();
+    const char* p = text.c_str();
+    const char* end = p + text.size();
+    char line[512];
+
+    while (p < end) {
+        const char* nl = (const char*)std::memchr(p, '\n', (size_t)(end - p));
+        const size_t len = std::min<size_t>((size_t)((nl ? nl + 1 : end) - p), sizeof(line) - 1);
+        std::memcpy(line, p, len);
+        line[len] = 0;
+        p = nl ? nl + 1 : end;
+
+        for (char* c = line; *c; ++c) if (*c == '\n' || *c == '\r') { *c = 0; break; }
+        char* s = line;
+        while (*s && std::isspace((unsigned char)*s)) ++s;
+        if (!s[0] || s[0] == '#') continue;
+
+        char buf[512];
+        std::snprintf(buf, sizeof(buf), "%s", s);
+        char* tokens[8] = { 0 };
+        int count = 0;
+        char* q = buf;
+        while (count < 8) {
+            tokens[count++] = q;
+            char* comma = std::strchr(q, ',');
+            if (!comma) break;
+            *comma = 0;
+            q = comma + 1;
+        }
+        if (count < 5) return false;
+
+        Territory t;
+        t.id = tokens[0];
+        if (!ParseTerritoryId(t.id.c_str(), t.id.size(), t.numId)) return false;
+        if (std::sscanf(tokens[1], "%f", &t.minX) != 1) return false;
+        if (std::sscanf(tokens[2], "%f", &t.minY) != 1) return false;
+        if (std::sscanf(tokens[3], "%f", &t.maxX) != 1) return false;
+        if (std::sscanf(tokens[4], "%f", &t.maxY) != 1) return false;
+        if (count >= 6) std::sscanf(tokens[5], "%d", &t.ownerGang);
+        if (count >= 8) std::sscanf(tokens[7], "%d", &t.defenseLevel);
+
+        auto dup = std::find_if(out.begin(), out.end(), [&](const Territory& x) { return x.numId == t.numId; });
+        if (dup != out.end()) return false;
+        out.push_back(t);
+    }
+    return !out.empty();
+}
+
+void RunTerritoryParserBenchmarks(Bench::Runner& b) {
+    b.suite("territories.txt parser (ns per line)");
+
+    const int sizes[] = { 1000, 100000, 1000000 };
+
+    for (int n : sizes) {
+        const std::string text = MakeTerritoryText(n, 2024u);
+        std::vector<Territory> out;
+        char name[96];
+
+        // The O(n^2) duplicate scan makes the legacy parser take ~15 s per
+        // parse at 100k lines, so it only runs at the smallest size.
+        if (n <= 1000) {
+            std::snprintf(name, sizeof(name), "legacy fgets/sscanf  lines=%d", n);
+            b.run(name, (long long)n * 20, [&](long long iters) {
+                for (long long done = 0; done < iters; done += n) {
+                    Bench::DoNotOptimize(LegacyParse(text, out) ? (long long)out.size() : -1);
+                }
+            });
+        }
+
+        std::snprintf(name, sizeof(name), "from_chars serial    lines=%d", n);
+        b.run(name, (long long)n * (n <= 1000 ? 200 : 2), [&](long long iters) {
+            std::string err;
+            for (long long done = 0; done < iters; done += n) {
+                TerritoryFileParser::ParseBuffer(text.data(), text.size(), out, err, 1);
+                Bench::DoNotOptimize((long long)out.size());
+            }
+        });
+
+        std::snprintf(name, sizeof(name), "from_chars auto-par  lines=%d", n);
+        b.run(name, (long long)n * (n <= 1000 ? 200 : 2), [&](long long iters) {
+            std::string err;
+            for (long long done = 0; done < iters; done += n) {
+                TerritoryFileParser::ParseBuffer(text.data(), text.size(), out, err, 0);
+                Bench::DoNotOptimize((long long)out.size());
+            }
+        });
+
+        // territories.bin hit: hash the text, then load rects + grid from the image.
+        TerritoryGrid grid;
+        grid.Build(out);
+        std::vector<unsigned char> image;
+        const unsigned long long hash = TerritoryCache::HashText(text.data(), text.size());
+        TerritoryCache::Build(out, &grid, hash, image);
+
+        std::snprintf(name, sizeof(name), "cache hit (hash+load+grid) lines=%d", n);
+        b.run(name, (long long)n * (n <= 1000 ? 200 : 2), [&](long long iters) {
+            std::string err;
+            for (long long done = 0; done < iters; done += n) {
+                const unsigned long long h = TerritoryCache::HashText(text.data(), text.size());
+                TerritoryCache::Load(image.data(), image.size(), h, out, &grid, err);
+                Bench::DoNotOptimize((long long)out.size() + grid.Count());
+            }
+        });
+
+        std::snprintf(name, sizeof(name), "text parse + grid build   lines=%d", n);
+        b.run(name, (long long)n * (n <= 1000 ? 200 : 2), [&](long long iters) {
+            std::string err;
+            for (long long done = 0; done < iters; done += n) {
+                TerritoryFileParser::ParseBuffer(text.data(), text.size(), out, err, 1);
+                grid.Build(out);
+                Bench::DoNotOptimize((long long)out.size() + grid.Count());
+            }
+        });
+    }
+}
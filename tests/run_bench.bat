@@ -0,0 +1,19 @@
+@echo off
+REM Build and run GTWBench (Release). Run from the solution root or tests\ directory.
+setlocal
+
+set MSBUILD="C:\Program Files\Microsoft Visual Studio\2022\Community\MSBuild\Current\Bin\MSBuild.exe"
+set PROJ=%~dp0GTWBench.vcxproj
+set EXE=%~dp0bin\Bench\Release\GTWBench.exe
+
+echo [build] GTWBench Release x64
+%MSBUILD% "%PROJ%" /p:Configuration=Release /p:Platform=x64 /v:minimal
+if errorlevel 1 (
+    echo [FAIL] Build failed.
+    exit /b 1
+)
+
+echo.
+echo [run]
+"%EXE%"
+exit /b %errorlevel%
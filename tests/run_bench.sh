@@ -0,0 +1,20 @@
+#!/bin/sh
+# Build and run GTWBench on Linux/macOS against tests/stubs (no game SDK needed).
+# Sources are taken from GTWBench.vcxproj so the two builds never drift.
+# Arguments go to GTWBench, e.g.:
+#   tests/run_bench.sh --filter Scaling --csv bench.csv --baseline old.csv
+set -e
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+CXX=${CXX:-g++}
+OUT="$DIR/bin/Bench/Linux"
+mkdir -p "$OUT"
+
+SRCS=$(sed -n 's/.*ClCompile Include="\([^"]*\)".*/\1/p' "$DIR/GTWBench.vcxproj" | tr '\\' '/')
+
+echo "[build] GTWBench Release ($CXX)"
+(cd "$DIR" && $CXX -std=c++17 -O2 -DNDEBUG -Istubs -I../source $SRCS -o "$OUT/GTWBench" -lpthread)
+
+echo
+echo "[run]"
+exec "$OUT/GTWBench" "$@"
@@ -0,0 +1,67 @@
+#include "TestFramework.h"
+#include "../source/Crc32c.h"
+
+#include <cstring>
+#include <vector>
+
+// Bit-at-a-time reference.
+static unsigned int Reference(const unsigned char* p, size_t n) {
+    unsigned int crc = 0xFFFFFFFFu;
+    while (n--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; ++k) crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : (crc >> 1);
+    }
+    return ~crc;
+}
+
+static std::vector<unsigned char> Noise(size_t n) {
+    std::vector<unsigned char> out(n);
+    unsigned int x = 2463534242u;
+    for (auto& b : out) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        b = (unsigned char)x;
+    }
+    return out;
+}
+
+void RunCrc32cTests(Test::Runner& t) {
+    t.suite("Crc32c");
+
+    t.run("check value and empty input", [] {
+        const char* s = "123456789";
+        REQUIRE_EQ(Crc32c::ComputeSoftware(s, 9), 0xE3069283u);
+        REQUIRE_EQ(Crc32c::ComputeHardware(s, 9), 0xE3069283u);
+        REQUIRE_EQ(Crc32c::Compute(s, 9), 0xE3069283u);
+        REQUIRE_EQ(Crc32c::Compute(s, 0), 0u);
+    });
+
+    t.run("slice-by-8 and hardware match the reference at every length and alignment", [] {
+        const auto buf = Noise(300);
+        for (size_t off = 0; off < 8; ++off) {
+            for (size_t n = 0; n + off <= buf.size(); n += 7) {
+                const unsigned int want = Reference(buf.data() + off, n);
+                REQUIRE_EQ(Crc32c::ComputeSoftware(buf.data() + off, n), want);
+                REQUIRE_EQ(Crc32c::ComputeHardware(buf.data() + off, n), want);
+            }
+        }
+    });
+
+    t.run("calls chain", [] {
+        const auto buf = Noise(1000);
+        const unsigned int whole = Crc32c::Compute(buf.data(), buf.size());
+        for (size_t cut : { (size_t)0, (size_t)1, (size_t)333, (size_t)999, (size_t)1000 }) {
+            const unsigned int a = Crc32c::ComputeSoftware(buf.data(), cut);
+            REQUIRE_EQ(Crc32c::ComputeHardware(buf.data() + cut, buf.size() - cut, a), whole);
+        }
+    });
+
+    t.run("every single-bit flip changes the value", [] {
+        auto buf = Noise(64);
+        const unsigned int clean = Crc32c::Compute(buf.data(), buf.size());
+        for (size_t i = 0; i < buf.size() * 8; ++i) {
+            buf[i / 8] ^= (unsigned char)(1u << (i % 8));
+            REQUIRE(Crc32c::Compute(buf.data(), buf.size()) != clean);
+            buf[i / 8] ^= (unsigned char)(1u << (i % 8));
+        }
+    });
+}
@@ -0,0 +1,106 @@
+#include "TestFramework.h"
+#include "../source/FileHandleTable.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+void RunFileHandleTableTests(Test::Runner& t) {
+    t.suite("FileHandleTable");
+
+    t.run("insert + take round-trips the op once", [] {
+        FileHandleTable tab;
+        REQUIRE(tab.Insert(0x1234, FileHandleTable::Op{ 3, true, false }));
+        REQUIRE_EQ(tab.Count(), 1);
+
+        FileHandleTable::Op op{};
+        REQUIRE(tab.Take(0x1234, op));
+        REQUIRE_EQ(op.slot, 3);
+        REQUIRE(op.isSave);
+        REQUIRE_FALSE(op.isLoad);
+        REQUIRE_FALSE(tab.Take(0x1234, op));
+        REQUIRE_EQ(tab.Count(), 0);
+    });
+
+    t.run("unknown and zero handles miss", [] {
+        FileHandleTable tab;
+        FileHandleTable::Op op{};
+        REQUIRE_FALSE(tab.Take(42, op));
+        REQUIRE_FALSE(tab.Insert(0, FileHandleTable::Op{ 1, false, true }));
+        REQUIRE_FALSE(tab.Take(0, op));
+    });
+
+    t.run("a reused handle keeps its slot, re-insert replaces the op", [] {
+        FileHandleTable tab;
+        FileHandleTable::Op op{};
+        for (int i = 1; i <= 1000; ++i) {
+            REQUIRE(tab.Insert(0x5000, FileHandleTable::Op{ 1 + i % 8, false, true }));
+            REQUIRE(tab.Take(0x5000, op));
+            REQUIRE_EQ(op.slot, 1 + i % 8);
+        }
+        REQUIRE(tab.Insert(0x5000, FileHandleTable::Op{ 1, false, true }));
+        REQUIRE(tab.Insert(0x5000, FileHandleTable::Op{ 2, true, false }));
+        REQUIRE_EQ(tab.Count(), 1);
+        REQUIRE(tab.Take(0x5000, op));
+        REQUIRE_EQ(op.slot, 2);
+    });
+
+    t.run("colliding handles probe past each other; full table refuses", [] {
+        FileHandleTable tab;
+        // Pointer-like handles 16 bytes apart, the whole capacity.
+        for (int i = 0; i < FileHandleTable::kCapacity; ++i) {
+            REQUIRE(tab.Insert(0x10000 + i * 16, FileHandleTable::Op{ 1 + i % 8, i % 2 == 0, i % 2 == 1 }));
+        }
+        REQUIRE_FALSE(tab.Insert(0x99999, FileHandleTable::Op{ 1, true, false }));
+        FileHandleTable::Op op{};
+        for (int i = 0; i < FileHandleTable::kCapacity; ++i) {
+            REQUIRE(tab.Take(0x10000 + i * 16, op));
+            REQUIRE_EQ(op.slot, 1 + i % 8);
+            REQUIRE_EQ(op.isSave, i % 2 == 0);
+        }
+        REQUIRE_FALSE(tab.Take(0x99999, op)); // full table, miss still ends
+
+        tab.Clear();
+        REQUIRE(tab.Insert(0x99999, FileHandleTable::Op{ 1, true, false }));
+    });
+
+    t.run("concurrent opens and closes: every op taken exactly once", [] {
+        FileHandleTable tab;
+        std::atomic<int> taken{ 0 };
+        std::atomic<int> wrongSlot{ 0 };
+
+        // Each thread opens and closes its own handles; a third thread
+        // races to close the same handles as thread A.
+        auto worker = [&](std::intptr_t base) {
+            FileHandleTable::Op op{};
+            for (int round = 0; round < 2000; ++round) {
+                for (int k = 0; k < 8; ++k) tab.Insert(base + k * 8, FileHandleTable::Op{ 1 + k, true, false });
+                for (int k = 0; k < 8; ++k) {
+                    if (tab.Take(base + k * 8, op)) {
+                        ++taken;
+                        if (op.slot != 1 + k) ++wrongSlot;
+                    }
+                }
+            }
+        };
+        auto stealer = [&] {
+            FileHandleTable::Op op{};
+            for (int round = 0; round < 20000; ++round) {
+                for (int k = 0; k < 8; ++k) {
+                    if (tab.Take(0x1000 + k * 8, op)) {
+                        ++taken;
+                        if (op.slot != 1 + k) ++wrongSlot;
+                    }
+                }
+            }
+        };
+        std::thread a(worker, (std::intptr_t)0x1000);
+        std::thread b(worker, (std::intptr_t)0x9000);
+        std::thread c(stealer);
+        a.join(); b.join(); c.join();
+
+        REQUIRE_EQ(wrongSlot.load(), 0);
+        REQUIRE_EQ(taken.load(), 2 * 2000 * 8); // none lost, none taken twice
+        REQUIRE_EQ(tab.Count(), 0);
+    });
+}
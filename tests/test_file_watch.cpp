@@ -0,0 +1,299 @@
+#include "TestFramework.h"
+#include "../source/FileWatch.h"
+#include "../source/TerritoryCache.h"
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+// In-memory files and directory notifications, counting every call.
+struct FakeWatchFs {
+    struct Entry {
+        std::string text;
+        long long mtime = 1;
+    };
+    std::map<std::string, Entry> files;
+    std::map<std::string, bool> signalled; // per directory, for the native mode
+    bool native = false;
+    bool failRead = false;
+    int stats = 0;
+    int reads = 0;
+    int dirsOpen = 0;
+
+    void Write(const std::string& path, const std::string& text) {
+        Entry& e = files[path];
+        e.text = text;
+        ++e.mtime;
+        signalled[path.substr(0, path.find_last_of('/'))] = true;
+    }
+
+    FileWatch::Backend Backend() {
+        FileWatch::Backend b;
+        b.user = this;
+        b.stat = [](const char* path, FileWatch::Stamp& out, void* user) {
+            FakeWatchFs* fs = (FakeWatchFs*)user;
+            ++fs->stats;
+            auto it = fs->files.find(path);
+            if (it == fs->files.end()) return false;
+            out.size = (long long)it->second.text.size();
+            out.mtime = it->second.mtime;
+            return true;
+        };
+        b.read = [](const char* path, std::vector<char>& out, void* user) {
+            FakeWatchFs* fs = (FakeWatchFs*)user;
+            ++fs->reads;
+            auto it = fs->files.find(path);
+            if (fs->failRead || it == fs->files.end()) return false;
+            out.assign(it->second.text.begin(), it->second.text.end());
+            return true;
+        };
+        if (native) {
+            b.openDir = [](const char* dir, void* user) -> void* {
+                FakeWatchFs* fs = (FakeWatchFs*)user;
+                ++fs->dirsOpen;
+                fs->signalled[dir] = false;
+                return new std::string(dir);
+            };
+            b.pollDir = [](void* handle, void* user) {
+                FakeWatchFs* fs = (FakeWatchFs*)user;
+                bool& s = fs->signalled[*(std::string*)handle];
+                const bool was = s;
+                s = false;
+                return was;
+            };
+            b.closeDir = [](void* handle, void* user) {
+                --((FakeWatchFs*)user)->dirsOpen;
+                delete (std::string*)handle;
+            };
+        }
+        return b;
+    }
+};
+
+struct Seen {
+    int calls = 0;
+    std::string text;
+    unsigned long long hash = 0;
+
+    static void Record(const std::vector<char>& content, unsigned long long hash, void* user) {
+        Seen* s = (Seen*)user;
+        ++s->calls;
+        s->text.assign(content.begin(), content.end());
+        s->hash = hash;
+    }
+};
+
+void RunFileWatchTests(Test::Runner& t) {
+    t.suite("FileWatch");
+
+    t.run("polling: a changed file is read once for all its subscribers", [] {
+        FakeWatchFs fs;
+        fs.Write("gtw/territories.txt", "a");
+        fs.Write("gtw/gtw.ini", "x=1");
+        FileWatch w(fs.Backend());
+        Seen a, b, c;
+        w.Watch("gtw/territories.txt", Seen::Record, &a);
+        w.Watch("gtw/territories.txt", Seen::Record, &b);
+        w.Watch("gtw/gtw.ini", Seen::Record, &c);
+        REQUIRE_EQ(w.FileCount(), 2);
+        REQUIRE_EQ(w.SubscriberCount(), 3);
+
+        fs.stats = 0;
+        w.Tick(1000);
+        REQUIRE_EQ(fs.stats, 2); // one per file, not per subscriber
+        REQUIRE_EQ(fs.reads, 0); // nothing changed since Watch
+        REQUIRE_EQ(a.calls, 0);
+
+        fs.Write("gtw/territories.txt", "bb");
+        w.Tick(1100); // within the interval
+        REQUIRE_EQ(fs.stats, 2);
+        w.Tick(1500);
+        REQUIRE_EQ(fs.stats, 4);
+        REQUIRE_EQ(fs.reads, 1);
+        REQUIRE_EQ(a.calls, 1);
+        REQUIRE_EQ(b.calls, 1);
+        REQUIRE_EQ(c.calls, 0);
+        REQUIRE_EQ(a.text, std::string("bb"));
+        REQUIRE_EQ(a.hash, TerritoryCache::HashText("bb", 2)); // what ApplyConfigText compares against
+    });
+
+    t.run("polling: touched with the same bytes notifies no one", [] {
+        FakeWatchFs fs;
+        fs.Write("gtw/territories.txt", "a");
+        FileWatch w(fs.Backend());
+        Seen a;
+        w.Watch("gtw/territories.txt", Seen::Record, &a);
+
+        fs.Write("gtw/territories.txt", "b");
+        w.Tick(1000);
+        REQUIRE_EQ(a.calls, 1);
+        fs.Write("gtw/territories.txt", "b"); // mtime moves, bytes do not
+        w.Tick(2000);
+        REQUIRE_EQ(fs.reads, 2);
+        REQUIRE_EQ(a.calls, 1);
+    });
+
+    t.run("polling: a deleted file is reported once it is back", [] {
+        FakeWatchFs fs;
+        fs.Write("gtw/territories.txt", "a");
+        FileWatch w(fs.Backend());
+        Seen a;
+        w.Watch("gtw/territories.txt", Seen::Record, &a);
+
+        fs.files.erase("gtw/territories.txt");
+        w.Tick(1000);
+        REQUIRE_EQ(a.calls, 0);
+        fs.Write("gtw/territories.txt", "c");
+        w.Tick(2000);
+        REQUIRE_EQ(a.calls, 1);
+        REQUIRE_EQ(a.text, std::string("c"));
+    });
+
+    t.run("polling: a failed read is retried on the next tick", [] {
+        FakeWatchFs fs;
+        fs.Write("gtw/territories.txt", "a");
+        FileWatch w(fs.Backend());
+        Seen a;
+        w.Watch("gtw/territories.txt", Seen::Record, &a);
+
+        fs.Write("gtw/territories.txt", "b");
+        fs.failRead = true;
+        w.Tick(1000);
+        REQUIRE_EQ(a.calls, 0);
+        fs.failRead = false;
+        w.Tick(2000);
+        REQUIRE_EQ(a.calls, 1);
+    });
+
+    t.run("native: a quiet directory costs no stat", [] {
+        FakeWatchFs fs;
+        fs.native = true;
+        fs.Write("gtw/territories.txt", "a");
+        fs.Write("gtw/gtw.ini", "x=1");
+        fs.Write("other/list.txt", "z");
+        FileWatch w(fs.Backend());
+        Seen a, b, c;
+        w.Watch("gtw/territories.txt", Seen::Record, &a);
+        w.Watch("gtw/gtw.ini", Seen::Record, &b);
+        w.Watch("other/list.txt", Seen::Record, &c);
+        REQUIRE_EQ(fs.dirsOpen, 2);
+
+        fs.stats = 0;
+        for (unsigned int now = 0; now < 10000; now += 500) w.Tick(now);
+        REQUIRE_EQ(fs.stats, 0);
+
+        fs.Write("gtw/gtw.ini", "x=2");
+        w.Tick(10000);
+        REQUIRE_EQ(fs.stats, 2); // only the signalled directory's files
+        REQUIRE_EQ(b.calls, 1);
+        REQUIRE_EQ(a.calls, 0);
+        REQUIRE_EQ(c.calls, 0);
+    });
+
+    t.run("native: a failed read is retried without a new signal", [] {
+        FakeWatchFs fs;
+        fs.native = true;
+        fs.Write("gtw/territories.txt", "a");
+        FileWatch w(fs.Backend());
+        Seen a;
+        w.Watch("gtw/territories.txt", Seen::Record, &a);
+
+        fs.Write("gtw/territories.txt", "b");
+        fs.failRead = true;
+        w.Tick(1000);
+        fs.failRead = false;
+        w.Tick(2000);
+        REQUIRE_EQ(a.calls, 1);
+        w.Tick(3000);
+        REQUIRE_EQ(fs.reads, 2);
+    });
+
+    t.run("unwatch: inside a callback, last one out closes the directory", [] {
+        struct Self {
+            FileWatch* w;
+            int id;
+            int calls;
+        };
+        FakeWatchFs fs;
+        fs.native = true;
+        fs.Write("gtw/territories.txt", "a");
+        FileWatch w(fs.Backend());
+        Self self{ &w, 0, 0 };
+        self.id = w.Watch("gtw/territories.txt", [](const std::vector<char>&, unsigned long long, void* user) {
+            Self* s = (Self*)user;
+            ++s->calls;
+            s->w->Unwatch(s->id);
+        }, &self);
+        Seen other;
+        w.Watch("gtw/territories.txt", Seen::Record, &other);
+
+        fs.Write("gtw/territories.txt", "b");
+        w.Tick(1000);
+        REQUIRE_EQ(self.calls, 1);
+        REQUIRE_EQ(other.calls, 1);
+        REQUIRE_EQ(w.SubscriberCount(), 1);
+
+        fs.Write("gtw/territories.txt", "c");
+        w.Tick(2000);
+        REQUIRE_EQ(self.calls, 1);
+        REQUIRE_EQ(other.calls, 2);
+
+        w.Clear();
+        REQUIRE_EQ(w.FileCount(), 0);
+        REQUIRE_EQ(fs.dirsOpen, 0);
+    });
+
+    t.run("acknowledge: our own write is not reported back", [] {
+        FakeWatchFs fs;
+        fs.Write("gtw/territories.txt", "a");
+        FileWatch w(fs.Backend());
+        Seen a;
+        w.Watch("gtw/territories.txt", Seen::Record, &a);
+
+        fs.Write("gtw/territories.txt", "ours");
+        w.Acknowledge("gtw/territories.txt");
+        w.Tick(1000);
+        REQUIRE_EQ(fs.reads, 0);
+        REQUIRE_EQ(a.calls, 0);
+
+        fs.Write("gtw/territories.txt", "a"); // back to bytes seen before: still a change
+        w.Tick(2000);
+        REQUIRE_EQ(a.calls, 1);
+    });
+
+    t.run("tick: game time going backwards checks right away", [] {
+        FakeWatchFs fs;
+        fs.Write("gtw/territories.txt", "a");
+        FileWatch w(fs.Backend());
+        Seen a;
+        w.Watch("gtw/territories.txt", Seen::Record, &a);
+        w.Tick(50000);
+        fs.Write("gtw/territories.txt", "b");
+        w.Tick(100); // a save was loaded
+        REQUIRE_EQ(a.calls, 1);
+    });
+
+    t.run("polling: real file on disk", [] {
+        const char* path = "gtw_file_watch_test.txt";
+        auto write = [&](const char* text) {
+            FILE* f = std::fopen(path, "wb");
+            std::fputs(text, f);
+            std::fclose(f);
+        };
+
+        write("a");
+        FileWatch w(FileWatch::Polling());
+        Seen a;
+        w.Watch(path, Seen::Record, &a);
+        w.Tick(1000);
+        REQUIRE_EQ(a.calls, 0);
+
+        write("abc"); // size differs even within the same mtime second
+        w.Tick(2000);
+        REQUIRE_EQ(a.calls, 1);
+        REQUIRE_EQ(a.text, std::string("abc"));
+
+        std::remove(path);
+    });
+}
@@ -1,6 +1,9 @@
 #include "TestFramework.h"
 #include "../source/IniConfig.h"
 
+#include <cstdio>
+#include <string>
+
 void RunIniConfigTests(Test::Runner& t) {
     t.suite("IniConfig");
 
@@ -71,4 +74,84 @@ void RunIniConfigTests(Test::Runner& t) {
         cfg.LoadFromString("");
         REQUIRE_EQ(cfg.GetInt("Any", "key", -1), -1);
     });
+
+    t.run("later duplicate key wins", [&] {
+        IniConfig cfg;
+        cfg.LoadFromString("[S]\nkey=1\n[T]\nkey=5\n[S]\nkey=2\n");
+        REQUIRE_EQ(cfg.GetInt("S", "key", 0), 2);
+        REQUIRE_EQ(cfg.GetInt("T", "key", 0), 5);
+    });
+
+    t.run("non-numeric values read as the default", [&] {
+        IniConfig cfg;
+        cfg.LoadFromString("[S]\na=abc\nb=\nc=99999999999\nd=1.5\ne=-3 ; note\n");
+        REQUIRE_EQ(cfg.GetInt("S", "a", 4), 4);
+        REQUIRE(cfg.GetFloat("S", "a", 0.25f) == 0.25f);
+        REQUIRE_EQ(cfg.GetInt("S", "b", 4), 4);
+        REQUIRE_EQ(cfg.GetInt("S", "c", 4), 4);
+        REQUIRE_EQ(cfg.GetInt("S", "d", 0), 1); // numeric prefix, as stoi
+        REQUIRE_EQ(cfg.GetInt("S", "e", 0), -3);
+        REQUIRE_EQ(cfg.GetString("S", "a", ""), std::string("abc"));
+    });
+
+    t.run("lookups by string_view match only the whole section and key", [&] {
+        IniConfig cfg;
+        cfg.LoadFromString("[Spawning]\nRadius=3\n[Spawn]\ningRadius=4\n");
+        const std::string buf = "SpawningRadiusX";
+        const std::string_view all(buf);
+        REQUIRE_EQ(cfg.GetInt(all.substr(0, 8), all.substr(8, 6), 0), 3);
+        REQUIRE_EQ(cfg.GetInt("Spawn", "ingRadius", 0), 4);
+        REQUIRE_EQ(cfg.GetInt("Spawnin", "gRadius", 0), 0);
+        REQUIRE_EQ(cfg.GetInt(all.substr(0, 8), all.substr(8, 7), 0), 0);
+    });
+
+    t.run("many keys stay reachable", [&] {
+        std::string text = "[Big]\n";
+        for (int i = 0; i < 500; ++i) text += "k" + std::to_string(i) + "=" + std::to_string(i * 3) + "\n";
+        IniConfig cfg;
+        cfg.LoadFromString(text);
+        for (int i = 0; i < 500; ++i) REQUIRE_EQ(cfg.GetInt("Big", "k" + std::to_string(i), -1), i * 3);
+        REQUIRE_EQ(cfg.GetInt("Big", "k500", -1), -1);
+    });
+
+    t.run("generation moves only when the content changes", [&] {
+        IniConfig cfg;
+        REQUIRE(cfg.LoadFromString("[S]\nx=1\ny=2\n"));
+        const unsigned int g = cfg.Generation();
+        REQUIRE_FALSE(cfg.LoadFromString("[S]\nx=1\ny=2\n"));
+        REQUIRE_EQ(cfg.Generation(), g);
+
+        REQUIRE(cfg.LoadFromString("[S]\nx=3\n"));
+        REQUIRE(cfg.Generation() != g);
+        REQUIRE_EQ(cfg.GetInt("S", "x", 0), 3);
+        REQUIRE_EQ(cfg.GetInt("S", "y", 0), 0); // removed keys are gone
+    });
+
+    t.run("file: unchanged file is not re-parsed, edits are", [&] {
+        const char* path = "gtw_ini_config_test.ini";
+        auto write = [&](const char* text) {
+            FILE* f = std::fopen(path, "wb");
+            std::fputs(text, f);
+            std::fclose(f);
+        };
+
+        IniConfig cfg;
+        write("[S]\nx=1\n");
+        REQUIRE(cfg.Load(path));
+        REQUIRE_EQ(cfg.GetInt("S", "x", 0), 1);
+        const unsigned int g = cfg.Generation();
+        REQUIRE_FALSE(cfg.Refresh());
+
+        write("[S]\nx=1\n"); // rewritten, same bytes
+        REQUIRE_FALSE(cfg.Refresh());
+        REQUIRE_EQ(cfg.Generation(), g);
+
+        write("[S]\nx=22\n"); // size differs even within the same mtime second
+        REQUIRE(cfg.Refresh());
+        REQUIRE_EQ(cfg.GetInt("S", "x", 0), 22);
+
+        std::remove(path);
+        REQUIRE_FALSE(cfg.Refresh()); // gone: keep what we had
+        REQUIRE_EQ(cfg.GetInt("S", "x", 0), 22);
+    });
 }
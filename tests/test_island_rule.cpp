@@ -88,4 +88,19 @@ void RunIslandRuleTests(Test::Runner& t) {
         REQUIRE_FALSE(IsIslandUnlocked(Island::UNKNOWN, 1));
         REQUIRE_FALSE(IsIslandUnlocked(Island::UNKNOWN, 3));
     });
+
+    t.suite("IslandRule – IsIslandActive");
+
+    t.run("Act 0: Portland active though still locked", [&] {
+        REQUIRE(IsIslandActive(Island::PORTLAND, 0));
+        REQUIRE_FALSE(IsIslandActive(Island::STAUNTON, 0));
+        REQUIRE_FALSE(IsIslandActive(Island::SHORESIDE, 0));
+    });
+
+    t.run("later acts follow unlocking", [&] {
+        REQUIRE(IsIslandActive(Island::STAUNTON, 2));
+        REQUIRE_FALSE(IsIslandActive(Island::SHORESIDE, 2));
+        REQUIRE(IsIslandActive(Island::SHORESIDE, 3));
+        REQUIRE_FALSE(IsIslandActive(Island::UNKNOWN, 3));
+    });
 }
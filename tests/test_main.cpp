@@ -1,15 +1,35 @@
 #include "TestFramework.h"
 
 void RunIniConfigTests(Test::Runner& t);
+void RunCrc32cTests(Test::Runner& t);
 void RunSidecarFormatTests(Test::Runner& t);
+void RunSidecarWriterTests(Test::Runner& t);
+void RunOwnershipJournalTests(Test::Runner& t);
+void RunFileWatchTests(Test::Runner& t);
 void RunWarKillTrackerTests(Test::Runner& t);
 void RunTerritoryAabbTests(Test::Runner& t);
+void RunTerritoryPolygonTests(Test::Runner& t);
+void RunTerritoryGridTests(Test::Runner& t);
+void RunTerritoryBoundsTests(Test::Runner& t);
+void RunTerritoryIdIndexTests(Test::Runner& t);
+void RunTerritoryHandleTableTests(Test::Runner& t);
+void RunTerritoryFileParserTests(Test::Runner& t);
+void RunTerritoryCacheTests(Test::Runner& t);
+void RunTerritoryDiffTests(Test::Runner& t);
+void RunTerritoryChangeLogTests(Test::Runner& t);
+void RunTerritoryEditJournalTests(Test::Runner& t);
+void RunTerritoryOverlapTests(Test::Runner& t);
+void RunTerritoryPartitionsTests(Test::Runner& t);
+void RunPlayerContextTests(Test::Runner& t);
+void RunTerritoryOwnershipIndexTests(Test::Runner& t);
 void RunSaveSlotParserTests(Test::Runner& t);
+void RunFileHandleTableTests(Test::Runner& t);
 void RunWaveDeathRuleTests(Test::Runner& t);
 void RunKillCreditRuleTests(Test::Runner& t);
 void RunWaveConfigTests(Test::Runner& t);
 void RunGangInfoTests(Test::Runner& t);
 void RunNeutralRevertTests(Test::Runner& t);
+void RunNeutralRevertQueueTests(Test::Runner& t);
 void RunIslandRuleTests(Test::Runner& t);
 void RunAffiliationRuleTests(Test::Runner& t);
 void RunTerritoryStateRuleTests(Test::Runner& t);
@@ -19,15 +39,35 @@ int main() {
     Test::Runner t;
 
     RunIniConfigTests(t);
+    RunCrc32cTests(t);
     RunSidecarFormatTests(t);
+    RunSidecarWriterTests(t);
+    RunOwnershipJournalTests(t);
+    RunFileWatchTests(t);
     RunWarKillTrackerTests(t);
     RunTerritoryAabbTests(t);
+    RunTerritoryPolygonTests(t);
+    RunTerritoryGridTests(t);
+    RunTerritoryBoundsTests(t);
+    RunTerritoryIdIndexTests(t);
+    RunTerritoryHandleTableTests(t);
+    RunTerritoryFileParserTests(t);
+    RunTerritoryCacheTests(t);
+    RunTerritoryDiffTests(t);
+    RunTerritoryChangeLogTests(t);
+    RunTerritoryEditJournalTests(t);
+    RunTerritoryOverlapTests(t);
+    RunTerritoryPartitionsTests(t);
+    RunPlayerContextTests(t);
+    RunTerritoryOwnershipIndexTests(t);
     RunSaveSlotParserTests(t);
+    RunFileHandleTableTests(t);
     RunWaveDeathRuleTests(t);
     RunKillCreditRuleTests(t);
     RunWaveConfigTests(t);
     RunGangInfoTests(t);
     RunNeutralRevertTests(t);
+    RunNeutralRevertQueueTests(t);
     RunIslandRuleTests(t);
     RunAffiliationRuleTests(t);
     RunTerritoryStateRuleTests(t);
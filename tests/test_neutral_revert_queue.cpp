@@ -0,0 +1,196 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/NeutralRevertQueue.h"
+
+#include <random>
+
+static constexpr int MAFIA   = 7;
+static constexpr int TRIADS  = 8;
+static constexpr int NEUTRAL = -1;
+
+static constexpr unsigned int REVERT_MS = 180000;
+
+// Helpers
+// A tiny stand-in for TerritorySystem's owner bookkeeping, run either with
+// the old per-frame scan or with the queue.
+struct RevertWorld {
+    std::vector<Territory> terrs;
+    TerritoryHandleTable handles;
+    NeutralRevertQueue queue;
+    int reverts = 0;
+
+    explicit RevertWorld(int count) {
+        for (int i = 0; i < count; ++i) {
+            Territory t;
+            t.numId = 1001u + (unsigned int)i;
+            t.id = std::to_string(t.numId);
+            t.ownerGang = t.defaultOwnerGang = (i % 3 == 0) ? NEUTRAL : MAFIA + (i % 4);
+            terrs.push_back(t);
+        }
+        handles.Sync(terrs);
+    }
+
+    // Same stamping as TerritorySystem::SetTerritoryOwner.
+    void SetOwner(int idx, int owner, unsigned int now) {
+        Territory& t = terrs[idx];
+        if (owner == NEUTRAL && t.ownerGang != NEUTRAL) {
+            t.lastOwnerGang = t.ownerGang;
+            t.neutralSinceMs = now;
+            queue.Push(handles.HandleAt(idx), now);
+        } else if (owner != NEUTRAL) {
+            t.neutralSinceMs = 0;
+        }
+        t.ownerGang = owner;
+        t.underAttack = false;
+    }
+
+    // The loop TerritorySystem::Update ran before the queue.
+    void ScanTick(unsigned int now, unsigned int revertMs) {
+        for (auto& t : terrs) {
+            if (t.ownerGang == -1 && !t.underAttack &&
+                NeutralRevertDue(t.neutralSinceMs, now, revertMs)) {
+                const int revertTo = NeutralRevertTarget(t.lastOwnerGang, t.defaultOwnerGang);
+                if (revertTo != -1) {
+                    t.ownerGang = revertTo;
+                    t.neutralSinceMs = 0;
+                    ++reverts;
+                }
+            }
+        }
+    }
+
+    void QueueTick(unsigned int now, unsigned int revertMs) {
+        reverts += queue.ProcessDue(now, revertMs,
+            [&](TerritoryHandle h) -> Territory* {
+                const int idx = handles.IndexOf(h);
+                return (idx >= 0) ? &terrs[idx] : nullptr;
+            },
+            [](const Territory&, int) {});
+    }
+};
+
+static bool SameState(const RevertWorld& a, const RevertWorld& b) {
+    for (size_t i = 0; i < a.terrs.size(); ++i) {
+        const Territory& x = a.terrs[i];
+        const Territory& y = b.terrs[i];
+        if (x.ownerGang != y.ownerGang || x.neutralSinceMs != y.neutralSinceMs ||
+            x.lastOwnerGang != y.lastOwnerGang) return false;
+    }
+    return a.reverts == b.reverts;
+}
+
+void RunNeutralRevertQueueTests(Test::Runner& t) {
+    t.suite("NeutralRevertQueue");
+
+    t.run("pops oldest first, only once due", [&] {
+        NeutralRevertQueue q;
+        TerritoryHandle a{ 0, 0 }, b{ 1, 0 }, c{ 2, 0 };
+        q.Push(b, 2000);
+        q.Push(a, 1000);
+        q.Push(c, 3000);
+
+        NeutralRevertQueue::Entry e;
+        REQUIRE_FALSE(q.PopDue(1000 + REVERT_MS - 1, REVERT_MS, e));
+        REQUIRE(q.PopDue(2000 + REVERT_MS, REVERT_MS, e));
+        REQUIRE(e.handle == a);
+        REQUIRE(q.PopDue(2000 + REVERT_MS, REVERT_MS, e));
+        REQUIRE(e.handle == b);
+        REQUIRE_FALSE(q.PopDue(2000 + REVERT_MS, REVERT_MS, e));
+        REQUIRE_EQ(q.Size(), 1);
+    });
+
+    t.run("revertMs = 0 keeps everything queued", [&] {
+        NeutralRevertQueue q;
+        q.Push(TerritoryHandle{ 0, 0 }, 1);
+        NeutralRevertQueue::Entry e;
+        REQUIRE_FALSE(q.PopDue(999999999, 0, e));
+        REQUIRE_EQ(q.Size(), 1);
+        REQUIRE(q.PopDue(999999999, REVERT_MS, e)); // re-enabling picks it up
+    });
+
+    t.run("stamp 0 is never queued", [&] {
+        NeutralRevertQueue q;
+        q.Push(TerritoryHandle{ 0, 0 }, 0);
+        REQUIRE_EQ(q.Size(), 0);
+    });
+
+    t.run("recapture cancels, re-neutral restarts the window", [&] {
+        RevertWorld w(3);
+        w.SetOwner(1, NEUTRAL, 1000);
+        w.SetOwner(1, TRIADS, 5000);
+        w.SetOwner(1, NEUTRAL, 9000);
+
+        w.QueueTick(1000 + REVERT_MS, REVERT_MS);
+        REQUIRE_EQ(w.terrs[1].ownerGang, NEUTRAL);
+        w.QueueTick(9000 + REVERT_MS, REVERT_MS);
+        REQUIRE_EQ(w.terrs[1].ownerGang, TRIADS);
+        REQUIRE_EQ(w.reverts, 1);
+        REQUIRE_EQ(w.queue.Size(), 0);
+    });
+
+    t.run("under attack defers until the flag clears", [&] {
+        RevertWorld w(2);
+        w.SetOwner(1, NEUTRAL, 1000);
+        w.terrs[1].underAttack = true;
+        w.QueueTick(1000 + REVERT_MS, REVERT_MS);
+        REQUIRE_EQ(w.terrs[1].ownerGang, NEUTRAL);
+        REQUIRE_EQ(w.queue.Size(), 1);
+
+        w.terrs[1].underAttack = false;
+        w.QueueTick(1000 + REVERT_MS + 16, REVERT_MS);
+        REQUIRE_EQ(w.terrs[1].ownerGang, w.terrs[1].lastOwnerGang);
+    });
+
+    t.run("no revert target stays neutral", [&] {
+        RevertWorld w(1);
+        w.terrs[0].ownerGang = MAFIA;
+        w.SetOwner(0, NEUTRAL, 1000);
+        w.terrs[0].lastOwnerGang = NEUTRAL;
+        w.terrs[0].defaultOwnerGang = NEUTRAL;
+        w.QueueTick(1000 + REVERT_MS, REVERT_MS);
+        REQUIRE_EQ(w.terrs[0].ownerGang, NEUTRAL);
+        REQUIRE_EQ(w.queue.Size(), 1);
+    });
+
+    t.run("removed territory's entry is dropped", [&] {
+        RevertWorld w(3);
+        w.SetOwner(2, NEUTRAL, 1000);
+        w.terrs.pop_back();
+        w.handles.Sync(w.terrs);
+        w.QueueTick(1000 + REVERT_MS, REVERT_MS);
+        REQUIRE_EQ(w.reverts, 0);
+        REQUIRE_EQ(w.queue.Size(), 0);
+    });
+
+    t.run("random play: identical to the full scan", [&] {
+        RevertWorld scan(200), heap(200);
+        std::mt19937 rng(99u);
+        unsigned int now = 1;
+        unsigned int revertMs = 30000;
+        bool same = true;
+
+        for (int frame = 0; frame < 20000 && same; ++frame) {
+            now += 16 + rng() % 200;
+
+            const unsigned int r = rng() % 100;
+            const int idx = (int)(rng() % 200);
+            if (r < 6) {
+                const int owner = (rng() % 3 == 0) ? NEUTRAL : MAFIA + (int)(rng() % 5);
+                scan.SetOwner(idx, owner, now);
+                heap.SetOwner(idx, owner, now);
+            } else if (r < 8) {
+                const bool attack = (rng() & 1) != 0;
+                scan.terrs[idx].underAttack = attack;
+                heap.terrs[idx].underAttack = attack;
+            } else if (r == 8) {
+                revertMs = (rng() % 4 == 0) ? 0 : 10000 + rng() % 40000;
+            }
+
+            scan.ScanTick(now, revertMs);
+            heap.QueueTick(now, revertMs);
+            same = SameState(scan, heap);
+        }
+        REQUIRE(same);
+        REQUIRE(scan.reverts > 50);
+    });
+}
@@ -0,0 +1,163 @@
+#include "TestFramework.h"
+#include "../source/OwnershipJournal.h"
+#include "../source/AffiliationRule.h"
+
+#include <string>
+#include <vector>
+
+using Record = OwnershipJournal::Record;
+
+static std::vector<unsigned char> MakeFile(unsigned int crc, const std::vector<Record>& records) {
+    std::vector<unsigned char> out;
+    OwnershipJournal::AppendHeader(out, crc);
+    for (const Record& r : records) OwnershipJournal::AppendRecord(out, r);
+    return out;
+}
+
+void RunOwnershipJournalTests(Test::Runner& t) {
+    t.suite("OwnershipJournal");
+
+    t.run("format: records round-trip, negative owners included", [] {
+        const auto bytes = MakeFile(0xDEADBEEFu, {
+            { 1001u, GANG1, OWNER_NEUTRAL, 5000u },
+            { 1001u, OWNER_NEUTRAL, GANG2, 9000u },
+            { 4000000000u, OWNER_CLEARED, GANG6, 0xFFFFFFF0u },
+        });
+        REQUIRE_EQ(bytes.size(), OwnershipJournal::kHeaderSize + 3 * OwnershipJournal::kRecordSize);
+
+        unsigned int crc = 0;
+        std::vector<Record> out;
+        std::string err;
+        REQUIRE(OwnershipJournal::Parse(bytes.data(), bytes.size(), crc, out, err));
+        REQUIRE_EQ(crc, 0xDEADBEEFu);
+        REQUIRE_EQ((int)out.size(), 3);
+        REQUIRE_EQ(out[0].oldOwner, GANG1);
+        REQUIRE_EQ(out[0].newOwner, OWNER_NEUTRAL);
+        REQUIRE_EQ(out[1].timeMs, 9000u);
+        REQUIRE_EQ(out[2].id, 4000000000u);
+        REQUIRE_EQ(out[2].oldOwner, OWNER_CLEARED);
+        REQUIRE_EQ(out[2].timeMs, 0xFFFFFFF0u);
+    });
+
+    t.run("format: header only is an empty, clean journal", [] {
+        const auto bytes = MakeFile(7u, {});
+        unsigned int crc = 0;
+        std::vector<Record> out;
+        std::string err;
+        REQUIRE(OwnershipJournal::Parse(bytes.data(), bytes.size(), crc, out, err));
+        REQUIRE_EQ(crc, 7u);
+        REQUIRE(out.empty());
+    });
+
+    t.run("format: torn last record keeps the ones before it", [] {
+        auto bytes = MakeFile(7u, { { 1001u, GANG1, GANG2, 1u }, { 1002u, GANG1, GANG3, 2u } });
+        bytes.resize(bytes.size() - 5);
+        unsigned int crc = 0;
+        std::vector<Record> out;
+        std::string err;
+        REQUIRE_FALSE(OwnershipJournal::Parse(bytes.data(), bytes.size(), crc, out, err));
+        REQUIRE_EQ(crc, 7u);
+        REQUIRE_EQ((int)out.size(), 1);
+        REQUIRE_EQ(out[0].id, 1001u);
+        REQUIRE(!err.empty());
+    });
+
+    t.run("format: a corrupt record ends the replay", [] {
+        auto bytes = MakeFile(7u, { { 1001u, GANG1, GANG2, 1u }, { 1002u, GANG1, GANG3, 2u }, { 1003u, GANG1, GANG4, 3u } });
+        bytes[OwnershipJournal::kHeaderSize + OwnershipJournal::kRecordSize + 5] ^= 0x04;
+        unsigned int crc = 0;
+        std::vector<Record> out;
+        std::string err;
+        REQUIRE_FALSE(OwnershipJournal::Parse(bytes.data(), bytes.size(), crc, out, err));
+        REQUIRE_EQ((int)out.size(), 1);
+        REQUIRE(err.find("record 1") != std::string::npos);
+    });
+
+    t.run("format: bad magic or version is rejected", [] {
+        auto bytes = MakeFile(7u, { { 1001u, GANG1, GANG2, 1u } });
+        unsigned int crc = 0;
+        std::vector<Record> out;
+        std::string err;
+        bytes[0] ^= 1;
+        REQUIRE_FALSE(OwnershipJournal::Parse(bytes.data(), bytes.size(), crc, out, err));
+        bytes[0] ^= 1;
+        bytes[4] = 2;
+        REQUIRE_FALSE(OwnershipJournal::Parse(bytes.data(), bytes.size(), crc, out, err));
+        REQUIRE(out.empty());
+        REQUIRE_FALSE(OwnershipJournal::Parse(bytes.data(), 3, crc, out, err));
+    });
+
+    t.run("lineage: first save checkpoints, same slot then appends", [] {
+        OwnershipJournal j;
+        std::vector<Record> out;
+        j.Note(1001u, GANG1, GANG2, 10u);
+        REQUIRE(j.BeginSave(1, 1u, 99u, out));
+        REQUIRE_EQ((int)out.size(), 1);
+        REQUIRE(j.Pending().empty());
+        REQUIRE_EQ(j.Journaled(), 0);
+
+        j.Note(1002u, GANG1, GANG3, 20u);
+        j.Note(1002u, GANG3, GANG3, 30u); // no change, not noted
+        REQUIRE_FALSE(j.BeginSave(1, 1u, 99u, out));
+        REQUIRE_EQ((int)out.size(), 1);
+        REQUIRE_EQ(out[0].newOwner, GANG3);
+        REQUIRE_EQ(j.Journaled(), 1);
+
+        REQUIRE_FALSE(j.BeginSave(1, 1u, 99u, out)); // nothing new: an empty append
+        REQUIRE(out.empty());
+    });
+
+    t.run("lineage: another slot, act or defaults hash checkpoints", [] {
+        OwnershipJournal j;
+        std::vector<Record> out;
+        j.Adopt(2, 1u, 99u, 10);
+        REQUIRE_FALSE(j.BeginSave(2, 1u, 99u, out));
+        REQUIRE(j.BeginSave(3, 1u, 99u, out));
+        REQUIRE(j.BeginSave(2, 1u, 99u, out)); // slot 2 on disk is behind now
+        REQUIRE(j.BeginSave(2, 2u, 99u, out));
+        REQUIRE(j.BeginSave(2, 2u, 100u, out));
+        REQUIRE_FALSE(j.BeginSave(2, 2u, 100u, out));
+    });
+
+    t.run("lineage: compaction past kCompactAfter records", [] {
+        OwnershipJournal j;
+        std::vector<Record> out;
+        j.Adopt(1, 1u, 99u, OwnershipJournal::kCompactAfter - 2);
+        j.Note(1001u, GANG1, GANG2, 1u);
+        j.Note(1001u, GANG2, GANG1, 2u);
+        REQUIRE_FALSE(j.BeginSave(1, 1u, 99u, out));
+        REQUIRE_EQ(j.Journaled(), OwnershipJournal::kCompactAfter);
+        j.Note(1001u, GANG1, GANG2, 3u);
+        REQUIRE(j.BeginSave(1, 1u, 99u, out));
+        REQUIRE_EQ(j.Journaled(), 0);
+    });
+
+    t.run("lineage: overflow drops pending and forces a checkpoint", [] {
+        OwnershipJournal j;
+        std::vector<Record> out;
+        j.Adopt(1, 1u, 99u, 0);
+        for (int i = 0; i <= OwnershipJournal::kMaxPending; ++i) j.Note(1001u, GANG1 + (i & 1), GANG2 - (i & 1), (unsigned int)i);
+        REQUIRE(j.Pending().empty());
+        REQUIRE(j.BeginSave(1, 1u, 99u, out));
+
+        j.Note(1001u, GANG1, GANG2, 1u);
+        REQUIRE_FALSE(j.BeginSave(1, 1u, 99u, out));
+    });
+
+    t.run("lineage: a failed write or a reset forces a checkpoint", [] {
+        OwnershipJournal j;
+        std::vector<Record> out;
+        j.Adopt(1, 1u, 99u, 0);
+        j.SaveFailed(2); // another slot: no effect
+        REQUIRE_FALSE(j.BeginSave(1, 1u, 99u, out));
+        j.SaveFailed(1);
+        REQUIRE_EQ(j.Slot(), -1);
+        REQUIRE(j.BeginSave(1, 1u, 99u, out));
+
+        j.Note(1001u, GANG1, GANG2, 1u);
+        j.Reset();
+        REQUIRE(j.Pending().empty());
+        REQUIRE(j.BeginSave(1, 1u, 99u, out));
+        REQUIRE(out.empty());
+    });
+}
@@ -0,0 +1,242 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/PlayerContext.h"
+#include "../source/TerritoryHandleTable.h"
+
+#include <vector>
+
+// Helpers
+static Territory MakeRect(unsigned int id, float minX, float minY, float maxX, float maxY, int owner) {
+    Territory t;
+    t.numId = id;
+    t.id = std::to_string(id);
+    t.minX = minX; t.minY = minY;
+    t.maxX = maxX; t.maxY = maxY;
+    t.ownerGang = owner;
+    return t;
+}
+
+// Stands in for TerritorySystem: first containing territory wins, overlap
+// flags are set by hand.
+struct World {
+    std::vector<Territory> terrs;
+    std::vector<unsigned char> contested;
+    TerritoryHandleTable handles;
+    int queries = 0;
+
+    void Sync() {
+        handles.Sync(terrs);
+        contested.assign(terrs.size(), 0);
+    }
+
+    PlayerContextTracker::Source MakeSource() {
+        PlayerContextTracker::Source src;
+        src.user = this;
+        src.query = [](const CVector& pos, void* user) {
+            World* w = (World*)user;
+            ++w->queries;
+            for (int i = 0; i < (int)w->terrs.size(); ++i) {
+                if (w->terrs[i].ContainsPoint(pos)) return w->handles.HandleAt(i);
+            }
+            return TerritoryHandle();
+        };
+        src.resolve = [](TerritoryHandle h, void* user) -> const Territory* {
+            World* w = (World*)user;
+            const int idx = w->handles.IndexOf(h);
+            return idx >= 0 ? &w->terrs[idx] : nullptr;
+        };
+        src.contested = [](TerritoryHandle h, void* user) {
+            World* w = (World*)user;
+            const int idx = w->handles.IndexOf(h);
+            return idx >= 0 && w->contested[idx] != 0;
+        };
+        return src;
+    }
+};
+
+// Two Portland blocks side by side, one Staunton block.
+static World MakeWorld() {
+    World w;
+    w.terrs.push_back(MakeRect(1001, 700, 0, 800, 100, GANG1));
+    w.terrs.push_back(MakeRect(1002, 800, 0, 900, 100, GANG2));
+    w.terrs.push_back(MakeRect(1003, 0, 0, 100, 100, GANG3));
+    w.Sync();
+    return w;
+}
+
+struct EventLog {
+    std::vector<PlayerContextTracker::Event> events;
+    static void Record(const PlayerContextTracker::Event& e, void* user) {
+        ((EventLog*)user)->events.push_back(e);
+    }
+};
+
+static void Step(PlayerContextTracker& tr, World& w, float x, float y, int act = 3, unsigned int epoch = 1,
+    bool inVehicle = false)
+{
+    tr.Update(true, CVector(x, y, 10.0f), inVehicle, act, epoch, w.MakeSource());
+}
+
+void RunPlayerContextTests(Test::Runner& t) {
+    t.suite("PlayerContext");
+
+    // ------------------------------------------------------------------
+    // Context fields
+    // ------------------------------------------------------------------
+    t.run("context: position, island, vehicle, territory and state", [] {
+        World w = MakeWorld();
+        PlayerContextTracker tr;
+        Step(tr, w, 750, 50, 1, 1, true);
+        const PlayerContext& c = tr.Context();
+        REQUIRE(c.valid);
+        REQUIRE(c.inVehicle);
+        REQUIRE_FALSE(c.OnFoot());
+        REQUIRE(c.island == Island::PORTLAND);
+        REQUIRE(c.territory == w.handles.HandleAt(0));
+        REQUIRE_EQ(c.ownerGang, GANG1);
+        REQUIRE(c.state == TerritoryState::GANG_ALLIED); // Leone turf in act 1
+    });
+
+    t.run("context: locked island territory reports LOCKED", [] {
+        World w = MakeWorld();
+        PlayerContextTracker tr;
+        Step(tr, w, 50, 50, 1);
+        REQUIRE(tr.Context().island == Island::STAUNTON);
+        REQUIRE(tr.Context().territory == w.handles.HandleAt(2));
+        REQUIRE(tr.Context().state == TerritoryState::LOCKED);
+    });
+
+    t.run("context: no player ped clears everything", [] {
+        World w = MakeWorld();
+        PlayerContextTracker tr;
+        Step(tr, w, 750, 50);
+        tr.Update(false, CVector(0, 0, 0), true, 3, 1, w.MakeSource());
+        REQUIRE_FALSE(tr.Context().valid);
+        REQUIRE_FALSE(tr.Context().inVehicle);
+        REQUIRE_FALSE(tr.Context().InTerritory());
+        REQUIRE(tr.Context().island == Island::UNKNOWN);
+    });
+
+    // ------------------------------------------------------------------
+    // Temporal coherence
+    // ------------------------------------------------------------------
+    t.run("coherence: staying inside needs no lookup", [] {
+        World w = MakeWorld();
+        PlayerContextTracker tr;
+        Step(tr, w, 710, 50);
+        for (int i = 0; i < 50; ++i) Step(tr, w, 710.0f + i, 50);
+        REQUIRE_EQ(w.queries, 1);
+        REQUIRE_EQ((int)tr.Lookups(), 1);
+        REQUIRE_EQ((int)tr.Reuses(), 50);
+        REQUIRE(tr.Context().territory == w.handles.HandleAt(0));
+    });
+
+    t.run("coherence: leaving the territory looks up again", [] {
+        World w = MakeWorld();
+        PlayerContextTracker tr;
+        Step(tr, w, 790, 50);
+        Step(tr, w, 810, 50);
+        REQUIRE_EQ(w.queries, 2);
+        REQUIRE(tr.Context().territory == w.handles.HandleAt(1));
+    });
+
+    t.run("coherence: contested territories always look up", [] {
+        World w = MakeWorld();
+        w.contested[0] = 1;
+        PlayerContextTracker tr;
+        for (int i = 0; i < 5; ++i) Step(tr, w, 750, 50);
+        REQUIRE_EQ(w.queries, 5);
+    });
+
+    t.run("coherence: new geometry epoch or act drops the cached answer", [] {
+        World w = MakeWorld();
+        PlayerContextTracker tr;
+        Step(tr, w, 750, 50, 3, 1);
+        Step(tr, w, 750, 50, 3, 2);
+        REQUIRE_EQ(w.queries, 2);
+        Step(tr, w, 750, 50, 2, 2);
+        REQUIRE_EQ(w.queries, 3);
+        Step(tr, w, 750, 50, 2, 2);
+        REQUIRE_EQ(w.queries, 3);
+    });
+
+    t.run("coherence: a territory removed under the player is dropped", [] {
+        World w = MakeWorld();
+        PlayerContextTracker tr;
+        Step(tr, w, 750, 50);
+        w.terrs.erase(w.terrs.begin());
+        w.Sync();
+        // Same epoch on purpose: the stale handle alone must force a lookup.
+        Step(tr, w, 750, 50);
+        REQUIRE_FALSE(tr.Context().InTerritory());
+        REQUIRE_EQ(w.queries, 2);
+    });
+
+    // ------------------------------------------------------------------
+    // Events
+    // ------------------------------------------------------------------
+    t.run("events: enter, cross a border, exit", [] {
+        World w = MakeWorld();
+        PlayerContextTracker tr;
+        EventLog log;
+        tr.Subscribe(PlayerContextTracker::kAll, EventLog::Record, &log);
+
+        Step(tr, w, 600, 50);  // outside
+        Step(tr, w, 750, 50);  // enter 1001
+        Step(tr, w, 760, 50);  // nothing
+        Step(tr, w, 850, 50);  // exit 1001, enter 1002
+        Step(tr, w, 950, 50);  // exit 1002
+
+        REQUIRE_EQ((int)log.events.size(), 4);
+        REQUIRE(log.events[0].kind == PlayerContextTracker::kEnter);
+        REQUIRE(log.events[0].territory == w.handles.HandleAt(0));
+        REQUIRE(log.events[1].kind == PlayerContextTracker::kExit);
+        REQUIRE(log.events[1].territory == w.handles.HandleAt(0));
+        REQUIRE(log.events[2].kind == PlayerContextTracker::kEnter);
+        REQUIRE(log.events[2].territory == w.handles.HandleAt(1));
+        REQUIRE_EQ(log.events[2].newOwner, GANG2);
+        REQUIRE(log.events[3].kind == PlayerContextTracker::kExit);
+    });
+
+    t.run("events: owner change while inside", [] {
+        World w = MakeWorld();
+        PlayerContextTracker tr;
+        EventLog log;
+        tr.Subscribe(PlayerContextTracker::kOwnerChanged, EventLog::Record, &log);
+
+        Step(tr, w, 750, 50);
+        w.terrs[0].ownerGang = OWNER_NEUTRAL;
+        Step(tr, w, 750, 50);
+        Step(tr, w, 750, 50);
+
+        REQUIRE_EQ((int)log.events.size(), 1);
+        REQUIRE_EQ(log.events[0].oldOwner, GANG1);
+        REQUIRE_EQ(log.events[0].newOwner, OWNER_NEUTRAL);
+        REQUIRE(tr.Context().state == TerritoryState::NEUTRAL);
+        REQUIRE_EQ(w.queries, 1); // owner changes need no lookup either
+    });
+
+    t.run("events: kinds filter, reset exits, unsubscribe from a callback", [] {
+        World w = MakeWorld();
+        PlayerContextTracker tr;
+        EventLog exits;
+        tr.Subscribe(PlayerContextTracker::kExit, EventLog::Record, &exits);
+
+        struct Once { PlayerContextTracker* tr; int id; int calls; } once{ &tr, 0, 0 };
+        once.id = tr.Subscribe(PlayerContextTracker::kAll, [](const PlayerContextTracker::Event&, void* user) {
+            Once* o = (Once*)user;
+            ++o->calls;
+            o->tr->Unsubscribe(o->id);
+        }, &once);
+
+        Step(tr, w, 750, 50);
+        Step(tr, w, 850, 50); // exit + enter
+        REQUIRE_EQ(once.calls, 1);
+        REQUIRE_EQ((int)exits.events.size(), 1);
+
+        tr.Reset();
+        REQUIRE_EQ((int)exits.events.size(), 2);
+        REQUIRE(exits.events[1].territory == w.handles.HandleAt(1));
+        REQUIRE_FALSE(tr.Context().valid);
+    });
+}
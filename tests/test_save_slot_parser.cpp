@@ -1,6 +1,8 @@
 #include "TestFramework.h"
 #include "../source/SaveSlotParser.h"
 
+#include <cstring>
+
 void RunSaveSlotParserTests(Test::Runner& t) {
     t.suite("SaveSlotParser");
 
@@ -75,6 +77,25 @@ void RunSaveSlotParserTests(Test::Runner& t) {
         REQUIRE_FALSE(SaveSlotParser::TryParseSaveSlot("", slot));
     });
 
+    t.run("slot: prefix must be in the file name, not a directory", [&] {
+        int slot = 0;
+        REQUIRE_FALSE(SaveSlotParser::TryParseSaveSlot("C:\\GTA3sf1\\other.b", slot));
+        REQUIRE_FALSE(SaveSlotParser::TryParseSaveSlot("C:\\GTA3sf1\\x2.b", slot));
+        REQUIRE(SaveSlotParser::TryParseSaveSlot("C:\\GTA3sf1\\GTA3sf2.B", slot));
+        REQUIRE_EQ(slot, 2);
+    });
+
+    t.run("candidate: suffix and length reject ordinary game files", [&] {
+        const char* others[] = { "models\\gta3.img", "TEXDB\\GENERIC.TXD", "data\\gta3.dat",
+                                 "anim\\ped.ifp", "audio\\sfx.raw", "x1.b" };
+        for (const char* p : others) {
+            REQUIRE_FALSE(SaveSlotParser::IsSavePathCandidate(p, std::strlen(p)));
+        }
+        REQUIRE(SaveSlotParser::IsSavePathCandidate("GTA3sf1.b", 9));
+        REQUIRE_FALSE(SaveSlotParser::IsSavePathCandidate("GTA3sf1.b", 8)); // length is honoured
+        REQUIRE_FALSE(SaveSlotParser::IsSavePathCandidate(nullptr, 9));
+    });
+
     // ------------------------------------------------------------------
     // IsReadMode
     // ------------------------------------------------------------------
@@ -1,5 +1,6 @@
 #include "TestFramework.h"
 #include "../source/SidecarFormat.h"
+#include "../source/AffiliationRule.h"
 
 using namespace SidecarFormat;
 
@@ -28,6 +29,23 @@ static std::vector<unsigned char> BuildV1Blob(const std::vector<Entry>& entries)
     return out;
 }
 
+// Helper: append a raw chunk to a v2 blob and bump its chunk count
+static void AppendChunk(std::vector<unsigned char>& blob, unsigned int tag, const std::vector<unsigned char>& payload) {
+    auto pushU32 = [&](unsigned int v) {
+        blob.push_back(v & 0xFF); blob.push_back((v>>8)&0xFF);
+        blob.push_back((v>>16)&0xFF); blob.push_back((v>>24)&0xFF);
+    };
+    pushU32(tag);
+    pushU32((unsigned int)payload.size());
+    blob.insert(blob.end(), payload.begin(), payload.end());
+    blob[8]++; // chunkCount low byte
+}
+
+static std::vector<unsigned char> U32Bytes(unsigned int v) {
+    return { (unsigned char)(v & 0xFF), (unsigned char)((v>>8)&0xFF),
+             (unsigned char)((v>>16)&0xFF), (unsigned char)((v>>24)&0xFF) };
+}
+
 void RunSidecarFormatTests(Test::Runner& t) {
     t.suite("SidecarFormat");
 
@@ -134,4 +152,504 @@ void RunSidecarFormatTests(Test::Runner& t) {
         const auto r = Deserialize(blob);
         REQUIRE_FALSE(r.ok);
     });
+
+    // ------------------------------------------------------------------
+    // Reader (in place, lazy)
+    // ------------------------------------------------------------------
+    t.run("reader: directory lists every chunk, unknown ones included", [&] {
+        auto blob = Serialize({ {"1001", 7}, {"1002", 8} });
+        AppendChunk(blob, 0x4B4E554A, { 1, 2, 3 }); // 'JUNK'
+        AppendChunk(blob, kTagActl, U32Bytes(2));
+
+        Reader r;
+        std::string err;
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE(r.Complete());
+        REQUIRE_FALSE(r.IsLegacy());
+        REQUIRE_EQ(r.ChunkCount(), 3);
+        REQUIRE_EQ(r.ChunkAt(1).tag, 0x4B4E554Au);
+        REQUIRE_EQ(r.ChunkAt(1).size, 3u);
+        REQUIRE_EQ((int)r.Payload(r.ChunkAt(1))[2], 3);
+
+        unsigned int act = 0;
+        REQUIRE(r.Act(act));
+        REQUIRE_EQ(act, 2u);
+    });
+
+    t.run("reader: ids are views into the blob", [&] {
+        const auto blob = Serialize({ {"1001", 7}, {"abc", -1} });
+        Reader r;
+        OwnershipCursor c;
+        std::string err;
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE(r.Ownership(c, err));
+        REQUIRE_EQ(c.Count(), 2u);
+
+        std::string_view id;
+        int owner = 0;
+        REQUIRE(c.Next(id, owner));
+        REQUIRE(id == "1001");
+        REQUIRE_EQ(owner, 7);
+        REQUIRE((const unsigned char*)id.data() > blob.data());
+        REQUIRE((const unsigned char*)id.data() < blob.data() + blob.size());
+        REQUIRE(c.Next(id, owner));
+        REQUIRE(id == "abc");
+        REQUIRE_EQ(owner, -1);
+        REQUIRE_FALSE(c.Next(id, owner));
+        REQUIRE_FALSE(c.Failed());
+    });
+
+    t.run("reader: a broken OWNR does not stop ACTL from loading", [&] {
+        auto blob = Serialize({ {"1001", 7} });
+        blob[12 + 8] = 0xFF; // OWNR count -> 255: more than the payload holds
+        AppendChunk(blob, kTagActl, U32Bytes(3));
+
+        Reader r;
+        OwnershipCursor c;
+        std::string err;
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        unsigned int act = 0;
+        REQUIRE(r.Act(act));
+        REQUIRE_EQ(act, 3u);
+        REQUIRE_FALSE(r.Ownership(c, err));
+        REQUIRE_FALSE(err.empty());
+    });
+
+    t.run("reader: truncated directory keeps the chunks before it", [&] {
+        auto blob = Serialize({ {"1001", 7} });
+        AppendChunk(blob, kTagActl, U32Bytes(1));
+        blob.resize(blob.size() - 2); // ACTL payload cut short
+
+        Reader r;
+        std::string err;
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE_FALSE(r.Complete());
+        REQUIRE_EQ(r.ChunkCount(), 1);
+        REQUIRE(r.FindChunk(kTagOwnr) != nullptr);
+        REQUIRE(r.FindChunk(kTagActl) == nullptr);
+
+        // The owning wrapper still treats it as corrupt.
+        REQUIRE_FALSE(Deserialize(blob).ok);
+    });
+
+    t.run("reader: v1 body reads as one OWNR chunk", [&] {
+        const auto blob = BuildV1Blob({ {"1001", 7}, {"1002", 8} });
+        Reader r;
+        OwnershipCursor c;
+        std::string err;
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE(r.IsLegacy());
+        REQUIRE_EQ(r.ChunkCount(), 1);
+        unsigned int act = 0;
+        REQUIRE_FALSE(r.Act(act));
+        REQUIRE(r.Ownership(c, err));
+        REQUIRE_EQ(c.Count(), 2u);
+    });
+
+    t.run("reader: damaged entry fails the cursor, not the open", [&] {
+        auto blob = Serialize({ {"1001", 7}, {"1002", 8} });
+        blob.resize(blob.size() - 3);
+        blob[16] = (unsigned char)(blob[16] - 3); // shrink OWNR len to match
+
+        Reader r;
+        OwnershipCursor c;
+        std::string err;
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE(r.Complete());
+        REQUIRE(r.Ownership(c, err));
+        std::string_view id;
+        int owner = 0;
+        REQUIRE(c.Next(id, owner));
+        REQUIRE_FALSE(c.Next(id, owner));
+        REQUIRE(c.Failed());
+    });
+
+    t.run("reader: missing OWNR chunk", [&] {
+        std::vector<unsigned char> blob = U32Bytes(kMagic);
+        const auto ver = U32Bytes(kChunkedVersion);
+        blob.insert(blob.end(), ver.begin(), ver.end());
+        const auto zero = U32Bytes(0);
+        blob.insert(blob.end(), zero.begin(), zero.end());
+        AppendChunk(blob, kTagActl, U32Bytes(1));
+
+        Reader r;
+        OwnershipCursor c;
+        std::string err;
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE_FALSE(r.Ownership(c, err));
+        REQUIRE_FALSE(Deserialize(blob).ok);
+    });
+
+    // ------------------------------------------------------------------
+    // Writer + ODLT
+    // ------------------------------------------------------------------
+    t.run("writer: numeric ids come back as decimal strings", [&] {
+        const IdOwner in[] = { { 1001u, 7 }, { 4000000000u, -2 } };
+        Writer w;
+        w.AddOwnership(in, 2);
+        const auto r = Deserialize(w.Bytes());
+        REQUIRE(r.ok);
+        REQUIRE_EQ(r.entries[1].id, std::string("4000000000"));
+        REQUIRE_EQ(r.entries[1].ownerGang, -2);
+    });
+
+    t.run("delta: round-trip with ACTL", [&] {
+        const IdOwner in[] = { { 1003u, 8 }, { 1010u, -1 }, { 1042u, -2 } };
+        Writer w;
+        w.AddOwnershipDelta(0x0123456789ABCDEFull, in, 3);
+        w.AddAct(2);
+
+        Reader r;
+        PackedCursor d;
+        unsigned long long hash = 0;
+        std::string err;
+        REQUIRE(r.Open(w.Bytes().data(), w.Bytes().size(), err));
+        REQUIRE_EQ(r.ChunkCount(), 2);
+        REQUIRE(r.Delta(hash, d, err));
+        REQUIRE(hash == 0x0123456789ABCDEFull);
+        REQUIRE_EQ(d.Count(), 3u);
+        IdOwner e{};
+        REQUIRE(d.Next(e));
+        REQUIRE_EQ(e.id, 1003u);
+        REQUIRE_EQ(e.ownerGang, 8);
+        REQUIRE(d.Next(e));
+        REQUIRE(d.Next(e));
+        REQUIRE_EQ(e.id, 1042u);
+        REQUIRE_EQ(e.ownerGang, -2);
+        REQUIRE_FALSE(d.Next(e));
+        REQUIRE_FALSE(d.Failed());
+        unsigned int act = 0;
+        REQUIRE(r.Act(act));
+        REQUIRE_EQ(act, 2u);
+
+        // No OWNR: the owning wrapper has nothing to return.
+        OwnershipCursor c;
+        REQUIRE_FALSE(r.Ownership(c, err));
+    });
+
+    t.run("delta: a typical campaign saves in a few dozen bytes", [&] {
+        const IdOwner in[] = { { 1003u, 8 }, { 1004u, 8 } };
+        Writer w;
+        w.AddOwnershipDelta(1, in, 2);
+        w.AddAct(1);
+        REQUIRE(w.Bytes().size() <= 64u);
+
+        // Versus every territory's id and owner for the stock ~128 territories.
+        std::vector<IdOwner> all;
+        for (unsigned int i = 0; i < 128; ++i) all.push_back(IdOwner{ 1000u + i, 7 });
+        Writer full;
+        full.AddOwnership(all.data(), all.size());
+        REQUIRE(full.Bytes().size() > 1000u);
+    });
+
+    t.run("delta: empty delta is valid", [&] {
+        Writer w;
+        w.AddOwnershipDelta(42, nullptr, 0);
+        Reader r;
+        PackedCursor d;
+        unsigned long long hash = 0;
+        std::string err;
+        REQUIRE(r.Open(w.Bytes().data(), w.Bytes().size(), err));
+        REQUIRE(r.Delta(hash, d, err));
+        REQUIRE(hash == 42ull);
+        REQUIRE_EQ(d.Count(), 0u);
+    });
+
+    t.run("delta: count must fit the payload", [&] {
+        const IdOwner in[] = { { 1003u, 8 } };
+        Writer w;
+        w.AddOwnershipDelta(1, in, 1);
+        auto blob = w.Bytes();
+        blob[12 + 8 + 8] = 3; // count 1 -> 3, but only 2 id bytes
+
+        Reader r;
+        PackedCursor d;
+        unsigned long long hash = 0;
+        std::string err;
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE_FALSE(r.Delta(hash, d, err));
+        REQUIRE_FALSE(err.empty());
+    });
+
+    t.run("delta: both chunks can sit in one file", [&] {
+        const IdOwner delta[] = { { 1003u, 8 } };
+        const IdOwner full[] = { { 1001u, 7 }, { 1003u, 8 } };
+        Writer w;
+        w.AddOwnershipDelta(7, delta, 1);
+        w.AddOwnership(full, 2);
+
+        Reader r;
+        PackedCursor d;
+        unsigned long long hash = 0;
+        OwnershipCursor c;
+        std::string err;
+        REQUIRE(r.Open(w.Bytes().data(), w.Bytes().size(), err));
+        REQUIRE(r.Delta(hash, d, err));
+        REQUIRE(r.Ownership(c, err));
+        REQUIRE_EQ(c.Count(), 2u);
+    });
+
+    t.run("delta: ReadOwnership takes ODLT on matching defaults, the snapshot otherwise", [&] {
+        const IdOwner delta[] = { { 1003u, 8 } };
+        const IdOwner full[] = { { 1001u, 7 }, { 1003u, 8 } };
+        std::vector<IdOwner> out;
+        OwnershipSource source;
+        std::string err;
+
+        Writer w;
+        w.AddOwnershipPacked(full, 2);
+        w.AddOwnershipDelta(7, delta, 1);
+        Reader r;
+        REQUIRE(r.Open(w.Bytes().data(), w.Bytes().size(), err));
+        REQUIRE(ReadOwnership(r, 7, out, source, err));
+        REQUIRE(source == OwnershipSource::Delta);
+        REQUIRE_EQ((int)out.size(), 1);
+        REQUIRE(ReadOwnership(r, 8, out, source, err));
+        REQUIRE(source == OwnershipSource::Snapshot);
+        REQUIRE_EQ((int)out.size(), 2);
+
+        // OWNR, what older builds wrote, serves as the snapshot too.
+        w.Clear();
+        w.AddOwnership(full, 2);
+        w.AddOwnershipDelta(7, delta, 1);
+        REQUIRE(r.Open(w.Bytes().data(), w.Bytes().size(), err));
+        REQUIRE(ReadOwnership(r, 8, out, source, err));
+        REQUIRE(source == OwnershipSource::Snapshot);
+        REQUIRE_EQ(out[0].id, 1001u);
+        REQUIRE_EQ(out[0].ownerGang, 7);
+
+        // No snapshot at all: the deltas by id are all there is.
+        w.Clear();
+        w.AddOwnershipDelta(7, delta, 1);
+        REQUIRE(r.Open(w.Bytes().data(), w.Bytes().size(), err));
+        REQUIRE(ReadOwnership(r, 8, out, source, err));
+        REQUIRE(source == OwnershipSource::DeltaById);
+        REQUIRE_EQ(out[0].id, 1003u);
+    });
+
+    t.run("delta: a load after the defaults were edited gets the exact saved owners", [&] {
+        struct Def { unsigned int id; int defaultOwner; };
+        const Def defaultsA[] = { { 1001u, 7 }, { 1002u, 7 }, { 1003u, 8 }, { 1004u, 0 } };
+        // The player re-assigned two default owners in territories.txt.
+        const Def defaultsB[] = { { 1001u, 9 }, { 1002u, 7 }, { 1003u, 7 }, { 1004u, 0 } };
+        const IdOwner saved[] = { { 1001u, 7 }, { 1002u, 10 }, { 1003u, 8 }, { 1004u, -2 } };
+
+        unsigned long long hashA = 0, hashB = 0;
+        for (const Def& d : defaultsA) hashA = DefaultsHashAdd(hashA, d.id, d.defaultOwner);
+        for (const Def& d : defaultsB) hashB = DefaultsHashAdd(hashB, d.id, d.defaultOwner);
+        REQUIRE(hashA != hashB);
+
+        // What SaveSidecar writes against A.
+        std::vector<IdOwner> deltas;
+        for (int k = 0; k < 4; ++k) {
+            if (saved[k].ownerGang != defaultsA[k].defaultOwner) deltas.push_back(saved[k]);
+        }
+        Writer w;
+        w.AddOwnershipPacked(saved, 4);
+        w.AddOwnershipDelta(hashA, deltas.data(), deltas.size());
+
+        // Load against B: reset to B's defaults, apply what the sidecar gives.
+        Reader r;
+        std::vector<IdOwner> entries;
+        OwnershipSource source;
+        std::string err;
+        REQUIRE(r.Open(w.Bytes().data(), w.Bytes().size(), err));
+        REQUIRE(ReadOwnership(r, hashB, entries, source, err));
+        REQUIRE(source == OwnershipSource::Snapshot);
+        int owners[4];
+        for (int k = 0; k < 4; ++k) owners[k] = defaultsB[k].defaultOwner;
+        for (const IdOwner& e : entries) owners[e.id - 1001u] = e.ownerGang;
+        for (int k = 0; k < 4; ++k) REQUIRE_EQ(owners[k], saved[k].ownerGang);
+
+        // Against A the small ODLT is enough.
+        REQUIRE(ReadOwnership(r, hashA, entries, source, err));
+        REQUIRE(source == OwnershipSource::Delta);
+        REQUIRE_EQ((int)entries.size(), (int)deltas.size());
+    });
+
+    // ------------------------------------------------------------------
+    // Packed ownership (OWN3)
+    // ------------------------------------------------------------------
+    t.run("packed: round-trip sorts by id and keeps every owner", [&] {
+        // Unsorted, every nibble class: neutral, cleared, gangs, escapes.
+        const IdOwner in[] = {
+            { 5000u, GANG6 }, { 1000u, OWNER_NEUTRAL }, { 4000000000u, 15 },
+            { 1001u, OWNER_CLEARED }, { 1002u, 0 }, { 1003u, 42 }, { 1004u, -7 }, { 1005u, GANG1 },
+        };
+        const int n = (int)(sizeof(in) / sizeof(in[0]));
+        Writer w;
+        w.AddOwnershipPacked(in, n);
+
+        Reader r;
+        PackedCursor c;
+        std::string err;
+        REQUIRE(r.Open(w.Bytes().data(), w.Bytes().size(), err));
+        REQUIRE_EQ(r.Version(), kPackedVersion);
+        REQUIRE(r.PackedOwnership(c, err));
+        REQUIRE_EQ(c.Count(), (unsigned int)n);
+
+        std::vector<IdOwner> out;
+        IdOwner e{};
+        while (c.Next(e)) out.push_back(e);
+        REQUIRE_FALSE(c.Failed());
+        REQUIRE_EQ((int)out.size(), n);
+        const unsigned int ids[]  = { 1000u, 1001u, 1002u, 1003u, 1004u, 1005u, 5000u, 4000000000u };
+        const int owners[] = { OWNER_NEUTRAL, OWNER_CLEARED, 0, 42, -7, GANG1, GANG6, 15 };
+        for (int i = 0; i < n; ++i) {
+            REQUIRE_EQ(out[i].id, ids[i]);
+            REQUIRE_EQ(out[i].ownerGang, owners[i]);
+        }
+    });
+
+    t.run("packed: Deserialize falls back to OWN3 with decimal ids", [&] {
+        const IdOwner in[] = { { 1002u, GANG2 }, { 1001u, GANG1 } };
+        Writer w;
+        w.AddOwnershipPacked(in, 2);
+        const auto r = Deserialize(w.Bytes());
+        REQUIRE(r.ok);
+        REQUIRE_EQ((int)r.entries.size(), 2);
+        REQUIRE_EQ(r.entries[0].id, std::string("1001"));
+        REQUIRE_EQ(r.entries[0].ownerGang, GANG1);
+        REQUIRE_EQ(r.entries[1].id, std::string("1002"));
+    });
+
+    t.run("packed: a stock-sized snapshot is a fraction of OWNR", [&] {
+        std::vector<IdOwner> all;
+        for (unsigned int i = 0; i < 4096; ++i) all.push_back(IdOwner{ 1000u + i, GANG1 + (int)(i % 6) });
+        Writer ownr, own3;
+        ownr.AddOwnership(all.data(), all.size());
+        own3.AddOwnershipPacked(all.data(), all.size());
+        // ~1.5 bytes per entry against 10.
+        REQUIRE(own3.Bytes().size() * 6 < ownr.Bytes().size());
+        REQUIRE(own3.Bytes().size() < 4096u * 2);
+    });
+
+    t.run("packed: header that overruns the payload is rejected", [&] {
+        const IdOwner in[] = { { 1001u, GANG1 }, { 1002u, GANG2 } };
+        Writer w;
+        w.AddOwnershipPacked(in, 2);
+        auto blob = w.Bytes();
+        blob[12 + 8 + 1] = 0x7F; // idBytes 3 -> 127
+
+        Reader r;
+        PackedCursor c;
+        std::string err;
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE_FALSE(r.PackedOwnership(c, err));
+        REQUIRE_FALSE(err.empty());
+    });
+
+    t.run("packed: reserved owner code and truncated escape fail the cursor", [&] {
+        const IdOwner in[] = { { 1001u, GANG1 } };
+        Writer w;
+        w.AddOwnershipPacked(in, 1);
+        auto blob = w.Bytes();
+        const size_t nibble = blob.size() - 1; // count, idBytes, 2 id bytes, 1 nibble byte
+
+        Reader r;
+        PackedCursor c;
+        IdOwner e{};
+        std::string err;
+
+        blob[nibble] = 12; // reserved
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE(r.PackedOwnership(c, err));
+        REQUIRE_FALSE(c.Next(e));
+        REQUIRE(c.Failed());
+
+        blob[nibble] = 15; // escape with no value after it
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE(r.PackedOwnership(c, err));
+        REQUIRE_FALSE(c.Next(e));
+        REQUIRE(c.Failed());
+    });
+
+    // ------------------------------------------------------------------
+    // Integrity (CSUM)
+    // ------------------------------------------------------------------
+    auto checkedBlob = [] {
+        const IdOwner in[] = { { 1001u, GANG1 }, { 1003u, GANG2 }, { 1042u, OWNER_CLEARED } };
+        Writer w;
+        w.AddOwnershipDelta(5, in, 3);
+        w.AddAct(2);
+        w.AddChecksum();
+        return w.Bytes();
+    };
+
+    t.run("checksum: v4 round-trip verifies, other chunks read as before", [&] {
+        const auto blob = checkedBlob();
+        Reader r;
+        std::string err;
+        REQUIRE(r.Open(blob.data(), blob.size(), err));
+        REQUIRE_EQ(r.Version(), kChecksumVersion);
+        REQUIRE_EQ(r.ChunkCount(), 3);
+        REQUIRE(r.Verify(err));
+        unsigned int act = 0;
+        REQUIRE(r.Act(act));
+        REQUIRE_EQ(act, 2u);
+    });
+
+    t.run("checksum: every single-bit flip is caught", [&] {
+        auto blob = checkedBlob();
+        for (size_t i = 0; i < blob.size() * 8; ++i) {
+            blob[i / 8] ^= (unsigned char)(1u << (i % 8));
+            Reader r;
+            std::string err;
+            REQUIRE_FALSE(r.Open(blob.data(), blob.size(), err) && r.Verify(err));
+            blob[i / 8] ^= (unsigned char)(1u << (i % 8));
+        }
+    });
+
+    t.run("checksum: every truncation is caught", [&] {
+        const auto blob = checkedBlob();
+        for (size_t n = 0; n < blob.size(); ++n) {
+            Reader r;
+            std::string err;
+            REQUIRE_FALSE(r.Open(blob.data(), n, err) && r.Verify(err));
+        }
+    });
+
+    t.run("checksum: Deserialize rejects a corrupt owner", [&] {
+        const IdOwner in[] = { { 1001u, GANG1 } };
+        Writer w;
+        w.AddOwnershipPacked(in, 1);
+        w.AddChecksum();
+        auto blob = w.Bytes();
+        REQUIRE(Deserialize(blob).ok);
+        blob[12 + 8 + 4] ^= 0x01; // owner nibble: GANG1 -> cleared
+        const auto r = Deserialize(blob);
+        REQUIRE_FALSE(r.ok);
+        REQUIRE_FALSE(r.error.empty());
+    });
+
+    t.run("checksum: pre-v4 files pass without one, CSUM must be last", [&] {
+        const IdOwner in[] = { { 1001u, GANG1 } };
+        Writer w;
+        w.AddOwnershipPacked(in, 1);
+        Reader r;
+        std::string err;
+        REQUIRE(r.Open(w.Bytes().data(), w.Bytes().size(), err));
+        REQUIRE(r.Verify(err));
+
+        w.AddChecksum();
+        w.AddAct(1);
+        REQUIRE(r.Open(w.Bytes().data(), w.Bytes().size(), err));
+        REQUIRE_FALSE(r.Verify(err));
+    });
+
+    t.run("defaults hash: order-independent, sensitive to ids and defaults", [&] {
+        unsigned long long a = 0, b = 0;
+        a = DefaultsHashAdd(a, 1001, 7);
+        a = DefaultsHashAdd(a, 1002, 8);
+        b = DefaultsHashAdd(b, 1002, 8);
+        b = DefaultsHashAdd(b, 1001, 7);
+        REQUIRE(a == b);
+
+        unsigned long long c = DefaultsHashAdd(DefaultsHashAdd(0, 1001, 7), 1002, -1);
+        unsigned long long d = DefaultsHashAdd(DefaultsHashAdd(0, 1001, 7), 1003, 8);
+        unsigned long long e = DefaultsHashAdd(0, 1001, 7);
+        REQUIRE(a != c);
+        REQUIRE(a != d);
+        REQUIRE(a != e);
+    });
 }
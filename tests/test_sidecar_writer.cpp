@@ -0,0 +1,422 @@
+#include "TestFramework.h"
+#include "../source/SidecarWriter.h"
+#include "../source/Crc32c.h"
+#include "../source/AffiliationRule.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using SidecarFormat::IdOwner;
+
+// In-memory files. The worker calls in from its own thread, hence the lock.
+// Set holdWrites to park the worker inside writeFile until Release().
+struct FakeFs {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::map<std::string, std::vector<unsigned char>> files;
+    std::vector<std::string> writes; // paths, in order
+    bool failWrite = false;
+    bool failRename = false;
+    bool failAppend = false;
+    bool flipOnWrite = false; // the disk hands back one bad bit
+    bool holdWrites = false;
+    bool parked = false;
+
+    SidecarWriter::FileOps Ops() {
+        SidecarWriter::FileOps ops;
+        ops.user = this;
+        ops.writeFile = [](const char* path, const unsigned char* data, size_t size, void* user) {
+            FakeFs* fs = (FakeFs*)user;
+            std::unique_lock<std::mutex> lock(fs->mutex);
+            fs->parked = true;
+            fs->cv.notify_all();
+            fs->cv.wait(lock, [fs] { return !fs->holdWrites; });
+            fs->parked = false;
+            fs->writes.push_back(path);
+            if (fs->failWrite) {
+                fs->files[path].assign(data, data + size / 2); // torn
+                return false;
+            }
+            fs->files[path].assign(data, data + size);
+            if (fs->flipOnWrite) fs->files[path][size / 2] ^= 0x10;
+            return true;
+        };
+        ops.readFile = [](const char* path, std::vector<unsigned char>& out, void* user) {
+            FakeFs* fs = (FakeFs*)user;
+            std::lock_guard<std::mutex> lock(fs->mutex);
+            auto it = fs->files.find(path);
+            if (it == fs->files.end()) return false;
+            out = it->second;
+            return true;
+        };
+        ops.appendFile = [](const char* path, const unsigned char* data, size_t size, void* user) {
+            FakeFs* fs = (FakeFs*)user;
+            std::lock_guard<std::mutex> lock(fs->mutex);
+            auto it = fs->files.find(path);
+            if (fs->failAppend || it == fs->files.end()) return false;
+            it->second.insert(it->second.end(), data, data + size);
+            return true;
+        };
+        ops.remove = [](const char* path, void* user) {
+            FakeFs* fs = (FakeFs*)user;
+            std::lock_guard<std::mutex> lock(fs->mutex);
+            return fs->files.erase(path) == 1;
+        };
+        ops.rename = [](const char* from, const char* to, void* user) {
+            FakeFs* fs = (FakeFs*)user;
+            std::lock_guard<std::mutex> lock(fs->mutex);
+            auto it = fs->files.find(from);
+            if (fs->failRename || it == fs->files.end()) return false;
+            fs->files[to] = it->second;
+            fs->files.erase(from);
+            return true;
+        };
+        return ops;
+    }
+
+    void WaitParked() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return parked; });
+    }
+
+    void Release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        holdWrites = false;
+        cv.notify_all();
+    }
+
+    bool Has(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return files.count(path) == 1;
+    }
+};
+
+static SidecarWriter::Job MakeJob(int slot, unsigned int act, std::vector<IdOwner> deltas) {
+    SidecarWriter::Job job;
+    job.slot = slot;
+    job.path = "persistence/slot_" + std::to_string(slot) + ".dat";
+    job.defaultsHash = 99;
+    job.act = act;
+    job.deltas = std::move(deltas);
+    return job;
+}
+
+// Decoded ODLT + ACTL of a written file.
+static bool ReadBack(const std::vector<unsigned char>& bytes, std::vector<IdOwner>& outDeltas, unsigned int& outAct) {
+    SidecarFormat::Reader r;
+    SidecarFormat::PackedCursor c;
+    unsigned long long hash = 0;
+    std::string err;
+    if (!r.Open(bytes.data(), bytes.size(), err) || !r.Verify(err)) return false;
+    if (!r.Delta(hash, c, err) || !r.Act(outAct)) return false;
+    outDeltas.clear();
+    IdOwner e{};
+    while (c.Next(e)) outDeltas.push_back(e);
+    return !c.Failed() && hash == 99;
+}
+
+static const char* const kJournal = "persistence/slot_1.jnl";
+
+static SidecarWriter::Job MakeAppend(int slot, std::vector<OwnershipJournal::Record> records) {
+    SidecarWriter::Job job = MakeJob(slot, 1, {});
+    job.checkpoint = false;
+    job.journalPath = kJournal;
+    job.journal = std::move(records);
+    return job;
+}
+
+// The journal's records, if it is tied to the checkpoint at slot 1.
+static bool ReadJournal(FakeFs& fs, std::vector<OwnershipJournal::Record>& out) {
+    const auto& dat = fs.files["persistence/slot_1.dat"];
+    const auto& jnl = fs.files[kJournal];
+    unsigned int crc = 0;
+    std::string err;
+    return OwnershipJournal::Parse(jnl.data(), jnl.size(), crc, out, err)
+        && crc == Crc32c::Compute(dat.data(), dat.size());
+}
+
+void RunSidecarWriterTests(Test::Runner& t) {
+    t.suite("SidecarWriter");
+
+    t.run("write: snapshot lands at the final path, no tmp left", [] {
+        FakeFs fs;
+        SidecarWriter w(fs.Ops());
+        w.Submit(MakeJob(3, 2, { { 1003u, GANG2 }, { 1001u, OWNER_CLEARED } }));
+        w.WaitIdle();
+
+        SidecarWriter::Result r;
+        REQUIRE(w.Poll(r));
+        REQUIRE(r.ok);
+        REQUIRE_EQ(r.slot, 3);
+        REQUIRE_EQ(r.entries, 2);
+        REQUIRE_EQ(r.bytes, (int)fs.files["persistence/slot_3.dat"].size());
+        REQUIRE_FALSE(fs.Has("persistence/slot_3.dat.tmp"));
+        REQUIRE_FALSE(w.Poll(r));
+
+        std::vector<IdOwner> deltas;
+        unsigned int act = 0;
+        REQUIRE(ReadBack(fs.files["persistence/slot_3.dat"], deltas, act));
+        REQUIRE_EQ(act, 2u);
+        REQUIRE_EQ((int)deltas.size(), 2);
+        REQUIRE_EQ(deltas[0].id, 1001u);
+        REQUIRE_EQ(deltas[1].ownerGang, GANG2);
+    });
+
+    t.run("write: a load after the defaults were edited gets the exact saved owners", [] {
+        struct Def { unsigned int id; int defaultOwner; };
+        const std::vector<Def> defaultsA = { { 1001u, GANG1 }, { 1002u, GANG1 }, { 1003u, GANG2 }, { 1004u, OWNER_NEUTRAL } };
+        // The player re-assigned two default owners in territories.txt.
+        const std::vector<Def> defaultsB = { { 1001u, GANG3 }, { 1002u, GANG1 }, { 1003u, GANG1 }, { 1004u, OWNER_NEUTRAL } };
+        const std::vector<IdOwner> saved = { { 1001u, GANG1 }, { 1002u, GANG4 }, { 1003u, GANG2 }, { 1004u, OWNER_CLEARED } };
+
+        unsigned long long hashA = 0, hashB = 0;
+        for (const Def& d : defaultsA) hashA = SidecarFormat::DefaultsHashAdd(hashA, d.id, d.defaultOwner);
+        for (const Def& d : defaultsB) hashB = SidecarFormat::DefaultsHashAdd(hashB, d.id, d.defaultOwner);
+        REQUIRE(hashA != hashB);
+
+        std::vector<IdOwner> deltas;
+        for (size_t k = 0; k < saved.size(); ++k) {
+            if (saved[k].ownerGang != defaultsA[k].defaultOwner) deltas.push_back(saved[k]);
+        }
+        SidecarWriter::Job job = MakeJob(1, 1, deltas);
+        job.defaultsHash = hashA;
+        job.owners = saved;
+
+        FakeFs fs;
+        SidecarWriter::Result r;
+        REQUIRE(SidecarWriter::Write(job, fs.Ops(), r));
+        const auto& bytes = fs.files["persistence/slot_1.dat"];
+        SidecarFormat::Reader reader;
+        std::string err;
+        REQUIRE(reader.Open(bytes.data(), bytes.size(), err));
+        REQUIRE(reader.Verify(err));
+
+        // Load against B: reset to B's defaults, apply what the sidecar gives.
+        std::vector<IdOwner> entries;
+        SidecarFormat::OwnershipSource source;
+        REQUIRE(SidecarFormat::ReadOwnership(reader, hashB, entries, source, err));
+        REQUIRE(source == SidecarFormat::OwnershipSource::Snapshot);
+        std::vector<int> owners;
+        for (const Def& d : defaultsB) owners.push_back(d.defaultOwner);
+        for (const IdOwner& e : entries) owners[e.id - 1001u] = e.ownerGang;
+        for (size_t k = 0; k < saved.size(); ++k) REQUIRE_EQ(owners[k], saved[k].ownerGang);
+
+        // Against A the small ODLT is enough.
+        REQUIRE(SidecarFormat::ReadOwnership(reader, hashA, entries, source, err));
+        REQUIRE(source == SidecarFormat::OwnershipSource::Delta);
+        REQUIRE_EQ((int)entries.size(), (int)deltas.size());
+    });
+
+    t.run("write: failure keeps the old file and removes the tmp", [] {
+        FakeFs fs;
+        fs.files["persistence/slot_1.dat"] = { 1, 2, 3 };
+        fs.failWrite = true;
+        SidecarWriter w(fs.Ops());
+        w.Submit(MakeJob(1, 1, { { 1001u, GANG1 } }));
+        w.WaitIdle();
+
+        SidecarWriter::Result r;
+        REQUIRE(w.Poll(r));
+        REQUIRE_FALSE(r.ok);
+        REQUIRE(r.error[0] != '\0');
+        REQUIRE_FALSE(fs.Has("persistence/slot_1.dat.tmp"));
+        REQUIRE_EQ((int)fs.files["persistence/slot_1.dat"].size(), 3);
+    });
+
+    t.run("write: a tmp that reads back corrupt is never renamed", [] {
+        FakeFs fs;
+        fs.files["persistence/slot_1.dat"] = { 1, 2, 3 };
+        fs.flipOnWrite = true;
+        SidecarWriter w(fs.Ops());
+        w.Submit(MakeJob(1, 1, { { 1001u, GANG1 }, { 1002u, GANG2 } }));
+        w.WaitIdle();
+
+        SidecarWriter::Result r;
+        REQUIRE(w.Poll(r));
+        REQUIRE_FALSE(r.ok);
+        REQUIRE_FALSE(fs.Has("persistence/slot_1.dat.tmp"));
+        REQUIRE_EQ((int)fs.files["persistence/slot_1.dat"].size(), 3);
+    });
+
+    t.run("write: rename failure is reported and the tmp removed", [] {
+        FakeFs fs;
+        fs.failRename = true;
+        SidecarWriter w(fs.Ops());
+        w.Submit(MakeJob(2, 1, {}));
+        w.WaitIdle();
+
+        SidecarWriter::Result r;
+        REQUIRE(w.Poll(r));
+        REQUIRE_FALSE(r.ok);
+        REQUIRE_FALSE(fs.Has("persistence/slot_2.dat.tmp"));
+        REQUIRE_FALSE(fs.Has("persistence/slot_2.dat"));
+    });
+
+    t.run("queue: pending saves of one slot coalesce to the newest", [] {
+        FakeFs fs;
+        fs.holdWrites = true;
+        SidecarWriter w(fs.Ops());
+        w.Submit(MakeJob(4, 1, {}));
+        fs.WaitParked(); // first job is in flight
+
+        w.Submit(MakeJob(4, 2, {}));
+        w.Submit(MakeJob(5, 2, {}));
+        w.Submit(MakeJob(4, 3, {}));
+        fs.Release();
+        w.WaitIdle();
+
+        REQUIRE_EQ((int)fs.writes.size(), 3); // 4 (act 1), 4 (act 3), 5
+        std::vector<IdOwner> deltas;
+        unsigned int act = 0;
+        REQUIRE(ReadBack(fs.files["persistence/slot_4.dat"], deltas, act));
+        REQUIRE_EQ(act, 3u);
+
+        SidecarWriter::Result r;
+        int results = 0;
+        while (w.Poll(r)) { REQUIRE(r.ok); ++results; }
+        REQUIRE_EQ(results, 3);
+    });
+
+    t.run("stop: drains the queue, submit restarts the worker", [] {
+        FakeFs fs;
+        SidecarWriter w(fs.Ops());
+        w.Submit(MakeJob(6, 1, {}));
+        w.Submit(MakeJob(7, 1, {}));
+        w.Stop();
+        REQUIRE(fs.Has("persistence/slot_6.dat"));
+        REQUIRE(fs.Has("persistence/slot_7.dat"));
+
+        w.Submit(MakeJob(8, 1, {}));
+        w.Stop();
+        REQUIRE(fs.Has("persistence/slot_8.dat"));
+    });
+
+    t.run("journal: a checkpoint starts a journal tied to it, appends extend it", [] {
+        FakeFs fs;
+        SidecarWriter w(fs.Ops());
+        SidecarWriter::Job cp = MakeJob(1, 1, { { 1001u, GANG2 } });
+        cp.journalPath = kJournal;
+        w.Submit(cp);
+        w.Submit(MakeAppend(1, { { 1002u, GANG1, GANG3, 10u } }));
+        w.WaitIdle();
+        w.Submit(MakeAppend(1, { { 1002u, GANG3, OWNER_NEUTRAL, 20u }, { 1001u, GANG2, GANG1, 30u } }));
+        w.WaitIdle();
+
+        std::vector<OwnershipJournal::Record> records;
+        REQUIRE(ReadJournal(fs, records));
+        REQUIRE_EQ((int)records.size(), 3);
+        REQUIRE_EQ(records[0].newOwner, GANG3);
+        REQUIRE_EQ(records[2].id, 1001u);
+        REQUIRE_FALSE(fs.Has(std::string(kJournal) + ".tmp"));
+
+        SidecarWriter::Result r;
+        while (w.Poll(r)) REQUIRE(r.ok);
+        REQUIRE_FALSE(r.checkpoint);
+        REQUIRE_EQ(r.entries, 2);
+        REQUIRE_EQ(r.bytes, 2 * (int)OwnershipJournal::kRecordSize);
+
+        // A new checkpoint empties the journal.
+        w.Submit(cp);
+        w.WaitIdle();
+        REQUIRE(ReadJournal(fs, records));
+        REQUIRE(records.empty());
+    });
+
+    t.run("journal: queued appends fold into the pending job", [] {
+        FakeFs fs;
+        fs.holdWrites = true;
+        SidecarWriter w(fs.Ops());
+        w.Submit(MakeJob(2, 1, {}));
+        fs.WaitParked();
+
+        SidecarWriter::Job cp = MakeJob(1, 1, {});
+        cp.journalPath = kJournal;
+        w.Submit(cp);
+        w.Submit(MakeAppend(1, { { 1001u, GANG1, GANG2, 1u } }));
+        w.Submit(MakeAppend(1, { { 1001u, GANG2, GANG3, 2u } }));
+        fs.Release();
+        w.WaitIdle();
+
+        std::vector<OwnershipJournal::Record> records;
+        REQUIRE(ReadJournal(fs, records));
+        REQUIRE_EQ((int)records.size(), 2);
+        REQUIRE_EQ(records[1].newOwner, GANG3);
+
+        SidecarWriter::Result r;
+        int results = 0;
+        while (w.Poll(r)) { REQUIRE(r.ok); ++results; }
+        REQUIRE_EQ(results, 2); // slot 2, then slot 1's checkpoint with both appends
+    });
+
+    t.run("journal: after a failed append, appends wait for a checkpoint", [] {
+        FakeFs fs;
+        SidecarWriter w(fs.Ops());
+        SidecarWriter::Job cp = MakeJob(1, 1, {});
+        cp.journalPath = kJournal;
+        w.Submit(cp);
+        w.WaitIdle();
+
+        fs.failAppend = true;
+        w.Submit(MakeAppend(1, { { 1001u, GANG1, GANG2, 1u } }));
+        w.WaitIdle();
+        fs.failAppend = false;
+        w.Submit(MakeAppend(1, { { 1001u, GANG2, GANG3, 2u } }));
+        w.WaitIdle();
+
+        std::vector<OwnershipJournal::Record> records;
+        REQUIRE(ReadJournal(fs, records));
+        REQUIRE(records.empty());
+
+        SidecarWriter::Result r;
+        REQUIRE(w.Poll(r) && r.ok);
+        REQUIRE(w.Poll(r) && !r.ok);
+        REQUIRE(w.Poll(r) && !r.ok);
+        REQUIRE(std::string(r.error).find("checkpoint") != std::string::npos);
+
+        w.Submit(cp);
+        w.Submit(MakeAppend(1, { { 1001u, GANG1, GANG4, 3u } }));
+        w.WaitIdle();
+        REQUIRE(ReadJournal(fs, records));
+        REQUIRE_EQ((int)records.size(), 1);
+    });
+
+    t.run("journal: appending with no journal on disk fails", [] {
+        FakeFs fs;
+        SidecarWriter w(fs.Ops());
+        w.Submit(MakeAppend(1, { { 1001u, GANG1, GANG2, 1u } }));
+        w.WaitIdle();
+        SidecarWriter::Result r;
+        REQUIRE(w.Poll(r));
+        REQUIRE_FALSE(r.ok);
+        REQUIRE_FALSE(fs.Has(kJournal));
+    });
+
+    t.run("stdio: writes and replaces a real file", [] {
+        const std::string path = "gtw_sidecar_writer_test.dat";
+        SidecarWriter w;
+        SidecarWriter::Job job = MakeJob(1, 2, { { 1002u, GANG2 } });
+        job.path = path;
+        w.Submit(job);
+        w.WaitIdle();
+        job.act = 3;
+        w.Submit(job); // over the existing file
+        w.Stop();
+
+        FILE* f = std::fopen(path.c_str(), "rb");
+        REQUIRE(f != nullptr);
+        std::vector<unsigned char> bytes(256);
+        bytes.resize(std::fread(bytes.data(), 1, bytes.size(), f));
+        std::fclose(f);
+        std::remove(path.c_str());
+
+        std::vector<IdOwner> deltas;
+        unsigned int act = 0;
+        REQUIRE(ReadBack(bytes, deltas, act));
+        REQUIRE_EQ(act, 3u);
+        REQUIRE_EQ(deltas[0].id, 1002u);
+    });
+}
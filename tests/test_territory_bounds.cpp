@@ -0,0 +1,204 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryBounds.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+// Helpers
+static Territory MakeRect(float minX, float minY, float maxX, float maxY) {
+    Territory t;
+    t.minX = minX; t.minY = minY;
+    t.maxX = maxX; t.maxY = maxY;
+    return t;
+}
+
+static float RandIn(float a, float b) {
+    return a + (b - a) * ((float)std::rand() / (float)RAND_MAX);
+}
+
+// Reference: the AoS scan over Territory::ContainsPoint.
+static int LinearFirst(const std::vector<Territory>& terrs, float x, float y) {
+    for (int i = 0; i < (int)terrs.size(); ++i)
+        if (terrs[i].ContainsPoint(CVector(x, y, 0.f))) return i;
+    return -1;
+}
+
+static int LinearMask4(const std::vector<Territory>& terrs, float x, float y, int base) {
+    int mask = 0;
+    for (int k = 0; k < 4 && base + k < (int)terrs.size(); ++k)
+        if (terrs[base + k].ContainsPoint(CVector(x, y, 0.f))) mask |= (1 << k);
+    return mask;
+}
+
+// Checks SIMD kernel, scalar fallback and Territory::ContainsPoint agree at (x, y).
+static void RequireAllAgree(const TerritoryBounds& b, const std::vector<Territory>& terrs, float x, float y) {
+    const int expected = LinearFirst(terrs, x, y);
+    REQUIRE_EQ(b.FindFirstContaining(x, y), expected);
+    REQUIRE_EQ(b.FindFirstContainingScalar(x, y), expected);
+    for (int base = 0; base < b.PaddedCount(); base += 4) {
+        const int m = LinearMask4(terrs, x, y, base);
+        REQUIRE_EQ(b.ContainsPoint4(x, y, base), m);
+        REQUIRE_EQ(b.ContainsPoint4Scalar(x, y, base), m);
+    }
+}
+
+void RunTerritoryBoundsTests(Test::Runner& t) {
+    t.suite("TerritoryBounds (SoA)");
+
+    // ------------------------------------------------------------------
+    // Layout
+    // ------------------------------------------------------------------
+    t.run("layout: padded to a multiple of 4", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs(5, MakeRect(0.f, 0.f, 1.f, 1.f));
+        b.Assign(terrs);
+        REQUIRE_EQ(b.Count(), 5);
+        REQUIRE_EQ(b.PaddedCount(), 8);
+    });
+
+    t.run("layout: arrays are 16-byte aligned", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs(7, MakeRect(0.f, 0.f, 1.f, 1.f));
+        b.Assign(terrs);
+        REQUIRE_EQ((int)((uintptr_t)b.MinX() & 15), 0);
+        REQUIRE_EQ((int)((uintptr_t)b.MinY() & 15), 0);
+        REQUIRE_EQ((int)((uintptr_t)b.MaxX() & 15), 0);
+        REQUIRE_EQ((int)((uintptr_t)b.MaxY() & 15), 0);
+    });
+
+    t.run("layout: re-assign after growth and shrink stays in sync", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs = { MakeRect(0.f, 0.f, 10.f, 10.f) };
+        b.Assign(terrs);
+        for (int i = 0; i < 40; ++i) terrs.push_back(MakeRect(100.f + i, 0.f, 101.f + i, 1.f));
+        b.Assign(terrs);
+        REQUIRE_EQ(b.FindFirstContaining(120.5f, 0.5f), LinearFirst(terrs, 120.5f, 0.5f));
+        terrs.resize(2);
+        b.Assign(terrs);
+        REQUIRE_EQ(b.Count(), 2);
+        REQUIRE_EQ(b.FindFirstContaining(120.5f, 0.5f), -1);
+        REQUIRE_EQ(b.FindFirstContaining(5.f, 5.f), 0);
+    });
+
+    t.run("empty: nothing contains anything", [&] {
+        TerritoryBounds b;
+        b.Assign({});
+        REQUIRE_EQ(b.FindFirstContaining(0.f, 0.f), -1);
+        REQUIRE_EQ(b.FindFirstContainingScalar(0.f, 0.f), -1);
+    });
+
+    // ------------------------------------------------------------------
+    // Edge-inclusive boundaries must match Territory::ContainsPoint exactly
+    // ------------------------------------------------------------------
+    t.run("edges: min/max on both axes are inside", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs = { MakeRect(10.f, 10.f, 90.f, 90.f) };
+        b.Assign(terrs);
+        RequireAllAgree(b, terrs, 10.f, 50.f);
+        RequireAllAgree(b, terrs, 90.f, 50.f);
+        RequireAllAgree(b, terrs, 50.f, 10.f);
+        RequireAllAgree(b, terrs, 50.f, 90.f);
+        RequireAllAgree(b, terrs, 10.f, 10.f);
+        RequireAllAgree(b, terrs, 90.f, 90.f);
+        REQUIRE_EQ(b.FindFirstContaining(90.f, 90.f), 0);
+    });
+
+    t.run("edges: one ulp outside is outside", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs = { MakeRect(10.f, 10.f, 90.f, 90.f) };
+        b.Assign(terrs);
+        RequireAllAgree(b, terrs, std::nextafter(10.f, 0.f), 50.f);
+        RequireAllAgree(b, terrs, std::nextafter(90.f, 100.f), 50.f);
+        RequireAllAgree(b, terrs, 50.f, std::nextafter(10.f, 0.f));
+        RequireAllAgree(b, terrs, 50.f, std::nextafter(90.f, 100.f));
+        REQUIRE_EQ(b.FindFirstContaining(std::nextafter(90.f, 100.f), 50.f), -1);
+    });
+
+    t.run("edges: zero-size rect contains only its point", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs = { MakeRect(5.f, 5.f, 5.f, 5.f) };
+        b.Assign(terrs);
+        RequireAllAgree(b, terrs, 5.f, 5.f);
+        REQUIRE_EQ(b.FindFirstContaining(5.f, 5.f), 0);
+    });
+
+    t.run("edges: signed zero compares equal", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs = { MakeRect(0.f, 0.f, 10.f, 10.f) };
+        b.Assign(terrs);
+        RequireAllAgree(b, terrs, -0.f, -0.f);
+        REQUIRE_EQ(b.FindFirstContaining(-0.f, 5.f), 0);
+    });
+
+    t.run("special values: NaN and infinities never match", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs = { MakeRect(-100.f, -100.f, 100.f, 100.f) };
+        b.Assign(terrs);
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        const float inf = std::numeric_limits<float>::infinity();
+        RequireAllAgree(b, terrs, nan, 0.f);
+        RequireAllAgree(b, terrs, 0.f, nan);
+        RequireAllAgree(b, terrs, inf, 0.f);
+        RequireAllAgree(b, terrs, -inf, 0.f);
+    });
+
+    t.run("padding: lanes past Count() never match", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs = { MakeRect(-1e30f, -1e30f, 1e30f, 1e30f) };
+        b.Assign(terrs);
+        REQUIRE_EQ(b.ContainsPoint4(0.f, 0.f, 0), 1);
+        REQUIRE_EQ(b.ContainsPoint4Scalar(0.f, 0.f, 0), 1);
+    });
+
+    t.run("overlap: lowest index wins inside a 4-lane block", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs = {
+            MakeRect(100.f, 100.f, 110.f, 110.f),
+            MakeRect(0.f, 0.f, 50.f, 50.f),
+            MakeRect(0.f, 0.f, 60.f, 60.f),
+        };
+        b.Assign(terrs);
+        REQUIRE_EQ(b.FindFirstContaining(20.f, 20.f), 1);
+        REQUIRE_EQ(b.ContainsPoint4(20.f, 20.f, 0), 0x6);
+    });
+
+    t.run("from: resumes past earlier hits, mid-block too", [&] {
+        TerritoryBounds b;
+        std::vector<Territory> terrs;
+        for (int i = 0; i < 11; ++i) terrs.push_back(MakeRect(0.f, 0.f, 10.f, 10.f));
+        terrs[3] = MakeRect(50.f, 50.f, 60.f, 60.f);
+        b.Assign(terrs);
+        for (int from = 0; from <= 12; ++from) {
+            int expected = -1;
+            for (int i = from; i < (int)terrs.size(); ++i)
+                if (terrs[i].ContainsPoint(CVector(5.f, 5.f, 0.f))) { expected = i; break; }
+            REQUIRE_EQ(b.FindFirstContaining(5.f, 5.f, from), expected);
+            REQUIRE_EQ(b.FindFirstContainingScalar(5.f, 5.f, from), expected);
+        }
+    });
+
+    // ------------------------------------------------------------------
+    // Randomized equivalence
+    // ------------------------------------------------------------------
+    t.run("random: kernel matches ContainsPoint on random and edge points", [&] {
+        std::srand(2024u);
+        std::vector<Territory> terrs;
+        for (int i = 0; i < 203; ++i) {
+            const float x = RandIn(-1500.f, 1500.f);
+            const float y = RandIn(-1500.f, 1500.f);
+            terrs.push_back(MakeRect(x, y, x + RandIn(0.f, 300.f), y + RandIn(0.f, 300.f)));
+        }
+        TerritoryBounds b;
+        b.Assign(terrs);
+
+        for (int i = 0; i < 500; ++i)
+            RequireAllAgree(b, terrs, RandIn(-1600.f, 1900.f), RandIn(-1600.f, 1900.f));
+        for (const auto& r : terrs) {
+            RequireAllAgree(b, terrs, r.minX, r.minY);
+            RequireAllAgree(b, terrs, r.maxX, r.maxY);
+        }
+    });
+}
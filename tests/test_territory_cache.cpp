@@ -0,0 +1,199 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryCache.h"
+#include "../source/Fnv1a.h"
+#include "../source/TerritoryGrid.h"
+
+#include <cstring>
+#include <cstdlib>
+
+// Helpers
+static Territory MakeTerritory(unsigned int id, float minX, float minY, float maxX, float maxY,
+                               int owner = -1, int defense = 1)
+{
+    Territory t;
+    t.id = std::to_string(id);
+    t.numId = id;
+    t.minX = minX; t.minY = minY;
+    t.maxX = maxX; t.maxY = maxY;
+    t.ownerGang = owner;
+    t.defaultOwnerGang = owner;
+    t.defenseLevel = defense;
+    return t;
+}
+
+static std::vector<Territory> MakeLayout(int count) {
+    std::vector<Territory> out;
+    for (int i = 0; i < count; ++i) {
+        const float x = (float)(i % 37) * 60.0f - 1000.0f;
+        const float y = (float)(i / 37) * 60.0f - 1000.0f;
+        out.push_back(MakeTerritory(1001u + (unsigned int)i, x, y, x + 55.0f, y + 70.0f, 7 + (i % 6), i % 3));
+    }
+    return out;
+}
+
+static const unsigned long long kHash = 0x1234ABCDull;
+
+void RunTerritoryCacheTests(Test::Runner& t) {
+    t.suite("TerritoryCache");
+
+    t.run("hash: stable, sensitive to single byte", [&] {
+        const char a[] = "1001,0,0,10,10\n";
+        const char b[] = "1001,0,0,10,11\n";
+        REQUIRE_EQ(TerritoryCache::HashText(a, sizeof(a) - 1), TerritoryCache::HashText(a, sizeof(a) - 1));
+        REQUIRE(TerritoryCache::HashText(a, sizeof(a) - 1) != TerritoryCache::HashText(b, sizeof(b) - 1));
+        REQUIRE(TerritoryCache::HashText("", 0) != TerritoryCache::HashText("\n", 1));
+    });
+
+    t.run("hash: FNV-1a reference values, chained adds match one pass", [&] {
+        REQUIRE_EQ(TerritoryCache::HashText("", 0), 0xCBF29CE484222325ull);
+        REQUIRE_EQ(TerritoryCache::HashText("a", 1), 0xAF63DC4C8601EC8Cull);
+        REQUIRE_EQ(Fnv1a::Add(Fnv1a::Hash("foo", 3), "bar", 3), TerritoryCache::HashText("foobar", 6));
+    });
+
+    t.run("round-trip: fields and defaults survive", [&] {
+        std::vector<Territory> in = {
+            MakeTerritory(1001u, -10.5f, 20.0f, 30.0f, 40.25f, 8, 2),
+            MakeTerritory(7u, 0.0f, 0.0f, 1.0f, 1.0f, -1, 0),
+            MakeTerritory(123456u, -2000.0f, -2000.0f, 2000.0f, 2000.0f, 12, 1),
+        };
+        in[1].id = "007"; // original spelling is kept
+        in[0].ownerGang = 3; // runtime owner is not cached
+        in[2].priority = -5;
+
+        std::vector<unsigned char> image;
+        TerritoryCache::Build(in, nullptr, kHash, image);
+        REQUIRE_EQ(image.size() % 16, (size_t)0);
+
+        std::vector<Territory> out;
+        std::string err;
+        REQUIRE(TerritoryCache::Load(image.data(), image.size(), kHash, out, nullptr, err));
+        REQUIRE_EQ((int)out.size(), 3);
+        for (size_t i = 0; i < in.size(); ++i) {
+            REQUIRE_EQ(out[i].id, in[i].id);
+            REQUIRE_EQ(out[i].numId, in[i].numId);
+            REQUIRE_EQ(out[i].minX, in[i].minX);
+            REQUIRE_EQ(out[i].minY, in[i].minY);
+            REQUIRE_EQ(out[i].maxX, in[i].maxX);
+            REQUIRE_EQ(out[i].maxY, in[i].maxY);
+            REQUIRE_EQ(out[i].defaultOwnerGang, in[i].defaultOwnerGang);
+            REQUIRE_EQ(out[i].ownerGang, in[i].defaultOwnerGang);
+            REQUIRE_EQ(out[i].defenseLevel, in[i].defenseLevel);
+            REQUIRE_EQ(out[i].priority, in[i].priority);
+            REQUIRE_FALSE(out[i].underAttack);
+        }
+    });
+
+    t.run("round-trip: polygon outlines survive and are rebuilt", [&] {
+        std::vector<Territory> in = MakeLayout(5);
+        const float l[] = { 0.f, 0.f, 40.f, 0.f, 40.f, 40.f, 20.f, 10.f, 0.f, 40.f }; // concave
+        const float tri[] = { -5.f, -5.f, 5.f, -5.f, 0.f, 5.f };
+        std::string err;
+        REQUIRE(in[1].poly.Build(l, 5, err));
+        REQUIRE(in[4].poly.Build(tri, 3, err));
+
+        std::vector<unsigned char> image;
+        TerritoryCache::Build(in, nullptr, kHash, image);
+        std::vector<Territory> out;
+        REQUIRE(TerritoryCache::Load(image.data(), image.size(), kHash, out, nullptr, err));
+        for (size_t i = 0; i < in.size(); ++i) {
+            REQUIRE(out[i].poly.SameShape(in[i].poly));
+            REQUIRE_EQ(out[i].poly.IsConvex(), in[i].poly.IsConvex());
+            REQUIRE_EQ(out[i].poly.Triangles().size(), in[i].poly.Triangles().size());
+        }
+        REQUIRE(out[1].poly.Contains(5.f, 20.f));
+        REQUIRE_FALSE(out[1].poly.Contains(20.f, 30.f));
+    });
+
+    t.run("grid: cached grid answers like a fresh build", [&] {
+        const auto terrs = MakeLayout(900);
+        TerritoryGrid built;
+        built.Build(terrs);
+
+        std::vector<unsigned char> image;
+        TerritoryCache::Build(terrs, &built, kHash, image);
+
+        std::vector<Territory> out;
+        TerritoryGrid loaded;
+        std::string err;
+        REQUIRE(TerritoryCache::Load(image.data(), image.size(), kHash, out, &loaded, err));
+        REQUIRE_EQ(loaded.Count(), built.Count());
+        REQUIRE_EQ(loaded.CellsX(), built.CellsX());
+
+        std::srand(77u);
+        bool same = true;
+        for (int i = 0; i < 3000; ++i) {
+            const float x = -1100.0f + 2400.0f * ((float)std::rand() / (float)RAND_MAX);
+            const float y = -1100.0f + 2400.0f * ((float)std::rand() / (float)RAND_MAX);
+            same &= loaded.QueryPoint(x, y) == built.QueryPoint(x, y);
+            same &= loaded.QueryNearest(x, y) == built.QueryNearest(x, y);
+        }
+        REQUIRE(same);
+    });
+
+    t.run("grid: omitted section leaves grid empty", [&] {
+        std::vector<unsigned char> image;
+        TerritoryCache::Build(MakeLayout(10), nullptr, kHash, image);
+        std::vector<Territory> out;
+        TerritoryGrid grid;
+        std::string err;
+        REQUIRE(TerritoryCache::Load(image.data(), image.size(), kHash, out, &grid, err));
+        REQUIRE(grid.IsEmpty());
+    });
+
+    t.run("miss: different source hash", [&] {
+        std::vector<unsigned char> image;
+        TerritoryCache::Build(MakeLayout(5), nullptr, kHash, image);
+        std::vector<Territory> out;
+        std::string err;
+        REQUIRE_FALSE(TerritoryCache::Load(image.data(), image.size(), kHash + 1, out, nullptr, err));
+        REQUIRE(out.empty());
+    });
+
+    t.run("miss: bad magic, version and truncation", [&] {
+        std::vector<unsigned char> image;
+        TerritoryCache::Build(MakeLayout(5), nullptr, kHash, image);
+        std::vector<Territory> out;
+        std::string err;
+
+        auto bad = image;
+        bad[0] ^= 0xFF;
+        REQUIRE_FALSE(TerritoryCache::Load(bad.data(), bad.size(), kHash, out, nullptr, err));
+
+        bad = image;
+        bad[4] += 1;
+        REQUIRE_FALSE(TerritoryCache::Load(bad.data(), bad.size(), kHash, out, nullptr, err));
+
+        REQUIRE_FALSE(TerritoryCache::Load(image.data(), image.size() - 16, kHash, out, nullptr, err));
+        REQUIRE_FALSE(TerritoryCache::Load(image.data(), 8, kHash, out, nullptr, err));
+        REQUIRE_FALSE(TerritoryCache::Load(nullptr, 0, kHash, out, nullptr, err));
+    });
+
+    t.run("miss: empty territory list is never a hit", [&] {
+        std::vector<unsigned char> image;
+        TerritoryCache::Build({}, nullptr, kHash, image);
+        std::vector<Territory> out;
+        std::string err;
+        REQUIRE_FALSE(TerritoryCache::Load(image.data(), image.size(), kHash, out, nullptr, err));
+    });
+
+    t.run("grid: deserialize rejects out-of-range index", [&] {
+        const auto terrs = MakeLayout(20);
+        TerritoryGrid built;
+        built.Build(terrs);
+        std::vector<unsigned char> image;
+        built.Serialize(image);
+
+        TerritoryGrid g;
+        REQUIRE(g.Deserialize(image.data(), image.size(), 20));
+        REQUIRE_FALSE(g.Deserialize(image.data(), image.size(), 19)); // count mismatch
+        REQUIRE(g.IsEmpty());
+        REQUIRE_FALSE(g.Deserialize(image.data(), image.size() - 4, 20)); // truncated
+
+        // Corrupt the index of the last center entry.
+        auto bad = image;
+        const int huge = 1 << 20;
+        std::memcpy(bad.data() + bad.size() - sizeof(int), &huge, sizeof(int));
+        REQUIRE_FALSE(g.Deserialize(bad.data(), bad.size(), 20));
+    });
+}
@@ -0,0 +1,184 @@
+#include "TestFramework.h"
+#include "../source/TerritoryChangeLog.h"
+
+#include <vector>
+
+// Helpers
+struct Recorder {
+    std::vector<TerritoryChangeLog::Event> events;
+
+    static void OnEvent(const TerritoryChangeLog::Event& e, void* user) {
+        static_cast<Recorder*>(user)->events.push_back(e);
+    }
+};
+
+static TerritoryHandle H(int slot, unsigned int gen = 0) { return TerritoryHandle{ slot, gen }; }
+
+void RunTerritoryChangeLogTests(Test::Runner& t) {
+    t.suite("TerritoryChangeLog");
+
+    // ------------------------------------------------------------------
+    // Epochs
+    // ------------------------------------------------------------------
+    t.run("epoch: every mark bumps it, per kind", [&] {
+        TerritoryChangeLog log;
+        REQUIRE_EQ(log.Epoch(), 0u);
+        log.Mark(H(2), TerritoryChangeLog::kOwner);
+        log.Mark(H(5), TerritoryChangeLog::kUnderAttack);
+        REQUIRE_EQ(log.Epoch(), 2u);
+        REQUIRE_EQ(log.Epoch(TerritoryChangeLog::kOwner), 1u);
+        REQUIRE_EQ(log.Epoch(TerritoryChangeLog::kUnderAttack), 2u);
+        REQUIRE_EQ(log.Epoch(TerritoryChangeLog::kGeometry), 0u);
+        REQUIRE_EQ(log.Epoch(TerritoryChangeLog::kOwner | TerritoryChangeLog::kGeometry), 1u);
+    });
+
+    t.run("epoch: bulk change stamps only the kinds it names", [&] {
+        TerritoryChangeLog log;
+        log.Mark(H(1), TerritoryChangeLog::kOwner);
+        log.Flush(); // nothing queued for the bulk change to fold in
+        log.MarkAll(TerritoryChangeLog::kGeometry);
+        REQUIRE_EQ(log.Epoch(TerritoryChangeLog::kGeometry), 2u);
+        REQUIRE_EQ(log.Epoch(TerritoryChangeLog::kOwner), 1u);
+        log.Mark(H(1), TerritoryChangeLog::kOwner);
+        REQUIRE_EQ(log.Epoch(TerritoryChangeLog::kOwner), 3u);
+        REQUIRE_EQ(log.Epoch(TerritoryChangeLog::kGeometry), 2u);
+    });
+
+    t.run("epoch: no-op marks and Reset never move it backwards", [&] {
+        TerritoryChangeLog log;
+        log.Mark(H(0), 0u);
+        log.Mark(TerritoryHandle{}, TerritoryChangeLog::kOwner);
+        log.MarkAll(0u);
+        REQUIRE_EQ(log.Epoch(), 0u);
+        REQUIRE_FALSE(log.HasPending());
+
+        log.Mark(H(0), TerritoryChangeLog::kOwner);
+        log.Reset();
+        REQUIRE_EQ(log.Epoch(), 1u);
+        REQUIRE_FALSE(log.HasPending());
+        log.Mark(H(0), TerritoryChangeLog::kOwner);
+        REQUIRE_EQ(log.Epoch(), 2u);
+    });
+
+    // ------------------------------------------------------------------
+    // Delivery
+    // ------------------------------------------------------------------
+    t.run("flush: nothing pending calls nobody", [&] {
+        TerritoryChangeLog log;
+        Recorder r;
+        log.Subscribe(TerritoryChangeLog::kAll, Recorder::OnEvent, &r);
+        REQUIRE_EQ(log.Flush(), 0);
+        REQUIRE(r.events.empty());
+    });
+
+    t.run("flush: coalesced per slot, in first-change order", [&] {
+        TerritoryChangeLog log;
+        Recorder r;
+        log.Subscribe(TerritoryChangeLog::kAll, Recorder::OnEvent, &r);
+        log.Mark(H(4), TerritoryChangeLog::kUnderAttack);
+        log.Mark(H(1), TerritoryChangeLog::kOwner);
+        log.Mark(H(4), TerritoryChangeLog::kOwner);
+
+        REQUIRE_EQ(log.Flush(), 2);
+        REQUIRE_EQ((int)r.events.size(), 2);
+        REQUIRE(r.events[0].handle == H(4));
+        REQUIRE_EQ(r.events[0].kinds, (unsigned int)(TerritoryChangeLog::kUnderAttack | TerritoryChangeLog::kOwner));
+        REQUIRE_EQ(r.events[0].epoch, 3u);
+        REQUIRE(r.events[1].handle == H(1));
+        REQUIRE_EQ(log.Flush(), 0);
+    });
+
+    t.run("flush: a reused slot with a new generation is its own event", [&] {
+        TerritoryChangeLog log;
+        Recorder r;
+        log.Subscribe(TerritoryChangeLog::kAll, Recorder::OnEvent, &r);
+        log.Mark(H(3, 0), TerritoryChangeLog::kOwner);
+        log.Mark(H(3, 1), TerritoryChangeLog::kOwner);
+        log.Flush();
+        REQUIRE_EQ((int)r.events.size(), 2);
+    });
+
+    t.run("flush: subscribers only see the kinds they asked for", [&] {
+        TerritoryChangeLog log;
+        Recorder owners, attacks;
+        log.Subscribe(TerritoryChangeLog::kOwner, Recorder::OnEvent, &owners);
+        log.Subscribe(TerritoryChangeLog::kUnderAttack | TerritoryChangeLog::kGeometry, Recorder::OnEvent, &attacks);
+        log.Mark(H(0), TerritoryChangeLog::kOwner);
+        log.Mark(H(1), TerritoryChangeLog::kUnderAttack);
+        log.Flush();
+        REQUIRE_EQ((int)owners.events.size(), 1);
+        REQUIRE(owners.events[0].handle == H(0));
+        REQUIRE_EQ((int)attacks.events.size(), 1);
+        REQUIRE(attacks.events[0].handle == H(1));
+    });
+
+    t.run("flush: bulk change swallows what was queued before it", [&] {
+        TerritoryChangeLog log;
+        Recorder r;
+        log.Subscribe(TerritoryChangeLog::kAll, Recorder::OnEvent, &r);
+        log.Mark(H(0), TerritoryChangeLog::kOwner);
+        log.MarkAll(TerritoryChangeLog::kGeometry);
+        log.Mark(H(0), TerritoryChangeLog::kUnderAttack);
+        REQUIRE_EQ(log.Flush(), 2);
+        REQUIRE_FALSE(r.events[0].handle.IsValid());
+        REQUIRE_EQ(r.events[0].kinds, (unsigned int)(TerritoryChangeLog::kOwner | TerritoryChangeLog::kGeometry));
+        REQUIRE(r.events[1].handle == H(0));
+        REQUIRE_EQ(r.events[1].kinds, (unsigned int)TerritoryChangeLog::kUnderAttack);
+    });
+
+    t.run("flush: marks from a callback go out on the next flush", [&] {
+        struct Chain {
+            TerritoryChangeLog* log;
+            int calls = 0;
+            static void OnEvent(const TerritoryChangeLog::Event& e, void* user) {
+                Chain* c = static_cast<Chain*>(user);
+                ++c->calls;
+                if (e.handle.slot < 3) c->log->Mark(H(e.handle.slot + 1), TerritoryChangeLog::kOwner);
+            }
+        };
+        TerritoryChangeLog log;
+        Chain c{ &log };
+        log.Subscribe(TerritoryChangeLog::kOwner, Chain::OnEvent, &c);
+        log.Mark(H(0), TerritoryChangeLog::kOwner);
+        REQUIRE_EQ(log.Flush(), 1);
+        REQUIRE_EQ(c.calls, 1);
+        REQUIRE(log.HasPending());
+        log.Flush();
+        log.Flush();
+        log.Flush();
+        REQUIRE_EQ(c.calls, 4);
+        REQUIRE_FALSE(log.HasPending());
+    });
+
+    t.run("subscribe: unsubscribe from inside a callback", [&] {
+        struct Once {
+            TerritoryChangeLog* log;
+            int id = 0;
+            int calls = 0;
+            static void OnEvent(const TerritoryChangeLog::Event&, void* user) {
+                Once* o = static_cast<Once*>(user);
+                ++o->calls;
+                o->log->Unsubscribe(o->id);
+            }
+        };
+        TerritoryChangeLog log;
+        Once o{ &log };
+        Recorder r;
+        o.id = log.Subscribe(TerritoryChangeLog::kAll, Once::OnEvent, &o);
+        log.Subscribe(TerritoryChangeLog::kAll, Recorder::OnEvent, &r);
+        REQUIRE(o.id > 0);
+
+        log.Mark(H(0), TerritoryChangeLog::kOwner);
+        log.Mark(H(1), TerritoryChangeLog::kOwner);
+        log.Flush();
+        REQUIRE_EQ(o.calls, 1);
+        REQUIRE_EQ((int)r.events.size(), 2);
+        REQUIRE_EQ(log.SubscriberCount(), 1);
+    });
+
+    t.run("subscribe: null callback is refused", [&] {
+        TerritoryChangeLog log;
+        REQUIRE_EQ(log.Subscribe(TerritoryChangeLog::kAll, nullptr, nullptr), 0);
+        REQUIRE_EQ(log.SubscriberCount(), 0);
+    });
+}
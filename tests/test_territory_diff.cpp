@@ -0,0 +1,174 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryDiff.h"
+#include "../source/TerritoryIdIndex.h"
+
+// Helpers
+static Territory MakeTerritory(unsigned int id, float minX, float minY, float maxX, float maxY, int owner = -1) {
+    Territory t;
+    t.id = std::to_string(id);
+    t.numId = id;
+    t.minX = minX; t.minY = minY;
+    t.maxX = maxX; t.maxY = maxY;
+    t.ownerGang = owner;
+    t.defaultOwnerGang = owner;
+    return t;
+}
+
+static std::vector<Territory> MakeRow(std::initializer_list<unsigned int> ids) {
+    std::vector<Territory> out;
+    for (unsigned int id : ids) {
+        const float x = (float)(id % 100) * 20.0f;
+        out.push_back(MakeTerritory(id, x, 0.0f, x + 10.0f, 10.0f, 7));
+    }
+    return out;
+}
+
+static TerritoryDiff::Result Diff(const std::vector<Territory>& current, const std::vector<Territory>& next) {
+    TerritoryIdIndex index;
+    index.Build(current);
+    TerritoryDiff::Result r;
+    TerritoryDiff::Compute(current, index, next, r);
+    return r;
+}
+
+static std::vector<unsigned int> Ids(const std::vector<Territory>& terrs) {
+    std::vector<unsigned int> out;
+    for (const auto& t : terrs) out.push_back(t.numId);
+    return out;
+}
+
+void RunTerritoryDiffTests(Test::Runner& t) {
+    t.suite("TerritoryDiff");
+
+    t.run("identical sets produce an empty diff", [&] {
+        const auto cur = MakeRow({ 1001, 1002, 1003 });
+        const auto r = Diff(cur, MakeRow({ 1001, 1002, 1003 }));
+        REQUIRE(r.Empty());
+        REQUIRE_FALSE(r.Structural());
+    });
+
+    t.run("one moved rect is the only change", [&] {
+        const auto cur = MakeRow({ 1001, 1002, 1003, 1004 });
+        auto next = MakeRow({ 1001, 1002, 1003, 1004 });
+        next[2].maxX += 5.0f;
+        const auto r = Diff(cur, next);
+        REQUIRE_EQ((int)r.changed.size(), 1);
+        REQUIRE_EQ(r.changed[0].index, 2);
+        REQUIRE_EQ(r.changed[0].nextIndex, 2);
+        REQUIRE(r.changed[0].geometry);
+        REQUIRE_FALSE(r.Structural());
+    });
+
+    t.run("outline change with the same box is geometry, and is applied", [&] {
+        auto cur = MakeRow({ 1001, 1002 });
+        auto next = MakeRow({ 1001, 1002 });
+        const float x0 = next[1].minX, y0 = next[1].minY, x1 = next[1].maxX, y1 = next[1].maxY;
+        const float a[] = { x0, y0, x1, y0, x1, y1, x0, y1 };
+        const float b[] = { x0, y0, x1, y0, (x0 + x1) * 0.5f, (y0 + y1) * 0.5f, x1, y1, x0, y1 };
+        std::string err;
+        REQUIRE(cur[1].poly.Build(a, 4, err));
+        REQUIRE(next[1].poly.Build(b, 5, err));
+
+        const auto r = Diff(cur, next);
+        REQUIRE_EQ((int)r.changed.size(), 1);
+        REQUIRE(r.changed[0].geometry);
+        TerritoryDiff::Apply(cur, next, r);
+        REQUIRE(cur[1].poly.SameShape(next[1].poly));
+    });
+
+    t.run("default owner, defense, priority or id spelling change is not geometry", [&] {
+        auto cur = MakeRow({ 7, 1002, 1003, 1004 });
+        auto next = MakeRow({ 7, 1002, 1003, 1004 });
+        next[0].id = "007";
+        next[1].defaultOwnerGang = 9;
+        next[2].defenseLevel = 2;
+        next[3].priority = 1;
+        const auto r = Diff(cur, next);
+        REQUIRE_EQ((int)r.changed.size(), 4);
+        for (const auto& c : r.changed) REQUIRE_FALSE(c.geometry);
+        TerritoryDiff::Apply(cur, next, r);
+        REQUIRE_EQ(cur[3].priority, 1);
+    });
+
+    t.run("added and removed ids", [&] {
+        const auto cur = MakeRow({ 1001, 1002, 1003 });
+        const auto r = Diff(cur, MakeRow({ 1001, 1003, 1004, 1005 }));
+        REQUIRE_EQ((int)r.removed.size(), 1);
+        REQUIRE_EQ(r.removed[0], 1);
+        REQUIRE_EQ((int)r.added.size(), 2);
+        REQUIRE_EQ(r.added[0], 2);
+        REQUIRE_EQ(r.added[1], 3);
+        REQUIRE(r.AddedAtTail());
+        REQUIRE_FALSE(r.reordered);
+        REQUIRE(r.changed.empty());
+    });
+
+    t.run("insert in the middle is not at the tail", [&] {
+        const auto r = Diff(MakeRow({ 1001, 1003 }), MakeRow({ 1001, 1002, 1003 }));
+        REQUIRE_EQ((int)r.added.size(), 1);
+        REQUIRE_FALSE(r.AddedAtTail());
+        REQUIRE_FALSE(r.reordered);
+    });
+
+    t.run("swapped lines are a reorder, changes listed by current index", [&] {
+        const auto cur = MakeRow({ 1001, 1002, 1003 });
+        auto next = MakeRow({ 1003, 1002, 1001 });
+        next[0].maxY += 1.0f; // 1003, current index 2
+        next[2].maxY += 1.0f; // 1001, current index 0
+        const auto r = Diff(cur, next);
+        REQUIRE(r.reordered);
+        REQUIRE(r.Structural());
+        REQUIRE_EQ((int)r.changed.size(), 2);
+        REQUIRE_EQ(r.changed[0].index, 0);
+        REQUIRE_EQ(r.changed[1].index, 2);
+    });
+
+    t.run("apply in place keeps runtime state", [&] {
+        auto cur = MakeRow({ 1001, 1002 });
+        cur[1].ownerGang = 9;
+        cur[1].lastOwnerGang = 7;
+        cur[1].neutralSinceMs = 1234;
+        cur[1].underAttack = true;
+        auto next = MakeRow({ 1001, 1002 });
+        next[1].minX = -50.0f;
+        next[1].defaultOwnerGang = 8;
+
+        const auto r = Diff(cur, next);
+        TerritoryDiff::Apply(cur, next, r);
+        REQUIRE_EQ(cur[1].minX, -50.0f);
+        REQUIRE_EQ(cur[1].defaultOwnerGang, 8);
+        REQUIRE_EQ(cur[1].ownerGang, 9);
+        REQUIRE_EQ(cur[1].lastOwnerGang, 7);
+        REQUIRE_EQ(cur[1].neutralSinceMs, 1234u);
+        REQUIRE(cur[1].underAttack);
+    });
+
+    t.run("apply structural follows the new file order", [&] {
+        auto cur = MakeRow({ 1001, 1002, 1003 });
+        cur[2].ownerGang = 12;
+        auto next = MakeRow({ 1003, 1004, 1001 });
+        next[1].ownerGang = 10; // added: comes in as loaded
+
+        const auto r = Diff(cur, next);
+        TerritoryDiff::Apply(cur, next, r);
+        REQUIRE(Ids(cur) == std::vector<unsigned int>({ 1003, 1004, 1001 }));
+        REQUIRE_EQ(cur[0].ownerGang, 12);
+        REQUIRE_EQ(cur[1].ownerGang, 10);
+    });
+
+    t.run("apply from empty and to empty", [&] {
+        std::vector<Territory> cur;
+        auto next = MakeRow({ 1001, 1002 });
+        auto r = Diff(cur, next);
+        REQUIRE_EQ((int)r.added.size(), 2);
+        TerritoryDiff::Apply(cur, next, r);
+        REQUIRE_EQ((int)cur.size(), 2);
+
+        std::vector<Territory> none;
+        r = Diff(cur, none);
+        REQUIRE_EQ((int)r.removed.size(), 2);
+        TerritoryDiff::Apply(cur, none, r);
+        REQUIRE(cur.empty());
+    });
+}
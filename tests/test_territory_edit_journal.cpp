@@ -0,0 +1,233 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryEditJournal.h"
+#include "../source/TerritoryFileParser.h"
+
+#include <cstring>
+
+using Journal = TerritoryEditJournal;
+
+// Helpers
+static Territory MakeTerr(unsigned int id, float x, float y, float size) {
+    Territory t;
+    t.numId = id;
+    t.id = std::to_string(id);
+    t.minX = x; t.minY = y;
+    t.maxX = x + size; t.maxY = y + size;
+    t.defaultOwnerGang = t.ownerGang = 7;
+    return t;
+}
+
+static std::vector<Territory> ParseAll(const char* text) {
+    std::vector<Territory> out;
+    std::string err;
+    TerritoryFileParser::ParseBuffer(text, std::strlen(text), out, err, 1);
+    return out;
+}
+
+static bool HasId(const std::vector<Territory>& terrs, unsigned int id) {
+    for (const auto& t : terrs) if (t.numId == id) return true;
+    return false;
+}
+
+// Base file plus a journal, as a fresh session would see them on disk.
+static std::vector<Territory> Replay(const char* base, const std::string& journal) {
+    std::vector<Territory> terrs = ParseAll(base);
+    unsigned long long hash = 0;
+    std::vector<Journal::Op> ops;
+    std::string err;
+    REQUIRE(Journal::Parse(journal.data(), journal.size(), hash, ops, err));
+    for (const auto& op : ops) REQUIRE(Journal::Apply(terrs, op, err));
+    return terrs;
+}
+
+void RunTerritoryEditJournalTests(Test::Runner& t) {
+    t.suite("TerritoryEditJournal");
+
+    const char* base = "1001,0,0,10,10,7\n1002,20,0,30,10,8\n";
+
+    // ------------------------------------------------------------------
+    // Records
+    // ------------------------------------------------------------------
+    t.run("apply: add appends, add of a known id replaces, remove by id", [&] {
+        std::vector<Territory> terrs = ParseAll(base);
+        std::string err;
+        REQUIRE(Journal::Apply(terrs, Journal::MakeAdd(MakeTerr(1003, 50, 50, 5)), err));
+        REQUIRE_EQ((int)terrs.size(), 3);
+        REQUIRE_EQ(terrs[2].numId, 1003u);
+
+        REQUIRE(Journal::Apply(terrs, Journal::MakeAdd(MakeTerr(1001, 100, 100, 20)), err));
+        REQUIRE_EQ((int)terrs.size(), 3);
+        REQUIRE_EQ(terrs[0].minX, 100.0f);
+
+        REQUIRE(Journal::Apply(terrs, Journal::MakeRemove(terrs[1]), err));
+        REQUIRE_FALSE(HasId(terrs, 1002));
+        REQUIRE(Journal::Apply(terrs, Journal::MakeRemove(MakeTerr(4242, 0, 0, 1)), err)); // no-op
+        REQUIRE_EQ((int)terrs.size(), 2);
+    });
+
+    t.run("apply: bad add record is refused", [&] {
+        std::vector<Territory> terrs = ParseAll(base);
+        Journal::Op op{ Journal::kAdd, 9u, "9,x,0,1,1" };
+        std::string err;
+        REQUIRE_FALSE(Journal::Apply(terrs, op, err));
+        REQUIRE_EQ(err, std::string("Bad minX"));
+        REQUIRE_EQ((int)terrs.size(), 2);
+    });
+
+    // ------------------------------------------------------------------
+    // File text
+    // ------------------------------------------------------------------
+    t.run("text: header once, then one line per op", [&] {
+        Journal j;
+        j.Reset(0xABCull);
+        j.Record(Journal::MakeAdd(MakeTerr(1003, 1, 2, 3)));
+        std::string text;
+        j.TakeAppendText(text);
+        REQUIRE_EQ(text, std::string("#journal base=0000000000000abc\n+1003,1.000,2.000,4.000,5.000,7,0,1\n"));
+
+        j.Record(Journal::MakeRemove(MakeTerr(1001, 0, 0, 10)));
+        j.TakeAppendText(text);
+        REQUIRE_EQ(text, std::string("-1001,0.000,0.000,10.000,10.000,7,0,1\n"));
+        j.TakeAppendText(text);
+        REQUIRE(text.empty());
+    });
+
+    t.run("text: parse round-trips base hash and ops", [&] {
+        Journal j;
+        j.Reset(0x1234567890ABCDEFull);
+        j.Record(Journal::MakeAdd(MakeTerr(1003, 1, 2, 3)));
+        j.Record(Journal::MakeRemove(MakeTerr(1001, 0, 0, 10)));
+        std::string text;
+        j.TakeAppendText(text);
+
+        unsigned long long hash = 0;
+        std::vector<Journal::Op> ops;
+        std::string err;
+        REQUIRE(Journal::Parse(text.data(), text.size(), hash, ops, err));
+        REQUIRE_EQ(hash, 0x1234567890ABCDEFull);
+        REQUIRE_EQ((int)ops.size(), 2);
+        REQUIRE(ops[0].kind == Journal::kAdd);
+        REQUIRE_EQ(ops[0].numId, 1003u);
+        REQUIRE(ops[1].kind == Journal::kRemove);
+        REQUIRE_EQ(ops[1].line, j.Ops()[1].line);
+    });
+
+    t.run("text: torn last line is dropped, CRLF accepted", [&] {
+        const std::string text = "#journal base=1\r\n+1003,0,0,5,5\r\n-1001,0,0,10,10";
+        unsigned long long hash = 0;
+        std::vector<Journal::Op> ops;
+        std::string err;
+        REQUIRE(Journal::Parse(text.data(), text.size(), hash, ops, err));
+        REQUIRE_EQ((int)ops.size(), 1);
+        REQUIRE_EQ(ops[0].line, std::string("1003,0,0,5,5"));
+    });
+
+    t.run("text: bad record keeps the ops before it", [&] {
+        const std::string text = "+1003,0,0,5,5\n*junk\n+1004,0,0,5,5\n";
+        unsigned long long hash = 0;
+        std::vector<Journal::Op> ops;
+        std::string err;
+        REQUIRE_FALSE(Journal::Parse(text.data(), text.size(), hash, ops, err));
+        REQUIRE_EQ(err, std::string("Journal line 2: Expected '+' or '-'"));
+        REQUIRE_EQ((int)ops.size(), 1);
+
+        const std::string bad = "+1003,0,0,5,5\n-1004,0,zz,5,5\n";
+        REQUIRE_FALSE(Journal::Parse(bad.data(), bad.size(), hash, ops, err));
+        REQUIRE_EQ(err, std::string("Journal line 2: Bad minY"));
+    });
+
+    // ------------------------------------------------------------------
+    // Undo / redo
+    // ------------------------------------------------------------------
+    t.run("undo: appends the inverse, replay lands on the undone state", [&] {
+        Journal j;
+        j.Reset(0);
+        std::vector<Territory> live = ParseAll(base);
+        std::string err, text;
+
+        const Journal::Op add = Journal::MakeAdd(MakeTerr(1003, 50, 50, 5));
+        REQUIRE(Journal::Apply(live, add, err));
+        j.Record(add);
+        const Journal::Op del = Journal::MakeRemove(live[0]);
+        REQUIRE(Journal::Apply(live, del, err));
+        j.Record(del);
+
+        Journal::Op op;
+        REQUIRE(j.Undo(op)); // brings 1001 back
+        REQUIRE(op.kind == Journal::kAdd);
+        REQUIRE(Journal::Apply(live, op, err));
+        REQUIRE(j.Undo(op)); // drops 1003
+        REQUIRE(op.kind == Journal::kRemove);
+        REQUIRE(Journal::Apply(live, op, err));
+        REQUIRE_FALSE(j.CanUndo());
+        REQUIRE_FALSE(j.Undo(op));
+
+        REQUIRE_EQ((int)j.Ops().size(), 4);
+        j.TakeAppendText(text);
+        const auto replayed = Replay(base, text);
+        REQUIRE_EQ((int)replayed.size(), 2);
+        REQUIRE(HasId(replayed, 1001));
+        REQUIRE_FALSE(HasId(replayed, 1003));
+        REQUIRE_EQ((int)live.size(), 2);
+    });
+
+    t.run("redo: reapplies in order; a new edit clears it", [&] {
+        Journal j;
+        j.Reset(0);
+        j.Record(Journal::MakeAdd(MakeTerr(1003, 0, 0, 5)));
+        j.Record(Journal::MakeAdd(MakeTerr(1004, 0, 0, 5)));
+
+        Journal::Op op;
+        REQUIRE(j.Undo(op));
+        REQUIRE(j.Undo(op));
+        REQUIRE(j.Redo(op));
+        REQUIRE_EQ(op.numId, 1003u);
+        REQUIRE(op.kind == Journal::kAdd);
+        REQUIRE(j.CanRedo());
+
+        j.Record(Journal::MakeAdd(MakeTerr(1005, 0, 0, 5)));
+        REQUIRE_FALSE(j.CanRedo());
+        REQUIRE_FALSE(j.Redo(op));
+
+        std::string text;
+        j.TakeAppendText(text);
+        const auto replayed = Replay(base, text);
+        REQUIRE(HasId(replayed, 1003));
+        REQUIRE_FALSE(HasId(replayed, 1004));
+        REQUIRE(HasId(replayed, 1005));
+    });
+
+    t.run("compact: ops and file text go, history stays", [&] {
+        Journal j;
+        j.Reset(1);
+        j.Record(Journal::MakeAdd(MakeTerr(1003, 0, 0, 5)));
+        std::string text;
+        j.TakeAppendText(text);
+        j.MarkCompacted(2);
+        REQUIRE(j.Ops().empty());
+        REQUIRE_EQ(j.BaseHash(), 2ull);
+        REQUIRE(j.CanUndo());
+
+        // The next append starts a new file on the new base.
+        Journal::Op op;
+        REQUIRE(j.Undo(op));
+        j.TakeAppendText(text);
+        REQUIRE_EQ(text.compare(0, 31, "#journal base=0000000000000002\n"), 0);
+        REQUIRE_EQ((int)j.Ops().size(), 1);
+    });
+
+    t.run("adopt: ops read from disk replay but are not undoable", [&] {
+        std::vector<Journal::Op> ops = { Journal::MakeAdd(MakeTerr(1003, 0, 0, 5)) };
+        Journal j;
+        j.Adopt(7, ops);
+        REQUIRE_EQ((int)j.Ops().size(), 1);
+        REQUIRE_FALSE(j.CanUndo());
+
+        // File already has its header.
+        j.Record(Journal::MakeAdd(MakeTerr(1004, 0, 0, 5)));
+        std::string text;
+        j.TakeAppendText(text);
+        REQUIRE_EQ(text[0], '+');
+    });
+}
@@ -0,0 +1,300 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryFileParser.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace TerritoryFileParser;
+
+// Helpers
+static bool ParseText(const std::string& text, std::vector<Territory>& out, std::string& err, int threads = 1) {
+    return ParseBuffer(text.data(), text.size(), out, err, threads);
+}
+
+static std::string ParseErr(const std::string& text, int threads = 1) {
+    std::vector<Territory> out;
+    std::string err;
+    ParseText(text, out, err, threads);
+    return err;
+}
+
+static bool LineOk(const char* line, Territory& t, std::string& err) {
+    return ParseLine(line, line + std::strlen(line), t, err);
+}
+
+// Big enough to cross kParallelThresholdBytes.
+static std::string MakeLargeFile(int lines) {
+    std::string text;
+    text.reserve((size_t)lines * 48);
+    char buf[128];
+    for (int i = 0; i < lines; ++i) {
+        if (i % 97 == 0) text += "# comment line\r\n";
+        const float x = (float)(i % 1000) * 4.0f - 2000.0f;
+        const float y = (float)(i / 1000) * 4.0f - 2000.0f;
+        std::snprintf(buf, sizeof(buf), "%d,%.1f,%.1f,%.1f,%.1f,%d,0,%d\n",
+            100000 + i, x, y, x + 3.5f, y + 3.5f, 7 + (i % 6), i % 3);
+        text += buf;
+    }
+    return text;
+}
+
+static int CountLinesBefore(const std::string& text, size_t pos) {
+    int n = 1;
+    for (size_t i = 0; i < pos; ++i) if (text[i] == '\n') ++n;
+    return n;
+}
+
+void RunTerritoryFileParserTests(Test::Runner& t) {
+    t.suite("TerritoryFileParser");
+
+    // ------------------------------------------------------------------
+    // Single line
+    // ------------------------------------------------------------------
+    t.run("line: minimal five fields", [&] {
+        Territory tr; std::string err;
+        REQUIRE(LineOk("1001,-10.5,20,30,40.25", tr, err));
+        REQUIRE_EQ(tr.id, std::string("1001"));
+        REQUIRE_EQ(tr.numId, 1001u);
+        REQUIRE_EQ(tr.minX, -10.5f);
+        REQUIRE_EQ(tr.maxY, 40.25f);
+        REQUIRE_EQ(tr.ownerGang, -1);
+        REQUIRE_EQ(tr.defaultOwnerGang, -1);
+        REQUIRE_EQ(tr.defenseLevel, 1);
+    });
+
+    t.run("line: owner and defense level, spaces around fields", [&] {
+        Territory tr; std::string err;
+        REQUIRE(LineOk("1002 ,  0 , 0 ,\t10, 10 , 8 , 1 , 2", tr, err));
+        REQUIRE_EQ(tr.ownerGang, 8);
+        REQUIRE_EQ(tr.defaultOwnerGang, 8);
+        REQUIRE_EQ(tr.defenseLevel, 2);
+        REQUIRE_FALSE(tr.underAttack);
+    });
+
+    t.run("line: defense level clamped, empty owner field allowed", [&] {
+        Territory tr; std::string err;
+        REQUIRE(LineOk("1,0,0,1,1,,0,9", tr, err));
+        REQUIRE_EQ(tr.ownerGang, -1);
+        REQUIRE_EQ(tr.defenseLevel, 2);
+        REQUIRE(LineOk("1,0,0,1,1,7,0,-4", tr, err));
+        REQUIRE_EQ(tr.defenseLevel, 0);
+    });
+
+    t.run("line: inverted rect is normalized", [&] {
+        Territory tr; std::string err;
+        REQUIRE(LineOk("5,100,200,-100,-200", tr, err));
+        REQUIRE_EQ(tr.minX, -100.f);
+        REQUIRE_EQ(tr.maxX, 100.f);
+        REQUIRE_EQ(tr.minY, -200.f);
+        REQUIRE_EQ(tr.maxY, 200.f);
+    });
+
+    t.run("line: leading '+' and trailing junk accepted like sscanf", [&] {
+        Territory tr; std::string err;
+        REQUIRE(LineOk("5,+1.5,2abc,3,4,+9", tr, err));
+        REQUIRE_EQ(tr.minX, 1.5f);
+        REQUIRE_EQ(tr.minY, 2.f);
+        REQUIRE_EQ(tr.ownerGang, 9);
+    });
+
+    t.run("line: extra fields past the 8th stay in the last token", [&] {
+        Territory tr; std::string err;
+        REQUIRE(LineOk("5,0,0,1,1,7,0,1,extra,stuff", tr, err));
+        REQUIRE_EQ(tr.defenseLevel, 1);
+    });
+
+    t.run("line: poly field replaces the rect with the outline's box", [&] {
+        Territory tr; std::string err;
+        REQUIRE(LineOk("9,0,0,1,1,7,0,1,poly: 10 20; 110 20 ;60 90;", tr, err));
+        REQUIRE_EQ(tr.poly.VertexCount(), 3);
+        REQUIRE_EQ(tr.minX, 10.f);
+        REQUIRE_EQ(tr.minY, 20.f);
+        REQUIRE_EQ(tr.maxX, 110.f);
+        REQUIRE_EQ(tr.maxY, 90.f);
+        REQUIRE_EQ(tr.defenseLevel, 1);
+        REQUIRE(tr.ContainsPoint(CVector(60.f, 40.f, 0.f)));
+        REQUIRE_FALSE(tr.ContainsPoint(CVector(15.f, 85.f, 0.f)));
+
+        // Other extra fields around it are still ignored.
+        REQUIRE(LineOk("9,0,0,1,1,7,0,,note,poly:0 0;4 0;4 4;0 4,more", tr, err));
+        REQUIRE_EQ(tr.poly.VertexCount(), 4);
+        REQUIRE_EQ(tr.maxX, 4.f);
+
+        REQUIRE(LineOk("9,0,0,1,1,7,0,1", tr, err));
+        REQUIRE(tr.poly.Empty());
+    });
+
+    t.run("line: prio field, before or after the outline", [&] {
+        Territory tr; std::string err;
+        REQUIRE(LineOk("9,0,0,1,1,7,0,1", tr, err));
+        REQUIRE_EQ(tr.priority, 0);
+        REQUIRE(LineOk("9,0,0,1,1,7,0,1,prio:3", tr, err));
+        REQUIRE_EQ(tr.priority, 3);
+        REQUIRE(LineOk("9,0,0,1,1,7,0,1,poly:0 0;4 0;4 4,prio:-2", tr, err));
+        REQUIRE_EQ(tr.priority, -2);
+        REQUIRE_EQ(tr.poly.VertexCount(), 3);
+        REQUIRE_FALSE(LineOk("9,0,0,1,1,7,0,1,prio:high", tr, err));
+        REQUIRE_EQ(err, std::string("Bad priority"));
+    });
+
+    t.run("line: poly field errors", [&] {
+        Territory tr; std::string err;
+        REQUIRE_FALSE(LineOk("9,0,0,1,1,7,0,1,poly:0 0;1 x;1 1", tr, err));
+        REQUIRE_EQ(err, std::string("Bad polygon vertex 2"));
+        REQUIRE_FALSE(LineOk("9,0,0,1,1,7,0,1,poly:0 0;1 1", tr, err));
+        REQUIRE_EQ(err, std::string("Polygon needs at least 3 vertices"));
+        REQUIRE_FALSE(LineOk("9,0,0,1,1,7,0,1,poly:0 0;10 10;10 0;0 20", tr, err));
+        REQUIRE_EQ(err, std::string("Polygon edges cross"));
+        REQUIRE_EQ(ParseErr("1001,0,0,1,1\n9,0,0,1,1,7,0,1,poly:0 0;1 1;2 2\n"),
+            std::string("Parse error line 2: Polygon has no area"));
+    });
+
+    t.run("line: error reasons", [&] {
+        Territory tr; std::string err;
+        REQUIRE_FALSE(LineOk("1001,0,0,10", tr, err));
+        REQUIRE_EQ(err, std::string("Expected at least 5 comma-separated fields"));
+        REQUIRE_FALSE(LineOk(" ,0,0,10,10", tr, err));
+        REQUIRE_EQ(err, std::string("Missing id"));
+        REQUIRE_FALSE(LineOk("A12,0,0,10,10", tr, err));
+        REQUIRE_EQ(err, std::string("Id must be numeric (e.g. 1001)"));
+        REQUIRE_FALSE(LineOk("1,x,0,10,10", tr, err));
+        REQUIRE_EQ(err, std::string("Bad minX"));
+        REQUIRE_FALSE(LineOk("1,0,,10,10", tr, err));
+        REQUIRE_EQ(err, std::string("Bad minY"));
+        REQUIRE_FALSE(LineOk("1,0,0,-,10", tr, err));
+        REQUIRE_EQ(err, std::string("Bad maxX"));
+        REQUIRE_FALSE(LineOk("1,0,0,10,q", tr, err));
+        REQUIRE_EQ(err, std::string("Bad maxY"));
+        REQUIRE_FALSE(LineOk("1,0,0,10,10,gang", tr, err));
+        REQUIRE_EQ(err, std::string("Bad ownerGangCode"));
+        REQUIRE_FALSE(LineOk("1,0,0,10,10,7,0,high", tr, err));
+        REQUIRE_EQ(err, std::string("Bad defenseLevel"));
+    });
+
+    // ------------------------------------------------------------------
+    // Whole buffer
+    // ------------------------------------------------------------------
+    t.run("buffer: comments, blanks, CRLF and missing final newline", [&] {
+        std::vector<Territory> out; std::string err;
+        const std::string text =
+            "# header\r\n"
+            "\r\n"
+            "   # indented comment\n"
+            "1001,0,0,10,10,7\r\n"
+            "  \t \n"
+            "1002,10,0,20,10,8";
+        REQUIRE(ParseText(text, out, err));
+        REQUIRE_EQ((int)out.size(), 2);
+        REQUIRE_EQ(out[0].id, std::string("1001"));
+        REQUIRE_EQ(out[1].ownerGang, 8);
+    });
+
+    t.run("buffer: stray CR ends the line content", [&] {
+        std::vector<Territory> out; std::string err;
+        REQUIRE(ParseText("1001,0,0,10,10\rgarbage\n", out, err));
+        REQUIRE_EQ((int)out.size(), 1);
+        REQUIRE_EQ(out[0].ownerGang, -1);
+    });
+
+    t.run("buffer: parse error message carries file line number", [&] {
+        REQUIRE_EQ(ParseErr("# c\n1001,0,0,10,10\n\n1002,0,0,bad,10\n"),
+                   std::string("Parse error line 4: Bad maxX"));
+    });
+
+    t.run("buffer: duplicate id message", [&] {
+        REQUIRE_EQ(ParseErr("1001,0,0,10,10\n1002,0,0,10,10\n1001,5,5,6,6\n"),
+                   std::string("Duplicate id '1001' at line 3"));
+    });
+
+    t.run("buffer: duplicate detected numerically", [&] {
+        REQUIRE_EQ(ParseErr("7,0,0,10,10\n007,0,0,10,10\n"),
+                   std::string("Duplicate id '007' at line 2"));
+    });
+
+    t.run("buffer: first problem in file order wins", [&] {
+        REQUIRE_EQ(ParseErr("1,0,0,1,1\n1,0,0,1,1\n2,x,0,1,1\n"),
+                   std::string("Duplicate id '1' at line 2"));
+        REQUIRE_EQ(ParseErr("1,0,0,1,1\n2,x,0,1,1\n1,0,0,1,1\n"),
+                   std::string("Parse error line 2: Bad minX"));
+    });
+
+    t.run("buffer: empty and comment-only files", [&] {
+        REQUIRE_EQ(ParseErr(""), std::string("No territories loaded"));
+        REQUIRE_EQ(ParseErr("# nothing\n\n"), std::string("No territories loaded"));
+    });
+
+    t.run("format: FormatLine reads back through ParseLine", [&] {
+        Territory a, b;
+        std::string err;
+        REQUIRE(LineOk("1234,-10.5,20,30,40.25,9,1,2", a, err));
+        std::string line;
+        FormatLine(a, line);
+        REQUIRE_EQ(line, std::string("1234,-10.500,20.000,30.000,40.250,9,0,2"));
+        REQUIRE(ParseLine(line.data(), line.data() + line.size(), b, err));
+        REQUIRE_EQ(b.numId, 1234u);
+        REQUIRE_EQ(b.maxY, 40.25f);
+        REQUIRE_EQ(b.defaultOwnerGang, 9);
+
+        REQUIRE(LineOk("5,0,0,1,1,-1,0,1,poly:0 0;10 0;0 10", a, err));
+        line.clear();
+        FormatLine(a, line);
+        REQUIRE_EQ(line, std::string("5,0.000,0.000,10.000,10.000,-1,0,1,poly:0.000 0.000;10.000 0.000;0.000 10.000"));
+        REQUIRE(ParseLine(line.data(), line.data() + line.size(), b, err));
+        REQUIRE(b.poly.SameShape(a.poly));
+
+        REQUIRE(LineOk("6,0,0,1,1,-1,0,1,poly:0 0;10 0;0 10,prio:4", a, err));
+        line.clear();
+        FormatLine(a, line);
+        REQUIRE_EQ(line, std::string("6,0.000,0.000,10.000,10.000,-1,0,1,prio:4,poly:0.000 0.000;10.000 0.000;0.000 10.000"));
+        REQUIRE(ParseLine(line.data(), line.data() + line.size(), b, err));
+        REQUIRE_EQ(b.priority, 4);
+    });
+
+    // ------------------------------------------------------------------
+    // Parallel path
+    // ------------------------------------------------------------------
+    t.run("parallel: identical result to serial parse", [&] {
+        const std::string text = MakeLargeFile(30000);
+        REQUIRE(text.size() >= kParallelThresholdBytes);
+
+        std::vector<Territory> serial, parallel;
+        std::string e1, e2;
+        REQUIRE(ParseText(text, serial, e1, 1));
+        REQUIRE(ParseText(text, parallel, e2, 4));
+        REQUIRE_EQ((int)serial.size(), 30000);
+        REQUIRE_EQ(serial.size(), parallel.size());
+
+        bool same = true;
+        for (size_t i = 0; i < serial.size(); ++i) {
+            same &= serial[i].numId == parallel[i].numId &&
+                    serial[i].minX == parallel[i].minX && serial[i].maxY == parallel[i].maxY &&
+                    serial[i].ownerGang == parallel[i].ownerGang &&
+                    serial[i].defenseLevel == parallel[i].defenseLevel;
+        }
+        REQUIRE(same);
+    });
+
+    t.run("parallel: error line number in a late chunk", [&] {
+        std::string text = MakeLargeFile(30000);
+        const size_t pos = text.find("\n129000,") + 1;
+        text.replace(pos, 6, "12x900");
+        const int line = CountLinesBefore(text, pos);
+
+        char expected[128];
+        std::snprintf(expected, sizeof(expected), "Parse error line %d: Id must be numeric (e.g. 1001)", line);
+        REQUIRE_EQ(ParseErr(text, 1), std::string(expected));
+        REQUIRE_EQ(ParseErr(text, 8), std::string(expected));
+    });
+
+    t.run("parallel: duplicate across chunks", [&] {
+        std::string text = MakeLargeFile(30000);
+        text += "100005,0,0,1,1\n";
+        const int line = CountLinesBefore(text, text.size() - 1);
+
+        char expected[128];
+        std::snprintf(expected, sizeof(expected), "Duplicate id '100005' at line %d", line);
+        REQUIRE_EQ(ParseErr(text, 1), std::string(expected));
+        REQUIRE_EQ(ParseErr(text, 8), std::string(expected));
+    });
+}
@@ -0,0 +1,333 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryGrid.h"
+
+#include <cmath>
+#include <cstdlib>
+
+// Helpers
+static Territory MakeRect(float minX, float minY, float maxX, float maxY) {
+    Territory t;
+    t.minX = minX; t.minY = minY;
+    t.maxX = maxX; t.maxY = maxY;
+    return t;
+}
+
+static float RandIn(float a, float b) {
+    return a + (b - a) * ((float)std::rand() / (float)RAND_MAX);
+}
+
+// Random overlapping layout in roughly GTA III world coordinates.
+static std::vector<Territory> MakeRandomLayout(int count, unsigned int seed) {
+    std::srand(seed);
+    std::vector<Territory> out;
+    out.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const float x = RandIn(-1500.f, 1500.f);
+        const float y = RandIn(-1500.f, 1500.f);
+        out.push_back(MakeRect(x, y, x + RandIn(2.f, 250.f), y + RandIn(2.f, 250.f)));
+    }
+    return out;
+}
+
+// Reference implementations: the linear scans TerritorySystem used before the grid.
+static int LinearPoint(const std::vector<Territory>& terrs, float x, float y) {
+    for (int i = 0; i < (int)terrs.size(); ++i)
+        if (terrs[i].ContainsPoint(CVector(x, y, 0.f))) return i;
+    return -1;
+}
+
+static int LinearNearest(const std::vector<Territory>& terrs, float x, float y) {
+    int best = -1;
+    float bestD2 = 0.f;
+    for (int i = 0; i < (int)terrs.size(); ++i) {
+        const float dx = x - (terrs[i].minX + terrs[i].maxX) * 0.5f;
+        const float dy = y - (terrs[i].minY + terrs[i].maxY) * 0.5f;
+        const float d2 = dx * dx + dy * dy;
+        if (best < 0 || d2 < bestD2) { best = i; bestD2 = d2; }
+    }
+    return best;
+}
+
+static std::vector<int> LinearRect(const std::vector<Territory>& terrs,
+    float minX, float minY, float maxX, float maxY)
+{
+    std::vector<int> out;
+    for (int i = 0; i < (int)terrs.size(); ++i) {
+        const auto& t = terrs[i];
+        if (t.minX <= maxX && t.maxX >= minX && t.minY <= maxY && t.maxY >= minY) out.push_back(i);
+    }
+    return out;
+}
+
+void RunTerritoryGridTests(Test::Runner& t) {
+    t.suite("TerritoryGrid");
+
+    // ------------------------------------------------------------------
+    // Empty / trivial
+    // ------------------------------------------------------------------
+    t.run("empty: all queries miss", [&] {
+        TerritoryGrid g;
+        g.Build({});
+        std::vector<int> hits;
+        g.QueryRect(-10.f, -10.f, 10.f, 10.f, hits);
+        REQUIRE(g.IsEmpty());
+        REQUIRE_EQ(g.QueryPoint(0.f, 0.f), -1);
+        REQUIRE_EQ(g.QueryNearest(0.f, 0.f), -1);
+        REQUIRE(hits.empty());
+    });
+
+    t.run("single rect: inside, outside and edges", [&] {
+        TerritoryGrid g;
+        g.Build({ MakeRect(10.f, 10.f, 90.f, 90.f) });
+        REQUIRE_EQ(g.QueryPoint(50.f, 50.f), 0);
+        REQUIRE_EQ(g.QueryPoint(10.f, 50.f), 0);
+        REQUIRE_EQ(g.QueryPoint(90.f, 90.f), 0);
+        REQUIRE_EQ(g.QueryPoint(9.9f, 50.f), -1);
+        REQUIRE_EQ(g.QueryPoint(50.f, 90.1f), -1);
+    });
+
+    t.run("zero-size rect is still found", [&] {
+        TerritoryGrid g;
+        g.Build({ MakeRect(5.f, 5.f, 5.f, 5.f) });
+        REQUIRE_EQ(g.QueryPoint(5.f, 5.f), 0);
+        REQUIRE_EQ(g.QueryNearest(1000.f, -1000.f), 0);
+    });
+
+    // ------------------------------------------------------------------
+    // Ordering semantics
+    // ------------------------------------------------------------------
+    t.run("overlap: lowest index wins like the linear scan", [&] {
+        TerritoryGrid g;
+        std::vector<Territory> terrs = {
+            MakeRect(0.f, 0.f, 100.f, 100.f),
+            MakeRect(50.f, 50.f, 150.f, 150.f),
+        };
+        g.Build(terrs);
+        REQUIRE_EQ(g.QueryPoint(75.f, 75.f), 0);
+        REQUIRE_EQ(g.QueryPoint(125.f, 125.f), 1);
+    });
+
+    t.run("from: next hit after an index, in index order", [&] {
+        TerritoryGrid g;
+        std::vector<Territory> terrs = {
+            MakeRect(0.f, 0.f, 100.f, 100.f),
+            MakeRect(500.f, 500.f, 600.f, 600.f),
+            MakeRect(50.f, 50.f, 150.f, 150.f),
+            MakeRect(-20.f, -20.f, 80.f, 80.f),
+        };
+        g.Build(terrs);
+        REQUIRE_EQ(g.QueryPoint(75.f, 75.f, 0), 0);
+        REQUIRE_EQ(g.QueryPoint(75.f, 75.f, 1), 2);
+        REQUIRE_EQ(g.QueryPoint(75.f, 75.f, 3), 3);
+        REQUIRE_EQ(g.QueryPoint(75.f, 75.f, 4), -1);
+    });
+
+    t.run("nearest: equal distance resolves to lowest index", [&] {
+        TerritoryGrid g;
+        g.Build({ MakeRect(-20.f, -5.f, -10.f, 5.f), MakeRect(10.f, -5.f, 20.f, 5.f) });
+        REQUIRE_EQ(g.QueryNearest(0.f, 0.f), 0);
+    });
+
+    t.run("nearest: query far outside the grid", [&] {
+        TerritoryGrid g;
+        g.Build({ MakeRect(0.f, 0.f, 10.f, 10.f), MakeRect(500.f, 500.f, 510.f, 510.f) });
+        REQUIRE_EQ(g.QueryNearest(-5000.f, -5000.f), 0);
+        REQUIRE_EQ(g.QueryNearest(9000.f, 9000.f), 1);
+    });
+
+    t.run("rect: spanning rect reported once", [&] {
+        TerritoryGrid g;
+        std::vector<Territory> terrs = MakeRandomLayout(200, 7u);
+        terrs.push_back(MakeRect(-1500.f, -1500.f, 1500.f, 1500.f));
+        g.Build(terrs);
+        std::vector<int> hits;
+        g.QueryRect(-1000.f, -1000.f, 1000.f, 1000.f, hits);
+        REQUIRE(hits == LinearRect(terrs, -1000.f, -1000.f, 1000.f, 1000.f));
+    });
+
+    t.run("NaN query misses instead of crashing", [&] {
+        TerritoryGrid g;
+        g.Build({ MakeRect(0.f, 0.f, 10.f, 10.f) });
+        const float nan = std::nanf("");
+        REQUIRE_EQ(g.QueryPoint(nan, 5.f), -1);
+    });
+
+    // ------------------------------------------------------------------
+    // Randomized equivalence against the linear scans
+    // ------------------------------------------------------------------
+    t.run("random: point queries match linear scan", [&] {
+        const auto terrs = MakeRandomLayout(1500, 1234u);
+        TerritoryGrid g;
+        g.Build(terrs);
+        for (int i = 0; i < 4000; ++i) {
+            const float x = RandIn(-1700.f, 1900.f);
+            const float y = RandIn(-1700.f, 1900.f);
+            REQUIRE_EQ(g.QueryPoint(x, y), LinearPoint(terrs, x, y));
+        }
+    });
+
+    t.run("random: points exactly on rect edges match linear scan", [&] {
+        const auto terrs = MakeRandomLayout(500, 99u);
+        TerritoryGrid g;
+        g.Build(terrs);
+        for (const auto& r : terrs) {
+            REQUIRE_EQ(g.QueryPoint(r.minX, r.minY), LinearPoint(terrs, r.minX, r.minY));
+            REQUIRE_EQ(g.QueryPoint(r.maxX, r.maxY), LinearPoint(terrs, r.maxX, r.maxY));
+            REQUIRE_EQ(g.QueryPoint(r.maxX, r.minY), LinearPoint(terrs, r.maxX, r.minY));
+        }
+    });
+
+    t.run("random: nearest queries match linear scan", [&] {
+        const auto terrs = MakeRandomLayout(1000, 4321u);
+        TerritoryGrid g;
+        g.Build(terrs);
+        for (int i = 0; i < 2000; ++i) {
+            const float x = RandIn(-2500.f, 2500.f);
+            const float y = RandIn(-2500.f, 2500.f);
+            REQUIRE_EQ(g.QueryNearest(x, y), LinearNearest(terrs, x, y));
+        }
+    });
+
+    t.run("random: rect queries match linear scan", [&] {
+        const auto terrs = MakeRandomLayout(800, 555u);
+        TerritoryGrid g;
+        g.Build(terrs);
+        std::vector<int> hits;
+        for (int i = 0; i < 500; ++i) {
+            const float x = RandIn(-1600.f, 1600.f);
+            const float y = RandIn(-1600.f, 1600.f);
+            const float w = RandIn(0.f, 400.f);
+            const float h = RandIn(0.f, 400.f);
+            g.QueryRect(x, y, x + w, y + h, hits);
+            REQUIRE(hits == LinearRect(terrs, x, y, x + w, y + h));
+        }
+    });
+
+    t.run("subset: only listed indices answer, with their original index", [&] {
+        const auto terrs = MakeRandomLayout(1200, 777u);
+        std::vector<int> subset;
+        std::vector<Territory> only;
+        for (int i = 0; i < (int)terrs.size(); i += 3) {
+            subset.push_back(i);
+            only.push_back(terrs[i]);
+        }
+        TerritoryGrid g;
+        g.Build(terrs, subset);
+        REQUIRE_EQ(g.Count(), (int)subset.size());
+        for (int i = 0; i < 3000; ++i) {
+            const float x = RandIn(-1700.f, 1900.f);
+            const float y = RandIn(-1700.f, 1900.f);
+            const int k = LinearPoint(only, x, y);
+            REQUIRE_EQ(g.QueryPoint(x, y), k < 0 ? -1 : subset[k]);
+            if (k >= 0) {
+                const int next = g.QueryPoint(x, y, subset[k] + 1);
+                REQUIRE(next < 0 || next % 3 == 0);
+            }
+        }
+
+        g.Build(terrs, std::vector<int>());
+        REQUIRE(g.IsEmpty());
+    });
+
+    t.run("rebuild: reflects removed territory", [&] {
+        std::vector<Territory> terrs = {
+            MakeRect(0.f, 0.f, 10.f, 10.f),
+            MakeRect(20.f, 0.f, 30.f, 10.f),
+        };
+        TerritoryGrid g;
+        g.Build(terrs);
+        REQUIRE_EQ(g.QueryPoint(25.f, 5.f), 1);
+        terrs.erase(terrs.begin());
+        g.Build(terrs);
+        REQUIRE_EQ(g.QueryPoint(25.f, 5.f), 0);
+        REQUIRE_EQ(g.QueryPoint(5.f, 5.f), -1);
+    });
+
+    // ------------------------------------------------------------------
+    // Incremental edits (hot reload)
+    // ------------------------------------------------------------------
+    auto sameAsLinear = [](const TerritoryGrid& g, const std::vector<Territory>& terrs, unsigned int seed) {
+        std::srand(seed);
+        bool same = true;
+        for (int i = 0; i < 2000; ++i) {
+            const float x = RandIn(-1700.f, 1700.f);
+            const float y = RandIn(-1700.f, 1700.f);
+            same &= g.QueryPoint(x, y) == LinearPoint(terrs, x, y);
+            same &= g.QueryNearest(x, y) == LinearNearest(terrs, x, y);
+            if ((i & 15) == 0) {
+                std::vector<int> hits;
+                g.QueryRect(x, y, x + 300.f, y + 200.f, hits);
+                same &= hits == LinearRect(terrs, x, y, x + 300.f, y + 200.f);
+            }
+        }
+        return same;
+    };
+
+    t.run("update: small nudge within the same cells", [&] {
+        auto terrs = MakeRandomLayout(400, 31u);
+        TerritoryGrid g;
+        g.Build(terrs);
+        const Territory before = terrs[17];
+        terrs[17].maxX -= 0.5f;
+        REQUIRE(g.Update(17, before, terrs[17]));
+        REQUIRE(sameAsLinear(g, terrs, 5u));
+    });
+
+    t.run("update: rect moved across the map", [&] {
+        auto terrs = MakeRandomLayout(400, 32u);
+        TerritoryGrid g;
+        g.Build(terrs);
+        for (int i : { 0, 150, 399 }) {
+            const Territory before = terrs[i];
+            terrs[i] = MakeRect(-1400.f + i, 1200.f, -1100.f + i, 1300.f);
+            REQUIRE(g.Update(i, before, terrs[i]));
+        }
+        REQUIRE_EQ(g.Count(), 400);
+        REQUIRE(sameAsLinear(g, terrs, 6u));
+    });
+
+    t.run("update/append: outside the extents is refused", [&] {
+        std::vector<Territory> terrs = { MakeRect(0.f, 0.f, 10.f, 10.f), MakeRect(20.f, 0.f, 30.f, 10.f) };
+        TerritoryGrid g;
+        g.Build(terrs);
+        REQUIRE_FALSE(g.Update(0, terrs[0], MakeRect(-5.f, 0.f, 10.f, 10.f)));
+        REQUIRE_FALSE(g.Append(MakeRect(0.f, 0.f, 10.f, 50.f)));
+        REQUIRE_EQ(g.QueryPoint(5.f, 5.f), 0);
+        REQUIRE_EQ(g.Count(), 2);
+    });
+
+    t.run("erase: later indices shift down", [&] {
+        auto terrs = MakeRandomLayout(300, 33u);
+        TerritoryGrid g;
+        g.Build(terrs);
+        for (int i : { 299, 0, 120 }) {
+            terrs.erase(terrs.begin() + i);
+            g.Erase(i);
+        }
+        REQUIRE_EQ(g.Count(), 297);
+        REQUIRE(sameAsLinear(g, terrs, 7u));
+    });
+
+    t.run("append: new rect gets the next index", [&] {
+        auto terrs = MakeRandomLayout(300, 34u);
+        TerritoryGrid g;
+        g.Build(terrs);
+        // Inside the built extents and overlapping existing rects.
+        const Territory added = MakeRect(terrs[3].minX, terrs[3].minY, terrs[3].maxX, terrs[3].maxY);
+        REQUIRE(g.Append(added));
+        terrs.push_back(added);
+        REQUIRE_EQ(g.Count(), 301);
+        REQUIRE(sameAsLinear(g, terrs, 8u));
+        REQUIRE_EQ(g.QueryPoint(added.minX, added.minY), LinearPoint(terrs, added.minX, added.minY));
+    });
+
+    t.run("erase: last territory empties the grid", [&] {
+        std::vector<Territory> terrs = { MakeRect(0.f, 0.f, 10.f, 10.f) };
+        TerritoryGrid g;
+        g.Build(terrs);
+        g.Erase(0);
+        REQUIRE(g.IsEmpty());
+        REQUIRE_EQ(g.QueryPoint(5.f, 5.f), -1);
+    });
+}
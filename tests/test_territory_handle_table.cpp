@@ -0,0 +1,153 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryHandleTable.h"
+
+// Helpers
+static Territory MakeWithId(unsigned int id) {
+    Territory t;
+    t.numId = id;
+    return t;
+}
+
+static std::vector<Territory> MakeIds(std::initializer_list<unsigned int> ids) {
+    std::vector<Territory> out;
+    for (unsigned int id : ids) out.push_back(MakeWithId(id));
+    return out;
+}
+
+void RunTerritoryHandleTableTests(Test::Runner& t) {
+    t.suite("TerritoryHandleTable");
+
+    t.run("default handle is invalid and resolves to -1", [&] {
+        TerritoryHandleTable table;
+        table.Sync(MakeIds({ 1001u }));
+        TerritoryHandle h;
+        REQUIRE_FALSE(h.IsValid());
+        REQUIRE_EQ(table.IndexOf(h), -1);
+    });
+
+    t.run("sync: handles resolve to vector index", [&] {
+        TerritoryHandleTable table;
+        table.Sync(MakeIds({ 1001u, 1002u, 1003u }));
+        for (int i = 0; i < 3; ++i) {
+            const TerritoryHandle h = table.HandleAt(i);
+            REQUIRE(h.IsValid());
+            REQUIRE_EQ(table.IndexOf(h), i);
+        }
+        REQUIRE(table.HandleForId(1002u) == table.HandleAt(1));
+        REQUIRE_FALSE(table.HandleForId(9999u).IsValid());
+        REQUIRE_FALSE(table.HandleAt(3).IsValid());
+    });
+
+    t.run("reload with reordered list: handle follows the id", [&] {
+        TerritoryHandleTable table;
+        table.Sync(MakeIds({ 1001u, 1002u, 1003u }));
+        const TerritoryHandle h = table.HandleForId(1003u);
+        table.Sync(MakeIds({ 1003u, 1001u, 1002u }));
+        REQUIRE_EQ(table.IndexOf(h), 0);
+        REQUIRE(table.HandleForId(1003u) == h);
+    });
+
+    t.run("erase before: handle index shifts down", [&] {
+        TerritoryHandleTable table;
+        table.Sync(MakeIds({ 1001u, 1002u, 1003u }));
+        const TerritoryHandle h = table.HandleAt(2);
+        table.Sync(MakeIds({ 1002u, 1003u }));
+        REQUIRE_EQ(table.IndexOf(h), 1);
+    });
+
+    t.run("push_back: existing handles unaffected", [&] {
+        TerritoryHandleTable table;
+        table.Sync(MakeIds({ 1001u, 1002u }));
+        const TerritoryHandle a = table.HandleAt(0);
+        const TerritoryHandle b = table.HandleAt(1);
+        table.Sync(MakeIds({ 1001u, 1002u, 1003u }));
+        REQUIRE_EQ(table.IndexOf(a), 0);
+        REQUIRE_EQ(table.IndexOf(b), 1);
+        REQUIRE_EQ(table.IndexOf(table.HandleForId(1003u)), 2);
+    });
+
+    t.run("removed id: handle goes stale", [&] {
+        TerritoryHandleTable table;
+        table.Sync(MakeIds({ 1001u, 1002u }));
+        const TerritoryHandle h = table.HandleForId(1001u);
+        table.Sync(MakeIds({ 1002u }));
+        REQUIRE_EQ(table.IndexOf(h), -1);
+        REQUIRE_FALSE(table.HandleForId(1001u).IsValid());
+    });
+
+    t.run("reused slot does not alias the old handle", [&] {
+        TerritoryHandleTable table;
+        table.Sync(MakeIds({ 1001u }));
+        const TerritoryHandle old = table.HandleForId(1001u);
+        table.Sync(MakeIds({ 2002u }));
+        const TerritoryHandle now = table.HandleForId(2002u);
+        REQUIRE_EQ(now.slot, old.slot); // freed slot is recycled…
+        REQUIRE(now != old);            // …under a new generation
+        REQUIRE_EQ(table.IndexOf(old), -1);
+        REQUIRE_EQ(table.IndexOf(now), 0);
+    });
+
+    t.run("id removed then re-added gets a fresh generation", [&] {
+        TerritoryHandleTable table;
+        table.Sync(MakeIds({ 1001u }));
+        const TerritoryHandle old = table.HandleForId(1001u);
+        table.Sync({});
+        table.Sync(MakeIds({ 1001u }));
+        REQUIRE_EQ(table.IndexOf(old), -1);
+        REQUIRE_EQ(table.IndexOf(table.HandleForId(1001u)), 0);
+    });
+
+    t.run("clear: old handles never come back", [&] {
+        TerritoryHandleTable table;
+        table.Sync(MakeIds({ 1001u, 1002u }));
+        const TerritoryHandle h = table.HandleForId(1002u);
+        table.Clear();
+        REQUIRE_EQ(table.IndexOf(h), -1);
+        table.Sync(MakeIds({ 1001u, 1002u }));
+        REQUIRE_EQ(table.IndexOf(h), -1);
+    });
+
+    t.run("repeated add/remove edits keep slot count bounded", [&] {
+        TerritoryHandleTable table;
+        for (unsigned int i = 0; i < 200; ++i) {
+            table.Sync(MakeIds({ 1u, 2u, 100u + i }));
+        }
+        REQUIRE(table.SlotCount() <= 4);
+    });
+
+    t.run("duplicate ids: both indices get handles, id finds the first", [&] {
+        TerritoryHandleTable table;
+        table.Sync(MakeIds({ 7u, 7u }));
+        const TerritoryHandle a = table.HandleAt(0);
+        const TerritoryHandle b = table.HandleAt(1);
+        REQUIRE(a.IsValid());
+        REQUIRE(b.IsValid());
+        REQUIRE(a != b);
+        REQUIRE_EQ(table.IndexOf(b), 1);
+        REQUIRE(table.HandleForId(7u) == a);
+    });
+
+    t.run("large reload keeps every surviving handle", [&] {
+        std::vector<Territory> terrs;
+        for (unsigned int i = 0; i < 5000; ++i) terrs.push_back(MakeWithId(1001u + i));
+        TerritoryHandleTable table;
+        table.Sync(terrs);
+
+        std::vector<TerritoryHandle> handles;
+        for (int i = 0; i < 5000; ++i) handles.push_back(table.HandleAt(i));
+
+        // Drop every third territory and reverse the rest.
+        std::vector<Territory> next;
+        for (int i = 4999; i >= 0; --i) if (i % 3 != 0) next.push_back(terrs[i]);
+        table.Sync(next);
+
+        bool ok = true;
+        for (int i = 0; i < 5000; ++i) {
+            const int idx = table.IndexOf(handles[i]);
+            if (i % 3 == 0) ok &= (idx == -1);
+            else ok &= (idx >= 0 && next[idx].numId == terrs[i].numId);
+        }
+        REQUIRE(ok);
+    });
+}
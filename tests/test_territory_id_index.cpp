@@ -0,0 +1,137 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryIdIndex.h"
+
+#include <cstring>
+
+// Helpers
+static Territory MakeWithId(unsigned int id) {
+    Territory t;
+    t.numId = id;
+    return t;
+}
+
+static bool Parse(const char* s, unsigned int& out) {
+    return ParseTerritoryId(s, std::strlen(s), out);
+}
+
+void RunTerritoryIdIndexTests(Test::Runner& t) {
+    t.suite("TerritoryIdIndex");
+
+    // ------------------------------------------------------------------
+    // ParseTerritoryId
+    // ------------------------------------------------------------------
+    t.run("parse: plain numeric id", [&] {
+        unsigned int id = 0;
+        REQUIRE(Parse("1001", id));
+        REQUIRE_EQ(id, 1001u);
+    });
+
+    t.run("parse: leading zeros collapse to the same value", [&] {
+        unsigned int a = 0, b = 0;
+        REQUIRE(Parse("007", a));
+        REQUIRE(Parse("7", b));
+        REQUIRE_EQ(a, b);
+    });
+
+    t.run("parse: uint32 max accepted, one past rejected", [&] {
+        unsigned int id = 0;
+        REQUIRE(Parse("4294967295", id));
+        REQUIRE_EQ(id, 4294967295u);
+        REQUIRE_FALSE(Parse("4294967296", id));
+        REQUIRE_FALSE(Parse("99999999999999999999", id));
+    });
+
+    t.run("parse: empty, sign and non-digits rejected", [&] {
+        unsigned int id = 123;
+        REQUIRE_FALSE(Parse("", id));
+        REQUIRE_FALSE(Parse("-1", id));
+        REQUIRE_FALSE(Parse("+1", id));
+        REQUIRE_FALSE(Parse("10a", id));
+        REQUIRE_FALSE(Parse(" 10", id));
+        REQUIRE_EQ(id, 123u); // untouched on failure
+    });
+
+    t.run("parse: respects length, not NUL", [&] {
+        unsigned int id = 0;
+        REQUIRE(ParseTerritoryId("1234xyz", 4, id));
+        REQUIRE_EQ(id, 1234u);
+    });
+
+    // ------------------------------------------------------------------
+    // Table
+    // ------------------------------------------------------------------
+    t.run("empty: find misses", [&] {
+        TerritoryIdIndex idx;
+        REQUIRE_EQ(idx.Find(1001u), -1);
+        idx.Build({});
+        REQUIRE_EQ(idx.Find(1001u), -1);
+        REQUIRE_EQ(idx.Count(), 0);
+    });
+
+    t.run("build: maps id to vector index", [&] {
+        TerritoryIdIndex idx;
+        idx.Build({ MakeWithId(1001u), MakeWithId(1005u), MakeWithId(1002u) });
+        REQUIRE_EQ(idx.Count(), 3);
+        REQUIRE_EQ(idx.Find(1001u), 0);
+        REQUIRE_EQ(idx.Find(1005u), 1);
+        REQUIRE_EQ(idx.Find(1002u), 2);
+        REQUIRE_EQ(idx.Find(1003u), -1);
+    });
+
+    t.run("id 0 is a normal key", [&] {
+        TerritoryIdIndex idx;
+        idx.Build({ MakeWithId(5u), MakeWithId(0u) });
+        REQUIRE_EQ(idx.Find(0u), 1);
+    });
+
+    t.run("duplicate id: first one wins", [&] {
+        TerritoryIdIndex idx;
+        idx.Build({ MakeWithId(42u), MakeWithId(42u) });
+        REQUIRE_EQ(idx.Count(), 1);
+        REQUIRE_EQ(idx.Find(42u), 0);
+        REQUIRE_FALSE(idx.Insert(42u, 7));
+        REQUIRE_EQ(idx.Find(42u), 0);
+    });
+
+    t.run("insert: grows past initial capacity", [&] {
+        TerritoryIdIndex idx;
+        for (int i = 0; i < 1000; ++i) REQUIRE(idx.Insert(1000u + (unsigned int)i * 7u, i));
+        REQUIRE_EQ(idx.Count(), 1000);
+        for (int i = 0; i < 1000; ++i) REQUIRE_EQ(idx.Find(1000u + (unsigned int)i * 7u), i);
+        REQUIRE_EQ(idx.Find(999u), -1);
+    });
+
+    t.run("build: large sequential id range", [&] {
+        std::vector<Territory> terrs;
+        for (unsigned int i = 0; i < 20000; ++i) terrs.push_back(MakeWithId(1001u + i));
+        TerritoryIdIndex idx;
+        idx.Build(terrs);
+        bool allFound = true;
+        for (int i = 0; i < 20000; ++i) allFound &= (idx.Find(1001u + (unsigned int)i) == i);
+        REQUIRE(allFound);
+        REQUIRE_EQ(idx.Find(1000u), -1);
+        REQUIRE_EQ(idx.Find(21001u), -1);
+    });
+
+    t.run("rebuild: reflects removed territory", [&] {
+        std::vector<Territory> terrs = { MakeWithId(1u), MakeWithId(2u), MakeWithId(3u) };
+        TerritoryIdIndex idx;
+        idx.Build(terrs);
+        terrs.erase(terrs.begin());
+        idx.Build(terrs);
+        REQUIRE_EQ(idx.Find(1u), -1);
+        REQUIRE_EQ(idx.Find(2u), 0);
+        REQUIRE_EQ(idx.Find(3u), 1);
+    });
+
+    t.run("clear: empties the table", [&] {
+        TerritoryIdIndex idx;
+        idx.Build({ MakeWithId(9u) });
+        idx.Clear();
+        REQUIRE_EQ(idx.Count(), 0);
+        REQUIRE_EQ(idx.Find(9u), -1);
+        REQUIRE(idx.Insert(9u, 0));
+        REQUIRE_EQ(idx.Find(9u), 0);
+    });
+}
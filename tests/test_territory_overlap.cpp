@@ -0,0 +1,209 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryOverlap.h"
+#include "../source/TerritoryFileParser.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using TerritoryOverlap::Pair;
+
+// Helpers
+static Territory MakeRect(unsigned int id, float minX, float minY, float maxX, float maxY, int prio = 0) {
+    Territory t;
+    t.numId = id;
+    t.id = std::to_string(id);
+    t.minX = minX; t.minY = minY;
+    t.maxX = maxX; t.maxY = maxY;
+    t.priority = prio;
+    return t;
+}
+
+static Territory MakePoly(unsigned int id, std::initializer_list<float> xy) {
+    Territory t;
+    t.numId = id;
+    t.id = std::to_string(id);
+    std::string err;
+    t.poly.Build(xy.begin(), (int)xy.size() / 2, err);
+    t.minX = t.poly.MinX(); t.minY = t.poly.MinY();
+    t.maxX = t.poly.MaxX(); t.maxY = t.poly.MaxY();
+    return t;
+}
+
+static std::vector<Pair> FindPairs(const std::vector<Territory>& terrs) {
+    std::vector<Pair> out;
+    TerritoryOverlap::Find(terrs, out);
+    return out;
+}
+
+static std::vector<Pair> BruteForce(const std::vector<Territory>& terrs) {
+    std::vector<Pair> out;
+    for (int i = 0; i < (int)terrs.size(); ++i) {
+        for (int j = i + 1; j < (int)terrs.size(); ++j) {
+            const Territory& a = terrs[i];
+            const Territory& b = terrs[j];
+            if (a.minX < b.maxX && b.minX < a.maxX && a.minY < b.maxY && b.minY < a.maxY &&
+                TerritoryOverlap::ShapesOverlap(a, b)) {
+                out.push_back(Pair{ i, j });
+            }
+        }
+    }
+    return out;
+}
+
+static bool SamePairs(const std::vector<Pair>& x, const std::vector<Pair>& y) {
+    if (x.size() != y.size()) return false;
+    for (size_t k = 0; k < x.size(); ++k) {
+        if (x[k].a != y[k].a || x[k].b != y[k].b) return false;
+    }
+    return true;
+}
+
+void RunTerritoryOverlapTests(Test::Runner& t) {
+    t.suite("TerritoryOverlap");
+
+    // ------------------------------------------------------------------
+    // Rects
+    // ------------------------------------------------------------------
+    t.run("rects: overlapping pairs are reported once, sorted", [] {
+        std::vector<Territory> terrs = {
+            MakeRect(1001, 0, 0, 10, 10),
+            MakeRect(1002, 5, 5, 15, 15),
+            MakeRect(1003, 100, 100, 110, 110),
+            MakeRect(1004, -5, 8, 8, 20),
+        };
+        const auto pairs = FindPairs(terrs);
+        REQUIRE_EQ((int)pairs.size(), 3);
+        REQUIRE_EQ(pairs[0].a, 0); REQUIRE_EQ(pairs[0].b, 1);
+        REQUIRE_EQ(pairs[1].a, 0); REQUIRE_EQ(pairs[1].b, 3);
+        REQUIRE_EQ(pairs[2].a, 1); REQUIRE_EQ(pairs[2].b, 3);
+    });
+
+    t.run("rects: shared edges and corners are not overlaps", [] {
+        std::vector<Territory> terrs = {
+            MakeRect(1001, 0, 0, 10, 10),
+            MakeRect(1002, 10, 0, 20, 10),  // right edge
+            MakeRect(1003, 0, 10, 10, 20),  // top edge
+            MakeRect(1004, 10, 10, 20, 20), // corner
+        };
+        REQUIRE(FindPairs(terrs).empty());
+    });
+
+    t.run("rects: containment and identical rects overlap", [] {
+        std::vector<Territory> terrs = {
+            MakeRect(1001, 0, 0, 100, 100),
+            MakeRect(1002, 40, 40, 60, 60),
+            MakeRect(1003, 0, 0, 100, 100),
+        };
+        REQUIRE_EQ((int)FindPairs(terrs).size(), 3);
+    });
+
+    t.run("rects: a long strip crossing many bucket rows", [] {
+        // One tall rect spans every y bucket the small ones make; the pair
+        // must still come out exactly once each.
+        std::vector<Territory> terrs;
+        for (int i = 0; i < 20; ++i) terrs.push_back(MakeRect(1001 + i, 0, i * 10.0f, 10, i * 10.0f + 10));
+        terrs.push_back(MakeRect(2000, 5, -5, 6, 205));
+        const auto pairs = FindPairs(terrs);
+        REQUIRE_EQ((int)pairs.size(), 20);
+        REQUIRE(SamePairs(pairs, BruteForce(terrs)));
+    });
+
+    t.run("empty and single-territory lists have no pairs", [] {
+        REQUIRE(FindPairs({}).empty());
+        REQUIRE(FindPairs({ MakeRect(1001, 0, 0, 1, 1) }).empty());
+    });
+
+    // ------------------------------------------------------------------
+    // Outlines
+    // ------------------------------------------------------------------
+    t.run("outlines: two triangles splitting a square do not overlap", [] {
+        std::vector<Territory> terrs = {
+            MakePoly(1001, { 0, 0, 10, 0, 10, 10 }),
+            MakePoly(1002, { 0, 0, 10, 10, 0, 10 }),
+        };
+        REQUIRE(FindPairs(terrs).empty());
+    });
+
+    t.run("outlines: boxes overlap but shapes do not", [] {
+        // An L and a rect tucked into its notch.
+        std::vector<Territory> terrs = {
+            MakePoly(1001, { 0, 0, 20, 0, 20, 10, 10, 10, 10, 20, 0, 20 }),
+            MakeRect(1002, 10, 10, 20, 20),
+        };
+        REQUIRE(FindPairs(terrs).empty());
+
+        terrs[1] = MakeRect(1002, 9, 9, 20, 20);
+        REQUIRE_EQ((int)FindPairs(terrs).size(), 1);
+    });
+
+    t.run("outlines: concave against concave", [] {
+        // Two interlocking combs: boxes overlap entirely, teeth never touch.
+        std::vector<Territory> terrs = {
+            MakePoly(1001, { 0, 0, 30, 0, 30, 4, 20, 4, 20, 10, 10, 10, 10, 4, 0, 4 }),
+            MakePoly(1002, { 0, 5, 10, 5, 10, 10, 20, 10, 20, 5, 30, 5, 30, 14, 0, 14 }),
+        };
+        REQUIRE_FALSE(TerritoryOverlap::ShapesOverlap(terrs[0], terrs[1]));
+
+        terrs[1] = MakePoly(1002, { 0, 3, 30, 3, 30, 14, 0, 14 });
+        REQUIRE(TerritoryOverlap::ShapesOverlap(terrs[0], terrs[1]));
+    });
+
+    // ------------------------------------------------------------------
+    // Against brute force
+    // ------------------------------------------------------------------
+    t.run("random worlds match the all-pairs check", [] {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> size(1.0f, 80.0f);
+        for (int world = 0; world < 8; ++world) {
+            std::vector<Territory> terrs;
+            for (int i = 0; i < 300; ++i) {
+                const float x = pos(rng), y = pos(rng);
+                // Snap some to a 10-unit lattice so shared edges are common.
+                if (i % 3 == 0) {
+                    const float sx = std::floor(x / 10) * 10, sy = std::floor(y / 10) * 10;
+                    terrs.push_back(MakeRect(1001 + i, sx, sy, sx + 10 * (1 + i % 4), sy + 10));
+                } else {
+                    terrs.push_back(MakeRect(1001 + i, x, y, x + size(rng), y + size(rng) * (world + 1) * 0.5f));
+                }
+            }
+            REQUIRE(SamePairs(FindPairs(terrs), BruteForce(terrs)));
+        }
+    });
+
+    // ------------------------------------------------------------------
+    // Precedence
+    // ------------------------------------------------------------------
+    t.run("precedence: higher priority, then lower id", [] {
+        const Territory a = MakeRect(1005, 0, 0, 1, 1, 2);
+        const Territory b = MakeRect(1001, 0, 0, 1, 1, 1);
+        const Territory c = MakeRect(1002, 0, 0, 1, 1, 1);
+        REQUIRE(TerritoryOverlap::TakesPrecedence(a, b));
+        REQUIRE_FALSE(TerritoryOverlap::TakesPrecedence(b, a));
+        REQUIRE(TerritoryOverlap::TakesPrecedence(b, c));
+        REQUIRE_FALSE(TerritoryOverlap::TakesPrecedence(c, b));
+    });
+
+    t.run("flags: every territory in a pair is marked", [] {
+        std::vector<unsigned char> flags;
+        TerritoryOverlap::MarkOverlapping(5, { Pair{ 0, 3 }, Pair{ 3, 4 } }, flags);
+        REQUIRE_EQ((int)flags.size(), 5);
+        REQUIRE(flags[0] && flags[3] && flags[4]);
+        REQUIRE_FALSE(flags[1] || flags[2]);
+    });
+
+    // ------------------------------------------------------------------
+    // Line numbers
+    // ------------------------------------------------------------------
+    t.run("id lines: 1-based, comments and blanks counted, sorted by id", [] {
+        const char* text = "# header\n1003,0,0,1,1\n\n1001,0,0,1,1\r\nbad,0,0,1,1\n 1002 ,0,0,1,1";
+        std::vector<TerritoryFileParser::IdLine> lines;
+        TerritoryFileParser::ScanIdLines(text, std::strlen(text), lines);
+        REQUIRE_EQ((int)lines.size(), 3);
+        REQUIRE_EQ(lines[0].numId, 1001u); REQUIRE_EQ(lines[0].line, 4);
+        REQUIRE_EQ(lines[1].numId, 1002u); REQUIRE_EQ(lines[1].line, 6);
+        REQUIRE_EQ(lines[2].numId, 1003u); REQUIRE_EQ(lines[2].line, 2);
+    });
+}
@@ -0,0 +1,166 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryOwnershipIndex.h"
+#include "../source/TerritoryStateRule.h"
+#include "../source/IslandRule.h"
+
+#include <cmath>
+#include <random>
+
+using Word = TerritoryOwnershipIndex::Word;
+
+// Helpers
+static Territory MakeOwned(float x, float y, float w, float h, int owner) {
+    Territory t;
+    t.minX = x; t.minY = y;
+    t.maxX = x + w; t.maxY = y + h;
+    t.ownerGang = owner;
+    return t;
+}
+
+// Random world spread over all three islands, owners including neutral,
+// cleared and out-of-range codes.
+static std::vector<Territory> MakeWorld(int count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(-1500.0f, 1500.0f);
+    std::uniform_real_distribution<float> size(10.0f, 200.0f);
+    std::vector<Territory> out;
+    for (int i = 0; i < count; ++i) {
+        const int r = (int)(rng() % 10);
+        const int owner = (r < 6) ? GANG1 + r : (r == 6) ? OWNER_NEUTRAL : (r == 7) ? OWNER_CLEARED : 3;
+        out.push_back(MakeOwned(pos(rng), pos(rng), size(rng), size(rng), owner));
+    }
+    return out;
+}
+
+// Reference: the per-territory rule chain the radar and war code use.
+static bool RuleAttackable(const Territory& t, int act) {
+    const Island island = GetIslandForPosition((t.minX + t.maxX) * 0.5f, (t.minY + t.maxY) * 0.5f);
+    const bool isLocked = !IsIslandUnlocked(island, act);
+    return CanStartWarInTerritory(ComputeTerritoryState(t.ownerGang, act, isLocked));
+}
+
+static bool BitSet(const std::vector<Word>& bits, int i) {
+    return (bits[i / TerritoryOwnershipIndex::kWordBits] >> (i % TerritoryOwnershipIndex::kWordBits)) & 1u;
+}
+
+// Index answers match a fresh scan of terrs for every act.
+static void RequireMatchesRules(const TerritoryOwnershipIndex& idx, const std::vector<Territory>& terrs) {
+    std::vector<Word> hostile, unlocked, attackable;
+    for (int act = 0; act <= 3; ++act) {
+        idx.Hostile(act, hostile);
+        idx.Unlocked(act, unlocked);
+        idx.Attackable(act, attackable);
+        int expected = 0;
+        for (int i = 0; i < (int)terrs.size(); ++i) {
+            const Territory& t = terrs[i];
+            const bool isLocked = !IsIslandUnlocked(
+                GetIslandForPosition((t.minX + t.maxX) * 0.5f, (t.minY + t.maxY) * 0.5f), act);
+            REQUIRE_EQ(BitSet(hostile, i), IsGangHostileInAct(act, t.ownerGang));
+            REQUIRE_EQ(BitSet(unlocked, i), !isLocked);
+            // The radar draws exactly the unlocked set.
+            REQUIRE_EQ(BitSet(unlocked, i), IsTerritoryVisible(ComputeTerritoryState(t.ownerGang, act, isLocked)));
+            REQUIRE_EQ(BitSet(attackable, i), RuleAttackable(t, act));
+            expected += RuleAttackable(t, act) ? 1 : 0;
+        }
+        REQUIRE_EQ(idx.CountAttackable(act), expected);
+        REQUIRE_EQ(TerritoryOwnershipIndex::CountBits(attackable), expected);
+    }
+    for (int g = GANG1; g <= GANG6; ++g) {
+        int n = 0;
+        double area = 0.0;
+        for (const auto& t : terrs) {
+            if (t.ownerGang == g) { ++n; area += t.GetArea(); }
+        }
+        REQUIRE_EQ(idx.OwnedCount(g), n);
+        REQUIRE(std::fabs(idx.OwnedArea(g) - area) <= 1.0 + area * 1e-5);
+    }
+}
+
+void RunTerritoryOwnershipIndexTests(Test::Runner& t) {
+    t.suite("TerritoryOwnershipIndex");
+
+    t.run("masks: derived from AffiliationRule and IslandRule", [&] {
+        REQUIRE_EQ(TerritoryOwnershipIndex::HostileGangMask(0), 0u);
+        REQUIRE_EQ(TerritoryOwnershipIndex::HostileGangMask(1), 0x6u);  // Triads, Diablos
+        REQUIRE_EQ(TerritoryOwnershipIndex::HostileGangMask(2), 0x31u); // Mafia, Colombians, Yardies
+        REQUIRE_EQ(TerritoryOwnershipIndex::HostileGangMask(3), 0x3Fu);
+        REQUIRE_EQ(TerritoryOwnershipIndex::UnlockedIslandMask(0), 0u);
+        REQUIRE_EQ(TerritoryOwnershipIndex::UnlockedIslandMask(1), 0x1u);
+        REQUIRE_EQ(TerritoryOwnershipIndex::UnlockedIslandMask(3), 0x7u);
+    });
+
+    t.run("buckets: neutral, cleared and unknown codes are kept apart", [&] {
+        std::vector<Territory> terrs = {
+            MakeOwned(700.f, 0.f, 10.f, 10.f, OWNER_NEUTRAL),
+            MakeOwned(700.f, 0.f, 10.f, 10.f, OWNER_CLEARED),
+            MakeOwned(700.f, 0.f, 10.f, 20.f, 42),
+            MakeOwned(700.f, 0.f, 10.f, 30.f, GANG2),
+        };
+        TerritoryOwnershipIndex idx;
+        idx.Build(terrs);
+        REQUIRE_EQ(idx.OwnedCount(OWNER_NEUTRAL), 1);
+        REQUIRE_EQ(idx.OwnedCount(OWNER_CLEARED), 1);
+        REQUIRE_EQ(idx.OwnedCount(42), 1);
+        REQUIRE_EQ(idx.OwnedCount(GANG2), 1);
+        REQUIRE_EQ(idx.OwnedArea(GANG2), 300.f);
+        REQUIRE_EQ(idx.CountAttackable(1), 1);
+        REQUIRE_EQ(idx.CountAttackable(1, GANG2), 1);
+        REQUIRE_EQ(idx.CountAttackable(1, GANG1), 0); // allied in act 1
+    });
+
+    t.run("area: polygon outline counts its own area, not the box", [&] {
+        Territory tri = MakeOwned(0.f, 0.f, 100.f, 100.f, GANG3);
+        const float xy[] = { 0.f, 0.f, 100.f, 0.f, 0.f, 100.f };
+        std::string err;
+        REQUIRE(tri.poly.Build(xy, 3, err));
+        TerritoryOwnershipIndex idx;
+        idx.Build({ tri });
+        REQUIRE_EQ(idx.OwnedArea(GANG3), 5000.f);
+    });
+
+    t.run("empty: every query is zero", [&] {
+        TerritoryOwnershipIndex idx;
+        idx.Build({});
+        std::vector<Word> bits;
+        idx.Attackable(3, bits);
+        REQUIRE(bits.empty());
+        REQUIRE_EQ(idx.CountAttackable(3), 0);
+        REQUIRE_EQ(idx.OwnedCount(GANG1), 0);
+        idx.SetOwner(0, GANG1); // out of range is ignored
+    });
+
+    t.run("for each: visits set bits in order across words", [&] {
+        std::vector<Word> bits = { 0x80000001u, 0u, 0x5u };
+        std::vector<int> seen;
+        TerritoryOwnershipIndex::ForEach(bits, [&](int i) { seen.push_back(i); });
+        REQUIRE_EQ((int)seen.size(), 4);
+        REQUIRE_EQ(seen[0], 0);
+        REQUIRE_EQ(seen[1], 31);
+        REQUIRE_EQ(seen[2], 64);
+        REQUIRE_EQ(seen[3], 66);
+        REQUIRE_EQ(TerritoryOwnershipIndex::PopCount(0xFFFFFFFFu), 32);
+    });
+
+    t.run("random: built index matches the per-territory rules", [&] {
+        const auto terrs = MakeWorld(1000, 11u);
+        TerritoryOwnershipIndex idx;
+        idx.Build(terrs);
+        RequireMatchesRules(idx, terrs);
+    });
+
+    t.run("random: incremental SetOwner stays equal to a rebuild", [&] {
+        auto terrs = MakeWorld(517, 23u);
+        TerritoryOwnershipIndex idx;
+        idx.Build(terrs);
+        std::mt19937 rng(5u);
+        for (int step = 0; step < 5000; ++step) {
+            const int i = (int)(rng() % terrs.size());
+            const int r = (int)(rng() % 8);
+            const int owner = (r < 6) ? GANG1 + r : (r == 6) ? OWNER_NEUTRAL : OWNER_CLEARED;
+            terrs[i].ownerGang = owner;
+            idx.SetOwner(i, owner);
+        }
+        RequireMatchesRules(idx, terrs);
+    });
+}
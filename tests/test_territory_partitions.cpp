@@ -0,0 +1,101 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryPartitions.h"
+#include "../source/TerritoryGrid.h"
+
+// Helpers
+static Territory MakeRect(float cx, float cy, float half) {
+    Territory t;
+    t.minX = cx - half; t.minY = cy - half;
+    t.maxX = cx + half; t.maxY = cy + half;
+    return t;
+}
+
+// Interleaved on purpose: file order is Portland, Staunton, Shoreside, ...
+static std::vector<Territory> MakeWorld(int perIsland) {
+    std::vector<Territory> out;
+    for (int i = 0; i < perIsland; ++i) {
+        const float y = -800.0f + i * 40.0f;
+        out.push_back(MakeRect(1000.0f, y, 15.0f));  // Portland
+        out.push_back(MakeRect(100.0f, y, 15.0f));   // Staunton
+        out.push_back(MakeRect(-800.0f, y, 15.0f));  // Shoreside
+    }
+    return out;
+}
+
+void RunTerritoryPartitionsTests(Test::Runner& t) {
+    t.suite("TerritoryPartitions");
+
+    t.run("build: every territory lands on its center's island", [&] {
+        const auto terrs = MakeWorld(10);
+        TerritoryPartitions p;
+        p.Build(terrs, 3);
+        REQUIRE_EQ(p.PartitionSize(Island::PORTLAND), 10);
+        REQUIRE_EQ(p.PartitionSize(Island::STAUNTON), 10);
+        REQUIRE_EQ(p.PartitionSize(Island::SHORESIDE), 10);
+        REQUIRE(p.IslandOf(0) == Island::PORTLAND);
+        REQUIRE(p.IslandOf(1) == Island::STAUNTON);
+        REQUIRE(p.IslandOf(2) == Island::SHORESIDE);
+    });
+
+    t.run("act 0 and 1: Portland only", [&] {
+        const auto terrs = MakeWorld(4);
+        TerritoryPartitions p;
+        p.Build(terrs, 0);
+        REQUIRE_EQ((int)p.Active().size(), 4);
+        REQUIRE(p.IsActive(0));
+        REQUIRE_FALSE(p.IsActive(1));
+        REQUIRE_FALSE(p.IsActive(2));
+        REQUIRE_FALSE(p.AllActive());
+
+        REQUIRE_FALSE(p.SetAct(1)); // same islands
+        REQUIRE_EQ(p.Act(), 1);
+    });
+
+    t.run("set act: promotes whole islands, active list stays ascending", [&] {
+        const auto terrs = MakeWorld(5);
+        TerritoryPartitions p;
+        p.Build(terrs, 1);
+
+        REQUIRE(p.SetAct(2));
+        REQUIRE_EQ((int)p.Active().size(), 10);
+        for (size_t k = 1; k < p.Active().size(); ++k) REQUIRE(p.Active()[k - 1] < p.Active()[k]);
+        REQUIRE(p.IsActive(1));
+        REQUIRE_FALSE(p.IsActive(2));
+
+        REQUIRE(p.SetAct(3));
+        REQUIRE(p.AllActive());
+        for (int k = 0; k < (int)terrs.size(); ++k) REQUIRE_EQ(p.Active()[k], k);
+    });
+
+    t.run("set act: a lower act (earlier save) demotes", [&] {
+        const auto terrs = MakeWorld(3);
+        TerritoryPartitions p;
+        p.Build(terrs, 3);
+        REQUIRE(p.SetAct(0));
+        REQUIRE_EQ((int)p.Active().size(), 3);
+        REQUIRE_FALSE(p.IsActive(4));
+    });
+
+    t.run("active grid: gated islands never answer a point query", [&] {
+        const auto terrs = MakeWorld(8);
+        TerritoryPartitions p;
+        p.Build(terrs, 1);
+        TerritoryGrid g;
+        g.Build(terrs, p.Active());
+        REQUIRE_EQ(g.QueryPoint(1000.0f, -800.0f), 0);
+        REQUIRE_EQ(g.QueryPoint(100.0f, -800.0f), -1);
+
+        REQUIRE(p.SetAct(2));
+        g.Build(terrs, p.Active());
+        REQUIRE_EQ(g.QueryPoint(100.0f, -800.0f), 1);
+        REQUIRE_EQ(g.QueryPoint(-800.0f, -800.0f), -1);
+    });
+
+    t.run("empty list: nothing active, counts as all active", [&] {
+        TerritoryPartitions p;
+        p.Build({}, 1);
+        REQUIRE(p.Active().empty());
+        REQUIRE(p.AllActive());
+    });
+}
@@ -0,0 +1,199 @@
+#include "TestFramework.h"
+#include "../source/TerritorySystem.h"
+#include "../source/TerritoryPolygon.h"
+
+#include <cmath>
+#include <cstdlib>
+
+// Helpers
+static float RandIn(float a, float b) {
+    return a + (b - a) * ((float)std::rand() / (float)RAND_MAX);
+}
+
+static TerritoryPolygon MakePoly(std::initializer_list<float> xy) {
+    TerritoryPolygon p;
+    std::string err;
+    const std::vector<float> v(xy);
+    p.Build(v.data(), (int)(v.size() / 2), err);
+    return p;
+}
+
+static std::string BuildErr(std::initializer_list<float> xy) {
+    TerritoryPolygon p;
+    std::string err;
+    const std::vector<float> v(xy);
+    if (p.Build(v.data(), (int)(v.size() / 2), err)) return "";
+    REQUIRE(p.Empty());
+    return err;
+}
+
+// Reference: textbook even-odd test straight over the vertex ring.
+static bool RingContains(const TerritoryPolygon& p, float x, float y) {
+    const int n = p.VertexCount();
+    bool inside = false;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        const float xi = p.X()[i], yi = p.Y()[i], xj = p.X()[j], yj = p.Y()[j];
+        if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi) inside = !inside;
+    }
+    return inside;
+}
+
+static double RingArea(const TerritoryPolygon& p) {
+    double a = 0.0;
+    const int n = p.VertexCount();
+    for (int i = 0; i < n; ++i) {
+        const int j = (i + 1) % n;
+        a += (double)p.X()[i] * p.Y()[j] - (double)p.X()[j] * p.Y()[i];
+    }
+    return a * 0.5;
+}
+
+static double TriangleArea(const TerritoryPolygon& p) {
+    double a = 0.0;
+    const auto& tris = p.Triangles();
+    for (size_t i = 0; i + 2 < tris.size(); i += 3) {
+        const float ax = p.X()[tris[i]], ay = p.Y()[tris[i]];
+        const float bx = p.X()[tris[i + 1]], by = p.Y()[tris[i + 1]];
+        const float cx = p.X()[tris[i + 2]], cy = p.Y()[tris[i + 2]];
+        const double t = ((double)bx - ax) * ((double)cy - ay) - ((double)by - ay) * ((double)cx - ax);
+        REQUIRE(t >= 0.0); // every triangle counter-clockwise
+        a += t * 0.5;
+    }
+    return a;
+}
+
+// Star-ish outline: random radius per evenly spaced angle, never self-crossing.
+static TerritoryPolygon MakeStar(int n, float cx, float cy) {
+    std::vector<float> xy;
+    for (int i = 0; i < n; ++i) {
+        const float a = 6.2831853f * (float)i / (float)n;
+        const float r = RandIn(40.f, 200.f);
+        xy.push_back(cx + r * std::cos(a));
+        xy.push_back(cy + r * std::sin(a));
+    }
+    TerritoryPolygon p;
+    std::string err;
+    p.Build(xy.data(), n, err);
+    return p;
+}
+
+void RunTerritoryPolygonTests(Test::Runner& t) {
+    t.suite("TerritoryPolygon");
+
+    // ------------------------------------------------------------------
+    // Build
+    // ------------------------------------------------------------------
+    t.run("build: box, AABB and convex fan", [&] {
+        auto p = MakePoly({ 0.f, 0.f, 100.f, 0.f, 100.f, 50.f, 0.f, 50.f });
+        REQUIRE_EQ(p.VertexCount(), 4);
+        REQUIRE(p.IsConvex());
+        REQUIRE_EQ(p.MinX(), 0.f);
+        REQUIRE_EQ(p.MaxY(), 50.f);
+        REQUIRE_EQ((int)p.Triangles().size(), 6);
+        REQUIRE(std::fabs(TriangleArea(p) - 5000.0) < 1e-3);
+    });
+
+    t.run("build: clockwise input is flipped, closing vertex dropped", [&] {
+        auto p = MakePoly({ 0.f, 0.f, 0.f, 50.f, 100.f, 50.f, 100.f, 0.f, 0.f, 0.f });
+        REQUIRE_EQ(p.VertexCount(), 4);
+        REQUIRE(RingArea(p) > 0.0);
+        REQUIRE(p.Contains(50.f, 25.f));
+    });
+
+    t.run("build: error reasons", [&] {
+        REQUIRE_EQ(BuildErr({ 0.f, 0.f, 1.f, 1.f }), std::string("Polygon needs at least 3 vertices"));
+        REQUIRE_EQ(BuildErr({ 0.f, 0.f, 1.f, 1.f, 1.f, 1.f, 0.f, 0.f }), std::string("Polygon needs at least 3 vertices"));
+        REQUIRE_EQ(BuildErr({ 0.f, 0.f, 5.f, 5.f, 10.f, 10.f }), std::string("Polygon has no area"));
+        REQUIRE_EQ(BuildErr({ 0.f, 0.f, 10.f, 10.f, 10.f, 0.f, 0.f, 20.f }), std::string("Polygon edges cross"));
+        REQUIRE_EQ(BuildErr({ 0.f, 0.f, NAN, 1.f, 1.f, 0.f }), std::string("Polygon vertex is not a number"));
+
+        std::vector<float> many;
+        for (int i = 0; i <= TerritoryPolygon::kMaxVertices; ++i) {
+            const float a = 6.2831853f * (float)i / (float)(TerritoryPolygon::kMaxVertices + 1);
+            many.push_back(1000.f * std::cos(a));
+            many.push_back(1000.f * std::sin(a));
+        }
+        TerritoryPolygon p;
+        std::string err;
+        REQUIRE_FALSE(p.Build(many.data(), (int)many.size() / 2, err));
+        REQUIRE_EQ(err, std::string("Polygon has too many vertices"));
+    });
+
+    t.run("build: failure clears a previous outline", [&] {
+        auto p = MakePoly({ 0.f, 0.f, 1.f, 0.f, 0.f, 1.f });
+        REQUIRE_FALSE(p.Empty());
+        const float bad[] = { 0.f, 0.f, 1.f, 1.f };
+        std::string err;
+        REQUIRE_FALSE(p.Build(bad, 2, err));
+        REQUIRE(p.Empty());
+    });
+
+    // ------------------------------------------------------------------
+    // Contains
+    // ------------------------------------------------------------------
+    t.run("contains: concave L leaves the notch out", [&] {
+        auto p = MakePoly({ 0.f, 0.f, 100.f, 0.f, 100.f, 40.f, 40.f, 40.f, 40.f, 100.f, 0.f, 100.f });
+        REQUIRE_FALSE(p.IsConvex());
+        REQUIRE(p.Contains(20.f, 80.f));
+        REQUIRE(p.Contains(80.f, 20.f));
+        REQUIRE_FALSE(p.Contains(80.f, 80.f));
+        REQUIRE_FALSE(p.Contains(-1.f, 20.f));
+        REQUIRE(std::fabs(TriangleArea(p) - RingArea(p)) < 1e-2);
+    });
+
+    t.run("contains: NaN never matches", [&] {
+        auto p = MakePoly({ 0.f, 0.f, 10.f, 0.f, 0.f, 10.f });
+        REQUIRE_FALSE(p.Contains(NAN, 1.f));
+        REQUIRE_FALSE(p.Contains(1.f, NAN));
+    });
+
+    t.run("contains: collinear run still triangulates", [&] {
+        auto p = MakePoly({ 0.f, 0.f, 10.f, 0.f, 20.f, 0.f, 30.f, 0.f, 30.f, 30.f, 15.f, 5.f, 0.f, 30.f });
+        REQUIRE_FALSE(p.Empty());
+        REQUIRE(std::fabs(TriangleArea(p) - RingArea(p)) < 1e-2);
+    });
+
+    t.run("random: edge table matches the ring test, triangles cover the area", [&] {
+        std::srand(77u);
+        for (int k = 0; k < 40; ++k) {
+            const auto p = MakeStar(3 + k % 40, RandIn(-1000.f, 1000.f), RandIn(-1000.f, 1000.f));
+            REQUIRE_FALSE(p.Empty());
+            REQUIRE(std::fabs(TriangleArea(p) - RingArea(p)) < RingArea(p) * 1e-4);
+            REQUIRE(p.Contains(p.InteriorX(), p.InteriorY()));
+            for (int i = 0; i < 200; ++i) {
+                const float x = RandIn(p.MinX() - 10.f, p.MaxX() + 10.f);
+                const float y = RandIn(p.MinY() - 10.f, p.MaxY() + 10.f);
+                REQUIRE_EQ(p.Contains(x, y), RingContains(p, x, y));
+            }
+        }
+    });
+
+    // ------------------------------------------------------------------
+    // PullInside / Territory
+    // ------------------------------------------------------------------
+    t.run("pull inside: inside points untouched, outside ones land inside", [&] {
+        auto p = MakePoly({ 0.f, 0.f, 100.f, 0.f, 100.f, 40.f, 40.f, 40.f, 40.f, 100.f, 0.f, 100.f });
+        float x = 20.f, y = 20.f;
+        p.PullInside(x, y);
+        REQUIRE_EQ(x, 20.f);
+        REQUIRE_EQ(y, 20.f);
+
+        const float probes[][2] = { { 80.f, 80.f }, { 200.f, 20.f }, { -50.f, -50.f }, { 41.f, 41.f } };
+        for (const auto& q : probes) {
+            x = q[0]; y = q[1];
+            p.PullInside(x, y);
+            REQUIRE(p.Contains(x, y));
+        }
+    });
+
+    t.run("territory: ContainsPoint uses the outline", [&] {
+        Territory terr;
+        std::string err;
+        const float tri[] = { 0.f, 0.f, 100.f, 0.f, 0.f, 100.f };
+        REQUIRE(terr.poly.Build(tri, 3, err));
+        terr.minX = terr.poly.MinX(); terr.minY = terr.poly.MinY();
+        terr.maxX = terr.poly.MaxX(); terr.maxY = terr.poly.MaxY();
+        REQUIRE(terr.ContainsPoint(CVector(10.f, 10.f, 0.f)));
+        REQUIRE_FALSE(terr.ContainsPoint(CVector(90.f, 90.f, 0.f)));
+    });
+}